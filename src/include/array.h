@@ -1,6 +1,7 @@
 #ifndef ARRAY_H
 #define ARRAY_H
 
+#include <deque>
 #include <list>
 
 /* these are required if you include array.h */
@@ -26,6 +27,7 @@
 #define NO_JOBS_IN_ARRAY   -21
 
 #define ARRAY_FILE_SUFFIX ".AR"
+#define ARRAY_COUNTERS_SUFFIX ".AR.cnt"
 
 enum ArrayEventsEnum {
   aeQueue = 0,
@@ -130,6 +132,60 @@ class array_info
   ~array_info();
   };
 
+/*
+ * The counters in array_info change every time a sub-job changes state. Rather
+ * than rewriting the whole array file for each of those they are kept in this
+ * fixed size record next to it (<fileprefix>.AR.cnt), which is overwritten in
+ * place. array_save() writes the record before the array file, so a valid
+ * record is never older than the counters in the array file.
+ */
+
+#define ARRAY_COUNTERS_MAGIC   0x41524354 /* ARCT */
+#define ARRAY_COUNTERS_VERSION 1
+
+typedef struct array_counters_record
+  {
+  unsigned int ac_magic;
+  unsigned int ac_version;
+  int          ac_jobs_running;
+  int          ac_jobs_done;
+  int          ac_num_cloned;
+  int          ac_num_started;
+  int          ac_num_failed;
+  int          ac_num_successful;
+  int          ac_num_purged;
+  int          ac_num_idle;
+  int          ac_highest_id_created;
+  unsigned int ac_checksum;        /* over every field above it */
+  } array_counters_record;
+
+
+/*
+ * A sorted set of sub-job indices stored as inclusive ranges. Sub-jobs that
+ * haven't been created cost a range instead of an entry each, so an array
+ * of 100,000 sub-jobs that is never run is still a few dozen bytes.
+ */
+
+class array_index_ranges
+  {
+  std::deque<std::pair<int, int> > ranges;
+  size_t                           count;
+
+  public:
+  array_index_ranges();
+
+  int    set_from_string(const char *range_str, int lowest);
+  void   clear();
+  size_t size() const;
+  bool   empty() const;
+  int    front() const;
+  int    pop_front();
+  bool   contains(int index) const;
+  bool   remove(int index);
+  const std::deque<std::pair<int, int> > &get_ranges() const;
+  };
+
+
 
 /* pbs_server will keep a list of these structs, with one struct per job array*/
 
@@ -146,8 +202,8 @@ class job_array
   // order to not lose sub-jobs
   bool               ai_ghost_recovered;
 
-  // Vector of array sub jobs indices that haven't been created
-  std::vector<int>   uncreated_ids;
+  // Indices of the sub jobs that haven't been created
+  array_index_ranges uncreated_ids;
 
   pthread_mutex_t   *ai_mutex;
 
@@ -169,7 +225,8 @@ class job_array
   void update_array_values(int old_state, enum ArrayEventsEnum event, const char *job_id,
                             int job_exit_status);
   void create_job_if_needed();
-  int  get_next_index_to_create(int &internal_index);
+  int  create_subjob(int index, bool in_order);
+  int  get_next_index_to_create();
   void initialize_uncreated_ids();
 
   bool need_to_update_slot_limits() const;
@@ -211,10 +268,11 @@ typedef container::item_container<job_array *>::item_iterator all_arrays_iterato
 int  is_array(char *id);
 int  array_delete(const char *array_id);
 int  array_save(job_array *pa);
-int  array_save(job_array *pa);
+int  array_save_counters(job_array *pa);
 void array_get_parent_id(char *job_id, char *parent_id);
 
 job_array *get_array(const char *id);
+job *find_or_create_array_subjob(const char *job_id);
 int array_recov(const char *path, job_array **pa);
 
 int delete_array_range(job_array *pa, char *range, bool purge);
@@ -210,6 +210,14 @@ struct rq_runjob
   unsigned int rq_resch;
   };
 
+/* RunJobs - several Run Job requests in one */
+
+struct rq_runjobs
+  {
+  int               rq_count;
+  struct rq_runjob *rq_jobs;
+  };
+
 /* SignalJob */
 
 struct rq_signal
@@ -226,6 +234,19 @@ struct rq_status
   tlist_head rq_attr;
   };
 
+/* StatusSnapshot - server, queue, job and node status in one request */
+
+#define SNAPSHOT_SERVER    0
+#define SNAPSHOT_QUEUE     1
+#define SNAPSHOT_JOB       2
+#define SNAPSHOT_NODE      3
+#define SNAPSHOT_OBJ_COUNT 4
+
+struct rq_snapshot
+  {
+  tlist_head rq_attr[SNAPSHOT_OBJ_COUNT]; /* attributes wanted, per object type */
+  };
+
 /* TrackJob */
 
 struct rq_track
@@ -375,6 +396,7 @@ struct batch_request
     struct rq_rescq       rq_rescq;
 
     struct rq_runjob      rq_run;
+    struct rq_runjobs     rq_runjobs;
     tlist_head            rq_select; /* svrattrlist */
     int                   rq_shutdown;
 
@@ -384,6 +406,8 @@ struct batch_request
 
     struct rq_status      rq_status;
 
+    struct rq_snapshot    rq_snapshot;
+
     struct rq_track       rq_track;
 
     struct rq_gpuctrl     rq_gpuctrl;
@@ -464,9 +488,11 @@ extern int decode_DIS_ReqHdr (struct tcp_chan *chan, struct batch_request *, int
 extern int decode_DIS_Rescl (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_Rescq (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_RunJob (struct tcp_chan *chan, struct batch_request *);
+extern int decode_DIS_RunJobs (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_ShutDown (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_SignalJob (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_Status (struct tcp_chan *chan, struct batch_request *);
+extern int decode_DIS_StatusSnapshot (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_TrackJob (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_replySvr (struct tcp_chan *chan, struct batch_reply *);
 extern int decode_DIS_svrattrl (struct tcp_chan *chan, tlist_head *);
@@ -17,6 +17,7 @@
 #include <boost/unordered_map.hpp>
 #include <string>
 #include <vector>
+#include <map>
 #include <pthread.h>
 #include <memory.h>
 #include <errno.h>
@@ -81,6 +82,8 @@ template <class T> class slot
   item<T> *pItem;
   int     next;
   int     prev;
+  bool    ranked; /* true if this slot is in rank_index */
+  long    rank;
   };
 
 template <class T>
@@ -279,9 +282,11 @@ class item_container
     
     item<T> *pItem = new item<T>(id,it);
 
-    if (insert_thing_after(pItem,index) < 0)
+    if ((index = insert_thing_after(pItem,index)) < 0)
       return false;
 
+    rank_like_neighbours(index);
+
     return true;
     }
 
@@ -309,9 +314,11 @@ class item_container
 
     item<T> *pItem = new item<T>(id,it);
 
-    if (insert_thing_before(pItem,iter) < 0)
+    if ((index = insert_thing_before(pItem,iter)) < 0)
       return false;
 
+    rank_like_neighbours(index);
+
     return true;
     }
 
@@ -332,6 +339,53 @@ class item_container
 
 
 
+  /*
+   * inserts it before the first ranked item whose rank is > rank, or last if
+   * there is none, so items inserted this way stay ordered by rank and equal
+   * ranks keep their insertion order. Finding
+   * the spot is O(log n) and doesn't look at the other items.
+   *
+   * @return PBSE_NONE, ALREADY_IN_LIST if id is present, or -1 on failure
+   */
+
+  int insert_by_rank(
+
+    T                  it,
+    std::string const &id,
+    long               rank)
+
+    {
+    CHECK_LOCK
+    if (exit_called)
+      return(-1);
+
+    if (map.find(id) != map.end())
+      return(ALREADY_IN_LIST);
+
+    item<T> *pItem = new item<T>(id,it);
+    std::multimap<long, int>::iterator pos = rank_index.upper_bound(rank);
+    int index;
+
+    if (pos == rank_index.end())
+      index = insert_thing(pItem);
+    else
+      index = insert_thing_before(pItem, pos->second);
+
+    if (index < 0)
+      {
+      delete pItem;
+      return(-1);
+      }
+
+    slots[index].ranked = true;
+    slots[index].rank = rank;
+    rank_index.insert(pos, std::pair<long, int>(rank, index));
+
+    return(PBSE_NONE);
+    }
+
+
+
   bool insert_before(
       
     std::string const &location_id,
@@ -500,8 +554,10 @@ class item_container
 
       slots[i].next = ALWAYS_EMPTY_INDEX;
       slots[i].prev = ALWAYS_EMPTY_INDEX;
+      slots[i].ranked = false;
       }
 
+    rank_index.clear();
     num = 0;
     next_slot = 1;
     last = 0;
@@ -792,6 +848,86 @@ class item_container
 
 
 
+  /*
+   * finds the rank_index entry for the ranked slot at index
+   */
+  std::multimap<long, int>::iterator find_rank_entry(
+
+    int index)
+
+    {
+    std::pair<std::multimap<long, int>::iterator, std::multimap<long, int>::iterator> range =
+      rank_index.equal_range(slots[index].rank);
+
+    for (std::multimap<long, int>::iterator it = range.first; it != range.second; it++)
+      {
+      if (it->second == index)
+        return(it);
+      }
+
+    return(rank_index.end());
+    } /* END find_rank_entry() */
+
+
+
+  /*
+   * gives an item that was inserted by position the rank of a ranked
+   * neighbour, so insert_by_rank() still finds the right spot around it
+   */
+  void rank_like_neighbours(
+
+    int index)
+
+    {
+    int                                prev = slots[index].prev;
+    int                                next = slots[index].next;
+    std::multimap<long, int>::iterator pos;
+
+    if ((prev != ALWAYS_EMPTY_INDEX) &&
+        (slots[prev].ranked == true))
+      {
+      /* just after prev among the items of the same rank */
+      pos = find_rank_entry(prev);
+      pos++;
+      slots[index].rank = slots[prev].rank;
+      }
+    else if ((next != ALWAYS_EMPTY_INDEX) &&
+             (slots[next].ranked == true))
+      {
+      /* just before next among the items of the same rank */
+      pos = find_rank_entry(next);
+      slots[index].rank = slots[next].rank;
+      }
+    else
+      return;
+
+    slots[index].ranked = true;
+    rank_index.insert(pos, std::pair<long, int>(slots[index].rank, index));
+    } /* END rank_like_neighbours() */
+
+
+
+  /*
+   * removes the slot at index from rank_index
+   */
+  void unrank_slot(
+
+    int index)
+
+    {
+    if (slots[index].ranked == false)
+      return;
+
+    std::multimap<long, int>::iterator it = find_rank_entry(index);
+
+    if (it != rank_index.end())
+      rank_index.erase(it);
+
+    slots[index].ranked = false;
+    } /* END unrank_slot() */
+
+
+
   /*
    * fix the next pointer for the box pointing to this index
    *
@@ -807,6 +943,7 @@ class item_container
     int next = slots[index].next;
 
     map.erase(slots[index].pItem->id);
+    unrank_slot(index);
     slots[index].prev = ALWAYS_EMPTY_INDEX;
     slots[index].next = ALWAYS_EMPTY_INDEX;
     delete slots[index].pItem;
@@ -1106,6 +1243,10 @@ class item_container
   int next_slot;
   int last;
   boost::unordered_map<std::string, int> map;
+  /* rank -> slot for items added by insert_by_rank(), and for items inserted
+   * next to them by position. swap() exchanges
+   * items but not slots, so a rank stays with its position */
+  std::multimap<long, int> rank_index;
 #ifdef CHECK_LOCKING
   bool locked;
 #endif
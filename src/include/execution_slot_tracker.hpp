@@ -82,10 +82,19 @@
 
 #include <vector>
 
+/*
+ * Tracks which of a node's execution slots are occupied, one bit per slot
+ * packed into 64-bit words so finding, reserving and releasing slots works
+ * on a word at a time.
+ */
+
 class execution_slot_tracker
   {
-  std::vector<bool> slots;
-  int               open_count;
+  std::vector<unsigned long long> slots;      /* a set bit is an occupied slot */
+  int                             slot_count;
+  int                             open_count;
+
+  unsigned long long valid_mask(size_t word) const;
 
   public:
     execution_slot_tracker(const execution_slot_tracker& est);
@@ -99,6 +108,8 @@ class execution_slot_tracker
   bool is_occupied(int index) const;
 	int mark_as_used(int index);
   int mark_as_free(int index);
+  int mark_range_as_used(int first, int count);
+  int mark_range_as_free(int first, int count);
   void add_execution_slot();
   int unset_subset(const execution_slot_tracker &subset);
   int reserve_execution_slot(int index, execution_slot_tracker &subset);
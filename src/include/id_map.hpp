@@ -98,9 +98,55 @@ class id_map
     int get_new_id(const char *name);
     int get_id(const char *name);
     const char *get_name(int id);
+    int rename_id(int id, const char *name);
+  };
+
+
+
+/*
+ * A set of ids handed out by an id_map, one bit per id. Checking whether an id
+ * is in the set is a single bit test.
+ */
+
+class id_set
+  {
+    std::vector<unsigned long long> words;
+
+  public:
+    id_set() : words() {}
+
+    void add(int id)
+      {
+      if (id < 0)
+        return;
+
+      size_t word = id / 64;
+
+      if (word >= this->words.size())
+        this->words.resize(word + 1, 0);
+
+      this->words[word] |= 1ULL << (id % 64);
+      }
+
+    bool contains(int id) const
+      {
+      if (id < 0)
+        return(false);
+
+      size_t word = id / 64;
+
+      return((word < this->words.size()) &&
+             ((this->words[word] & (1ULL << (id % 64))) != 0));
+      }
+
+    void clear()
+      {
+      this->words.clear();
+      }
   };
 
 extern id_map node_mapper;
 extern id_map job_mapper;
+extern id_map property_mapper; /* node properties and features */
 
 #endif // ID_MAP_HPP
@@ -0,0 +1,107 @@
+#ifndef JOB_JOURNAL_HPP
+#define JOB_JOURNAL_HPP
+
+#include <map>
+#include <set>
+#include <string>
+#include <pthread.h>
+#include <sys/types.h>
+
+#include "pbs_ifl.h"
+#include "server_limits.h"
+
+#define JOB_JOURNAL            "job_journal"
+#define JOB_JOURNAL_OLD_SUFFIX ".1"
+#define JOURNAL_MAGIC          0x4a4a524e /* "JJRN" */
+
+/* compact once the journal grows past this many bytes */
+#define JOURNAL_COMPACT_SIZE         (64 * 1024 * 1024)
+/* otherwise compact a non-empty journal this often */
+#define JOURNAL_COMPACT_INTERVAL     300
+#define JOURNAL_COMPACT_SLEEP_TIME   5
+
+enum journal_record_type
+  {
+  JOURNAL_SAVE = 1, /* payload is the job's full XML image */
+  JOURNAL_QUICK,    /* payload is a job_quick_record */
+  JOURNAL_PURGE     /* no payload, the job is gone */
+  };
+
+typedef struct journal_record_header
+  {
+  int           jr_magic;
+  int           jr_type;
+  int           jr_is_template;
+  int           jr_length;   /* payload bytes following the header */
+  unsigned long jr_checksum; /* checksum of the payload */
+  char          jr_jobid[PBS_MAXSVRJOBID + 1];
+  char          jr_fileprefix[PBS_JOBBASE + 1];
+  } journal_record_header;
+
+
+
+/*
+ * The collapsed result of every journal record for one job: only the newest
+ * image and the quick record written after it matter.
+ */
+
+class journal_entry
+  {
+  public:
+  bool        purged;
+  bool        is_template;
+  std::string fileprefix;
+  std::string image;
+  std::string quick;
+
+  journal_entry();
+  };
+
+typedef int (*journal_apply_func)(const std::string &jobid, const journal_entry &je);
+
+
+
+class job_journal
+  {
+  std::string            jj_path;
+  int                    jj_fd;
+  off_t                  jj_size;
+  time_t                 jj_last_compact;
+  std::string            jj_pending;     /* records waiting for the next group commit */
+  unsigned long          jj_next_seq;    /* sequence number of the last appended record */
+  unsigned long          jj_durable_seq; /* records up to here are on disk */
+  std::map<unsigned long, unsigned long> jj_failed; /* last -> first seq of batches that failed */
+  bool                   jj_flushing;
+  std::set<std::string>  jj_purged;      /* jobs purged since the last rotation */
+  pthread_mutex_t        jj_mutex;
+  pthread_mutex_t        jj_compact_mutex;
+  pthread_mutex_t        jj_purge_mutex; /* orders purges against compaction's writes */
+  pthread_cond_t         jj_cond;
+
+  int  write_pending(const std::string &batch);
+  void record_failed(unsigned long low, unsigned long high);
+  bool has_failed(unsigned long seq);
+
+  public:
+  job_journal();
+  ~job_journal();
+
+  int           open_journal(const char *path);
+  void          close_journal();
+  bool          is_open();
+  unsigned long append(int type, const char *jobid, const char *fileprefix, bool is_template,
+                       const char *payload, size_t len);
+  int           commit(unsigned long seq);
+  bool          needs_compaction(time_t time_now);
+  int           compact(journal_apply_func apply);
+
+  static unsigned long checksum(const char *buf, size_t len);
+  static int           read_journal(const char *path, std::map<std::string, journal_entry> &entries);
+  static int           replay(const char *path, journal_apply_func apply);
+  };
+
+extern job_journal server_job_journal;
+
+void *compact_job_journal(void *vp);
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef JOB_RECORD_HPP
+#define JOB_RECORD_HPP
+
+#include <stdint.h>
+#include <string>
+
+#include "pbs_job.h"
+
+/*
+ * Binary job record, an alternative to the xml job file that can be read
+ * straight out of an mmap()ed file without building a DOM.
+ *
+ * A record is a job_record_header, the job's ji_qs exactly as it is in
+ * memory, and then one block per set attribute:
+ *
+ *   job_record_attr   - block header
+ *   name              - ja_name_len bytes including the terminating NUL
+ *   values            - ja_value_count times:
+ *     job_record_value  - value header
+ *     resource          - jv_resc_len bytes including the NUL, may be 0
+ *     value             - jv_value_len bytes including the NUL
+ *
+ * Values are stored the way they are written to xml, so records convert to
+ * and from xml without losing anything. ja_index is only a hint: a reader
+ * uses it when job_attr_def[ja_index] has the block's name and looks the
+ * name up otherwise, so records survive attributes being added. Nothing in
+ * a record is aligned, and records use the host's byte order and ji_qs
+ * layout, the same as the quick save record.
+ */
+
+#define JOB_RECORD_MAGIC    0x544a5231 /* "TJR1" */
+#define JOB_RECORD_VERSION  1
+#define JOB_RECORD_NO_INDEX 0xffff     /* look the attribute up by name */
+
+typedef struct job_record_header
+  {
+  uint32_t jr_magic;
+  uint16_t jr_version;     /* JOB_RECORD_VERSION when written */
+  uint16_t jr_header_size; /* sizeof(job_record_header) when written */
+  uint32_t jr_qs_version;  /* PBS_QS_VERSION when written */
+  uint32_t jr_qs_size;     /* sizeof(struct jobfix) when written */
+  uint32_t jr_attr_count;  /* number of attribute blocks */
+  uint32_t jr_reserved;
+  uint64_t jr_size;        /* size of the whole record */
+  uint64_t jr_checksum;    /* checksum of everything after the header */
+  } job_record_header;
+
+typedef struct job_record_attr
+  {
+  uint32_t ja_size;        /* size of the block, including this header */
+  uint16_t ja_index;       /* index into job_attr_def, or JOB_RECORD_NO_INDEX */
+  uint16_t ja_name_len;
+  uint32_t ja_value_count;
+  } job_record_attr;
+
+typedef struct job_record_value
+  {
+  uint32_t jv_flags;       /* the attribute's or resource's at_flags */
+  uint32_t jv_resc_len;
+  uint32_t jv_value_len;
+  } job_record_value;
+
+
+
+/*
+ * Builds a record in memory. Attributes are added with begin_attr() followed
+ * by one add_value() per value.
+ */
+
+class job_record_builder
+  {
+  std::string jb_image;
+  uint32_t    jb_attr_count;
+  size_t      jb_attr_start; /* offset of the open block, 0 if none */
+
+  void end_attr();
+
+  public:
+  job_record_builder(const struct jobfix &qs);
+
+  void               begin_attr(int index, const char *name);
+  void               add_value(const char *resc, const char *value, unsigned int flags);
+  const std::string &finish();
+  };
+
+
+
+/*
+ * Walks a record in place. open_record() checks the header and checksum;
+ * next_attr() and next_value() then return pointers into the record, so the
+ * buffer must outlive anything they return.
+ */
+
+class job_record_reader
+  {
+  const char *jr_buf;
+  size_t      jr_len;
+  size_t      jr_offset;     /* next unread byte */
+  size_t      jr_attr_end;   /* end of the current block */
+  uint32_t    jr_attrs_left;
+  uint32_t    jr_values_left;
+  const char *jr_qs;
+
+  public:
+  job_record_reader();
+
+  int  open_record(const char *buf, size_t len, char *log_buf, size_t buf_len);
+  void get_qs(struct jobfix &qs) const;
+  bool next_attr(int &index, const char *&name);
+  bool next_value(const char *&resc, const char *&value, unsigned int &flags);
+  bool is_complete() const;
+  };
+
+uint64_t job_record_checksum(const char *buf, size_t len);
+bool     is_job_record(const char *buf, size_t len);
+
+#endif /* JOB_RECORD_HPP */
@@ -0,0 +1,54 @@
+#ifndef JOB_WRITER_HPP
+#define JOB_WRITER_HPP
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+#include "job_journal.hpp"
+
+/* the most jobs a writer thread takes from the queue at once */
+#define JOB_WRITER_BATCH_SIZE 64
+
+typedef std::vector<std::pair<std::string, journal_entry> > job_write_batch;
+
+
+
+/*
+ * Queues serialized job images so that request threads don't wait on the
+ * disk. Saves of a job that is already queued replace the queued image, so
+ * a job saved many times between flushes is only written once. Writer
+ * threads take the queued jobs in batches and never write the same job
+ * from two threads at once.
+ */
+
+class job_writer
+  {
+  std::map<std::string, journal_entry> jw_dirty;   /* jobs waiting to be written */
+  std::set<std::string>                jw_writing; /* jobs a writer is writing now */
+  pthread_mutex_t                      jw_mutex;
+  pthread_cond_t                       jw_work_cond;
+  pthread_cond_t                       jw_done_cond;
+
+  void take_batch(job_write_batch &batch);
+  void finish_batch(const job_write_batch &batch);
+
+  public:
+  job_writer();
+  ~job_writer();
+
+  void   queue_save(const char *jobid, const char *fileprefix, bool is_template,
+                    const std::string &payload, bool quick);
+  void   forget(const char *jobid);
+  int    write_batch(journal_apply_func apply, bool wait);
+  void   flush(journal_apply_func apply);
+  size_t dirty_count();
+  };
+
+extern job_writer server_job_writer;
+
+void *write_dirty_jobs(void *vp);
+
+#endif
@@ -62,6 +62,8 @@ int PBSD_async_sig_put(int c, const char *jobid, const char *signal, char *exten
 /* PBSD_status.c */
 struct batch_status *PBSD_status(int c, int function, int *, char *id, struct attrl *attrib, char *extend); 
 struct batch_status *PBSD_status_get(int *, int c); 
+int PBSD_snapshot_get(int *, int c, struct batch_snapshot *snap);
+int split_snapshot_status(struct brp_cmdstat *stp, struct batch_snapshot *snap);
 /* static struct batch_status * alloc_bs(void); */
 
 /* PBSD_status2.c */
@@ -147,6 +149,7 @@ int decode_DIS_ReturnFiles(struct tcp_chan *chan, struct batch_request *preq);
 
 /* dec_RunJob.c */
 int decode_DIS_RunJob(struct tcp_chan *chan, struct batch_request *preq);
+int decode_DIS_RunJobs(struct tcp_chan *chan, struct batch_request *preq);
 
 /* dec_Shut.c */
 int decode_DIS_ShutDown(struct tcp_chan *chan, struct batch_request *preq);
@@ -156,6 +159,7 @@ int decode_DIS_SignalJob(struct tcp_chan *chan, struct batch_request *preq);
 
 /* dec_Status.c */
 int decode_DIS_Status(struct tcp_chan *chan, struct batch_request *preq);
+int decode_DIS_StatusSnapshot(struct tcp_chan *chan, struct batch_request *preq);
 
 /* dec_Track.c */
 int decode_DIS_TrackJob(struct tcp_chan *chan, struct batch_request *preq);
@@ -219,6 +223,7 @@ int encode_DIS_ReturnFiles(struct tcp_chan *chan, struct batch_request *preq);
 
 /* enc_RunJob.c */
 int encode_DIS_RunJob(struct tcp_chan *chan, char *jobid, char *where, unsigned int resch); 
+int encode_DIS_RunJobs(struct tcp_chan *chan, int count, char **jobids, char **wheres);
 
 /* enc_Shut.c */
 int encode_DIS_ShutDown(struct tcp_chan *chan, int manner); 
@@ -228,6 +233,7 @@ int encode_DIS_SignalJob(struct tcp_chan *chan, const char *jobid, const char *s
 
 /* enc_Status.c */
 int encode_DIS_Status(struct tcp_chan *chan, char *objid, struct attrl *pattrl);
+int encode_DIS_StatusSnapshot(struct tcp_chan *chan, struct attrl *svr_attrl, struct attrl *que_attrl, struct attrl *job_attrl, struct attrl *node_attrl);
 
 /* enc_Track.c */
 int encode_DIS_TrackJob(struct tcp_chan *chan, struct batch_request *preq);
@@ -340,6 +346,8 @@ int pbs_rlsjob_err(int c, const char *jobid, const char *holdtype, char *extend,
 
 /* pbsD_runjob.c */
 int pbs_runjob_err(int c, char *jobid, char *location, char *extend, int *);
+int pbs_runjobs_err(int c, int count, char **jobids, char **locations, char *extend, int *codes, int *);
+int parse_runjobs_reply(const char *text, int count, int *codes);
 
 /* pbsD_selectj.c */
 char ** pbs_selectjob_err(int c, struct attropl *attrib, char *extend, int *);
@@ -363,6 +371,7 @@ struct batch_status *pbs_statque_err(int c, char *id, struct attrl *attrib, char
 
 /* pbsD_statsrv.c */
 struct batch_status *pbs_statserver_err(int c, struct attrl *attrib, char *extend, int *); 
+int pbs_statsnapshot_err(int c, struct attrl *svr_attrib, struct attrl *que_attrib, struct attrl *job_attrib, struct attrl *node_attrib, char *extend, struct batch_snapshot *snap, int *);
 
 /* pbsD_submit.c */
 char *pbs_submit_err(int c, struct attropl *attrib, char *script, char *destination, char *extend, int *); 
@@ -262,6 +262,9 @@ enum PBatchReqTypeEnum
 #define PBS_BATCH_FileOpt_EFlg     2
 
 #define PBS_credentialtype_none 0
+
+/* the most jobs one RunJobs request may start */
+#define PBS_RUNJOBS_MAX 10000
 const char *reqtype_to_txt(int);
 
 void initialize_connections_table();
@@ -320,6 +323,8 @@ struct batch_status *PBSD_status(int c, int function, int *, char *id, struct at
 
 struct batch_status *PBSD_status_get(int *local_errno, int c);
 
+int PBSD_snapshot_get(int *local_errno, int c, struct batch_snapshot *snap);
+
 char *PBSD_queuejob (int c, int *, const char *j, const char *d, struct attropl *a, char *ex);
 char *PBSD_queuejob2 (int c, int *, const char *j, const char *d, struct attropl *a, char *ex);
 int PBSD_QueueJob_hash(int c, char *j, char *d, job_data_container *ja, job_data_container *ra, char *ex, char **job_id, char **msg);
@@ -343,9 +348,11 @@ extern int encode_DIS_PowerState (struct tcp_chan *chan, unsigned short power_st
 extern int encode_DIS_ReqHdr (struct tcp_chan *chan, int reqt, char *user);
 extern int encode_DIS_Rescq (struct tcp_chan *chan, char **rlist, int num);
 extern int encode_DIS_RunJob (struct tcp_chan *chan, char *jid, char *where, unsigned int resch);
+extern int encode_DIS_RunJobs (struct tcp_chan *chan, int count, char **jids, char **wheres);
 extern int encode_DIS_ShutDown (struct tcp_chan *chan, int manner);
 extern int encode_DIS_SignalJob (struct tcp_chan *chan, const char *jid, const char *sig);
 extern int encode_DIS_Status (struct tcp_chan *chan, char *objid, struct attrl *);
+extern int encode_DIS_StatusSnapshot (struct tcp_chan *chan, struct attrl *, struct attrl *, struct attrl *, struct attrl *);
 extern int encode_DIS_attrl (struct tcp_chan *chan, struct attrl *);
 extern int encode_DIS_attropl (struct tcp_chan *chan, struct attropl *);
 int encode_DIS_attropl_hash(struct tcp_chan *chan, job_data_container *job_attr, job_data_container *res_attr);
@@ -122,6 +122,7 @@ class Chip
   int                     totalThreads;
   int                     availableCores;
   int                     availableThreads;
+  int                     free_cores; // cores with none of their threads in use
   int                     total_gpus;
   int                     available_gpus;
   int                     total_mics;
@@ -134,6 +134,7 @@ extern int              hostname_specified;
 extern int              MOMConfigRReconfig;
 extern char            *TNoSpoolDirList[];
 extern int              is_reporter_mom;
+extern int              MOMConfigStatusStream;
 extern int              is_login_node;
 extern int              job_exit_wait_time;
 extern char             jobstarter_exe_name[];
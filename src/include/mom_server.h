@@ -87,6 +87,11 @@
 
 #define DEFAULT_SERVER_STAT_UPDATES 45
 
+/* what the last status update did with mom_server.status_stream */
+#define STATUS_STREAM_UNUSED 0
+#define STATUS_STREAM_SENT   1
+#define STATUS_STREAM_BROKEN 2
+
 
 typedef struct mom_server
   {
@@ -102,6 +107,8 @@ typedef struct mom_server
   int                received_hello_count;
   int                received_cluster_address_count;
   char               MOMSendStatFailure[MMAX_LINE];
+  int                status_stream;         /* connection kept open for status updates, -1 if none */
+  int                status_stream_result;  /* what the last status update did with it */
   } mom_server;
 
 extern mom_server    mom_servers[];
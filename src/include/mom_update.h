@@ -81,4 +81,29 @@
 #include <vector>
 
 
+/*
+ * One node's part of a status update: the strings that go into its nd_status
+ * and, when the mom sent only what changed, how to apply them to the strings
+ * kept from its last update.
+ */
+
+struct status_block
+  {
+  std::vector<std::string> strings;
+  std::vector<std::string> removed; /* keys the mom no longer reports */
+  unsigned long            seq;     /* from status_seq= or status_delta=, 0 if neither was sent */
+  bool                     delta;
+
+  status_block() : strings(), removed(), seq(0), delta(false) {}
+
+  void clear()
+    {
+    this->strings.clear();
+    this->removed.clear();
+    this->seq = 0;
+    this->delta = false;
+    }
+  };
+
+int save_status_block(struct pbsnode *np, status_block &block);
 int process_status_info(const char *nd_name, std::vector<std::string> &status_info);
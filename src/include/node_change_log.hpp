@@ -0,0 +1,70 @@
+#ifndef NODE_CHANGE_LOG_HPP
+#define NODE_CHANGE_LOG_HPP
+
+#include <map>
+#include <string>
+#include <pthread.h>
+#include <sys/types.h>
+
+#define NODE_CHANGES              "node_changes"
+
+/* fold the log into node_status and node_note once it holds this many records */
+#define NODE_CHANGES_COMPACT_RECORDS 4096
+/* seconds to wait for more changes before writing the ones that are pending */
+#define NODE_CHANGES_DELAY           1
+
+#define NODE_CHANGE_STATE         "state"
+#define NODE_CHANGE_NOTE          "note"
+
+typedef void (*node_state_apply_func)(const char *node_name, int state);
+typedef void (*node_note_apply_func)(const char *node_name, const char *note);
+typedef int  (*node_snapshot_func)();
+
+
+
+/*
+ * An append-only log of the persistent node state bits and node notes that
+ * changed since node_status and node_note were last written in full. Each
+ * record is a line holding the complete new value for one node:
+ *
+ *   state <node name> <offline/reserve bits>
+ *   note <node name> <note text, empty if cleared>
+ *
+ * Changes are kept in memory until flush() so a burst of changes to the same
+ * node costs a single record, and a burst to many nodes a single write.
+ */
+
+class node_change_log
+  {
+  std::string                        ncl_path;
+  int                                ncl_fd;
+  off_t                              ncl_size;     /* bytes of complete records in the log */
+  int                                ncl_records;  /* records in the log */
+  bool                               ncl_flush_queued;
+  std::map<std::string, int>         ncl_states;   /* pending state changes */
+  std::map<std::string, std::string> ncl_notes;    /* pending note changes */
+  pthread_mutex_t                    ncl_mutex;
+  pthread_mutex_t                    ncl_write_mutex;
+
+  public:
+  node_change_log();
+  ~node_change_log();
+
+  int  open_log(const char *path, int existing_records);
+  void close_log();
+  bool is_open();
+  bool record_state(const char *node_name, int state);
+  bool record_note(const char *node_name, const std::string &note);
+  bool needs_flush_task();
+  int  flush();
+  bool needs_compaction();
+  int  compact(node_snapshot_func write_snapshot);
+
+  static off_t complete_length(int fd);
+  static int   replay(const char *path, node_state_apply_func apply_state,
+                    node_note_apply_func apply_note);
+  };
+
+extern node_change_log node_changes;
+
+#endif
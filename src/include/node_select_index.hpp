@@ -0,0 +1,183 @@
+#ifndef NODE_SELECT_INDEX_HPP
+#define NODE_SELECT_INDEX_HPP
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+class prop;
+class pbsnode;
+
+/* find_candidates_parallel() only splits the work once the index is this big,
+ * and gives each thread at least NODE_SELECT_MIN_PARTITION nodes */
+#define NODE_SELECT_PARALLEL_MIN_NODES 1024
+#define NODE_SELECT_MIN_PARTITION      256
+
+
+
+/*
+ * The node fields a node_index_summary is computed from. update_node_index()
+ * only recomputes the summary when one of them has changed.
+ */
+
+class node_index_inputs
+  {
+  public:
+  int          state;
+  int          power_state;
+  bool         has_subnodes;
+  int          slots_total;
+  int          slots_free;
+  int          np_to_be_used;
+  int          gpus_real;
+  int          ngpus;
+  int          ngpus_free;
+  int          ngpus_to_be_used;
+  unsigned int gpus_generation;
+  int          nmics;
+  int          nmics_free;
+  int          nmics_to_be_used;
+  unsigned int props_generation;
+
+  node_index_inputs() : state(0), power_state(0), has_subnodes(false), slots_total(0),
+                        slots_free(0), np_to_be_used(0), gpus_real(0), ngpus(0), ngpus_free(0),
+                        ngpus_to_be_used(0), gpus_generation(0), nmics(0), nmics_free(0),
+                        nmics_to_be_used(0), props_generation(0) {}
+  bool same_as(const node_index_inputs &other) const;
+  };
+
+
+
+/*
+ * What node_is_spec_acceptable() looks at for a node, as of the last time the
+ * node was unlocked.
+ */
+
+class node_index_summary
+  {
+  public:
+  bool         valid;            /* false until the node has been indexed */
+  bool         removed;          /* the node was taken out of allnodes */
+  bool         indexable;        /* false for nodes with numa or alps subnodes */
+  bool         available;        /* in a state that can take a job */
+  bool         all_slots_free;
+  int          total_slots;
+  int          free_slots;       /* free execution slots not yet promised to a job */
+  int          gpus_total;
+  int          gpus_free;        /* an upper bound: shared gpus count as free */
+  int          mics_total;
+  int          mics_free;
+  unsigned int props_generation;
+  node_index_inputs inputs;      /* what this was computed from */
+
+  node_index_summary() : valid(false), removed(false), indexable(true), available(false),
+                         all_slots_free(false), total_slots(0), free_slots(0), gpus_total(0),
+                         gpus_free(0), mics_total(0), mics_free(0), props_generation(0),
+                         inputs() {}
+  bool same_as(const node_index_summary &other) const;
+  bool is_eligible(int ppn, int gpus, int mics) const;
+  bool can_run(int ppn, int gpus, int mics, bool exclusive) const;
+  };
+
+
+
+/*
+ * One request of a job, as find_candidates_parallel() checks it.
+ */
+
+class node_index_request
+  {
+  public:
+  const std::vector<prop> *plist;
+  int                      ppn;
+  int                      gpus;
+  int                      mics;
+
+  node_index_request(const std::vector<prop> *p, int pp, int g, int m) : plist(p), ppn(pp),
+                                                                        gpus(g), mics(m) {}
+  };
+
+
+
+/*
+ * An index of the nodes select_from_all_nodes() considers, so a request only
+ * has to lock the nodes that could satisfy it. Nodes are grouped by their
+ * property set (without the node's own name, which every node has as a
+ * property), and each group keeps its available nodes bucketed by free
+ * execution slots. A request checks each distinct property set once and then
+ * only looks at the buckets with enough free slots.
+ *
+ * The index is only a filter: the candidates it returns are still checked with
+ * node_is_spec_acceptable() under the node's lock.
+ *
+ * On big clusters find_candidates_parallel() instead splits the nodes, in the
+ * order they were indexed, into partitions that threads check against all of
+ * a job's requests at once.
+ */
+
+class node_select_index
+  {
+  class indexed_node
+    {
+    public:
+    unsigned long      seq;   /* nodes are returned in the order they were indexed */
+    int                id;
+    std::string        name;
+    int                group;
+    node_index_summary summary;
+    };
+
+  class property_group
+    {
+    public:
+    std::vector<std::string>      properties; /* sorted */
+    std::set<int>                 members;
+    std::map<int, std::set<int> > by_free_slots; /* available members only */
+    };
+
+  std::map<int, indexed_node>              nsi_nodes;     /* by node id */
+  std::map<std::string, int>               nsi_names;     /* node name to node id */
+  std::vector<indexed_node *>              nsi_ordered;   /* by seq, for partitioned scans */
+  std::vector<property_group>              nsi_groups;
+  std::map<std::vector<std::string>, int>  nsi_group_ids;
+  unsigned long                            nsi_next_seq;
+  int                                      nsi_unindexable;
+  pthread_mutex_t                          nsi_mutex;
+
+  void unlink_node(int id, indexed_node &in);
+  void link_node(int id, indexed_node &in);
+  int  get_group(const std::vector<std::string> &properties);
+  bool matching_nodes(const property_group &pg, const std::vector<prop> &plist, int &only_id);
+
+  static bool seq_less(const indexed_node *a, const indexed_node *b);
+
+  class partitioned_scan;
+  static void  scan_partitions(partitioned_scan *scan);
+  static void  release_scan(partitioned_scan *scan);
+  static void *scan_partitions_task(void *vp);
+
+  public:
+  node_select_index();
+  ~node_select_index();
+
+  void update_node(int id, const char *name, const std::vector<std::string> &properties,
+                   const node_index_summary &summary);
+  void remove_node(int id);
+  bool is_usable();
+  int  size();
+  void find_candidates(const std::vector<prop> &plist, int ppn, int gpus, int mics,
+                       bool exclusive, std::map<unsigned long, std::string> &candidates);
+  void find_candidates_parallel(const std::vector<node_index_request> &reqs, bool exclusive,
+                                int threads, std::map<unsigned long, std::string> &candidates);
+  int  count_eligible(const std::vector<prop> &plist, int ppn, int gpus, int mics,
+                      const std::set<std::string> &skip);
+  };
+
+extern node_select_index node_index;
+
+void update_node_index(pbsnode *pnode);
+void remove_from_node_index(pbsnode *pnode);
+
+#endif
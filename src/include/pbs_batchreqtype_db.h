@@ -83,5 +83,7 @@ PbsBatchReqType(PBS_BATCH_DeleteReservation,    "DeleteAlpsReservation")
 PbsBatchReqType(PBS_BATCH_SelStatAttr,          "SelStatAttr")
 PbsBatchReqType(PBS_BATCH_ChangePowerState,     "ChangePowerState")
 PbsBatchReqType(PBS_BATCH_ModifyNode,           "ModifyNode")
+PbsBatchReqType(PBS_BATCH_RunJobs,              "RunJobs")
+PbsBatchReqType(PBS_BATCH_StatusSnapshot,       "StatusSnapshot")
 #endif
 #endif /* _PBS_BATCHREQTYPE_DB_H */
@@ -298,6 +298,7 @@ PbsErrClient(PBSE_CGROUP_CREATE_FAIL, (char *)"Could not create all of the cgrou
 PbsErrClient(PBSE_EOF, (char *)"This stream has already been closed. End of File.")
 PbsErrClient(PBSE_GPU_PROHIBITED_MODE, (char *)"Invalid gpu mode requested. Prohibited mode is not allowed. Check the spelling of the mode request for errors")
 PbsErrClient(PBSE_NODE_DELETED,      (char *)"Node was deleted during work")
+PbsErrClient(PBSE_STATUS_STREAM,     (char *)"Connection kept open for the mom's next status update. (Not an error)")
 /* pbs client errors ceiling (max_client_err + 1) */
 PbsErrClient(PBSE_CEILING,           (char*)0)
 #endif
@@ -402,6 +402,10 @@
 #define ATTR_tcpincomingtimeout        "tcp_incoming_timeout"
 #define ATTR_ghost_array_recovery      "ghost_array_recovery"
 #define ATTR_cgroup_per_task           "cgroup_per_task"
+#define ATTR_job_journal               "job_journal"
+#define ATTR_job_writer_threads        "job_writer_threads"
+#define ATTR_job_binary_records        "job_binary_records"
+#define ATTR_node_select_threads       "node_select_threads"
 
 /* notification email formating */
 #define ATTR_mailsubjectfmt "mail_subject_fmt"
@@ -425,8 +429,15 @@
 #define DELASYNC     "delasync"   /* see req_delete.c */
 #define PURGECOMP    "purgecomplete="   /* see req_delete.c */
 #define EXECQUEONLY  "exec_queue_only"   /* see req_stat.c */
+#define STATUS_SINCE "since="   /* see req_stat.c */
 #define RERUNFORCE   "force"
 
+/* markers in the reply to a STATUS_SINCE status request */
+
+#define ATTR_status_generation "status_generation"
+#define ATTR_status_resync     "status_resync"
+#define ATTR_status_deleted    "status_deleted"
+
 #define USER_HOLD   "u"
 #define OTHER_HOLD  "o"
 #define SYSTEM_HOLD "s"
@@ -635,6 +646,17 @@ struct batch_status
   char                *text;
   };
 
+/* the server, its queues, jobs and nodes as returned by pbs_statsnapshot() */
+
+struct batch_snapshot
+  {
+
+  struct batch_status *server;
+  struct batch_status *queues;
+  struct batch_status *jobs;
+  struct batch_status *nodes;
+  };
+
 
 
 
@@ -690,6 +712,8 @@ int pbs_rlsjob(int connect, char *job_id, char *hold_type, char *extend);
 
 int pbs_runjob(int connect, char *jobid, char *loc, char *extend);
 
+int pbs_runjobs(int connect, int count, char **jobids, char **locs, char *extend, int *codes);
+
 char **pbs_selectjob(int connect, struct attropl *select_list, char *extend);
 
 int pbs_sigjob(int connect, char *job_id, char *signal, char *extend);
@@ -708,6 +732,10 @@ struct batch_status *pbs_statserver(int connect, struct attrl *attrib, char *ext
 
 struct batch_status *pbs_statnode(int connect, char *id, struct attrl *attrib, char *extend);
 
+int pbs_statsnapshot(int connect, struct attrl *svr_attrib, struct attrl *que_attrib, struct attrl *job_attrib, struct attrl *node_attrib, char *extend, struct batch_snapshot *snap);
+
+void pbs_freesnapshot(struct batch_snapshot *snap);
+
 char *pbs_submit(int connect, struct attropl *attrib, char *script, char *destination, char *extend);
 
 int pbs_submit_hash_ext(int connect, void *job_attr, void *res_attr, char *script, char *destination, char *extend, char **job_id, char **msg);
@@ -773,6 +773,10 @@ class job
   // Usage information coming from a plug-in
   std::map<std::string, std::string> ji_plugin_usage_info;
 
+  // Encoded values and flags of attributes whose decoding was put off when
+  // the job was recovered. See defer_attr().
+  std::map<int, std::pair<std::string, unsigned int> > ji_deferred_attrs;
+
   public:
 
   /* MOM: links to polled jobs */
@@ -801,6 +805,7 @@ class job
   bool              ji_being_recycled;
   time_t            ji_last_reported_time;
   time_t            ji_mod_time;       // the timestamp of when the state last changed
+  unsigned long long ji_status_gen;    // status generation of the last change (see status_generation.hpp)
   // This is used as a bitmap to ensure that a job is only counted once as a queued job for 
   // the queue count and the server count
   unsigned          ji_queue_counted;
@@ -842,6 +847,11 @@ class job
 
   void encode_plugin_resource_usage(tlist_head *phead) const;
   void add_plugin_resource_usage(std::string &acct_data) const;
+
+  void defer_attr(int index, const char *value, unsigned int flags);
+  bool get_deferred_attr(int index, std::string &value, unsigned int &flags) const;
+  void hydrate_attr(int index);
+  void hydrate_attrs();
   };
 #endif
 
@@ -870,6 +880,7 @@ int  get_jobs_index(all_jobs *, job *);
 int  remove_job(all_jobs *, job *, bool force_lock=false);
 int  has_job(all_jobs *,job *);
 int  swap_jobs(all_jobs *,job *,job *);
+int  rerank_job(all_jobs *,job *);
 struct pbs_queue *get_jobs_queue(job **);
 
 job *next_job(all_jobs *,all_jobs_iterator *);
@@ -1165,6 +1176,7 @@ class send_job_request
 #define JOB_FILE_COPY           ".JC"    /* tmp copy while updating */
 #define JOB_FILE_SUFFIX         ".JB"    /* job control file */
 #define JOB_FILE_BACKUP         ".BK"    /* job file backup */
+#define JOB_FILE_QUICK          ".JQ"    /* job quick save record */
 #define JOB_SCRIPT_SUFFIX       ".SC"    /* job script file  */
 #define JOB_STDOUT_SUFFIX       ".OU"    /* job standard out */
 #define JOB_STDERR_SUFFIX       ".ER"    /* job standard error */
@@ -1339,6 +1351,7 @@ int lock_ji_mutex(job *pjob, const char *id, const char *msg, int logging);
 int unlock_ji_mutex(job *pjob, const char *id, const char *msg, int logging);
 #ifdef BATCH_REQUEST_H
 extern job  *chk_job_request(char *, struct batch_request *);
+extern job  *chk_job_request(char *, struct batch_request *, int &);
 extern int   net_move(job *, struct batch_request *);
 extern int   svr_chk_owner(struct batch_request *, job *);
 
@@ -99,11 +99,13 @@
 
 #include "container.hpp"
 #include "job_usage_info.hpp"
+#include "id_map.hpp"
 #include "attribute.h"
 #ifdef PENABLE_LINUX_CGROUPS
 #include "machine.hpp"
 #endif
 #include "runjob_help.hpp"
+#include "node_select_index.hpp"
 #include "attribute.h"
 
 #ifdef NUMA_SUPPORT
@@ -117,6 +119,12 @@
 #define START_MIC_STATUS       "<mic_status>"
 #define END_MIC_STATUS         "</mic_status>"
 
+/* status updates sent over a status stream are numbered so that the mom can
+ * send only the strings that changed since the last one */
+#define STATUS_SEQ             "status_seq="     /* everything, with its sequence number */
+#define STATUS_DELTA           "status_delta="   /* what changed since the previous sequence number */
+#define STATUS_REMOVED         "status_removed=" /* comma separated keys the mom no longer reports */
+
 #ifdef NUMA_SUPPORT
 #  define MAX_NODE_BOARDS      2048
 #endif  /* NUMA_SUPPORT */
@@ -213,6 +221,7 @@ typedef struct nodeboard_t
 
 
 #define SEND_HELLO 11
+#define SEND_FULL_STATUS 13 /* reply to a status delta the server couldn't apply */
 
 /* container for holding communication information */
 class received_node
@@ -230,12 +239,15 @@ private:
   std::string                          nd_name;             /* node's host name */
   int                                  nd_error;            // set if there's an error
   std::vector<std::string>             nd_properties;       // The node's properties
+  id_set                               nd_property_ids;     // nd_properties without the node's name
   int                                  nd_version;          // The node's software version
   std::map<std::string, unsigned int>  nd_plugin_generic_resources; // Plugin-supplied gres
   std::map<std::string, double>        nd_plugin_generic_metrics; // Plugin-supplied gmetrics
   std::map<std::string, std::string>   nd_plugin_varattrs; // Plugin-supplied varattrs
   std::string                          nd_plugin_features;
 
+  void index_properties();
+
 public:
   // Network failures without two consecutive successive between them.
   int                           nd_proximal_failures;
@@ -313,6 +325,12 @@ public:
                                                        doing the unlock intends to lock it again
                                                        so we need a flag here to prevent a node from being
                                                        deleted while it is temporarily locked. */
+  unsigned int                  nd_props_generation; /* bumped whenever nd_properties changes */
+  unsigned int                  nd_gpus_generation;  /* bumped whenever a gpu's state changes */
+  node_index_summary            nd_index_summary;    /* what node_index last heard about this node */
+  unsigned long long            nd_status_gen;       /* status generation of the last change (see status_generation.hpp) */
+  std::vector<std::string>      nd_status_strings;   /* what nd_status was built from, kept to apply status deltas */
+  unsigned long                 nd_status_seq;       /* sequence number of the last status update, 0 if it had none */
 
   /* numa hardware configuration information */
 #ifdef PENABLE_LINUX_CGROUPS
@@ -331,6 +349,7 @@ public:
   int         get_error() const;
   const char *get_name() const;
   bool        hasprop(std::vector<prop> *props) const;
+  const std::vector<std::string> &get_properties() const;
   void        write_compute_node_properties(FILE *nin) const;
   void        write_to_nodes_file(FILE *nin) const;
   int         copy_properties(pbsnode *dest) const;
@@ -619,6 +638,7 @@ extern int update_nodes_file(struct pbsnode *);
 
 struct pbsnode  *tfind_addr(const u_long key, uint16_t port, char *job_momname);
 struct pbsnode  *find_nodebyname(const char *);
+void             resolve_property(prop &p);
 struct pbsnode  *find_nodebyid(int);
 struct pbsnode  *find_node_in_allnodes(all_nodes *an, const char *nodename);
 int              create_partial_pbs_node(char *, unsigned long, int);
@@ -2,4 +2,8 @@
 
 extern bool cray_enabled;
 extern bool ghost_array_recovery;
+extern bool job_journal_enabled;
+extern long job_writer_threads;
+extern bool job_binary_records;
+extern long node_select_threads;
 
@@ -204,3 +204,7 @@ ATTR_ghost_array_recovery,
 ATTR_cgroup_per_task,
 ATTR_idle_slot_limit,
 ATTR_default_gpu_mode,
+ATTR_job_journal,
+ATTR_job_writer_threads,
+ATTR_job_binary_records,
+ATTR_node_select_threads,
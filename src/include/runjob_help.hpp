@@ -10,14 +10,19 @@ class alps_req_data
   alps_req_data() : node_list(), ppn(1) {}
   };
 
+#define PROP_NODE_NAME  -1 /* not a property, may still be a node's name */
+#define PROP_UNRESOLVED -2 /* not looked up in property_mapper yet */
+#define PROP_UNKNOWN    -3 /* neither a property nor a node name, matches no node */
+
 class prop
   {
   public:
   std::string name;
   short       mark;
+  int         id;   /* property_mapper id, or one of the PROP_* values above */
 
-  prop() : name(), mark(0) {}
-  prop(const std::string &n) : name(n), mark(1) {}
+  prop() : name(), mark(0), id(PROP_UNRESOLVED) {}
+  prop(const std::string &n) : name(n), mark(1), id(PROP_UNRESOLVED) {}
   };
  
 class single_spec_data
@@ -229,6 +229,10 @@ enum srv_atr
   SRV_ATR_CgroupPerTask,
   SRV_ATR_IdleSlotLimit,
   SRV_ATR_DefaultGpuMode,
+  SRV_ATR_JobJournal,
+  SRV_ATR_JobWriterThreads,
+  SRV_ATR_JobBinaryRecords,
+  SRV_ATR_NodeSelectThreads,
 
   /* This must be last */
   SRV_ATR_LAST
@@ -81,9 +81,14 @@
 
 void *start_process_pbs_server_port(void *new_sock);
 void *svr_is_request(void *args);
+void  park_status_stream(int sock, long *args);
+void *process_status_stream(void *vp);
+int   init_status_stream_poller();
+void *poll_status_streams(void *vp);
 
 typedef struct is_request_info
   {
   struct tcp_chan *chan;
   long            *args;
+  bool             keep_open; /* set if the connection is a mom's status stream */
   } is_request_info;
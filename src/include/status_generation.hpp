@@ -0,0 +1,70 @@
+#ifndef STATUS_GENERATION_HPP
+#define STATUS_GENERATION_HPP
+
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+/* the kinds of objects whose deletions are remembered */
+#define STATUS_GEN_JOB            0
+#define STATUS_GEN_NODE           1
+#define STATUS_GEN_KINDS          2
+
+/* deletions remembered per kind before the oldest are forgotten */
+#define STATUS_GEN_DELETED_MAX    65536
+
+
+
+/*
+ * A server-wide counter that is stamped on jobs (ji_status_gen) and nodes
+ * (nd_status_gen) whenever they change, plus a bounded history of the jobs
+ * and nodes that were deleted. A status request that carries "since=<N>"
+ * only reports the objects stamped after N and the objects deleted after N.
+ * Jobs that leave a queue are kept in the job history too, with the queue
+ * they left, so a delta status of that queue can report them as removed.
+ *
+ * The counter starts from the time the server started, shifted left, so the
+ * generations a client saw before a restart are older than every generation
+ * after it. Deletions from before the restart are gone, so those clients are
+ * told to resync, as are clients whose since is older than the oldest
+ * deletion that was forgotten.
+ */
+
+class status_generation
+  {
+  class removal
+    {
+    public:
+    unsigned long long gen;
+    std::string        name;
+    std::string        queue; /* set if the job only left this queue */
+    };
+
+  unsigned long long  sg_current;
+  unsigned long long  sg_complete_since[STATUS_GEN_KINDS];
+  std::deque<removal> sg_deleted[STATUS_GEN_KINDS];
+  size_t              sg_deleted_max;
+  pthread_mutex_t     sg_mutex;
+
+  void               record_removal(int kind, const char *name, const char *queue);
+
+  public:
+  status_generation();
+  status_generation(unsigned long long start, size_t deleted_max);
+  ~status_generation();
+
+  unsigned long long next();
+  unsigned long long current();
+  void               record_deleted(int kind, const char *name);
+  void               record_dequeued(const char *job_id, const char *queue);
+  bool               deleted_since(int kind, unsigned long long since,
+                                   std::vector<std::string> &names, const char *queue = NULL);
+  };
+
+extern status_generation status_gen;
+
+bool parse_status_since(const char *extend, unsigned long long &since);
+
+#endif
@@ -32,6 +32,7 @@ extern int   srv_shutdown(int);
 extern void  write_node_state(void);
 extern void  write_node_power_state(void);
 extern int  write_node_note(void);
+extern void  write_node_changes(int need_todo);
 extern int   setup_nodes(void);
 extern int   node_avail(char *spec, int  *navail,
                               int *nalloc, int *nreserved, int *ndown);
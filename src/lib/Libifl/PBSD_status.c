@@ -248,6 +248,148 @@ struct batch_status *PBSD_status_get(
 
 
 
+/*
+ * split_snapshot_status - move the entries of a status snapshot reply onto
+ * the server, queue, job and node lists of snap according to their object type.
+ *
+ * Entries keep the order the server sent them in.  The attribute lists are
+ * taken over by the new batch_status structures.
+ *
+ * @return PBSE_NONE, PBSE_SYSTEM if out of memory or PBSE_PROTOCOL on an unknown
+ * object type.  On failure snap holds whatever was split so far.
+ */
+
+int split_snapshot_status(
+
+  struct brp_cmdstat    *stp,  /* I/O - attribute lists are moved */
+  struct batch_snapshot *snap) /* O */
+
+  {
+  struct batch_status  *tails[4] = { NULL, NULL, NULL, NULL };
+  struct batch_status **heads[4];
+  struct batch_status  *bsp;
+  int                   index;
+
+  heads[0] = &snap->server;
+  heads[1] = &snap->queues;
+  heads[2] = &snap->jobs;
+  heads[3] = &snap->nodes;
+
+  for (;stp != NULL;stp = stp->brp_stlink)
+    {
+    switch (stp->brp_objtype)
+      {
+      case MGR_OBJ_SERVER:
+
+        index = 0;
+        break;
+
+      case MGR_OBJ_QUEUE:
+
+        index = 1;
+        break;
+
+      case MGR_OBJ_JOB:
+
+        index = 2;
+        break;
+
+      case MGR_OBJ_NODE:
+
+        index = 3;
+        break;
+
+      default:
+
+        return(PBSE_PROTOCOL);
+      }
+
+    if ((bsp = alloc_bs()) == NULL)
+      return(PBSE_SYSTEM);
+
+    if ((bsp->name = strdup(stp->brp_objname)) == NULL)
+      {
+      free(bsp);
+      return(PBSE_SYSTEM);
+      }
+
+    bsp->attribs = stp->brp_attrl;
+    stp->brp_attrl = NULL;
+
+    if (tails[index] == NULL)
+      *heads[index] = bsp;
+    else
+      tails[index]->next = bsp;
+
+    tails[index] = bsp;
+    }
+
+  return(PBSE_NONE);
+  }  /* END split_snapshot_status() */
+
+
+
+
+/*
+ * PBSD_snapshot_get - read the reply to a Status Snapshot request
+ *
+ * @return PBSE_NONE and the filled in snap, or the error code (also
+ * stored in local_errno) with every list of snap empty.
+ */
+
+int PBSD_snapshot_get(
+
+  int                   *local_errno, /* O */
+  int                    c,           /* I */
+  struct batch_snapshot *snap)        /* O */
+
+  {
+  struct batch_reply *reply;
+
+  memset(snap, 0, sizeof(struct batch_snapshot));
+
+  if ((c < 0) || 
+      (c >= PBS_NET_MAX_CONNECTIONS))
+    {
+    *local_errno = PBSE_IVALREQ;
+    return(*local_errno);
+    }
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+
+  *local_errno = 0;
+
+  reply = PBSD_rdrpy(local_errno, c);
+
+  if (reply == NULL)
+    {
+    if (*local_errno == 0)
+      *local_errno = PBSE_PROTOCOL;
+    }
+  else if (*local_errno == 0)
+    {
+    if (reply->brp_choice != BATCH_REPLY_CHOICE_Status)
+      *local_errno = PBSE_PROTOCOL;
+    else
+      *local_errno = split_snapshot_status(reply->brp_un.brp_statc, snap);
+    }
+
+  pthread_mutex_unlock(connection[c].ch_mutex);
+
+  PBSD_FreeReply(reply);
+
+  if (*local_errno != PBSE_NONE)
+    {
+    /* destroy partial results */
+    pbs_freesnapshot(snap);
+    }
+
+  return(*local_errno);
+  }  /* END PBSD_snapshot_get() */
+
+
+
+
 /* Allocate a batch status reply structure */
 
 static struct batch_status *
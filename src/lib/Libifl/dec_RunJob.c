@@ -91,6 +91,7 @@
 
 #include <pbs_config.h>   /* the master config generated by configure */
 
+#include <stdlib.h>
 #include <sys/types.h>
 #include "libpbs.h"
 #include "list_link.h"
@@ -101,25 +102,78 @@
 #include "dis.h"
 #include "tcp.h" /* tcp_chan */
 
+static int decode_runjob(
+
+  struct tcp_chan  *chan,
+  struct rq_runjob *prun)
+  {
+  int rc;
+
+  prun->rq_destin = 0;
+
+  rc = disrfst(chan, PBS_MAXSVRJOBID, prun->rq_jid);
+
+  if (rc) return rc;
+
+  /* This will need to be changed for nodes for FPA */
+  prun->rq_destin = disrst(chan, &rc);
+
+  if (rc) return rc;
+
+  prun->rq_resch = disrui(chan, &rc);
+
+  return rc;
+  }
+
 int decode_DIS_RunJob(
     
   struct tcp_chan *chan,
   struct batch_request *preq)
   {
-  int rc;
+  return(decode_runjob(chan, &preq->rq_ind.rq_run));
+  }
 
-  preq->rq_ind.rq_run.rq_destin = 0;
+/*
+ * decode_DIS_RunJobs() - decode a Run Jobs batch request
+ *
+ * Data items are: unsigned int count
+ *   followed by count Run Job requests, as decoded above
+ *
+ * rq_jobs is allocated here and freed by free_br(), even when decoding fails
+ * part way.
+ */
 
-  rc = disrfst(chan, PBS_MAXSVRJOBID, preq->rq_ind.rq_run.rq_jid);
+int decode_DIS_RunJobs(
 
-  if (rc) return rc;
+  struct tcp_chan *chan,
+  struct batch_request *preq)
+  {
+  int          rc;
+  unsigned int count;
 
-  /* This will need to be changed for nodes for FPA */
-  preq->rq_ind.rq_run.rq_destin = disrst(chan, &rc);
+  preq->rq_ind.rq_runjobs.rq_count = 0;
+  preq->rq_ind.rq_runjobs.rq_jobs = NULL;
+
+  count = disrui(chan, &rc);
 
   if (rc) return rc;
 
-  preq->rq_ind.rq_run.rq_resch = disrui(chan, &rc);
+  if ((count == 0) ||
+      (count > PBS_RUNJOBS_MAX))
+    return(DIS_PROTO);
+
+  preq->rq_ind.rq_runjobs.rq_jobs = (struct rq_runjob *)calloc(count, sizeof(struct rq_runjob));
+
+  if (preq->rq_ind.rq_runjobs.rq_jobs == NULL)
+    return(DIS_NOMALLOC);
+
+  preq->rq_ind.rq_runjobs.rq_count = count;
+
+  for (unsigned int i = 0; i < count; i++)
+    {
+    if ((rc = decode_runjob(chan, &preq->rq_ind.rq_runjobs.rq_jobs[i])) != 0)
+      return rc;
+    }
 
   return rc;
   }
@@ -121,3 +121,30 @@ int decode_DIS_Status(
   }
 
 
+
+/*
+ * decode_DIS_StatusSnapshot() - decode a Status Snapshot batch request
+ *
+ * Data items are: list of svrattrl for the server, queues, jobs and nodes,
+ * in that order (see SNAPSHOT_SERVER ... SNAPSHOT_NODE)
+ */
+
+int decode_DIS_StatusSnapshot(
+
+  struct tcp_chan      *chan,
+  struct batch_request *preq)
+
+  {
+  int rc = 0;
+  int i;
+
+  for (i = 0; i < SNAPSHOT_OBJ_COUNT; i++)
+    CLEAR_HEAD(preq->rq_ind.rq_snapshot.rq_attr[i]);
+
+  for (i = 0; (i < SNAPSHOT_OBJ_COUNT) && (rc == 0); i++)
+    rc = decode_DIS_svrattrl(chan, &preq->rq_ind.rq_snapshot.rq_attr[i]);
+
+  return rc;
+  }
+
+
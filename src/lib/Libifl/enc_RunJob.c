@@ -108,3 +108,31 @@ int encode_DIS_RunJob(
   return 0;
   }
 
+/*
+ * encode_DIS_RunJobs() - encode a Run Jobs Batch Request
+ *
+ * Data items are: unsigned int count
+ *   followed by count Run Job requests, as encoded above
+ */
+
+int encode_DIS_RunJobs(
+
+  struct tcp_chan *chan,
+  int           count,
+  char        **jids,
+  char        **wheres)
+  {
+  int   rc;
+
+  if ((rc = diswui(chan, count)) != 0)
+    return rc;
+
+  for (int i = 0; i < count; i++)
+    {
+    if ((rc = encode_DIS_RunJob(chan, jids[i], (wheres[i] != NULL) ? wheres[i] : (char *)"", 0)) != 0)
+      return rc;
+    }
+
+  return 0;
+  }
+
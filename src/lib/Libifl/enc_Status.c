@@ -111,6 +111,42 @@ int encode_DIS_Status(
   }  /* END encode_DIS_Status() */
 
 
+
+
+/*
+ * encode_DIS_StatusSnapshot() - encode a Status Snapshot Batch Request
+ *
+ * Data items are: list of  attrl  server attributes
+ *   list of  attrl  queue attributes
+ *   list of  attrl  job attributes
+ *   list of  attrl  node attributes
+ *
+ * An empty list asks for every attribute of that object type.
+ */
+
+int encode_DIS_StatusSnapshot(
+
+  struct tcp_chan *chan,
+  struct attrl    *svr_attrl,
+  struct attrl    *que_attrl,
+  struct attrl    *job_attrl,
+  struct attrl    *node_attrl)
+
+  {
+  int rc;
+
+  if ((rc = encode_DIS_attrl(chan, svr_attrl)) ||
+      (rc = encode_DIS_attrl(chan, que_attrl)) ||
+      (rc = encode_DIS_attrl(chan, job_attrl)) ||
+      (rc = encode_DIS_attrl(chan, node_attrl)))
+    {
+    return(rc);
+    }
+
+  return(0);
+  }  /* END encode_DIS_StatusSnapshot() */
+
+
 /* END enc_Status.c */
 
 
@@ -84,6 +84,7 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include "libpbs.h"
 #include "dis.h"
 #include "tcp.h" /* tcp_chan */
@@ -234,5 +235,192 @@ int pbs_runjob(
 
 
 
+/*
+ * parse_runjobs_reply()
+ *
+ * Reads the result of each job from the reply to a RunJobs request. The
+ * server answers with one "<jobid> <code>" line per job, in the order the
+ * jobs were sent.
+ *
+ * @param text - the reply text
+ * @param count - the number of jobs in the request
+ * @param codes - set to the result of each job
+ * @return PBSE_NONE, or PBSE_PROTOCOL if the reply doesn't have a result for
+ *         every job
+ */
+
+int parse_runjobs_reply(
+
+  const char *text,
+  int         count,
+  int        *codes)
+
+  {
+  const char *line = text;
+  const char *code;
+  char       *end;
+
+  for (int i = 0; i < count; i++)
+    {
+    if ((line == NULL) ||
+        ((code = strchr(line, ' ')) == NULL))
+      return(PBSE_PROTOCOL);
+
+    codes[i] = strtol(code + 1, &end, 10);
+
+    if ((end == code + 1) ||
+        ((*end != '\n') &&
+         (*end != '\0')))
+      return(PBSE_PROTOCOL);
+
+    line = (*end == '\n') ? end + 1 : NULL;
+    }
+
+  return(PBSE_NONE);
+  } /* END parse_runjobs_reply() */
+
+
+
+/*
+ * pbs_runjobs_err()
+ *
+ * Starts several jobs with one request. The server starts them concurrently
+ * and replies once, with a result for each job.
+ *
+ * @param c - the connection to the server
+ * @param count - the number of jobs
+ * @param jobids - the jobs to start
+ * @param locations - the hostlist for each job, or NULL to let the server
+ *                    pick. Entries may also be NULL.
+ * @param codes - set to the result of starting each job, PBSE_NONE if it was
+ *                started
+ * @param rc - set to the result of the request itself
+ * @return the result of the request itself
+ */
+
+int pbs_runjobs_err(
+
+  int    c,
+  int    count,
+  char **jobids,
+  char **locations,
+  char  *extend,
+  int   *codes,
+  int   *rc)
+
+  {
+  struct batch_reply   *reply;
+  int                   sock;
+  struct tcp_chan      *chan = NULL;
+  char                **wheres = locations;
+
+  if ((jobids == NULL) ||
+      (codes == NULL) ||
+      (count <= 0) ||
+      (count > PBS_RUNJOBS_MAX))
+    {
+    *rc = PBSE_IVALREQ;
+    return (*rc) * -1;
+    }
 
+  if ((c < 0) || 
+      (c >= PBS_NET_MAX_CONNECTIONS))
+    {
+    return(PBSE_IVALREQ * -1);
+    }
+
+  if (locations == NULL)
+    {
+    if ((wheres = (char **)calloc(count, sizeof(char *))) == NULL)
+      {
+      *rc = PBSE_SYSTEM;
+      return(*rc);
+      }
+    }
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+
+  sock = connection[c].ch_socket;
+
+  /* setup DIS support routines for following DIS calls */
+
+  if ((chan = DIS_tcp_setup(sock)) == NULL)
+    {
+    pthread_mutex_unlock(connection[c].ch_mutex);
+
+    if (wheres != locations)
+      free(wheres);
+
+    *rc = PBSE_PROTOCOL;
+    return(*rc);
+    }
+  /* send the run requests */
+  else if ((*rc = encode_DIS_ReqHdr(chan, PBS_BATCH_RunJobs, pbs_current_user)) ||
+           (*rc = encode_DIS_RunJobs(chan, count, jobids, wheres)) ||
+           (*rc = encode_DIS_ReqExtend(chan, extend)))
+    {
+    connection[c].ch_errtxt = strdup(dis_emsg[*rc]);
+
+    pthread_mutex_unlock(connection[c].ch_mutex);
+
+    DIS_tcp_cleanup(chan);
+
+    if (wheres != locations)
+      free(wheres);
+
+    return(PBSE_PROTOCOL);
+    }
+
+  if (wheres != locations)
+    free(wheres);
+
+  if ((*rc = DIS_tcp_wflush(chan)) != PBSE_NONE)
+    {
+    pthread_mutex_unlock(connection[c].ch_mutex);
+    
+    DIS_tcp_cleanup(chan);
+
+    return(PBSE_PROTOCOL);
+    }
+
+  /* get reply */
+
+  reply = PBSD_rdrpy(rc, c);
+
+  if ((*rc == PBSE_NONE) &&
+      (reply != NULL))
+    {
+    if ((reply->brp_choice != BATCH_REPLY_CHOICE_Text) ||
+        (reply->brp_un.brp_txt.brp_str == NULL))
+      *rc = PBSE_PROTOCOL;
+    else
+      *rc = parse_runjobs_reply(reply->brp_un.brp_txt.brp_str, count, codes);
+    }
+
+  pthread_mutex_unlock(connection[c].ch_mutex);
+
+  PBSD_FreeReply(reply);
+    
+  DIS_tcp_cleanup(chan);
+
+  return(*rc);
+  }  /* END pbs_runjobs_err() */
+
+
+
+
+
+int pbs_runjobs(
+
+  int    c,
+  int    count,
+  char **jobids,
+  char **locations,
+  char  *extend,
+  int   *codes)
+
+  {
+  pbs_errno = 0;
 
+  return(pbs_runjobs_err(c, count, jobids, locations, extend, codes, &pbs_errno));
+  } /* END pbs_runjobs() */
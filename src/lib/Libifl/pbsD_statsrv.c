@@ -83,7 +83,11 @@
 
 #include <pbs_config.h>   /* the master config generated by configure */
 
+#include <string.h>
 #include "libpbs.h"
+#include "dis.h"
+#include "tcp.h" /* tcp_chan */
+#include "server_limits.h"
 
 struct batch_status *pbs_statserver_err(
 
@@ -115,5 +119,135 @@ struct batch_status *pbs_statserver(
 
 
 
+/*
+ * pbs_statsnapshot_err - status the server, all of its queues, jobs and nodes
+ * in a single request.
+ *
+ * Each attribute list selects what is reported for that object type, a NULL
+ * list reports everything.  Release the result with pbs_freesnapshot().
+ *
+ * @return PBSE_NONE or the error code, also stored in local_errno.  Servers
+ * that predate the request answer PBSE_UNKREQ.
+ */
+
+int pbs_statsnapshot_err(
+
+  int                    c,
+  struct attrl          *svr_attrib,
+  struct attrl          *que_attrib,
+  struct attrl          *job_attrib,
+  struct attrl          *node_attrib,
+  char                  *extend,
+  struct batch_snapshot *snap,
+  int                   *local_errno)
+
+  {
+  int              sock;
+  struct tcp_chan *chan = NULL;
+
+  if (snap == NULL)
+    {
+    *local_errno = PBSE_IVALREQ;
+    return(*local_errno);
+    }
+
+  memset(snap, 0, sizeof(struct batch_snapshot));
+
+  if ((c < 0) || 
+      (c >= PBS_NET_MAX_CONNECTIONS))
+    {
+    *local_errno = PBSE_IVALREQ;
+    return(*local_errno);
+    }
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+
+  sock = connection[c].ch_socket;
+
+  if ((chan = DIS_tcp_setup(sock)) == NULL)
+    {
+    pthread_mutex_unlock(connection[c].ch_mutex);
+
+    *local_errno = PBSE_MEM_MALLOC;
+    return(*local_errno);
+    }
+  else if ((*local_errno = encode_DIS_ReqHdr(chan, PBS_BATCH_StatusSnapshot, pbs_current_user)) ||
+           (*local_errno = encode_DIS_StatusSnapshot(chan, svr_attrib, que_attrib, job_attrib, node_attrib)) ||
+           (*local_errno = encode_DIS_ReqExtend(chan, extend)))
+    {
+    connection[c].ch_errtxt = strdup(dis_emsg[*local_errno]);
+
+    pthread_mutex_unlock(connection[c].ch_mutex);
+
+    DIS_tcp_cleanup(chan);
+
+    *local_errno = PBSE_PROTOCOL;
+    return(*local_errno);
+    }
+
+  if (DIS_tcp_wflush(chan))
+    {
+    pthread_mutex_unlock(connection[c].ch_mutex);
+
+    DIS_tcp_cleanup(chan);
+
+    *local_errno = PBSE_PROTOCOL;
+    return(*local_errno);
+    }
+
+  pthread_mutex_unlock(connection[c].ch_mutex);
+
+  DIS_tcp_cleanup(chan);
+
+  /* get the status reply */
+
+  return(PBSD_snapshot_get(local_errno, c, snap));
+  } /* END pbs_statsnapshot_err() */
+
+
+
+
+int pbs_statsnapshot(
+
+  int                    c,
+  struct attrl          *svr_attrib,
+  struct attrl          *que_attrib,
+  struct attrl          *job_attrib,
+  struct attrl          *node_attrib,
+  char                  *extend,
+  struct batch_snapshot *snap)
+
+  {
+  pbs_errno = 0;
+
+  return(pbs_statsnapshot_err(c, svr_attrib, que_attrib, job_attrib, node_attrib, extend, snap, &pbs_errno));
+  } /* END pbs_statsnapshot() */
+
+
+
+
+/*
+ * pbs_freesnapshot - free the lists held by a snapshot and empty it
+ */
+
+void pbs_freesnapshot(
+
+  struct batch_snapshot *snap)
+
+  {
+  if (snap == NULL)
+    return;
+
+  pbs_statfree(snap->server);
+  pbs_statfree(snap->queues);
+  pbs_statfree(snap->jobs);
+  pbs_statfree(snap->nodes);
+
+  memset(snap, 0, sizeof(struct batch_snapshot));
+  } /* END pbs_freesnapshot() */
+
+
+
+
 /* END pbsD_statsrv.c */
 
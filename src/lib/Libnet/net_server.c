@@ -91,6 +91,7 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <time.h>
+#include <limits.h>
 
 #include <sys/types.h>
 #include <sys/stat.h>  /* added - CRI 9/05 */
@@ -108,6 +109,9 @@
 #if defined(NTOHL_NEEDS_ARPA_INET_H) && defined(HAVE_ARPA_INET_H)
 #include <arpa/inet.h>
 #endif
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 #include <pthread.h>
 
 
@@ -158,6 +162,23 @@ static u_long   *GlobalSocketAddrSet = NULL;
 static u_long   *GlobalSocketPortSet = NULL;
 pthread_mutex_t *global_sock_read_mutex = NULL;
 
+#ifdef HAVE_SYS_EPOLL_H
+/*
+ * wait_request() watches the global read set with epoll when it can, so a
+ * wakeup costs the number of ready sockets instead of the highest descriptor.
+ * The epoll set is created the first time wait_request() is called and kept
+ * in step with GlobalSocketReadSet, which is still kept for the select()
+ * fallback.  GlobalEpollPid is checked because a forked child shares the
+ * epoll set with its parent and must not take the parent's sockets out of it.
+ */
+
+#define PBS_NET_EPOLL_EVENTS 256
+
+static int       GlobalEpollFd = -1;
+static pid_t     GlobalEpollPid = 0;
+static int       GlobalEpollFailed = FALSE;
+#endif /* HAVE_SYS_EPOLL_H */
+
 void *(*read_func[2])(void *);
 
 pthread_mutex_t *nc_list_mutex  = NULL;
@@ -646,21 +667,280 @@ int check_network_port(
 
 
 /*
- * wait_request - wait for a request (socket with data to read)
- * This routine does a select on the readset of sockets,
- * when data is ready, the processing routine associated with
- * the socket is invoked.
+ * dispatch_ready_socket()
+ *
+ * calls the processing routine of a socket wait_request() found ready to
+ * read, or closes the socket if its connection has already gone idle
+ *
+ * @param sock - the ready socket
+ * @param addr - the address recorded for the socket in the global read set
+ * @param port - the port recorded for the socket in the global read set
  */
 
-int wait_request(
+static void dispatch_ready_socket(
 
-  time_t  waittime,   /* I (seconds) */
-  long   *SState)     /* I (optional) */
+  int    sock,
+  u_long addr,
+  u_long port)
+
+  {
+  char tmpLine[1024];
+
+  if ((sock < 0) ||
+      (sock >= max_connection))
+    return;
+
+  pthread_mutex_lock(svr_conn[sock].cn_mutex);
+
+  svr_conn[sock].cn_lasttime = time(NULL);
+
+  if (svr_conn[sock].cn_active != Idle)
+    {
+    void *(*func)(void *) = svr_conn[sock].cn_func;
+
+    netcounter_incr();
+
+    pthread_mutex_unlock(svr_conn[sock].cn_mutex);
+
+    if (func != NULL)
+      {
+      int args[3];
+
+      args[0] = sock;
+      args[1] = (int)addr;
+      args[2] = (int)port;
+      func((void *)args);
+      }
+    }
+  else
+    {
+    pthread_mutex_unlock(svr_conn[sock].cn_mutex);
+
+    globalset_del_sock(sock);
+    close_conn(sock, FALSE);
+
+    pthread_mutex_lock(num_connections_mutex);
+
+    sprintf(tmpLine, "closed connections to fd %d - num_connections=%d (select bad socket)",
+      sock,
+      num_connections);
+
+    pthread_mutex_unlock(num_connections_mutex);
+    log_err(-1, __func__, tmpLine);
+    }
+  } /* END dispatch_ready_socket() */
+
+
+
+
+#ifdef HAVE_SYS_EPOLL_H
+/*
+ * epoll_add_sock()
+ *
+ * adds a socket to the epoll set. If epoll can't watch the descriptor the
+ * epoll set is dropped for good and wait_request() goes back to select(),
+ * which still has every descriptor in GlobalSocketReadSet.
+ *
+ * NOTE: called with global_sock_read_mutex held
+ *
+ * @param sock - the socket to watch
+ * @return PBSE_NONE if the socket is watched, -1 if epoll was dropped
+ */
+
+static int epoll_add_sock(
+
+  int sock)
+
+  {
+  struct epoll_event ev;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.fd = sock;
+
+  if ((epoll_ctl(GlobalEpollFd, EPOLL_CTL_ADD, sock, &ev) == 0) ||
+      ((errno == EEXIST) &&
+       (epoll_ctl(GlobalEpollFd, EPOLL_CTL_MOD, sock, &ev) == 0)))
+    return(PBSE_NONE);
+
+  log_err(errno, __func__, "Unable to add socket to the epoll set, falling back to select()");
+
+  close(GlobalEpollFd);
+  GlobalEpollFd = -1;
+  GlobalEpollFailed = TRUE;
+
+  return(-1);
+  } /* END epoll_add_sock() */
+
+
+
+
+/*
+ * epoll_owned()
+ *
+ * @return TRUE if this process created the epoll set and may change it
+ *
+ * NOTE: called with global_sock_read_mutex held
+ */
+
+static int epoll_owned(void)
+
+  {
+  return((GlobalEpollFd != -1) && (GlobalEpollPid == getpid()));
+  } /* END epoll_owned() */
+
+
+
+
+/*
+ * init_epoll_set()
+ *
+ * creates the epoll set the first time wait_request() needs it and adds
+ * every socket already in the global read set
+ *
+ * NOTE: called with global_sock_read_mutex held
+ *
+ * @return the epoll descriptor, or -1 if wait_request() should use select()
+ */
+
+static int init_epoll_set(void)
+
+  {
+  int MaxNumDescriptors;
+  int i;
+
+  if (GlobalEpollFd != -1)
+    {
+    if (GlobalEpollPid == getpid())
+      return(GlobalEpollFd);
+
+    /* inherited from the parent, leave its set alone and build our own */
+    close(GlobalEpollFd);
+    GlobalEpollFd = -1;
+    }
+
+  if (GlobalEpollFailed == TRUE)
+    return(-1);
+
+  if ((GlobalEpollFd = epoll_create1(EPOLL_CLOEXEC)) == -1)
+    {
+    log_err(errno, __func__, "Unable to create the epoll set, falling back to select()");
+    GlobalEpollFailed = TRUE;
+
+    return(-1);
+    }
+
+  GlobalEpollPid = getpid();
+
+  MaxNumDescriptors = get_max_num_descriptors();
+
+  for (i = 0; i < MaxNumDescriptors; i++)
+    {
+    if ((FD_ISSET(i, GlobalSocketReadSet)) &&
+        (epoll_add_sock(i) != PBSE_NONE))
+      return(-1);
+    }
+
+  return(GlobalEpollFd);
+  } /* END init_epoll_set() */
+
+
+
+
+/*
+ * wait_request_epoll()
+ *
+ * waits on the epoll set and dispatches each ready socket
+ *
+ * @param epoll_fd - the epoll set from init_epoll_set()
+ * @param waittime - how many seconds to wait for a socket to be ready
+ * @param SState - the daemon state, dispatching stops if it changes
+ * @param OrigState - the daemon state before waiting
+ * @return PBSE_NONE, or -1 if the wait failed
+ */
+
+static int wait_request_epoll(
+
+  int      epoll_fd,
+  time_t   waittime,
+  long    *SState,
+  long     OrigState)
+
+  {
+  struct epoll_event events[PBS_NET_EPOLL_EVENTS];
+  u_long             addrs[PBS_NET_EPOLL_EVENTS];
+  u_long             ports[PBS_NET_EPOLL_EVENTS];
+  int                timeout_ms;
+  int                n;
+  int                i;
+
+  if (waittime > INT_MAX / 1000)
+    timeout_ms = INT_MAX;
+  else
+    timeout_ms = (int)waittime * 1000;
+
+  n = epoll_wait(epoll_fd, events, PBS_NET_EPOLL_EVENTS, timeout_ms);
+
+  if (n == -1)
+    {
+    if (errno == EINTR)
+      return(PBSE_NONE); /* interrupted, cycle around */
+
+    /* closed descriptors leave the epoll set by themselves, nothing to clean */
+    log_err(errno, __func__, "Unable to wait for sockets to read requests");
+
+    return(-1);
+    }
+
+  /* only the ready sockets' addresses are needed, not the whole table */
+  pthread_mutex_lock(global_sock_read_mutex);
+
+  for (i = 0; i < n; i++)
+    {
+    addrs[i] = GlobalSocketAddrSet[events[i].data.fd];
+    ports[i] = GlobalSocketPortSet[events[i].data.fd];
+    }
+
+  pthread_mutex_unlock(global_sock_read_mutex);
+
+  for (i = 0; i < n; i++)
+    {
+    dispatch_ready_socket(events[i].data.fd, addrs[i], ports[i]);
+
+    /* NOTE:  breakout if state changed (probably received shutdown request) */
+
+    if ((SState != NULL) && 
+        (OrigState != *SState))
+      break;
+    }
+
+  return(PBSE_NONE);
+  } /* END wait_request_epoll() */
+#endif /* HAVE_SYS_EPOLL_H */
+
+
+
+
+/*
+ * wait_request_select()
+ *
+ * selects on a copy of the global read set and dispatches each ready socket
+ *
+ * @param waittime - how many seconds to wait for a socket to be ready
+ * @param SState - the daemon state, dispatching stops if it changes
+ * @param OrigState - the daemon state before waiting
+ * @return PBSE_NONE, or -1 if the select failed
+ */
+
+static int wait_request_select(
+
+  time_t   waittime,
+  long    *SState,
+  long     OrigState)
 
   {
   int             i;
   int             n;
-  time_t          now;
 
   fd_set          *SelectSet = NULL;
   int             SelectSetSize = 0;
@@ -669,13 +949,7 @@ int wait_request(
   u_long   		  *SocketAddrSet = NULL;
   u_long          *SocketPortSet = NULL;
 
-
-  char            tmpLine[1024];
   struct timeval  timeout;
-  long            OrigState = 0;
-
-  if (SState != NULL)
-    OrigState = *SState;
 
   timeout.tv_usec = 0;
   timeout.tv_sec  = waittime;
@@ -754,58 +1028,69 @@ int wait_request(
     {
     if (FD_ISSET(i, SelectSet))
       {
-      pthread_mutex_lock(svr_conn[i].cn_mutex);
       /* this socket has data */
       n--;
 
-      svr_conn[i].cn_lasttime = time(NULL);
+      dispatch_ready_socket(i, SocketAddrSet[i], SocketPortSet[i]);
 
-      if (svr_conn[i].cn_active != Idle)
-        {
-        void *(*func)(void *) = svr_conn[i].cn_func;
+      /* NOTE:  breakout if state changed (probably received shutdown request) */
 
-        netcounter_incr();
+      if ((SState != NULL) && 
+          (OrigState != *SState))
+        break;
+      }
+    } /* END for i */
 
-        pthread_mutex_unlock(svr_conn[i].cn_mutex);
+  free(SelectSet);
+  free(SocketAddrSet);
+  free(SocketPortSet);
 
-        if (func != NULL)
-          {
-          int args[3];
+  return(PBSE_NONE);
+  } /* END wait_request_select() */
 
-          args[0] = i;
-          args[1] = (int)SocketAddrSet[i];
-          args[2] = (int)SocketPortSet[i];
-          func((void *)args);
-          }
 
-        /* NOTE:  breakout if state changed (probably received shutdown request) */
 
-        if ((SState != NULL) && 
-            (OrigState != *SState))
-          break;
-        }
-      else
-        {
-        pthread_mutex_unlock(svr_conn[i].cn_mutex);
 
-        globalset_del_sock(i);
-        close_conn(i, FALSE);
+/*
+ * wait_request - wait for a request (socket with data to read)
+ * This routine waits on the readset of sockets with epoll, or with select
+ * where epoll isn't available, and when data is ready, the processing
+ * routine associated with the socket is invoked.
+ */
 
-        pthread_mutex_lock(num_connections_mutex);
+int wait_request(
 
-        sprintf(tmpLine, "closed connections to fd %d - num_connections=%d (select bad socket)",
-          i,
-          num_connections);
+  time_t  waittime,   /* I (seconds) */
+  long   *SState)     /* I (optional) */
 
-        pthread_mutex_unlock(num_connections_mutex);
-        log_err(-1, __func__, tmpLine);
-        }
-      }
-    } /* END for i */
+  {
+  int             i;
+  int             rc;
+  time_t          now;
+  static time_t   last_idle_check = 0;
 
-  free(SelectSet);
-  free(SocketAddrSet);
-  free(SocketPortSet);
+  char            tmpLine[1024];
+  long            OrigState = 0;
+#ifdef HAVE_SYS_EPOLL_H
+  int             epoll_fd;
+#endif
+
+  if (SState != NULL)
+    OrigState = *SState;
+
+#ifdef HAVE_SYS_EPOLL_H
+  pthread_mutex_lock(global_sock_read_mutex);
+  epoll_fd = init_epoll_set();
+  pthread_mutex_unlock(global_sock_read_mutex);
+
+  if (epoll_fd != -1)
+    rc = wait_request_epoll(epoll_fd, waittime, SState, OrigState);
+  else
+#endif
+    rc = wait_request_select(waittime, SState, OrigState);
+
+  if (rc != PBSE_NONE)
+    return(rc);
 
   /* NOTE:  break out if shutdown request received */
 
@@ -816,6 +1101,13 @@ int wait_request(
 
   now = time((time_t *)0);
 
+  /* idle times are in seconds, once a second is often enough to look */
+
+  if (now == last_idle_check)
+    return(PBSE_NONE);
+
+  last_idle_check = now;
+
   for (i = 0;i < max_connection;i++)
     {
     struct connection *cp;
@@ -965,6 +1257,10 @@ void globalset_add_sock(
   FD_SET(sock, GlobalSocketReadSet);
   GlobalSocketAddrSet[sock] = addr;
   GlobalSocketPortSet[sock] = port;
+#ifdef HAVE_SYS_EPOLL_H
+  if (epoll_owned() == TRUE)
+    epoll_add_sock(sock);
+#endif
   pthread_mutex_unlock(global_sock_read_mutex);
   } /* END globalset_add_sock() */
 
@@ -980,6 +1276,11 @@ void globalset_del_sock(
   FD_CLR(sock, GlobalSocketReadSet);
   GlobalSocketAddrSet[sock] = 0;
   GlobalSocketPortSet[sock] = 0;
+#ifdef HAVE_SYS_EPOLL_H
+  /* fails harmlessly if the socket was never added or already closed */
+  if (epoll_owned() == TRUE)
+    epoll_ctl(GlobalEpollFd, EPOLL_CTL_DEL, sock, NULL);
+#endif
   pthread_mutex_unlock(global_sock_read_mutex);
   } /* END globalset_del_sock() */
 
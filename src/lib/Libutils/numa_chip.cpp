@@ -30,7 +30,7 @@ using namespace std;
 
 
 Chip::Chip() : id(0), totalCores(0), totalThreads(0), availableCores(0), availableThreads(0),
-               total_gpus(0), available_gpus(0), total_mics(0), available_mics(0),
+               free_cores(0), total_gpus(0), available_gpus(0), total_mics(0), available_mics(0),
                chip_exclusive(false), memory(0), available_memory(0), cores(), devices(),
                allocations()
 
@@ -43,7 +43,8 @@ Chip::Chip(
     
   const Chip &other) : id(other.id), totalCores(other.totalCores), totalThreads(other.totalThreads),
                        availableCores(other.availableCores), availableThreads(other.availableThreads),
-                       total_gpus(other.total_gpus), available_gpus(other.available_gpus),
+                       free_cores(other.free_cores), total_gpus(other.total_gpus),
+                       available_gpus(other.available_gpus),
                        total_mics(other.total_mics), available_mics(other.available_mics),
                        chip_exclusive(other.chip_exclusive), memory(other.memory),
                        available_memory(other.available_memory), cores(other.cores),
@@ -66,6 +67,7 @@ Chip &Chip::operator =(
   this->totalThreads = other.totalThreads;
   this->availableCores = other.availableCores;
   this->availableThreads = other.availableThreads;
+  this->free_cores = other.free_cores;
   this->total_gpus = other.total_gpus;
   this->available_gpus = other.available_gpus;
   this->total_mics = other.total_mics;
@@ -89,7 +91,7 @@ Chip::Chip(
 
   int  execution_slots,
   int &es_remainder,
-  int &per_numa_remainder) : id(0),total_gpus(0), available_gpus(0), total_mics(0), available_mics(0), 
+  int &per_numa_remainder) : id(0), free_cores(0), total_gpus(0), available_gpus(0), total_mics(0), available_mics(0), 
                              chip_exclusive(false), memory(0), available_memory(0), cores(), devices(),
                              allocations()
 
@@ -118,6 +120,8 @@ Chip::Chip(
 
     this->cores.push_back(c);
     }
+
+  this->free_cores = this->cores.size();
   } // END constructor for Cray
 
 
@@ -192,6 +196,7 @@ void Chip::initialize_cores_from_strings(
   this->totalCores = this->cores.size();
   this->availableCores = this->totalCores;
   this->availableThreads = this->totalThreads;
+  this->free_cores = this->cores.size();
   } // END initialize_cores_from_strings()
 
 
@@ -303,8 +308,13 @@ void Chip::reserve_allocation_resources(
     {
     for (unsigned int c = 0; c < this->cores.size(); c++)
       {
+      bool was_free = this->cores[c].is_free();
+
       if (this->cores[c].reserve_processing_unit(a.cpu_indices[j]) == true)
         {
+        if (was_free == true)
+          this->free_cores--;
+
         if (a.cores_only == true)
           {
           this->availableCores--;
@@ -445,7 +455,7 @@ Chip::Chip(
    
   const Json::Value &layout,
   std::vector<std::string> &valid_ids) : id(0), totalCores(0), totalThreads(0), availableCores(0),
-                                         availableThreads(0), total_gpus(0), available_gpus(0),
+                                         availableThreads(0), free_cores(0), total_gpus(0), available_gpus(0),
                                          total_mics(0), available_mics(0), chip_exclusive(false),
                                          memory(0), available_memory(0), cores(), devices(),
                                          allocations()
@@ -514,6 +524,7 @@ int Chip::initializeNonNUMAChip(hwloc_obj_t socket_obj, hwloc_topology_t topolog
   this->totalCores = this->cores.size();
   this->availableCores = this->totalCores;
   this->availableThreads = this->totalThreads;
+  this->free_cores = this->cores.size();
   this->chip_cpuset = hwloc_topology_get_allowed_cpuset(topology);
   this->chip_nodeset = hwloc_topology_get_allowed_nodeset(topology);
   hwloc_bitmap_list_snprintf(chip_cpuset_string, MAX_CPUSET_SIZE, this->chip_cpuset);
@@ -559,6 +570,8 @@ int Chip::initializeChip(hwloc_obj_t chip_obj, hwloc_topology_t topology)
     prev = core_obj;
     }
 
+  this->free_cores = this->cores.size();
+
   this->initializePCIDevices(chip_obj, topology);
 
   return(PBSE_NONE);
@@ -853,6 +866,7 @@ void Chip::make_core(
   c.is_index_busy.push_back(false);
   c.processing_units_open = 2;
   this->cores.push_back(c);
+  this->free_cores++;
   }
 
 
@@ -901,18 +915,15 @@ void Chip::aggregate_allocation(
 /*
  * free_core_count()
  *
- * Returns the number of cores that are completely free on this numa node
+ * Returns the number of cores that are completely free on this numa node.
+ * Placement asks this for every chip for every task, so the count is kept
+ * up to date as cores are reserved and freed instead of counted here.
  *
  */
 int Chip::free_core_count() const
 
   {
-  int free_count = 0;
-  for (size_t i = 0; i < this->cores.size(); i++)
-    if (this->cores[i].is_free())
-      free_count++;
-
-  return(free_count);
+  return(this->free_cores);
   } // END free_core_count()
 
 
@@ -1422,6 +1433,7 @@ bool Chip::reserve_chip_core(
     while ( this->cores[core_index].get_open_processing_unit() != -1 )
       continue;
 
+    this->free_cores--;
     this->availableCores--;
     this->availableThreads -= this->cores[core_index].totalThreads;
     a.cpu_place_indices.push_back(os_index);
@@ -1456,6 +1468,7 @@ bool Chip::reserve_core(
     while ( this->cores[core_index].get_open_processing_unit() != -1 )
       continue;
 
+    this->free_cores--;
     this->availableCores--;
     this->availableThreads -= this->cores[core_index].totalThreads;
     a.cpu_indices.push_back(os_index);
@@ -1479,8 +1492,13 @@ bool Chip::reserve_place_thread(
 
   for (unsigned int i = 0; i < this->cores.size(); i++)
     {
+     bool was_free = this->cores[i].is_free();
+
      if (this->cores[i].reserve_processing_unit(thread_index) == true)
        {
+       if (was_free == true)
+         this->free_cores--;
+
        a.threads++;
        a.cpus++;
        a.cpu_indices.push_back(thread_index);
@@ -1500,8 +1518,13 @@ bool Chip::reserve_chip_place_thread(
   {
   for (unsigned int i = 0; i < this->cores.size(); i++)
     {
+    bool was_free = this->cores[i].is_free();
+
     if (this->cores[i].reserve_processing_unit(thread_index) == true)
       {
+      if (was_free == true)
+        this->free_cores--;
+
       a.threads++;
       a.cpu_place_indices.push_back(thread_index);
       this->availableThreads--;
@@ -1530,7 +1553,12 @@ bool Chip::reserve_thread(
   allocation &a)
 
   {
-  int index = this->cores[core_index].get_open_processing_unit();
+  bool was_free = this->cores[core_index].is_free();
+  int  index = this->cores[core_index].get_open_processing_unit();
+
+  if ((was_free == true) &&
+      (this->cores[core_index].is_free() == false))
+    this->free_cores--;
 
   if (index >= 0)
     {
@@ -1561,7 +1589,12 @@ bool Chip::reserve_chip_thread(
   allocation &a)
 
   {
-  int index = this->cores[core_index].get_open_processing_unit();
+  bool was_free = this->cores[core_index].is_free();
+  int  index = this->cores[core_index].get_open_processing_unit();
+
+  if ((was_free == true) &&
+      (this->cores[core_index].is_free() == false))
+    this->free_cores--;
 
   if (index >= 0)
     {
@@ -2372,6 +2405,7 @@ void Chip::free_cpu_index(
 
       if (core_is_now_free == true)
         {
+        this->free_cores++;
         this->availableCores++;
         return;
         }
@@ -2379,7 +2413,12 @@ void Chip::free_cpu_index(
     else
       {
       if (this->cores[i].free_pu_index(index, core_is_now_free) == true)
+        {
+        if (core_is_now_free == true)
+          this->free_cores++;
+
         return;
+        }
       }
     }
 
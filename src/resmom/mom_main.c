@@ -455,6 +455,7 @@ const char *PBSServerCmds[] =
   "UPDATE",
   "STATUS",
   "GPU_STATUS",
+  "STATUS_STREAM",
   NULL
   };
 
@@ -244,6 +244,7 @@
 #include "mom_func.h"
 #include <string>
 #include <vector>
+#include <map>
 #include "container.hpp"
 #include <arpa/inet.h>
 #include <boost/tokenizer.hpp>
@@ -264,6 +265,7 @@
 #define MAX_SERVER_UPDATE_SPACING         40
 #define NO_SERVER_CONFIGURED             -1
 #define COULD_NOT_CONTACT_SERVER         -2
+#define STATUS_UPDATES_PER_FULL           20
 
 #ifdef NUMA_SUPPORT
 extern int numa_index;
@@ -330,6 +332,14 @@ int check_for_mics(uint32_t& num_engines);
 
 int num_stat_update_failures = 0;
 
+/* what the server last accepted over a status stream, so that the next update
+ * only has to send what changed. The forked process that sends an update
+ * passes these back to the main mom process (see encode_status_baseline()). */
+std::vector<std::string>   status_baseline;
+unsigned long              status_seq = 0;
+int                        updates_since_full_status = 0;
+bool                       status_baseline_changed = false;
+
 void check_state(int);
 void state_to_server(int, int);
 void node_comm_error(node_comm_t *, const char *);
@@ -345,6 +355,11 @@ void clear_servers()
   for (sindex = 0; sindex < PBS_MAXSERVER; sindex++)
     {
     pms = &mom_servers[sindex];
+
+    if ((pms->pbs_servername[0] != '\0') &&
+        (pms->status_stream >= 0))
+      close_status_stream(pms);
+
     /* the name is what we check in order to know if the server is there */
     memset(pms->pbs_servername, 0, sizeof(pms->pbs_servername));
     }
@@ -538,6 +553,11 @@ int mom_server_add(
     pms->sock_addr.sin_family = AF_INET;
     pms->sock_addr.sin_port = htons(port);
 
+    pms->status_stream = -1;
+    pms->status_stream_result = STATUS_STREAM_UNUSED;
+    pms->next_connect_time = 0;
+    pms->connect_failure_count = 0;
+
     mom_server_count++;
 
     sprintf(log_buffer, "server %s added", pms->pbs_servername);
@@ -1000,6 +1020,8 @@ typedef struct stat_record
   gen_func_ptr func;
   } stat_record;
 
+void gen_load_threshold(const char *name, std::vector<std::string> &status);
+
 stat_record stats[] = {
   {"arch",        gen_arch},
   {"opsys",       gen_gen},
@@ -1013,6 +1035,8 @@ stat_record stats[] = {
   {"physmem",     gen_gen},
   {"ncpus",       gen_gen},
   {"loadave",     gen_gen},
+  {"max_load",    gen_load_threshold},
+  {"ideal_load",  gen_load_threshold},
   {"message",     gen_gen},
   {"gres",        gen_gres},
   {"netload",     gen_gen},
@@ -1218,7 +1242,7 @@ int should_request_cluster_addrs()
  *
  *  Header format
  *
- *   Protocol | Version | Command (IS_STATUS) | mom service port | mom manager port 
+ *   Protocol | Version | Command (IS_STATUS or IS_STATUS_STREAM) | mom service port | mom manager port 
  *   The following two lines are added to the header if cgroups are enabled.
  *   | available sockets | available numa_nodes | available cores | available threads
  *   | total sockets     | total numa_nodes     | total cores     | total threads
@@ -1227,13 +1251,14 @@ int write_update_header(
     
   struct tcp_chan *chan,
   const char *id,
-  const char *name)
+  const char *name,
+  int         command)
 
   {
   int  ret;
   char buf[MAXLINE];
   
-  if ((ret = is_compose(chan, name, IS_STATUS)) == DIS_SUCCESS)
+  if ((ret = is_compose(chan, name, command)) == DIS_SUCCESS)
     {
     if ((ret = diswus(chan, pbs_mom_port)) == DIS_SUCCESS)
       {
@@ -1400,10 +1425,547 @@ int write_cached_statuses(
 
 
 
+/*
+ * close_status_stream()
+ *
+ * closes the connection kept open to send status updates to this server
+ *
+ * @param pms - the server whose stream should be closed
+ */
+
+void close_status_stream(
+
+  mom_server *pms)
+
+  {
+  if (pms->status_stream >= 0)
+    {
+    close(pms->status_stream);
+    pms->status_stream = -1;
+    }
+  } /* END close_status_stream() */
+
+
+
+/*
+ * status_stream_failed()
+ *
+ * Backs off before trying to open another status stream to this server.
+ * The wait doubles with each consecutive failure up to MAX_RETRY_TIME_IN_SECS
+ * so that a server that is down or doesn't know about status streams isn't
+ * reconnected to on every update. Updates are still sent one connection at a
+ * time while the mom waits.
+ *
+ * @param pms - the server the stream failed for
+ */
+
+void status_stream_failed(
+
+  mom_server *pms)
+
+  {
+  close_status_stream(pms);
+
+  pms->connect_failure_count++;
+  pms->next_connect_time = time_now + calculate_retry_seconds(pms->connect_failure_count);
+
+  if (LOGLEVEL >= 3)
+    {
+    snprintf(log_buffer, sizeof(log_buffer),
+      "status stream to %s failed %d time(s), not retrying for %ld seconds",
+      pms->pbs_servername,
+      pms->connect_failure_count,
+      (long)(pms->next_connect_time - time_now));
+
+    log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, log_buffer);
+    }
+  } /* END status_stream_failed() */
+
+
+
+/*
+ * open_status_streams()
+ *
+ * When $status_stream is set, opens a connection to each server that doesn't
+ * have one yet so that status updates can reuse it instead of connecting for
+ * each update. This is called in the main mom process before the update is
+ * forked so that the connection outlives the process that sends the update.
+ * Streams are closed if $status_stream has been turned off.
+ */
+
+void open_status_streams()
+
+  {
+  for (int sindex = 0; sindex < PBS_MAXSERVER; sindex++)
+    {
+    mom_server *pms = &mom_servers[sindex];
+    int         stream;
+    int         on = 1;
+
+    if (pms->pbs_servername[0] == '\0')
+      continue;
+
+    pms->status_stream_result = STATUS_STREAM_UNUSED;
+
+    if (MOMConfigStatusStream == FALSE)
+      {
+      close_status_stream(pms);
+      continue;
+      }
+
+    if ((pms->status_stream >= 0) ||
+        (time_now < pms->next_connect_time))
+      continue;
+
+    stream = tcp_connect_sockaddr((struct sockaddr *)&pms->sock_addr, sizeof(pms->sock_addr), false);
+
+    if (!IS_VALID_STREAM(stream))
+      {
+      status_stream_failed(pms);
+      continue;
+      }
+
+    /* let tcp notice a server that has gone away between updates */
+    setsockopt(stream, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+    fcntl(stream, F_SETFD, FD_CLOEXEC);
+
+    pms->status_stream = stream;
+
+    if (LOGLEVEL >= 6)
+      {
+      snprintf(log_buffer, sizeof(log_buffer),
+        "opened status stream %d to %s", stream, pms->pbs_servername);
+
+      log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, log_buffer);
+      }
+    }
+  } /* END open_status_streams() */
+
+
+
+/*
+ * apply_status_stream_result()
+ *
+ * Records what the last status update did with the server's stream in the
+ * main mom process. A stream that carried an update resets the back off and
+ * a broken one is closed so the next update opens a new one.
+ *
+ * @param pms - the server the update was sent to
+ * @param result - one of the STATUS_STREAM_* values
+ */
+
+void apply_status_stream_result(
+
+  mom_server *pms,
+  int         result)
+
+  {
+  if (result == STATUS_STREAM_SENT)
+    pms->connect_failure_count = 0;
+  else if (result == STATUS_STREAM_BROKEN)
+    status_stream_failed(pms);
+  } /* END apply_status_stream_result() */
+
+
+
+/*
+ * status_block_end()
+ *
+ * @return the string that ends the block of status strings status starts,
+ * or NULL if status is a single key=value string
+ */
+
+const char *status_block_end(
+
+  const std::string &status)
+
+  {
+  if (status == START_GPU_STATUS)
+    return(END_GPU_STATUS);
+  else if (status == START_MIC_STATUS)
+    return(END_MIC_STATUS);
+
+  return(NULL);
+  } /* END status_block_end() */
+
+
+
+/*
+ * key_status_strings()
+ *
+ * Maps each key=value status string to its key. GPU and MIC blocks are skipped
+ * because they are always sent whole.
+ *
+ * @param strings - the status strings
+ * @param keyed - O: each string by its key
+ * @return false if a key is repeated, which a delta couldn't describe
+ */
+
+bool key_status_strings(
+
+  const std::vector<std::string>     &strings,
+  std::map<std::string, std::string> &keyed)
+
+  {
+  const char *end_block = NULL;
+
+  for (size_t i = 0; i < strings.size(); i++)
+    {
+    if (end_block != NULL)
+      {
+      if (strings[i] == end_block)
+        end_block = NULL;
+
+      continue;
+      }
+
+    if ((end_block = status_block_end(strings[i])) != NULL)
+      continue;
+
+    std::string key = strings[i].substr(0, strings[i].find('='));
+
+    if (keyed.find(key) != keyed.end())
+      return(false);
+
+    keyed[key] = strings[i];
+    }
+
+  return(true);
+  } /* END key_status_strings() */
+
+
+
+/*
+ * always_send_status()
+ *
+ * @return true for keys the server acts on in every update, which are sent
+ * in every delta whether or not they've changed
+ */
+
+bool always_send_status(
+
+  const std::string &key)
+
+  {
+  return((key == "state") ||
+         (key == "message") ||
+         (key == "jobs") ||
+         (key == "jobdata"));
+  } /* END always_send_status() */
+
+
+
+/*
+ * build_status_delta()
+ *
+ * Builds an update holding only the status strings that changed since
+ * status_baseline was accepted, followed by the keys that are no longer
+ * reported.
+ *
+ * @param strings - this mom's status
+ * @param seq - the update's sequence number
+ * @param update - O: the strings to send
+ * @return false if there is no baseline or the strings can't be described as a delta
+ */
+
+bool build_status_delta(
+
+  const std::vector<std::string> &strings,
+  unsigned long                   seq,
+  std::vector<std::string>       &update)
+
+  {
+  std::map<std::string, std::string> last;
+  std::map<std::string, std::string> current;
+  std::string                        removed;
+  const char                        *end_block = NULL;
+  char                               buf[MAXLINE];
+
+  if ((status_baseline.size() == 0) ||
+      (key_status_strings(status_baseline, last) == false) ||
+      (key_status_strings(strings, current) == false))
+    return(false);
+
+  update.clear();
+
+  snprintf(buf, sizeof(buf), "%s%lu", STATUS_DELTA, seq);
+  update.push_back(buf);
+
+  for (size_t i = 0; i < strings.size(); i++)
+    {
+    if (end_block != NULL)
+      {
+      update.push_back(strings[i]);
+
+      if (strings[i] == end_block)
+        end_block = NULL;
+
+      continue;
+      }
+
+    if ((end_block = status_block_end(strings[i])) != NULL)
+      {
+      update.push_back(strings[i]);
+      continue;
+      }
+
+    std::string                                  key = strings[i].substr(0, strings[i].find('='));
+    std::map<std::string, std::string>::iterator it = last.find(key);
+
+    if ((it == last.end()) ||
+        (it->second != strings[i]) ||
+        (always_send_status(key) == true))
+      update.push_back(strings[i]);
+    }
+
+  for (std::map<std::string, std::string>::iterator it = last.begin(); it != last.end(); it++)
+    {
+    if (current.find(it->first) != current.end())
+      continue;
+
+    if (removed.size() != 0)
+      removed += ",";
+
+    removed += it->first;
+    }
+
+  if (removed.size() != 0)
+    update.insert(update.begin() + 1, STATUS_REMOVED + removed);
+
+  return(true);
+  } /* END build_status_delta() */
+
+
+
+/*
+ * build_full_status()
+ *
+ * @param strings - this mom's status
+ * @param seq - the update's sequence number
+ * @param update - O: all of strings, numbered with seq
+ */
+
+void build_full_status(
+
+  const std::vector<std::string> &strings,
+  unsigned long                   seq,
+  std::vector<std::string>       &update)
+
+  {
+  char buf[MAXLINE];
+
+  snprintf(buf, sizeof(buf), "%s%lu", STATUS_SEQ, seq);
+
+  update.clear();
+  update.push_back(buf);
+  update.insert(update.end(), strings.begin(), strings.end());
+  } /* END build_full_status() */
+
+
+
+/*
+ * encode_status_baseline()
+ *
+ * Appends the status baseline to the message the forked update process
+ * writes back to the main mom process, if this update changed it. Status
+ * strings may hold newlines so each one is ended with a '\0'.
+ *
+ * @param msg - the message (modified)
+ */
+
+void encode_status_baseline(
+
+  std::string &msg)
+
+  {
+  char buf[MAXLINE];
+
+  if (status_baseline_changed == false)
+    return;
+
+  snprintf(buf, sizeof(buf), "\n%lu %d\n", status_seq, updates_since_full_status);
+  msg += buf;
+
+  for (size_t i = 0; i < status_baseline.size(); i++)
+    {
+    msg += status_baseline[i];
+    msg += '\0';
+    }
+  } /* END encode_status_baseline() */
+
+
+
+/*
+ * decode_status_baseline()
+ *
+ * Reads the status baseline written by encode_status_baseline(). If the
+ * update process didn't write one the server wasn't sent a numbered update,
+ * so the next one has to send everything.
+ *
+ * @param msg - the message from the update process
+ */
+
+void decode_status_baseline(
+
+  const std::string &msg)
+
+  {
+  size_t start = msg.find('\n');
+  size_t end;
+
+  status_baseline.clear();
+
+  if ((start == std::string::npos) ||
+      ((end = msg.find('\n', start + 1)) == std::string::npos) ||
+      (sscanf(msg.c_str() + start + 1, "%lu %d", &status_seq, &updates_since_full_status) != 2))
+    return;
+
+  for (start = end + 1; start < msg.size(); start = end + 1)
+    {
+    if ((end = msg.find('\0', start)) == std::string::npos)
+      end = msg.size();
+
+    status_baseline.push_back(msg.substr(start, end - start));
+    }
+  } /* END decode_status_baseline() */
+
+
+
+/*
+ * send_status_on_stream()
+ *
+ * Sends a status update over the server's status stream. Updates are numbered
+ * and, between full updates every STATUS_UPDATES_PER_FULL updates, only
+ * hold what changed since the last one the server accepted. If the server
+ * can't apply a delta it asks for everything, which is sent right away.
+ *
+ * @param pms - the server
+ * @param strings - this mom's status
+ * @return DIS_SUCCESS if the server accepted the update
+ */
+
+int send_status_on_stream(
+
+  mom_server               *pms,
+  std::vector<std::string> &strings)
+
+  {
+  std::vector<std::string> update;
+  unsigned long            seq = status_seq + 1;
+  bool                     full = true;
+  int                      ret;
+
+#ifdef NUMA_SUPPORT
+  /* each numa board would need its own baseline */
+  bool                     numbered = false;
+#else
+  /* the alps status is processed separately and doesn't take deltas */
+  bool                     numbered = (is_reporter_mom == FALSE);
+#endif
+
+  if (numbered == false)
+    return(send_status_update(pms->status_stream, pms, strings, IS_STATUS_STREAM));
+
+  if ((updates_since_full_status < STATUS_UPDATES_PER_FULL) &&
+      (build_status_delta(strings, seq, update) == true))
+    full = false;
+  else
+    build_full_status(strings, seq, update);
+
+  ret = send_status_update(pms->status_stream, pms, update, IS_STATUS_STREAM);
+
+  if ((ret == SEND_FULL_STATUS) &&
+      (full == false))
+    {
+    if (LOGLEVEL >= 3)
+      {
+      snprintf(log_buffer, sizeof(log_buffer),
+        "%s asked for all of status update %lu, resending it", pms->pbs_servername, seq);
+      log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, log_buffer);
+      }
+
+    full = true;
+    build_full_status(strings, seq, update);
+    ret = send_status_update(pms->status_stream, pms, update, IS_STATUS_STREAM);
+    }
+
+  if (ret == DIS_SUCCESS)
+    {
+    status_baseline = strings;
+    status_seq = seq;
+    updates_since_full_status = (full == true) ? 0 : updates_since_full_status + 1;
+    status_baseline_changed = true;
+    }
+
+  return(ret);
+  } /* END send_status_on_stream() */
+
+
+
+/*
+ * send_status_update()
+ *
+ * Writes a status update, this mom's and any cached from below it in the
+ * hierarchy, to the server over stream and reads the server's reply.
+ *
+ * @param stream - a connection to the server
+ * @param pms - the server
+ * @param strings - this mom's status
+ * @param command - IS_STATUS, or IS_STATUS_STREAM to ask the server to keep stream open
+ * @return DIS_SUCCESS if the server accepted the update
+ */
+
+int send_status_update(
+
+  int                       stream,
+  mom_server               *pms,
+  std::vector<std::string> &strings,
+  int                       command)
+
+  {
+  int              ret = -1;
+  struct tcp_chan *chan = NULL;
+
+  if ((chan = DIS_tcp_setup(stream)) == NULL)
+    {
+    }
+  else if ((ret = write_update_header(chan, __func__, pms->pbs_servername, command)) != DIS_SUCCESS)
+    {
+    }
+  else if ((ret = write_my_server_status(chan, __func__, strings, pms, UPDATE_TO_SERVER)) != DIS_SUCCESS)
+    {
+    }
+  else if ((ret = write_cached_statuses(chan, __func__, pms, UPDATE_TO_SERVER)) != DIS_SUCCESS)
+    {
+    }
+  else if ((ret = diswst(chan, IS_EOL_MESSAGE)) != DIS_SUCCESS)
+    {
+    }
+  else if ((ret = DIS_tcp_wflush(chan)) != DIS_SUCCESS)
+    {
+    }
+  else
+    {
+    /* the server replies with IS_STATUS to both commands */
+    read_tcp_reply(chan, IS_PROTOCOL, IS_PROTOCOL_VER, IS_STATUS, &ret);
+    }
+
+  if (chan != NULL)
+    DIS_tcp_cleanup(chan);
+
+  return(ret);
+  } /* END send_status_update() */
+
+
+
+
+
 /**
  * mom_server_update_stat
  *
- * Send a status update message to a server.
+ * Send a status update message to a server. The server's status stream is
+ * used if there is one, and if it fails the update is sent over a new
+ * connection that is closed afterwards.
  *
  * NOTE:  if interface is bad, try to recover is ???
  *
@@ -1420,7 +1982,6 @@ int mom_server_update_stat(
   int              stream;
   int              ret = -1;
   int              rc  = COULD_NOT_CONTACT_SERVER;
-  struct tcp_chan *chan = NULL;
 
   if ((pms->pbs_servername[0] == '\0') ||
       (time_now < (pms->MOMLastSendToServerTime + get_stat_update_interval())))
@@ -1430,37 +1991,41 @@ int mom_server_update_stat(
     return(NO_SERVER_CONFIGURED);
     }
 
-  stream = tcp_connect_sockaddr((struct sockaddr *)&pms->sock_addr, sizeof(pms->sock_addr), false);
- 
-  if (IS_VALID_STREAM(stream))
+  if ((MOMConfigStatusStream == TRUE) &&
+      (pms->status_stream >= 0))
     {
-    if ((chan = DIS_tcp_setup(stream)) == NULL)
-      {
-      }
-    else if ((ret = write_update_header(chan, __func__, pms->pbs_servername)) != DIS_SUCCESS)
-      {
-      }
-    else if ((ret = write_my_server_status(chan, __func__, strings, pms, UPDATE_TO_SERVER)) != DIS_SUCCESS)
-      {
-      }
-    else if ((ret = write_cached_statuses(chan, __func__, pms, UPDATE_TO_SERVER)) != DIS_SUCCESS)
-      {
-      }
-    else if ((ret = diswst(chan, IS_EOL_MESSAGE)) != DIS_SUCCESS)
-      {
-      }
-    else if ((ret = DIS_tcp_wflush(chan)) != DIS_SUCCESS)
+    if ((ret = send_status_on_stream(pms, strings)) == DIS_SUCCESS)
       {
+      pms->status_stream_result = STATUS_STREAM_SENT;
       }
     else
       {
-      read_tcp_reply(chan, IS_PROTOCOL, IS_PROTOCOL_VER, IS_STATUS, &ret);
+      snprintf(log_buffer, sizeof(log_buffer),
+        "status stream to %s failed, sending the update on a new connection",
+        pms->pbs_servername);
+      log_err(-1, __func__, log_buffer);
+
+      /* the main mom process closes its copy and backs off */
+      close(pms->status_stream);
+      pms->status_stream = -1;
+      pms->status_stream_result = STATUS_STREAM_BROKEN;
       }
+    }
 
-    if (chan != NULL)
-      DIS_tcp_cleanup(chan);
+  if (ret == DIS_SUCCESS)
+    stream = -1;
+  else
+    stream = tcp_connect_sockaddr((struct sockaddr *)&pms->sock_addr, sizeof(pms->sock_addr), false);
+ 
+  if ((ret == DIS_SUCCESS) ||
+      (IS_VALID_STREAM(stream)))
+    {
+    if (IS_VALID_STREAM(stream))
+      {
+      ret = send_status_update(stream, pms, strings, IS_STATUS);
       
-    close(stream);
+      close(stream);
+      }
   
     if (ret != DIS_SUCCESS)
       {
@@ -1568,7 +2133,7 @@ int write_status_strings(
     {
     }
   /* write protocol */
-  else if ((rc = write_update_header(chan,__func__,nc->name.c_str())) != DIS_SUCCESS)
+  else if ((rc = write_update_header(chan,__func__,nc->name.c_str(),IS_STATUS)) != DIS_SUCCESS)
     {
     }
   else if ((rc = write_my_server_status(chan,__func__, strings, nc, UPDATE_TO_SERVER)) != DIS_SUCCESS)
@@ -1778,6 +2343,8 @@ void mom_server_all_update_stat(void)
     check_state((LastServerUpdateTime == 0));
  
   LastUpdateAttempt = time_now;
+
+  open_status_streams();
  
   /* We generate the status once, because this might be costly.
    * The dynamic string mom_status will contain NULL terminated strings.
@@ -1798,6 +2365,9 @@ void mom_server_all_update_stat(void)
       ForceServerUpdate = false;
       LastServerUpdateTime = time_now;
       }
+
+    for (int sindex = 0; sindex < PBS_MAXSERVER; sindex++)
+      apply_status_stream_result(&mom_servers[sindex], mom_servers[sindex].status_stream_result);
     }
   else
     {
@@ -1854,17 +2424,41 @@ void mom_server_all_update_stat(void)
       delete iter;
       received_statuses.unlock();
 
-      len = read(fd_pipe[0], buf, LOCAL_LOG_BUF_SIZE);
+      std::string msg;
+      ssize_t     bytes;
+
+      while ((bytes = read(fd_pipe[0], buf, sizeof(buf))) > 0)
+        msg.append(buf, bytes);
 
       close(fd_pipe[0]);
 
-      if (len <= 0)
+      if (msg.size() == 0)
         {
         log_err(-1, __func__, "read of pipe failed for status update");
         return;
         }
 
-      if (buf[0] != '0')
+      /* the child writes its rc followed by what it did with each server's status stream,
+       * then the status baseline if it sent a numbered update */
+      char *ptr = (char *)msg.c_str();
+
+      rc = strtol(ptr, &ptr, 10);
+
+      for (int sindex = 0; sindex < PBS_MAXSERVER; sindex++)
+        {
+        char *next;
+        int   result = strtol(ptr, &next, 10);
+
+        if (next == ptr)
+          break;
+
+        ptr = next;
+        apply_status_stream_result(&mom_servers[sindex], result);
+        }
+
+      decode_status_baseline(msg);
+
+      if (rc != PBSE_NONE)
         num_stat_update_failures++;
       else
         {
@@ -1893,9 +2487,24 @@ void mom_server_all_update_stat(void)
         rc = send_update_to_a_server();
       }
 
-    sprintf(buf, "%d", rc);
-    len = strlen(buf);
-    write(fd_pipe[1], buf, len);
+    len = sprintf(buf, "%d", rc);
+
+    for (int sindex = 0; sindex < PBS_MAXSERVER; sindex++)
+      len += sprintf(buf + len, " %d", mom_servers[sindex].status_stream_result);
+
+    std::string msg(buf, len);
+
+    encode_status_baseline(msg);
+
+    for (size_t written = 0; written < msg.size(); )
+      {
+      ssize_t bytes = write(fd_pipe[1], msg.c_str() + written, msg.size() - written);
+
+      if (bytes <= 0)
+        break;
+
+      written += bytes;
+      }
 
     exit_called = true;
   
@@ -2005,6 +2614,19 @@ void mom_server_diag(
     output << tmpLine;
     }
 
+  if (pms->status_stream >= 0)
+    {
+    output << "  Status Stream:          open\n";
+    }
+  else if (MOMConfigStatusStream == TRUE)
+    {
+    sprintf(tmpLine, "  Status Stream:          closed (%d failures, retry in %ld seconds)\n",
+            pms->connect_failure_count,
+            (pms->next_connect_time > Now) ? (long)(pms->next_connect_time - Now) : 0L);
+
+    output << tmpLine;
+    }
+
   if (TMOMRejectConn[0] != '\0')
     {
     output << "  WARNING:  invalid attempt to connect from server " << TMOMRejectConn << "\n";
@@ -2851,25 +3473,20 @@ float compute_load_threshold(
 
 
 /*
- * check_busy() -
- * If current load average ge max_load_val and busy not already set
- *  set it
- * If current load average lt ideal_load_val and busy currently set
- *  unset it
+ * get_load_thresholds()
+ *
+ * @param myideal_load - O: $ideal_load, or $auto_ideal_load for the jobs running here
+ * @param mymax_load - O: $max_load, or $auto_max_load for the jobs running here
  */
 
-void check_busy(
+void get_load_thresholds(
 
-  double mla) /* I */
+  float &myideal_load,
+  float &mymax_load)
 
   {
-  int sindex;
-  int numvnodes = 0;
+  int  numvnodes = 0;
   job *pjob;
-  float myideal_load;
-  float mymax_load;
-
-  extern int   internal_state;
 
   if ((auto_max_load != NULL) || (auto_ideal_load != NULL))
     {
@@ -2891,6 +3508,71 @@ void check_busy(
     mymax_load = max_load_val;
     myideal_load = ideal_load_val;
     }
+  } /* END get_load_thresholds() */
+
+
+
+/*
+ * gen_load_threshold()
+ *
+ * Reports max_load or ideal_load so schedulers can load balance from the
+ * node's status instead of asking the resource monitor. A static resource
+ * of the same name is what the resource monitor answered with, so it wins
+ * over the $max_load and $ideal_load thresholds. Both are always reported.
+ */
+
+void gen_load_threshold(
+
+  const char               *name,
+  std::vector<std::string> &status)
+
+  {
+  float myideal_load;
+  float mymax_load;
+  float value;
+  char  buf[64];
+
+  if (rm_search(config_array, name) != NULL)
+    {
+    gen_gen(name, status);
+    return;
+    }
+
+  get_load_thresholds(myideal_load, mymax_load);
+
+  value = (!strcmp(name, "max_load")) ? mymax_load : myideal_load;
+
+  /* an unset threshold is reported as 0 so schedulers know the status is
+   * complete and apply their own default instead of asking the mom */
+  if (value <= 0.0)
+    value = 0.0;
+
+  snprintf(buf, sizeof(buf), "%s=%.2f", name, value);
+  status.push_back(buf);
+  } /* END gen_load_threshold() */
+
+
+
+/*
+ * check_busy() -
+ * If current load average ge max_load_val and busy not already set
+ *  set it
+ * If current load average lt ideal_load_val and busy currently set
+ *  unset it
+ */
+
+void check_busy(
+
+  double mla) /* I */
+
+  {
+  int sindex;
+  float myideal_load;
+  float mymax_load;
+
+  extern int   internal_state;
+
+  get_load_thresholds(myideal_load, mymax_load);
 
   if ((mla >= mymax_load) &&
       ((internal_state & INUSE_BUSY) == 0))
@@ -84,6 +84,26 @@ int write_status_strings(char *stat_str, node_comm_t *nc);
 
 int send_update();
 
+void close_status_stream(mom_server *pms);
+
+void status_stream_failed(mom_server *pms);
+
+void open_status_streams();
+
+void apply_status_stream_result(mom_server *pms, int result);
+
+int send_status_update(int stream, mom_server *pms, std::vector<std::string> &strings, int command);
+
+bool build_status_delta(const std::vector<std::string> &strings, unsigned long seq, std::vector<std::string> &update);
+
+void build_full_status(const std::vector<std::string> &strings, unsigned long seq, std::vector<std::string> &update);
+
+void encode_status_baseline(std::string &msg);
+
+void decode_status_baseline(const std::string &msg);
+
+int send_status_on_stream(mom_server *pms, std::vector<std::string> &strings);
+
 void mom_server_all_update_stat(void);
 
 long power(register int x, register int n);
@@ -106,6 +126,10 @@ void mom_is_request(struct tcp_chan *chan, int version, int *cmdp,struct sockadd
 
 float compute_load_threshold(char *config, int numvnodes, float threshold);
 
+void get_load_thresholds(float &myideal_load, float &mymax_load);
+
+void gen_load_threshold(const char *name, std::vector<std::string> &status);
+
 void check_busy(double mla);
 
 void check_state(int Force);
@@ -148,6 +148,7 @@ int              hostname_specified = 0;
 int              MOMConfigRReconfig        = 0;
 char            *TNoSpoolDirList[TMAX_NSDCOUNT];
 int              is_reporter_mom = FALSE;
+int              MOMConfigStatusStream = FALSE;
 int              is_login_node   = FALSE;
 int              job_exit_wait_time = DEFAULT_JOB_EXIT_WAIT_TIME;
 char             jobstarter_exe_name[MAXPATHLEN + 1];
@@ -299,6 +300,7 @@ unsigned long setmomhierarchyretrytime(const char *);
 unsigned long setjobdirectorysticky(const char *);
 unsigned long setcudavisibledevices(const char *);
 unsigned long set_presetup_prologue(const char *);
+unsigned long setstatusstream(const char *);
 
 struct specials special[] = {
   { "force_overwrite",     setforceoverwrite}, 
@@ -384,6 +386,7 @@ struct specials special[] = {
   { "cuda_visible_devices", setcudavisibledevices},
   { "cray_check_rur",       setrur },
   { "presetup_prologue",    set_presetup_prologue},
+  { "status_stream",        setstatusstream},
   { NULL,                  NULL }
   };
 
@@ -1200,6 +1203,30 @@ unsigned long setreportermom(
 
 
 
+/*
+ * setstatusstream()
+ *
+ * $status_stream - keep the connection to the server open between status
+ * updates instead of opening a new one for each
+ */
+
+unsigned long setstatusstream(
+
+  const char *value)
+
+  {
+  int enable;
+
+  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, value);
+
+  if ((enable = setbool(value)) != -1)
+    MOMConfigStatusStream = enable;
+
+  return(1);
+  } /* END setstatusstream() */
+
+
+
 
 unsigned long setloginnode(
 
@@ -2271,6 +2298,7 @@ void reset_config_vars()
   MOMConfigRReconfig = 0;
   TNoSpoolDirList[0] = '\0';
   is_reporter_mom = FALSE;
+  MOMConfigStatusStream = FALSE;
   is_login_node = FALSE;
   job_exit_wait_time = DEFAULT_JOB_EXIT_WAIT_TIME;
   jobstarter_exe_name[0] = '\0';
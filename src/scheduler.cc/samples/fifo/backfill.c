@@ -0,0 +1,416 @@
+/*
+ * backfill.c - reserve resources for a job that can't run and backfill
+ *              smaller jobs around it
+ *
+ * Without backfilling, a job too big to run either holds up everything
+ * behind it (strict_fifo, help_starving_jobs) or is passed over by smaller
+ * jobs until the system happens to drain.  The calendar here records when
+ * the walltime of each running job runs out, which is when its resources
+ * come back.  The first job that can't run for lack of resources is given
+ * the earliest time enough resources come back to start it.  Jobs behind it
+ * are still run if they end before that time, or if they fit in what the
+ * reserved job leaves spare, so the reserved job is never delayed.
+ *
+ * Functions included are:
+ * new_calendar()
+ * free_calendar()
+ * reserve_job()
+ * check_backfill()
+ * update_calendar_on_run()
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pbs_ifl.h"
+#include "log.h"
+#include "backfill.h"
+#include "constant.h"
+#include "config.h"
+#include "globals.h"
+#include "misc.h"
+#include "check.h"
+
+/* Internal functions */
+int grow_calendar(calendar *cal);
+int add_calendar_event(calendar *cal, time_t end, job_info *jinfo);
+int cmp_cal_event(const void *e1, const void *e2);
+resource *find_tracked_resource(server_info *sinfo, int res_index);
+
+
+/*
+ *
+ * find_tracked_resource - find a res_to_check resource whose use the
+ *    calendar can track.  Only resources with resources_available set have
+ *    their assigned amount taken off; the rest never run out.
+ *
+ *   sinfo     - the server
+ *   res_index - index into res_to_check
+ *
+ * returns the resource or NULL if it isn't tracked
+ *
+ */
+resource *find_tracked_resource(server_info *sinfo, int res_index)
+  {
+  resource *res;
+
+  res = find_resource(sinfo -> res, res_to_check[res_index].name);
+
+  if (res == NULL || res -> avail == UNSPECIFIED)
+    return NULL;
+
+  return res;
+  }
+
+/*
+ *
+ * cmp_cal_event - sort calendar events soonest to end first
+ *
+ */
+int cmp_cal_event(const void *e1, const void *e2)
+  {
+  const struct cal_event *ev1 = (const struct cal_event *) e1;
+  const struct cal_event *ev2 = (const struct cal_event *) e2;
+
+  if (ev1 -> end < ev2 -> end)
+    return -1;
+  else if (ev1 -> end > ev2 -> end)
+    return 1;
+
+  return 0;
+  }
+
+/*
+ *
+ * grow_calendar - make room for another event in a calendar
+ *
+ *   cal - the calendar
+ *
+ * returns non-zero on error
+ *
+ */
+int grow_calendar(calendar *cal)
+  {
+  struct cal_event *events;
+
+  if (cal -> num_events < cal -> size)
+    return 0;
+
+  if ((events = (struct cal_event *) realloc(cal -> events,
+        (cal -> size * 2 + 16) * sizeof(struct cal_event))) == NULL)
+    {
+    perror("Memory Allocation Error");
+    return 1;
+    }
+
+  cal -> events = events;
+  cal -> size = cal -> size * 2 + 16;
+
+  return 0;
+  }
+
+/*
+ *
+ * add_calendar_event - add a running job to the calendar, keeping the
+ *    events sorted soonest to end first
+ *
+ *   cal   - the calendar
+ *   end   - when the job ends
+ *   jinfo - the running job
+ *
+ * returns non-zero on error
+ *
+ */
+int add_calendar_event(calendar *cal, time_t end, job_info *jinfo)
+  {
+  int i;
+
+  if (grow_calendar(cal))
+    return 1;
+
+  for (i = cal -> num_events; i > 0 && cal -> events[i - 1].end > end; i--)
+    cal -> events[i] = cal -> events[i - 1];
+
+  cal -> events[i].end = end;
+  cal -> events[i].job = jinfo;
+  cal -> num_events++;
+
+  return 0;
+  }
+
+/*
+ *
+ * new_calendar - build the calendar of when the running jobs on a server
+ *    end.  Jobs without a walltime never give their resources back.
+ *
+ *   sinfo - the server
+ *
+ * returns the new calendar or NULL on error
+ *
+ */
+calendar *new_calendar(server_info *sinfo)
+  {
+  calendar *cal;
+  int time_left;
+  int i;
+
+  if ((cal = (calendar *) malloc(sizeof(calendar))) == NULL)
+    {
+    perror("Memory Allocation Error");
+    return NULL;
+    }
+
+  cal -> events = NULL;
+  cal -> num_events = 0;
+  cal -> size = 0;
+
+  if ((cal -> spare = (sch_resource_t *) malloc(num_res * sizeof(sch_resource_t))) == NULL)
+    {
+    perror("Memory Allocation Error");
+    free(cal);
+    return NULL;
+    }
+
+  for (i = 0; i < num_res; i++)
+    cal -> spare[i] = INFINITY_VAL;
+
+  if (sinfo -> running_jobs != NULL)
+    {
+    for (i = 0; sinfo -> running_jobs[i] != NULL; i++)
+      {
+      if ((time_left = calc_time_left(sinfo -> running_jobs[i])) < 0)
+        continue;
+
+      if (grow_calendar(cal))
+        {
+        free_calendar(cal);
+        return NULL;
+        }
+
+      cal -> events[cal -> num_events].end = cstat.current_time + time_left;
+      cal -> events[cal -> num_events].job = sinfo -> running_jobs[i];
+      cal -> num_events++;
+      }
+
+    qsort(cal -> events, cal -> num_events, sizeof(struct cal_event), cmp_cal_event);
+    }
+
+  return cal;
+  }
+
+/*
+ *
+ * free_calendar - free a calendar
+ *
+ *   cal - the calendar to free
+ *
+ * returns nothing
+ *
+ */
+void free_calendar(calendar *cal)
+  {
+  if (cal != NULL)
+    {
+    if (cal -> events != NULL)
+      free(cal -> events);
+
+    if (cal -> spare != NULL)
+      free(cal -> spare);
+
+    free(cal);
+    }
+  }
+
+/*
+ *
+ * reserve_job - find the earliest time the running jobs give back enough
+ *    resources to start a job, and reserve them for it
+ *
+ *   sinfo - the server
+ *   jinfo - the job to reserve resources for
+ *
+ * returns 1 if the resources were reserved
+ *  0 if the job can't be fit in the calendar
+ *
+ */
+int reserve_job(server_info *sinfo, job_info *jinfo)
+  {
+  calendar *cal = sinfo -> cal;
+  resource *res;
+  resource_req *req;
+  sch_resource_t *avail;  /* available amount of each tracked resource */
+  sch_resource_t *need;  /* amount of each tracked resource jinfo needs */
+  time_t start;   /* when jinfo can start */
+  int fits = 0;
+  int ev = 0;
+  int i;
+  char log_buf[MAX_LOG_SIZE];
+
+  if (cal == NULL || cstat.resv_job != NULL)
+    return 0;
+
+  avail = (sch_resource_t *) malloc(num_res * sizeof(sch_resource_t));
+  need = (sch_resource_t *) malloc(num_res * sizeof(sch_resource_t));
+
+  if (avail == NULL || need == NULL)
+    {
+    perror("Memory Allocation Error");
+    free(avail);
+    free(need);
+    return 0;
+    }
+
+  for (i = 0; i < num_res; i++)
+    {
+    res = find_tracked_resource(sinfo, i);
+    req = find_resource_req(jinfo -> resreq, res_to_check[i].name);
+
+    if (res == NULL || req == NULL)
+      {
+      avail[i] = INFINITY_VAL;
+      need[i] = 0;
+      }
+    else
+      {
+      avail[i] = res -> avail - res -> assigned;
+      need[i] = req -> amount;
+      }
+    }
+
+  start = cstat.current_time;
+
+  while (!fits)
+    {
+    for (i = 0, fits = 1; i < num_res && fits; i++)
+      {
+      if (avail[i] != INFINITY_VAL && avail[i] < need[i])
+        fits = 0;
+      }
+
+    if (fits || ev == cal -> num_events)
+      break;
+
+    /* the next running job to end gives its resources back */
+    start = cal -> events[ev].end;
+
+    for (i = 0; i < num_res; i++)
+      {
+      if (avail[i] == INFINITY_VAL)
+        continue;
+
+      if ((req = find_resource_req(cal -> events[ev].job -> resreq, res_to_check[i].name)) != NULL)
+        avail[i] += req -> amount;
+      }
+
+    ev++;
+    }
+
+  if (fits)
+    {
+    for (i = 0; i < num_res; i++)
+      cal -> spare[i] = (avail[i] == INFINITY_VAL) ? INFINITY_VAL : avail[i] - need[i];
+
+    cstat.resv_job = jinfo;
+    cstat.resv_start = start;
+
+    snprintf(log_buf, sizeof(log_buf), "Resources reserved for job to start in %ld seconds",
+             (long)(start - cstat.current_time));
+    sched_log(PBSEVENT_SCHED, PBS_EVENTCLASS_JOB, jinfo -> name, log_buf);
+    }
+
+  free(avail);
+  free(need);
+
+  return fits;
+  }
+
+/*
+ *
+ * check_backfill - check if running a job would delay the job resources
+ *    are reserved for
+ *
+ *   sinfo - the server
+ *   jinfo - the job to check
+ *
+ * returns 0 if the job can run
+ *  BACKFILL_CONFLICT if it would delay the reserved job
+ *
+ */
+int check_backfill(server_info *sinfo, job_info *jinfo)
+  {
+  resource_req *req;
+  int i;
+
+  if (sinfo -> cal == NULL || cstat.resv_job == NULL || cstat.resv_job == jinfo)
+    return 0;
+
+  /* done before the reserved job needs the resources */
+  req = find_resource_req(jinfo -> resreq, "walltime");
+
+  if (req != NULL && cstat.current_time + req -> amount <= cstat.resv_start)
+    return 0;
+
+  /* still running then, it has to fit beside the reserved job */
+  for (i = 0; i < num_res; i++)
+    {
+    if (sinfo -> cal -> spare[i] == INFINITY_VAL)
+      continue;
+
+    req = find_resource_req(jinfo -> resreq, res_to_check[i].name);
+
+    if (req != NULL && req -> amount > sinfo -> cal -> spare[i])
+      return BACKFILL_CONFLICT;
+    }
+
+  return 0;
+  }
+
+/*
+ *
+ * update_calendar_on_run - add a job that was just run to the calendar
+ *
+ *   sinfo - the server
+ *   jinfo - the job that was run
+ *
+ * returns nothing
+ *
+ */
+void update_calendar_on_run(server_info *sinfo, job_info *jinfo)
+  {
+  calendar *cal = sinfo -> cal;
+  resource_req *req;
+  time_t end = 0;
+  int i;
+
+  if (cal == NULL)
+    return;
+
+  if ((req = find_resource_req(jinfo -> resreq, "walltime")) != NULL)
+    {
+    end = cstat.current_time + req -> amount;
+
+    add_calendar_event(cal, end, jinfo);
+    }
+
+  if (cstat.resv_job == jinfo)
+    {
+    /* the reserved job started, the next blocked job can have a reservation */
+    cstat.resv_job = NULL;
+
+    for (i = 0; i < num_res; i++)
+      cal -> spare[i] = INFINITY_VAL;
+    }
+  else if (cstat.resv_job != NULL && (req == NULL || end > cstat.resv_start))
+    {
+    /* a backfilled job still running when the reserved job starts */
+    for (i = 0; i < num_res; i++)
+      {
+      if (cal -> spare[i] == INFINITY_VAL)
+        continue;
+
+      if ((req = find_resource_req(jinfo -> resreq, res_to_check[i].name)) != NULL)
+        cal -> spare[i] -= req -> amount;
+      }
+    }
+  }
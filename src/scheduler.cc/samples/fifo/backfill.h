@@ -0,0 +1,34 @@
+#ifndef BACKFILL_H
+#define BACKFILL_H
+
+#include "data_types.h"
+
+/*
+ *      new_calendar - build the calendar of when the running jobs on a
+ *                     server end
+ */
+calendar *new_calendar(server_info *sinfo);
+
+/*
+ *      free_calendar - free a calendar
+ */
+void free_calendar(calendar *cal);
+
+/*
+ *      reserve_job - reserve resources for a job at the earliest time the
+ *                    running jobs give enough back
+ */
+int reserve_job(server_info *sinfo, job_info *jinfo);
+
+/*
+ *      check_backfill - check if running a job would delay the job
+ *                       resources are reserved for
+ */
+int check_backfill(server_info *sinfo, job_info *jinfo);
+
+/*
+ *      update_calendar_on_run - add a job that was just run to the calendar
+ */
+void update_calendar_on_run(server_info *sinfo, job_info *jinfo);
+
+#endif
@@ -92,6 +92,7 @@
 #include "globals.h"
 #include "dedtime.h"
 #include "token_acct.h"
+#include "backfill.h"
 
 /* Internal functions */
 int check_server_max_run(server_info *sinfo);
@@ -194,6 +195,9 @@ int is_ok_to_run_job(int pbs_sd, server_info *sinfo, queue_info *qinfo,
   if ((rc = check_token_utilization(sinfo, jinfo)) != SUCCESS)
     return rc;
 
+  if ((rc = check_backfill(sinfo, jinfo)))
+    return rc;
+
   return SUCCESS;
   }
 
@@ -214,7 +218,7 @@ int is_ok_to_run_job(int pbs_sd, server_info *sinfo, queue_info *qinfo,
 int check_server_max_user_run(server_info *sinfo, char *account)
   {
   if (sinfo -> max_user_run == INFINITY_VAL ||
-      count_by_user(sinfo -> running_jobs, account) < sinfo -> max_user_run)
+      find_run_count(sinfo -> user_run, account) < sinfo -> max_user_run)
     return 0;
 
   return SERVER_USER_LIMIT_REACHED;
@@ -236,7 +240,7 @@ int check_server_max_user_run(server_info *sinfo, char *account)
 int check_queue_max_user_run(queue_info *qinfo, char *account)
   {
   if (qinfo -> max_user_run == INFINITY_VAL ||
-      count_by_user(qinfo -> running_jobs, account) < qinfo -> max_user_run)
+      find_run_count(qinfo -> user_run, account) < qinfo -> max_user_run)
     return 0;
 
   return QUEUE_USER_LIMIT_REACHED;
@@ -258,7 +262,7 @@ int check_queue_max_user_run(queue_info *qinfo, char *account)
 int check_queue_max_group_run(queue_info *qinfo, char *group)
   {
   if (qinfo -> max_group_run == INFINITY_VAL ||
-      count_by_group(qinfo -> running_jobs, group) < qinfo -> max_group_run)
+      find_run_count(qinfo -> group_run, group) < qinfo -> max_group_run)
     return 0;
 
   return QUEUE_GROUP_LIMIT_REACHED;
@@ -280,7 +284,7 @@ int check_queue_max_group_run(queue_info *qinfo, char *group)
 int check_server_max_group_run(server_info *sinfo, char *group)
   {
   if (sinfo -> max_group_run == INFINITY_VAL ||
-      count_by_group(sinfo -> running_jobs, group) < sinfo -> max_group_run)
+      find_run_count(sinfo -> group_run, group) < sinfo -> max_group_run)
     return 0;
 
   return SERVER_GROUP_LIMIT_REACHED;
@@ -311,7 +315,7 @@ int check_avail_resources(resource *reslist, job_info *jinfo)
   resource *res;
   int ret_code = UNSPECIFIED;
   char done = 0;                        /* Are we done? */
-  int avail;                            /* amount of available resource */
+  sch_resource_t avail;                 /* amount of available resource */
   int i;
 
   for (i = 0; (i < num_res) && !done; i++)
@@ -693,6 +697,10 @@ int check_starvation(job_info *jinfo)
   {
   if (cstat.starving_job == NULL || cstat.starving_job == jinfo)
     return 0;
+  /* the starving job has its resources reserved, check_backfill() keeps
+   * other jobs from delaying it instead of draining the system */
+  else if (cstat.resv_job == cstat.starving_job)
+    return 0;
   else
     return JOB_STARVING;
   }
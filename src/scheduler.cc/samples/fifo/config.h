@@ -120,6 +120,15 @@
 #define PARSE_MAX_STARVE "max_starve"
 #define PARSE_SORT_QUEUES "sort_queues"
 #define PARSE_IGNORE_QUEUE "ignore_queue"
+#define PARSE_BACKFILL "backfill"
+#define PARSE_MOM_QUERY_FANOUT "mom_query_fanout"
+#define PARSE_MOM_QUERY_TIMEOUT "mom_query_timeout"
+
+/* moms asked for resources at once when a node's status doesn't have them,
+ * and how long to wait on them before giving up
+ */
+#define DEFAULT_MOM_QUERY_FANOUT 32
+#define DEFAULT_MOM_QUERY_TIMEOUT 5
 
 /* max sizes */
 #define MAX_HOLIDAY_SIZE 50
@@ -129,6 +138,7 @@
 #define MAX_RES_NAME_SIZE 256
 #define MAX_RES_RET_SIZE 256
 #define MAX_IGNORED_QUEUES 16
+#define RUN_COUNT_BUCKETS 1024
 
 
 /* messages -
@@ -153,6 +163,7 @@
 #define INFO_SCHD_ERROR "Internal Scheduling Error"
 #define INFO_TOKEN_UTILIZATION "Max token usage reached"
 #define INFO_QUEUE_IGNORED "Queue is configured to be ignored"
+#define INFO_BACKFILL_CONFLICT "Job would delay %s, which has resources reserved"
 
 #define COMMENT_QUEUE_NOT_STARTED "Not Running: Queue not started."
 #define COMMENT_QUEUE_NOT_EXEC    "Not Running: Queue not an execution queue."
@@ -172,5 +183,6 @@
 #define COMMENT_TOKEN_UTILIZATION "Not Running: Max token usage reached"
 #define COMMENT_SCHD_ERROR "Not Running: An internal scheduling error has occured"
 #define COMMENT_QUEUE_IGNORED "Not Running: Queue is configured to be ignored"
+#define COMMENT_BACKFILL_CONFLICT "Not Running: Job would delay a job with reserved resources"
 
 #endif
@@ -109,8 +109,16 @@ struct usage_info;
 
 struct token;
 
+struct run_count;
+
+struct calendar;
+
 typedef struct state_count state_count;
 
+typedef struct run_count run_count;
+
+typedef struct calendar calendar;
+
 typedef struct server_info server_info;
 
 typedef struct queue_info queue_info;
@@ -155,6 +163,17 @@ struct state_count
   int total;   /* total number of jobs in all states */
   };
 
+/* the number of running jobs a user or group has, kept in a hash table of
+ * RUN_COUNT_BUCKETS chains so limit checks don't scan the running jobs */
+
+struct run_count
+  {
+  char *name;   /* user or group name */
+  int count;   /* number of running jobs */
+
+  struct run_count *next; /* next entry in the bucket */
+  };
+
 struct server_info
   {
   char *name;   /* name of server */
@@ -173,6 +192,9 @@ struct server_info
   node_info **nodes;  /* array of nodes associated with the server */
   node_info **timesharing_nodes;/* array of timesharing nodes */
   token **tokens;               /* array of tokens */
+  run_count *user_run[RUN_COUNT_BUCKETS]; /* running jobs by user */
+  run_count *group_run[RUN_COUNT_BUCKETS]; /* running jobs by group */
+  calendar *cal;  /* when running jobs end, for backfilling */
   };
 
 struct queue_info
@@ -204,6 +226,8 @@ unsigned dedtime_queue:
   struct resource *qres; /* list of resources on the queue */
   job_info **jobs;  /* array of jobs that reside in queue */
   job_info **running_jobs; /* array of jobs in the running state */
+  run_count *user_run[RUN_COUNT_BUCKETS]; /* running jobs by user */
+  run_count *group_run[RUN_COUNT_BUCKETS]; /* running jobs by group */
   };
 
 struct job_info
@@ -292,6 +316,9 @@ unsigned is_timeshare:
 unsigned is_cluster:
   1; /* This node is a member of a cluster */
 
+unsigned has_mom_status:
+  1; /* resources came from the node's status */
+
   char *name;   /* name of the node */
   char **properties;  /* the node properties */
   char **jobs;   /* the jobs currently running on the node */
@@ -306,6 +333,27 @@ unsigned is_cluster:
   float loadave;  /* current load average */
   };
 
+/* a running job's walltime runs out at end, freeing its resources */
+
+struct cal_event
+  {
+  time_t end;   /* when the job ends */
+  job_info *job;  /* the running job */
+  };
+
+/* the availability profile of the server's resources over time */
+
+struct calendar
+  {
+  struct cal_event *events; /* running jobs, soonest to end first */
+  int num_events;  /* number of events */
+  int size;   /* number of events allocated */
+
+  /* per res_to_check resource: what is left at cstat.resv_start once the
+   * reserved job starts, or INFINITY_VAL if the resource isn't tracked */
+  sch_resource_t *spare;
+  };
+
 struct resource
   {
   char *name;   /* name of the resource */
@@ -460,6 +508,12 @@ unsigned prime_lbrr :
 unsigned non_prime_lbrr:
   1;
 
+unsigned prime_bf :
+  1; /* backfill around a reserved job */
+
+unsigned non_prime_bf :
+  1;
+
 
   struct sort_info *sort_by;  /* current sort */
 
@@ -481,6 +535,19 @@ unsigned non_prime_lbrr:
   char ded_prefix[PBS_MAXQUEUENAME +1]; /* prefix to dedicated queues */
   time_t max_starve;   /* starving threshold */
   char* ignored_queues[MAX_IGNORED_QUEUES]; /* list of ignored queues */
+  int mom_query_fanout;   /* moms queried at once */
+  time_t mom_query_timeout;  /* time to wait on a mom query */
+  };
+
+/* how long each phase of the last scheduling cycle took, in seconds */
+
+struct cycle_times
+  {
+  double query;   /* getting the server, queues, jobs and nodes */
+  double sort;   /* init_scheduling_cycle(): fair share, starvation, sorting */
+  double check;   /* picking jobs and checking if they can run */
+  double run;   /* running jobs and updating the cycle's state */
+  double total;   /* the whole cycle */
   };
 
 /* for description of these bits, check the PBS admin guide or scheduler IDS */
@@ -518,12 +585,19 @@ unsigned is_prime:
 unsigned is_ded_time:
   1;
 
+unsigned backfill:
+  1;
+
   struct sort_info *sort_by;
 
   time_t current_time;
 
   job_info *starving_job; /* the most starving job */
 
+  job_info *resv_job;  /* the job resources are reserved for */
+
+  time_t resv_start;  /* when resv_job will be able to start */
+
   };
 
 /* static data types */
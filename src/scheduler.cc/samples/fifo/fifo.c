@@ -104,6 +104,7 @@
 #include "prime.h"
 #include "dedtime.h"
 #include "token_acct.h"
+#include "backfill.h"
 #include "lib_ifl.h"
 
 
@@ -299,6 +300,18 @@ int init_scheduling_cycle(server_info *sinfo)
   if (cstat.help_starving_jobs)
     cstat.starving_job = update_starvation(sinfo -> jobs);
 
+  cstat.resv_job = NULL;
+
+  if (cstat.backfill)
+    {
+    if ((sinfo -> cal = new_calendar(sinfo)) == NULL)
+      return 0;
+
+    /* backfill around the starving job rather than draining for it */
+    if (cstat.starving_job != NULL)
+      reserve_job(sinfo, cstat.starving_job);
+    }
+
   /* sort queues by priority if requested */
 
   if (cstat.sort_queues)
@@ -455,6 +468,24 @@ int schedule(
 
 
 
+/*
+ *
+ * cycle_elapsed - seconds since a point in the scheduling cycle
+ *
+ *   since - the point, from clock_gettime(CLOCK_MONOTONIC)
+ *
+ * returns the seconds since then
+ *
+ */
+static double cycle_elapsed(struct timespec *since)
+  {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (now.tv_sec - since -> tv_sec) + (now.tv_nsec - since -> tv_nsec) / 1e9;
+  }
+
 /*
  *
  * scheduling_cycle - the controling function of the scheduling cycle
@@ -477,19 +508,33 @@ int scheduling_cycle(
   char log_msg[MAX_LOG_SIZE]; /* used to log an message about job */
   char comment[MAX_COMMENT_SIZE]; /* used to update comment of job */
 
+  struct timespec cycle_start; /* when the cycle started */
+
+  struct timespec phase_start; /* when the current phase started */
+
   sched_log(PBSEVENT_DEBUG2, PBS_EVENTCLASS_REQUEST, "", "Entering Schedule");
 
+  memset(&cycle_times, 0, sizeof(cycle_times));
+
+  clock_gettime(CLOCK_MONOTONIC, &cycle_start);
+
   update_cycle_status();
 
   /* create the server / queue / job / node structures */
 
-  if ((sinfo = query_server(sd)) == NULL)
+  sinfo = query_server(sd);
+
+  cycle_times.query = cycle_elapsed(&cycle_start);
+
+  if (sinfo == NULL)
     {
     fprintf(stderr, "Problem with creating server data strucutre\n");
 
     return(0);
     }
 
+  clock_gettime(CLOCK_MONOTONIC, &phase_start);
+
   if (init_scheduling_cycle(sinfo) == 0)
     {
     sched_log(
@@ -503,8 +548,12 @@ int scheduling_cycle(
     return(0);
     }
 
+  cycle_times.sort = cycle_elapsed(&phase_start);
+
   /* main scheduling loop */
 
+  clock_gettime(CLOCK_MONOTONIC, &phase_start);
+
   while ((jinfo = next_job(sinfo, 0)))
     {
     sched_log(
@@ -515,7 +564,13 @@ int scheduling_cycle(
 
     if ((ret = is_ok_to_run_job(sd, sinfo, jinfo->queue, jinfo)) == SUCCESS)
       {
+      struct timespec run_start;
+
+      clock_gettime(CLOCK_MONOTONIC, &run_start);
+
       run_update_job(sd, sinfo, jinfo->queue, jinfo);
+
+      cycle_times.run += cycle_elapsed(&run_start);
       }
     else
       {
@@ -548,6 +603,12 @@ int scheduling_cycle(
           }
         }
 
+      /* reserve resources for the first job that doesn't fit, and
+       * backfill the jobs behind it */
+      if (cstat.backfill && (ret >= 0) && (ret < num_res) &&
+          (reserve_job(sinfo, jinfo) != 0))
+        continue;
+
       if ((ret != NOT_QUEUED) && cstat.strict_fifo)
         {
         update_jobs_cant_run(
@@ -560,11 +621,20 @@ int scheduling_cycle(
       }
     }
 
+  cycle_times.check = cycle_elapsed(&phase_start) - cycle_times.run;
+
   if (cstat.fair_share)
     update_last_running(sinfo);
 
   free_server(sinfo, 1); /* free server and queues and jobs */
 
+  cycle_times.total = cycle_elapsed(&cycle_start);
+
+  snprintf(log_msg, sizeof(log_msg), "Cycle took %.3fs: query %.3fs sort %.3fs check %.3fs run %.3fs",
+           cycle_times.total, cycle_times.query, cycle_times.sort, cycle_times.check, cycle_times.run);
+
+  sched_log(PBSEVENT_DEBUG2, PBS_EVENTCLASS_REQUEST, "", log_msg);
+
   sched_log(PBSEVENT_DEBUG2, PBS_EVENTCLASS_REQUEST, "", "Leaving schedule\n");
 
   return 0;
@@ -716,6 +786,8 @@ int run_update_job(int pbs_sd, server_info *sinfo, queue_info *qinfo,
 
     update_job_on_run(pbs_sd, jinfo);
 
+    update_calendar_on_run(sinfo, jinfo);
+
     if (cstat.fair_share)
       update_usage_on_run(jinfo);
 
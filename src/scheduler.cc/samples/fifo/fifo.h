@@ -90,7 +90,7 @@ int schedinit(int argc, char *argv[]);
  *                 It will handle the difference cases that caused a
  *                 scheduling cycle
  */
-int schedule(int cmd, int sd);
+int schedule(int cmd);
 
 /*
  *      scheduling_cycle - the controling function of the scheduling cycle
@@ -164,3 +164,5 @@ const int num_resget = sizeof(res_to_get) / sizeof(char *);
 struct config conf;
 
 struct status cstat;
+
+struct cycle_times cycle_times;
@@ -97,6 +97,8 @@ extern struct config conf;
 
 extern struct status cstat;
 
+extern struct cycle_times cycle_times;
+
 extern const int num_sorts;
 extern const int num_res;
 extern const int num_resget;
@@ -119,6 +119,41 @@ job_info **query_jobs(int pbs_sd, queue_info *qinfo)
 
   struct batch_status *jobs;
 
+  /* array of internal scheduler structures for jobs */
+  job_info **jinfo_arr;
+
+  int local_errno = 0;
+
+  opl.value = qinfo -> name;
+
+  if ((jobs = pbs_selstat_err(pbs_sd, &opl, NULL, &local_errno)) == NULL)
+    {
+    if (local_errno > 0)
+      fprintf(stderr, "pbs_selstat failed: %d\n", local_errno);
+
+    return NULL;
+    }
+
+  jinfo_arr = jobs_from_status(jobs, qinfo);
+
+  pbs_statfree(jobs);
+
+  return jinfo_arr;
+  }
+
+/*
+ *
+ * jobs_from_status - create an array of jobs from a list of job statuses
+ *
+ *   jobs  - batch_status list of the jobs in the queue
+ *   qinfo - queue the jobs reside in
+ *
+ * returns pointer to the head of a list of jobs or NULL if there are no
+ * jobs or on error
+ *
+ */
+job_info **jobs_from_status(struct batch_status *jobs, queue_info *qinfo)
+  {
   /* current job in jobs linked list */
 
   struct batch_status *cur_job;
@@ -132,17 +167,9 @@ job_info **query_jobs(int pbs_sd, queue_info *qinfo)
   /* number of jobs in jinfo_arr */
   int num_jobs = 0;
   int i;
-  int local_errno = 0;
-
-  opl.value = qinfo -> name;
-
-  if ((jobs = pbs_selstat_err(pbs_sd, &opl, NULL, &local_errno)) == NULL)
-    {
-    if (local_errno > 0)
-      fprintf(stderr, "pbs_selstat failed: %d\n", local_errno);
 
+  if (jobs == NULL)
     return NULL;
-    }
 
   cur_job = jobs;
 
@@ -156,7 +183,6 @@ job_info **query_jobs(int pbs_sd, queue_info *qinfo)
   if ((jinfo_arr = (job_info **) malloc(sizeof(jinfo) * (num_jobs + 1))) == NULL)
     {
     perror("Memory allocation error");
-    pbs_statfree(jobs);
     return NULL;
     }
 
@@ -166,7 +192,7 @@ job_info **query_jobs(int pbs_sd, queue_info *qinfo)
     {
     if ((jinfo = query_job_info(cur_job, qinfo)) == NULL)
       {
-      pbs_statfree(jobs);
+      jinfo_arr[i] = NULL;
       free_jobs(jinfo_arr);
       return NULL;
       }
@@ -188,11 +214,105 @@ job_info **query_jobs(int pbs_sd, queue_info *qinfo)
 
   jinfo_arr[i] = NULL;
 
-  pbs_statfree(jobs);
-
   return jinfo_arr;
   }
 
+/*
+ *
+ * split_jobs_by_queue - hand out the jobs of a status snapshot to the
+ *         queues they reside in
+ *
+ *   jobs       - batch_status list of jobs, every entry is moved
+ *   queues     - batch_status list of queues
+ *   num_queues - number of queues in the list
+ *
+ * returns an array with the list of jobs of each queue, in the order of
+ * the queues and in the order the server sent the jobs, or NULL on error
+ * (jobs is freed either way).  Free it with free_jobs_by_queue().
+ *
+ */
+struct batch_status **split_jobs_by_queue(struct batch_status *jobs, struct batch_status *queues, int num_queues)
+  {
+  struct batch_status **queue_jobs;  /* jobs of each queue */
+  struct batch_status **tails;       /* last job of each queue */
+  struct batch_status *cur_queue;
+  struct batch_status *cur_job;
+  struct attrl *attrp;
+  int i;
+
+  queue_jobs = (struct batch_status **) calloc(num_queues + 1, sizeof(struct batch_status *));
+  tails = (struct batch_status **) calloc(num_queues + 1, sizeof(struct batch_status *));
+
+  if ((queue_jobs == NULL) || (tails == NULL))
+    {
+    perror("Memory allocation error");
+    free(queue_jobs);
+    free(tails);
+    pbs_statfree(jobs);
+    return NULL;
+    }
+
+  while (jobs != NULL)
+    {
+    cur_job = jobs;
+    jobs = jobs -> next;
+    cur_job -> next = NULL;
+
+    for (attrp = cur_job -> attribs; attrp != NULL; attrp = attrp -> next)
+      {
+      if (!strcmp(attrp -> name, ATTR_q))
+        break;
+      }
+
+    i = 0;
+
+    if (attrp != NULL)
+      {
+      for (cur_queue = queues; cur_queue != NULL; cur_queue = cur_queue -> next, i++)
+        {
+        if (!strcmp(cur_queue -> name, attrp -> value))
+          break;
+        }
+      }
+
+    if ((attrp == NULL) || (i >= num_queues))
+      {
+      /* not in a queue we know about */
+      pbs_statfree(cur_job);
+      continue;
+      }
+
+    if (tails[i] == NULL)
+      queue_jobs[i] = cur_job;
+    else
+      tails[i] -> next = cur_job;
+
+    tails[i] = cur_job;
+    }
+
+  free(tails);
+
+  return queue_jobs;
+  }
+
+/*
+ *
+ * free_jobs_by_queue - free the lists made by split_jobs_by_queue()
+ *
+ */
+void free_jobs_by_queue(struct batch_status **queue_jobs, int num_queues)
+  {
+  int i;
+
+  if (queue_jobs == NULL)
+    return;
+
+  for (i = 0; i < num_queues; i++)
+    pbs_statfree(queue_jobs[i]);
+
+  free(queue_jobs);
+  }
+
 /*
  *
  * query_job_info - takes info from a batch_status about a job and
@@ -914,6 +1034,11 @@ int translate_job_fail_code(int fail_code, char *comment_msg, char *log_msg)
         sprintf(log_msg, INFO_TOKEN_UTILIZATION);
         break;
 
+      case BACKFILL_CONFLICT:
+        strcpy(comment_msg, COMMENT_BACKFILL_CONFLICT);
+        snprintf(log_msg, MAX_LOG_SIZE, INFO_BACKFILL_CONFLICT, cstat.resv_job -> name);
+        break;
+
       default:
         rc = 0;
         comment_msg[0] = '\0';
@@ -88,6 +88,22 @@
  */
 job_info **query_jobs(int pbs_sd, queue_info *qinfo);
 
+/*
+ *      jobs_from_status - create an array of jobs from a list of job statuses
+ */
+job_info **jobs_from_status(struct batch_status *jobs, queue_info *qinfo);
+
+/*
+ *      split_jobs_by_queue - hand out the jobs of a status snapshot to the
+ *                            queues they reside in
+ */
+struct batch_status **split_jobs_by_queue(struct batch_status *jobs, struct batch_status *queues, int num_queues);
+
+/*
+ *      free_jobs_by_queue - free the lists made by split_jobs_by_queue()
+ */
+void free_jobs_by_queue(struct batch_status **queue_jobs, int num_queues);
+
 /*
  * query_job_info - takes info from a batch_status about a job and puts
  */
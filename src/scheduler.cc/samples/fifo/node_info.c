@@ -81,6 +81,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
 #include <sys/types.h>
 #include "pbs_ifl.h"
 #include "log.h"
@@ -90,10 +93,18 @@
 #include "globals.h"
 #include "lib_ifl.h"
 
+/* the load values a mom's status has to hold for it to stand in for a query */
+#define LOAD_FOUND_LOADAVE 0x1
+#define LOAD_FOUND_MAX     0x2
+#define LOAD_FOUND_IDEAL   0x4
+#define LOAD_FOUND_ALL     (LOAD_FOUND_LOADAVE | LOAD_FOUND_MAX | LOAD_FOUND_IDEAL)
+
 
 
 /* Internal functions */
 int set_node_type(node_info *ninfo, char *ntype);
+void set_node_load_defaults(node_info *ninfo);
+void query_moms(node_info **window, int count);
 
 
 /*
@@ -109,14 +120,9 @@ node_info **query_nodes(int pbs_sd, server_info *sinfo)
   {
 
   struct batch_status *nodes;  /* nodes returned from the server */
-
-  struct batch_status *cur_node; /* used to cycle through nodes */
   node_info **ninfo_arr;  /* array of nodes for scheduler's use */
-  node_info *ninfo;   /* used to set up a node */
   char errbuf[256];
   char *err;    /* used with pbs_geterrmsg() */
-  int num_nodes = 0;   /* the number of nodes */
-  int i;
   int local_errno;
 
   if ((nodes = pbs_statnode_err(pbs_sd, NULL, NULL, NULL, &local_errno)) == NULL)
@@ -127,6 +133,34 @@ node_info **query_nodes(int pbs_sd, server_info *sinfo)
     return NULL;
     }
 
+  ninfo_arr = nodes_from_status(nodes, sinfo);
+
+  pbs_statfree(nodes);
+  return ninfo_arr;
+  }
+
+/*
+ *      nodes_from_status - create the node array from a list of node
+ *                          statuses
+ *
+ *   nodes - batch_status list of the nodes
+ *   sinfo - server information
+ *
+ * returns array of nodes associated with server
+ *
+ */
+node_info **nodes_from_status(struct batch_status *nodes, server_info *sinfo)
+  {
+
+  struct batch_status *cur_node; /* used to cycle through nodes */
+  node_info **ninfo_arr;  /* array of nodes for scheduler's use */
+  node_info *ninfo;   /* used to set up a node */
+  int num_nodes = 0;   /* the number of nodes */
+  int i;
+
+  if (nodes == NULL)
+    return NULL;
+
   cur_node = nodes;
 
   while (cur_node != NULL)
@@ -138,7 +172,6 @@ node_info **query_nodes(int pbs_sd, server_info *sinfo)
   if ((ninfo_arr = (node_info **) malloc((num_nodes + 1) * sizeof(node_info *))) == NULL)
     {
     perror("Error Allocating Memory");
-    pbs_statfree(nodes);
     return NULL;
     }
 
@@ -148,14 +181,11 @@ node_info **query_nodes(int pbs_sd, server_info *sinfo)
     {
     if ((ninfo = query_node_info(cur_node, sinfo)) == NULL)
       {
-      pbs_statfree(nodes);
+      ninfo_arr[i] = NULL;
       free_nodes(ninfo_arr);
       return NULL;
       }
 
-    /* query mom on the node for resources */
-    talk_with_mom(ninfo);
-
     ninfo_arr[i] = ninfo;
 
     cur_node = cur_node -> next;
@@ -163,8 +193,10 @@ node_info **query_nodes(int pbs_sd, server_info *sinfo)
 
   ninfo_arr[i] = NULL;
 
+  /* query the moms whose status didn't have their resources */
+  talk_with_moms(ninfo_arr);
+
   sinfo -> num_nodes = num_nodes;
-  pbs_statfree(nodes);
   return ninfo_arr;
   }
 
@@ -211,6 +243,10 @@ node_info *query_node_info(struct batch_status *node, server_info *sinfo)
     else if (!strcmp(attrp -> name, ATTR_NODE_ntype))
       set_node_type(ninfo, attrp -> value);
 
+    /* the resources the node's mom last reported */
+    else if (!strcmp(attrp -> name, ATTR_NODE_status))
+      set_node_mom_status(ninfo, attrp -> value);
+
     attrp = attrp -> next;
     }
 
@@ -244,6 +280,7 @@ node_info *new_node_info()
   new_node_info -> is_sharing = 0;
   new_node_info -> is_timeshare = 0;
   new_node_info -> is_cluster = 0;
+  new_node_info -> has_mom_status = 0;
 
   new_node_info -> name = NULL;
   new_node_info -> properties = NULL;
@@ -403,107 +440,368 @@ int set_node_state(node_info *ninfo, char *state)
 
 /*
  *
- *      talk_with_mom - talk to mom and get resources
+ *      set_node_resource - set one of the res_to_get resources of a node
  *
- *   ninfo - the node to to talk to its mom
+ *   ninfo - the node
+ *   name  - the name of the resource
+ *   value - its value, as "value" or "name=value"
  *
- * returns non-zero on error
+ * returns non-zero if the resource is unknown
  *
  */
+int set_node_resource(
 
-int talk_with_mom(
-
-  node_info *ninfo)
+  node_info  *ninfo,
+  const char *name,
+  char       *value)
 
   {
-  int mom_sd;   /* connection descriptor to mom */
-  char *mom_ans;  /* the answer from mom - getreq() */
   char *endp;   /* used with strtol() */
+  char *eq;
   double testd;   /* used to convert string -> double */
   int testi;   /* used to convert string -> int */
+
+  /* moms answer in full "name=value" form unless asked not to */
+  if (((eq = strchr(value, '=')) != NULL) &&
+      (!strncmp(value, name, eq - value)) &&
+      (name[eq - value] == '\0'))
+    value = eq + 1;
+
+  if ((!strcmp(name, "max_load")) ||
+      (!strcmp(name, "ideal_load")))
+    {
+    testd = strtod(value, &endp);
+
+    /* left unset, the thresholds default to ncpus in set_node_load_defaults() */
+    if ((*value == '\0') || (*endp != '\0'))
+      testd = 0.0;
+
+    if (!strcmp(name, "max_load"))
+      ninfo -> max_load = testd;
+    else
+      ninfo -> ideal_load = testd;
+    }
+  else if (!strcmp(name, "arch"))
+    {
+    if (ninfo -> arch != NULL)
+      free(ninfo -> arch);
+
+    ninfo -> arch = string_dup(value);
+    }
+  else if (!strcmp(name, "ncpus"))
+    {
+    testi = strtol(value, &endp, 10);
+
+    if ((*value != '\0') && (*endp == '\0'))
+      ninfo -> ncpus = testi;
+    else
+      ninfo -> ncpus = 1;
+    }
+  else if (!strcmp(name, "physmem"))
+    ninfo -> physmem = res_to_num(value);
+  else if (!strcmp(name, "loadave"))
+    {
+    testd = strtod(value, &endp);
+
+    if ((*value != '\0') && (*endp == '\0'))
+      ninfo -> loadave = testd;
+    else
+      ninfo -> loadave = -1.0;
+    }
+  else
+    return 1;
+
+  return 0;
+  }
+
+/*
+ *
+ *      set_node_load_defaults - default the load thresholds a mom didn't
+ *                               report to the node's number of cpus
+ *
+ *   ninfo - the node
+ *
+ */
+void set_node_load_defaults(
+
+  node_info *ninfo)
+
+  {
+  if (ninfo -> max_load <= 0.0)
+    ninfo -> max_load = ninfo -> ncpus;
+
+  if (ninfo -> ideal_load <= 0.0)
+    ninfo -> ideal_load = ninfo -> ncpus;
+  }
+
+/*
+ *
+ *      set_node_mom_status - take a node's resources from the status its mom
+ *                            last reported to the server
+ *
+ *   ninfo  - the node
+ *   status - the node's status attribute, "name=value,name=value,..."
+ *
+ * returns non-zero on error
+ *
+ */
+int set_node_mom_status(
+
+  node_info  *ninfo,
+  const char *status)
+
+  {
+  char *status_copy;
+  char *tok;
+  char *eq;
+  int i;
+  int load_found = 0; /* LOAD_FOUND_* bits of the load values the mom reported */
+
+  if ((status_copy = string_dup((char *)status)) == NULL)
+    return 1;
+
+  for (tok = strtok(status_copy, ","); tok != NULL; tok = strtok(NULL, ","))
+    {
+    if ((eq = strchr(tok, '=')) == NULL)
+      continue;
+
+    *eq = '\0';
+
+    for (i = 0; i < num_resget; i++)
+      {
+      if (!strcmp(tok, res_to_get[i]))
+        {
+        set_node_resource(ninfo, res_to_get[i], eq + 1);
+
+        if (!strcmp(tok, "loadave"))
+          load_found |= LOAD_FOUND_LOADAVE;
+        else if (!strcmp(tok, "max_load"))
+          load_found |= LOAD_FOUND_MAX;
+        else if (!strcmp(tok, "ideal_load"))
+          load_found |= LOAD_FOUND_IDEAL;
+
+        break;
+        }
+      }
+    }
+
+  free(status_copy);
+
+  /* without all of the load values the mom still has to be asked directly */
+  if (load_found == LOAD_FOUND_ALL)
+    {
+    ninfo -> has_mom_status = 1;
+    set_node_load_defaults(ninfo);
+    }
+
+  return 0;
+  }
+
+/*
+ *
+ *      query_moms - ask a window of moms for resources at once
+ *
+ *   window - the nodes whose moms to ask
+ *   count  - the number of nodes in window
+ *
+ * The requests are all sent before any answer is read, so a slow mom only
+ * holds up the others until conf.mom_query_timeout runs out.
+ *
+ */
+void query_moms(
+
+  node_info **window,
+  int         count)
+
+  {
+  int *mom_sds;   /* connection descriptors to the moms */
+  struct pollfd *pfds;
+  int *pfd_node;   /* which node each pollfd belongs to */
+  char *mom_ans;  /* the answer from mom - getreq() */
   char errbuf[256];
+  int pending = 0;
+  int npfds;
+  int rc;
   int i;
+  int j;
   int local_errno = 0;
+  time_t deadline;
+  time_t now;
 
-  if ((ninfo != NULL) && !ninfo->is_down && !ninfo->is_offline)
+  mom_sds = (int *)calloc(count, sizeof(int));
+  pfds = (struct pollfd *)calloc(count, sizeof(struct pollfd));
+  pfd_node = (int *)calloc(count, sizeof(int));
+
+  if ((mom_sds == NULL) || (pfds == NULL) || (pfd_node == NULL))
+    {
+    perror("Memory Allocation Error");
+    free(mom_sds);
+    free(pfds);
+    free(pfd_node);
+    return;
+    }
+
+  for (i = 0; i < count; i++)
     {
-    if ((mom_sd = openrm(ninfo -> name, pbs_rm_port)) < 0)
+    if ((mom_sds[i] = openrm(window[i] -> name, pbs_rm_port)) < 0)
       {
-      sched_log(PBSEVENT_SYSTEM, PBS_EVENTCLASS_REQUEST, ninfo -> name, "Can not open connection to mom");
-      return 1;
+      sched_log(PBSEVENT_SYSTEM, PBS_EVENTCLASS_REQUEST, window[i] -> name, "Can not open connection to mom");
+      mom_sds[i] = -1;
+      continue;
       }
 
-    if(begin_rm_req(mom_sd,&local_errno,num_resget) != 0)
+    if (begin_rm_req(mom_sds[i], &local_errno, num_resget) != 0)
       {
-      closerm_err(&local_errno, mom_sd);
-      return 0;
+      closerm_err(&local_errno, mom_sds[i]);
+      mom_sds[i] = -1;
+      continue;
       }
-    for (i = 0; i < num_resget; i++)
-      addreq_err(mom_sd, &local_errno, (char *) res_to_get[i]);
 
-    for (i = 0; i < num_resget && (mom_ans = getreq_err(&local_errno, (mom_sd))) != NULL; i++)
+    for (j = 0; j < num_resget; j++)
       {
-      if (!strcmp(res_to_get[i], "max_load"))
+      /* a failed request closes the stream */
+      if (addreq_err(mom_sds[i], &local_errno, (char *) res_to_get[j]) != 0)
         {
-        testd = strtod(mom_ans, &endp);
+        mom_sds[i] = -1;
+        break;
+        }
+      }
 
-        if (*endp == '\0')
-          ninfo -> max_load = testd;
-        else
-          ninfo -> max_load = ninfo -> ncpus;
+    if (mom_sds[i] >= 0)
+      pending++;
+    }
 
-        free(mom_ans);
-        }
-      else if (!strcmp(res_to_get[i], "ideal_load"))
-        {
-        testd = strtod(mom_ans, &endp);
+  /* send every request before waiting on any answer */
+  flushreq();
 
-        if (*endp == '\0')
-          ninfo -> ideal_load = testd;
-        else
-          ninfo -> ideal_load = ninfo -> ncpus;
+  deadline = time(NULL) + conf.mom_query_timeout;
 
-        free(mom_ans);
-        }
-      else if (!strcmp(res_to_get[i], "arch"))
-        ninfo -> arch = mom_ans;
-      else if (!strcmp(res_to_get[i], "ncpus"))
-        {
-        testi = strtol(mom_ans, &endp, 10);
+  while (pending > 0)
+    {
+    now = time(NULL);
 
-        if (*endp == '\0')
-          ninfo -> ncpus = testi;
-        else
-          ninfo -> ncpus = 1;
+    if (now >= deadline)
+      break;
 
-        free(mom_ans);
-        }
-      else if (!strcmp(res_to_get[i], "physmem"))
+    npfds = 0;
+
+    for (i = 0; i < count; i++)
+      {
+      if (mom_sds[i] < 0)
+        continue;
+
+      pfds[npfds].fd = mom_sds[i];
+      pfds[npfds].events = POLLIN;
+      pfds[npfds].revents = 0;
+      pfd_node[npfds] = i;
+      npfds++;
+      }
+
+    rc = poll(pfds, npfds, (deadline - now) * 1000);
+
+    if (rc < 0)
+      {
+      if (errno == EINTR)
+        continue;
+
+      break;
+      }
+
+    if (rc == 0)
+      break;
+
+    for (j = 0; j < npfds; j++)
+      {
+      if (pfds[j].revents == 0)
+        continue;
+
+      i = pfd_node[j];
+
+      for (rc = 0; rc < num_resget && (mom_ans = getreq_err(&local_errno, mom_sds[i])) != NULL; rc++)
         {
-        ninfo -> physmem = res_to_num(mom_ans);
+        if (set_node_resource(window[i], res_to_get[rc], mom_ans) != 0)
+          {
+          sprintf(errbuf, "Unknown resource value[%d]: %s", rc, mom_ans);
+          sched_log(PBSEVENT_SCHED, PBS_EVENTCLASS_NODE, window[i] -> name, errbuf);
+          }
+
         free(mom_ans);
         }
-      else if (!strcmp(res_to_get[i], "loadave"))
-        {
-        testd = strtod(mom_ans, &endp);
 
-        if (*endp == '\0')
-          ninfo -> loadave = testd;
-        else
-          ninfo -> loadave = -1.0;
+      set_node_load_defaults(window[i]);
 
-        free(mom_ans);
-        }
-      else
-        {
-        sprintf(errbuf, "Unknown resource value[%d]: %s", i, mom_ans);
-        sched_log(PBSEVENT_SCHED, PBS_EVENTCLASS_NODE, ninfo -> name, errbuf);
-        }
+      closerm_err(&local_errno, mom_sds[i]);
+      mom_sds[i] = -1;
+      pending--;
       }
+    }
+
+  for (i = 0; i < count; i++)
+    {
+    if (mom_sds[i] < 0)
+      continue;
+
+    sched_log(PBSEVENT_SYSTEM, PBS_EVENTCLASS_REQUEST, window[i] -> name, "Timed out waiting on mom");
+    closerm_err(&local_errno, mom_sds[i]);
+    }
+
+  free(mom_sds);
+  free(pfds);
+  free(pfd_node);
+  }
+
+/*
+ *
+ *      talk_with_moms - get resources from the moms of the nodes whose
+ *                       status didn't have them
+ *
+ *   ninfo_arr - the nodes
+ *
+ * Moms report their resources in their node's status, so this is only
+ * needed for moms that haven't reported yet or are too old to report
+ * max_load and ideal_load.  They are asked conf.mom_query_fanout at a time.
+ *
+ * returns non-zero on error
+ *
+ */
+
+int talk_with_moms(
+
+  node_info **ninfo_arr)
+
+  {
+  node_info **to_query;
+  int num_nodes;
+  int num_query = 0;
+  int fanout;
+  int i;
+
+  if (ninfo_arr == NULL)
+    return 0;
+
+  for (num_nodes = 0; ninfo_arr[num_nodes] != NULL; num_nodes++);
+
+  if ((to_query = (node_info **)malloc((num_nodes + 1) * sizeof(node_info *))) == NULL)
+    {
+    perror("Memory Allocation Error");
+    return 1;
+    }
 
-    closerm_err(&local_errno, mom_sd);
+  for (i = 0; i < num_nodes; i++)
+    {
+    if (!ninfo_arr[i] -> has_mom_status &&
+        !ninfo_arr[i] -> is_down &&
+        !ninfo_arr[i] -> is_offline)
+      to_query[num_query++] = ninfo_arr[i];
     }
 
+  fanout = (conf.mom_query_fanout > 0) ? conf.mom_query_fanout : DEFAULT_MOM_QUERY_FANOUT;
+
+  for (i = 0; i < num_query; i += fanout)
+    query_moms(to_query + i, (num_query - i < fanout) ? num_query - i : fanout);
+
+  free(to_query);
+
   return 0;
   }
 
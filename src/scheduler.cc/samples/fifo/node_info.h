@@ -88,6 +88,12 @@
  */
 node_info **query_nodes(int pbs_sd, server_info *sinfo);
 
+/*
+ *      nodes_from_status - create the node array from a list of node
+ *                          statuses
+ */
+node_info **nodes_from_status(struct batch_status *nodes, server_info *sinfo);
+
 /*
  *      query_node_info - collect information from a batch_status and
  *                        put it in a node_info struct for easier access
@@ -116,9 +122,21 @@ void free_node_info(node_info *ninfo);
 int set_node_state(node_info *ninfo, char *state);
 
 /*
- *      talk_with_mom - talk to mom and get resources
+ *      set_node_resource - set one of the res_to_get resources of a node
+ */
+int set_node_resource(node_info *ninfo, const char *name, char *value);
+
+/*
+ *      set_node_mom_status - take a node's resources from the status its mom
+ *                            last reported to the server
+ */
+int set_node_mom_status(node_info *ninfo, const char *status);
+
+/*
+ *      talk_with_moms - get resources from the moms of the nodes whose
+ *                       status didn't have them
  */
-int talk_with_mom(node_info *ninfo);
+int talk_with_moms(node_info **ninfo_arr);
 
 /*
  *      node_filter - filter a node array and return a new filterd array
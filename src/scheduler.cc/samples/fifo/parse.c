@@ -234,6 +234,14 @@ int parse_config(const char *fname)
           if (prime == NON_PRIME || prime == ALL)
             conf.non_prime_hsv = num ? 1 : 0;
           }
+        else if (!strcmp(config_name, PARSE_BACKFILL))
+          {
+          if (prime == PRIME || prime == ALL)
+            conf.prime_bf = num ? 1 : 0;
+
+          if (prime == NON_PRIME || prime == ALL)
+            conf.non_prime_bf = num ? 1 : 0;
+          }
         else if (!strcmp(config_name, PARSE_SORT_QUEUES))
           {
           if (prime == PRIME || prime == ALL)
@@ -260,6 +268,20 @@ int parse_config(const char *fname)
           conf.unknown_shares = num;
         else if (!strcmp(config_name, PARSE_LOG_FILTER))
           conf.log_filter = num;
+        else if (!strcmp(config_name, PARSE_MOM_QUERY_FANOUT))
+          {
+          if (num < 1)
+            error = 1;
+          else
+            conf.mom_query_fanout = num;
+          }
+        else if (!strcmp(config_name, PARSE_MOM_QUERY_TIMEOUT))
+          {
+          if (res_to_num(config_value) < 1)
+            error = 1;
+          else
+            conf.mom_query_timeout = res_to_num(config_value);
+          }
         else if (!strcmp(config_name, PARSE_DEDICATED_PREFIX))
           {
           if (strlen(config_value) > PBS_MAXQUEUENAME)
@@ -361,6 +383,9 @@ init_config(void)
   memset(&conf, 0, sizeof(struct config));
   memset(&cstat, 0, sizeof(struct status));
 
+  conf.mom_query_fanout = DEFAULT_MOM_QUERY_FANOUT;
+  conf.mom_query_timeout = DEFAULT_MOM_QUERY_TIMEOUT;
+
   if ((conf.prime_sort = (struct sort_info *)malloc((num_sorts + 1) * sizeof(struct sort_info)))
       == NULL)
     {
@@ -515,6 +515,7 @@ init_prime_time(void)
   cstat.help_starving_jobs = conf.prime_hsv;
   cstat.sort_queues = conf.prime_sq;
   cstat.load_balancing_rr = conf.prime_lbrr;
+  cstat.backfill = conf.prime_bf;
   }
 
 /*
@@ -538,4 +539,5 @@ init_non_prime_time(void)
   cstat.help_starving_jobs = conf.non_prime_hsv;
   cstat.sort_queues = conf.non_prime_sq;
   cstat.load_balancing_rr = conf.non_prime_lbrr;
+  cstat.backfill = conf.non_prime_bf;
   }
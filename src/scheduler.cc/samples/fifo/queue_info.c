@@ -89,6 +89,7 @@
 #include "check.h"
 #include "config.h"
 #include "globals.h"
+#include "state_count.h"
 #include "lib_ifl.h"
 
 /*
@@ -108,6 +109,43 @@ queue_info **query_queues(int pbs_sd, server_info *sinfo)
 
   struct batch_status *queues;
 
+  /* array of pointers to internal scheduling structure for queues */
+  queue_info **qinfo_arr;
+
+  int local_errno = 0;
+
+  /* get queue info from PBS server */
+
+  if ((queues = pbs_statque_err(pbs_sd, NULL, NULL, NULL, &local_errno)) == NULL)
+    {
+    fprintf(stderr, "Statque failed: %d\n", local_errno);
+    return NULL;
+    }
+
+  qinfo_arr = queues_from_status(pbs_sd, queues, NULL, sinfo);
+
+  pbs_statfree(queues);
+
+  return qinfo_arr;
+  }
+
+/*
+ *
+ * queues_from_status - creates an array of queue_info structs from a list
+ *   of queue statuses
+ *
+ *   pbs_sd     - connection to the pbs_server
+ *   queues     - batch_status list of the queues
+ *   queue_jobs - the job statuses of each queue, in the order of queues
+ *                (see split_jobs_by_queue()), or NULL to query the jobs
+ *                of each queue from the server
+ *   sinfo      - server the queues belong to
+ *
+ * returns pointer to the head of the queue structure
+ *
+ */
+queue_info **queues_from_status(int pbs_sd, struct batch_status *queues, struct batch_status **queue_jobs, server_info *sinfo)
+  {
   /* the current queue in the linked list of queues */
 
   struct batch_status *cur_queue;
@@ -132,15 +170,9 @@ queue_info **query_queues(int pbs_sd, server_info *sinfo)
 
   int i;
   int num_queues = 0;
-  int local_errno = 0;
 
-  /* get queue info from PBS server */
-
-  if ((queues = pbs_statque_err(pbs_sd, NULL, NULL, NULL, &local_errno)) == NULL)
-    {
-    fprintf(stderr, "Statque failed: %d\n", local_errno);
+  if (queues == NULL)
     return NULL;
-    }
 
   cur_queue = queues;
 
@@ -153,7 +185,6 @@ queue_info **query_queues(int pbs_sd, server_info *sinfo)
   if ((qinfo_arr = (queue_info **) malloc(sizeof(queue_info *) * (num_queues + 1))) == NULL)
     {
     perror("Memory Allocation error");
-    pbs_statfree(queues);
     return NULL;
     }
 
@@ -164,13 +195,16 @@ queue_info **query_queues(int pbs_sd, server_info *sinfo)
     /* convert queue information from batch_status to queue_info */
     if ((qinfo = query_queue_info(cur_queue, sinfo)) == NULL)
       {
-      pbs_statfree(queues);
+      qinfo_arr[i] = NULL;
       free_queues(qinfo_arr, 1);
       return NULL;
       }
 
     /* get all the jobs which reside in the queue */
-    qinfo -> jobs = query_jobs(pbs_sd, qinfo);
+    if (queue_jobs != NULL)
+      qinfo -> jobs = jobs_from_status(queue_jobs[i], qinfo);
+    else
+      qinfo -> jobs = query_jobs(pbs_sd, qinfo);
 
     /* check if the queue is a dedicated time queue */
     if (conf.ded_prefix[0] != '\0')
@@ -194,6 +228,8 @@ queue_info **query_queues(int pbs_sd, server_info *sinfo)
 
     qinfo -> running_jobs = job_filter(qinfo -> jobs, qinfo -> sc.total, check_run_job, NULL);
 
+    count_running(qinfo -> running_jobs, qinfo -> user_run, qinfo -> group_run);
+
     res = qinfo -> qres;
 
     while (res != NULL)
@@ -211,8 +247,6 @@ queue_info **query_queues(int pbs_sd, server_info *sinfo)
 
   qinfo_arr[i] = NULL;
 
-  pbs_statfree(queues);
-
   return qinfo_arr;
   }
 
@@ -372,6 +406,10 @@ queue_info *new_queue_info()
 
   init_state_count(&(qinfo -> sc));
 
+  init_run_counts(qinfo -> user_run);
+
+  init_run_counts(qinfo -> group_run);
+
   qinfo -> max_run  = INFINITY_VAL;
 
   qinfo -> max_user_run  = INFINITY_VAL;
@@ -487,6 +525,9 @@ void update_queue_on_run(queue_info *qinfo, job_info *jinfo)
   qinfo -> sc.running++;
   qinfo -> sc.queued--;
 
+  add_run_count(qinfo -> user_run, jinfo -> account, 1);
+  add_run_count(qinfo -> group_run, jinfo -> group, 1);
+
   resreq = jinfo -> resreq;
 
   while (resreq != NULL)
@@ -521,6 +562,10 @@ void free_queue_info(queue_info *qinfo)
   if (qinfo -> running_jobs != NULL)
     free(qinfo -> running_jobs);
 
+  free_run_counts(qinfo -> user_run);
+
+  free_run_counts(qinfo -> group_run);
+
   free(qinfo);
   }
 
@@ -91,6 +91,13 @@
  */
 queue_info **query_queues(int pbs_sd, server_info *sinfo);
 
+/*
+ *
+ *      queues_from_status - creates an array of queue_info structs from a
+ *                           list of queue statuses
+ */
+queue_info **queues_from_status(int pbs_sd, struct batch_status *queues, struct batch_status **queue_jobs, server_info *sinfo);
+
 /*
  *      query_queue_info - collects information from a batch_status and
  *                         puts it in a queue_info struct for easier access
@@ -82,6 +82,7 @@
 #include <string.h>
 #include "pbs_ifl.h"
 #include "pbs_error.h"
+#include "log.h"
 #include "server_info.h"
 #include "constant.h"
 #include "queue_info.h"
@@ -89,54 +90,192 @@
 #include "misc.h"
 #include "config.h"
 #include "node_info.h"
+#include "backfill.h"
 #include "lib_ifl.h"
 
 
+/* the attributes query_server_info(), query_queue_info(), query_job_info()
+ * and query_node_info() look at, asked for in a status snapshot.  Jobs also
+ * report their queue so they can be handed out to the queues. */
+
+static struct attrl svr_snapshot_attrs[] =
+  {
+  { &svr_snapshot_attrs[1], (char *)ATTR_dfltque, NULL, NULL, SET },
+  { &svr_snapshot_attrs[2], (char *)ATTR_maxrun, NULL, NULL, SET },
+  { &svr_snapshot_attrs[3], (char *)ATTR_maxuserrun, NULL, NULL, SET },
+  { &svr_snapshot_attrs[4], (char *)ATTR_maxgrprun, NULL, NULL, SET },
+  { &svr_snapshot_attrs[5], (char *)ATTR_rescavail, NULL, NULL, SET },
+  { &svr_snapshot_attrs[6], (char *)ATTR_rescmax, NULL, NULL, SET },
+  { &svr_snapshot_attrs[7], (char *)ATTR_rescassn, NULL, NULL, SET },
+  { NULL, (char *)ATTR_tokens, NULL, NULL, SET }
+  };
+
+static struct attrl que_snapshot_attrs[] =
+  {
+  { &que_snapshot_attrs[1], (char *)ATTR_start, NULL, NULL, SET },
+  { &que_snapshot_attrs[2], (char *)ATTR_maxrun, NULL, NULL, SET },
+  { &que_snapshot_attrs[3], (char *)ATTR_maxuserrun, NULL, NULL, SET },
+  { &que_snapshot_attrs[4], (char *)ATTR_maxgrprun, NULL, NULL, SET },
+  { &que_snapshot_attrs[5], (char *)ATTR_p, NULL, NULL, SET },
+  { &que_snapshot_attrs[6], (char *)ATTR_qtype, NULL, NULL, SET },
+  { &que_snapshot_attrs[7], (char *)ATTR_rescavail, NULL, NULL, SET },
+  { &que_snapshot_attrs[8], (char *)ATTR_rescmax, NULL, NULL, SET },
+  { NULL, (char *)ATTR_rescassn, NULL, NULL, SET }
+  };
+
+static struct attrl job_snapshot_attrs[] =
+  {
+  { &job_snapshot_attrs[1], (char *)ATTR_q, NULL, NULL, SET },
+  { &job_snapshot_attrs[2], (char *)ATTR_p, NULL, NULL, SET },
+  { &job_snapshot_attrs[3], (char *)ATTR_qtime, NULL, NULL, SET },
+  { &job_snapshot_attrs[4], (char *)ATTR_state, NULL, NULL, SET },
+  { &job_snapshot_attrs[5], (char *)ATTR_comment, NULL, NULL, SET },
+  { &job_snapshot_attrs[6], (char *)ATTR_euser, NULL, NULL, SET },
+  { &job_snapshot_attrs[7], (char *)ATTR_egroup, NULL, NULL, SET },
+  { &job_snapshot_attrs[8], (char *)ATTR_exechost, NULL, NULL, SET },
+  { &job_snapshot_attrs[9], (char *)ATTR_l, NULL, NULL, SET },
+  { NULL, (char *)ATTR_used, NULL, NULL, SET }
+  };
+
+static struct attrl node_snapshot_attrs[] =
+  {
+  { &node_snapshot_attrs[1], (char *)ATTR_NODE_state, NULL, NULL, SET },
+  { &node_snapshot_attrs[2], (char *)ATTR_NODE_properties, NULL, NULL, SET },
+  { &node_snapshot_attrs[3], (char *)ATTR_NODE_jobs, NULL, NULL, SET },
+  { &node_snapshot_attrs[4], (char *)ATTR_NODE_ntype, NULL, NULL, SET },
+  { NULL, (char *)ATTR_NODE_status, NULL, NULL, SET }
+  };
+
+/* cleared once the server turns down a status snapshot */
+static int use_snapshot = 1;
+
 /*
  *
- * query_server - creates a structure of arrays consisting of a server
- *   and all the queues and jobs that reside in that server
+ * query_server_snapshot - get the server, its queues, jobs and nodes
+ *    from a single status snapshot request
  *
  *   pbs_sd - connection to pbs_server
  *
- * returns a pointer to the server_info struct
+ * returns a pointer to the server_info struct with its nodes and queues
  *
  */
-server_info *query_server(int pbs_sd)
+static server_info *query_server_snapshot(int pbs_sd)
   {
 
-  struct batch_status *server; /* info about the server */
+  struct batch_snapshot snap; /* everything the server sent */
+
+  struct batch_status **queue_jobs; /* jobs of each queue */
+
+  struct batch_status *cur_queue;
   server_info *sinfo;  /* scheduler internal form of server info */
-  queue_info **qinfo;  /* array of queues on the server */
-  resource *res;  /* ptr to cycle through sources on server */
+  int       num_queues = 0;
   int       local_errno = 0;
 
-  /* get server information from pbs server */
-
-  if ((server = pbs_statserver_err(pbs_sd, NULL, NULL, &local_errno)) == NULL)
+  if (pbs_statsnapshot_err(pbs_sd, svr_snapshot_attrs, que_snapshot_attrs,
+        job_snapshot_attrs, node_snapshot_attrs, NULL, &snap, &local_errno) != PBSE_NONE)
     {
-    fprintf(stderr, "pbs_statserver failed: %d\n", local_errno);
+    fprintf(stderr, "pbs_statsnapshot failed: %d\n", local_errno);
+
+    if (local_errno == PBSE_UNKREQ)
+      {
+      /* the server predates the request and may have dropped the connection
+       * over it, so fall back to the per object requests from the next cycle on */
+      use_snapshot = 0;
+
+      sched_log(PBSEVENT_SCHED, PBS_EVENTCLASS_SERVER, "",
+        "server does not support status snapshots, querying objects one at a time");
+      }
+
     return NULL;
     }
 
   /* convert batch_status structure into server_info structure */
-  if ((sinfo = query_server_info(server)) == NULL)
+  if ((snap.server == NULL) ||
+      ((sinfo = query_server_info(snap.server)) == NULL))
     {
-    pbs_statfree(server);
+    pbs_freesnapshot(&snap);
     return NULL;
     }
 
-  /* get the nodes, if any */
-  sinfo -> nodes = query_nodes(pbs_sd, sinfo);
+  for (cur_queue = snap.queues; cur_queue != NULL; cur_queue = cur_queue -> next)
+    num_queues++;
+
+  /* the nodes, if any */
+  sinfo -> nodes = nodes_from_status(snap.nodes, sinfo);
+
+  /* the queues and the jobs in them */
+  queue_jobs = split_jobs_by_queue(snap.jobs, snap.queues, num_queues);
+  snap.jobs = NULL;
 
-  /* get the queues */
-  if ((sinfo -> queues = query_queues(pbs_sd, sinfo)) == NULL)
+  if ((queue_jobs == NULL) ||
+      ((sinfo -> queues = queues_from_status(pbs_sd, snap.queues, queue_jobs, sinfo)) == NULL))
     {
-    pbs_statfree(server);
+    free_jobs_by_queue(queue_jobs, num_queues);
+    pbs_freesnapshot(&snap);
     free_server(sinfo, 0);
     return NULL;
     }
 
+  free_jobs_by_queue(queue_jobs, num_queues);
+  pbs_freesnapshot(&snap);
+
+  return sinfo;
+  }
+
+/*
+ *
+ * query_server - creates a structure of arrays consisting of a server
+ *   and all the queues and jobs that reside in that server
+ *
+ *   pbs_sd - connection to pbs_server
+ *
+ * returns a pointer to the server_info struct
+ *
+ */
+server_info *query_server(int pbs_sd)
+  {
+
+  struct batch_status *server; /* info about the server */
+  server_info *sinfo;  /* scheduler internal form of server info */
+  queue_info **qinfo;  /* array of queues on the server */
+  resource *res;  /* ptr to cycle through sources on server */
+  int       local_errno = 0;
+
+  if (use_snapshot)
+    {
+    if ((sinfo = query_server_snapshot(pbs_sd)) == NULL)
+      return NULL;
+    }
+  else
+    {
+    /* get server information from pbs server */
+
+    if ((server = pbs_statserver_err(pbs_sd, NULL, NULL, &local_errno)) == NULL)
+      {
+      fprintf(stderr, "pbs_statserver failed: %d\n", local_errno);
+      return NULL;
+      }
+
+    /* convert batch_status structure into server_info structure */
+    if ((sinfo = query_server_info(server)) == NULL)
+      {
+      pbs_statfree(server);
+      return NULL;
+      }
+
+    pbs_statfree(server);
+
+    /* get the nodes, if any */
+    sinfo -> nodes = query_nodes(pbs_sd, sinfo);
+
+    /* get the queues */
+    if ((sinfo -> queues = query_queues(pbs_sd, sinfo)) == NULL)
+      {
+      free_server(sinfo, 0);
+      return NULL;
+      }
+    }
+
   /* count the queues and total up the individual queue states
    * for server totals. (total up all the state_count structs)
    */
@@ -161,6 +300,8 @@ server_info *query_server(int pbs_sd)
   sinfo -> running_jobs =
     job_filter(sinfo -> jobs, sinfo -> sc.total, check_run_job, NULL);
 
+  count_running(sinfo -> running_jobs, sinfo -> user_run, sinfo -> group_run);
+
   res = sinfo -> res;
 
   while (res != NULL)
@@ -175,8 +316,6 @@ server_info *query_server(int pbs_sd)
 
     node_filter(sinfo -> nodes, sinfo -> num_nodes, is_node_timeshared, NULL);
 
-  pbs_statfree(server);
-
   return sinfo;
   }
 
@@ -374,6 +513,12 @@ void free_server_info(server_info *sinfo)
 
   free_resource_list(sinfo -> res);
 
+  free_run_counts(sinfo -> user_run);
+
+  free_run_counts(sinfo -> group_run);
+
+  free_calendar(sinfo -> cal);
+
   free(sinfo);
   }
 
@@ -459,8 +604,14 @@ server_info *new_server_info()
 
   sinfo -> tokens = NULL;
 
+  sinfo -> cal = NULL;
+
   init_state_count(&(sinfo -> sc));
 
+  init_run_counts(sinfo -> user_run);
+
+  init_run_counts(sinfo -> group_run);
+
   return sinfo;
   }
 
@@ -576,6 +727,9 @@ void update_server_on_run(server_info *sinfo, queue_info *qinfo, job_info *jinfo
   sinfo -> sc.running++;
   sinfo -> sc.queued--;
 
+  add_run_count(sinfo -> user_run, jinfo -> account, 1);
+  add_run_count(sinfo -> group_run, jinfo -> group, 1);
+
   resreq = jinfo -> resreq;
 
   while (resreq != NULL)
@@ -200,3 +200,169 @@ void total_states(state_count *sc1, state_count *sc2)
   sc1 -> total += sc2 -> total;
   }
 
+/*
+ *
+ * run_count_bucket - hash a user or group name into a run count bucket
+ *
+ *   name - the name
+ *
+ * returns the bucket index
+ *
+ */
+static unsigned int run_count_bucket(const char *name)
+  {
+  unsigned int hash = 5381;
+
+  while (*name != '\0')
+    hash = hash * 33 + (unsigned char) *name++;
+
+  return hash % RUN_COUNT_BUCKETS;
+  }
+
+/*
+ *
+ * init_run_counts - initalize a run count table
+ *
+ *   table - the table to initalize
+ *
+ * returns nothing
+ *
+ */
+void init_run_counts(run_count **table)
+  {
+  int i;
+
+  for (i = 0; i < RUN_COUNT_BUCKETS; i++)
+    table[i] = NULL;
+  }
+
+/*
+ *
+ * free_run_counts - free the entries of a run count table
+ *
+ *   table - the table to free
+ *
+ * returns nothing
+ *
+ */
+void free_run_counts(run_count **table)
+  {
+  run_count *rc;
+  run_count *tmp;
+  int i;
+
+  for (i = 0; i < RUN_COUNT_BUCKETS; i++)
+    {
+    rc = table[i];
+
+    while (rc != NULL)
+      {
+      tmp = rc -> next;
+      free(rc -> name);
+      free(rc);
+      rc = tmp;
+      }
+
+    table[i] = NULL;
+    }
+  }
+
+/*
+ *
+ * find_run_count - look up the running jobs of a user or group
+ *
+ *   table - the run count table
+ *   name  - the user or group name
+ *
+ * returns the number of running jobs
+ *
+ */
+int find_run_count(run_count **table, char *name)
+  {
+  run_count *rc;
+
+  if (name == NULL)
+    return 0;
+
+  for (rc = table[run_count_bucket(name)]; rc != NULL; rc = rc -> next)
+    {
+    if (!strcmp(rc -> name, name))
+      return rc -> count;
+    }
+
+  return 0;
+  }
+
+/*
+ *
+ * add_run_count - add to the running jobs of a user or group
+ *
+ *   table  - the run count table
+ *   name   - the user or group name
+ *   amount - the number of jobs to add
+ *
+ * returns non-zero on error
+ *
+ */
+int add_run_count(run_count **table, char *name, int amount)
+  {
+  run_count *rc;
+  unsigned int bucket;
+
+  if (name == NULL)
+    return 0;
+
+  bucket = run_count_bucket(name);
+
+  for (rc = table[bucket]; rc != NULL; rc = rc -> next)
+    {
+    if (!strcmp(rc -> name, name))
+      {
+      rc -> count += amount;
+      return 0;
+      }
+    }
+
+  if ((rc = (run_count *) malloc(sizeof(run_count))) == NULL)
+    {
+    perror("Memory Allocation Error");
+    return 1;
+    }
+
+  if ((rc -> name = string_dup(name)) == NULL)
+    {
+    free(rc);
+    return 1;
+    }
+
+  rc -> count = amount;
+  rc -> next = table[bucket];
+  table[bucket] = rc;
+
+  return 0;
+  }
+
+/*
+ *
+ * count_running - count the running jobs of each user and group
+ *
+ *   jobs      - array of running jobs
+ *   user_run  - run count table to count users in
+ *   group_run - run count table to count groups in
+ *
+ * returns nothing
+ *
+ */
+void count_running(job_info **jobs, run_count **user_run, run_count **group_run)
+  {
+  int i;
+
+  if (jobs != NULL)
+    {
+    for (i = 0; jobs[i] != NULL; i++)
+      {
+      add_run_count(user_run, jobs[i] -> account, 1);
+      add_run_count(group_run, jobs[i] -> group, 1);
+      }
+    }
+  }
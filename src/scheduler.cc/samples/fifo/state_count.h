@@ -102,4 +102,29 @@ void count_states(job_info **jobs, state_count *sc);
  */
 void total_states(state_count *sc1, state_count *sc2);
 
+/*
+ *      init_run_counts - initalize a run count table
+ */
+void init_run_counts(run_count **table);
+
+/*
+ *      free_run_counts - free the entries of a run count table
+ */
+void free_run_counts(run_count **table);
+
+/*
+ *      find_run_count - look up the running jobs of a user or group
+ */
+int find_run_count(run_count **table, char *name);
+
+/*
+ *      add_run_count - add to the running jobs of a user or group
+ */
+int add_run_count(run_count **table, char *name, int amount);
+
+/*
+ *      count_running - count the running jobs of each user and group
+ */
+void count_running(job_info **jobs, run_count **user_run, run_count **group_run);
+
 #endif
@@ -7,17 +7,20 @@
   is_array() determine if jobnum is actually an array identifyer
   get_array() return array struct for given "parent id"
   array_save() save array struct to disk
+  array_save_counters() save only the array's counters to disk
   array_get_parent_id() return id of parent job if job belongs to a job array
   array_recov() recover the array struct for a job array at restart
   array_delete() free memory used by struct and delete sved struct on disk
  */
 
+#include <ctype.h>
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <fcntl.h>
 #include <limits.h> /* INT_MAX */
+#include <stddef.h> /* offsetof */
 
 /* this macro is for systems like BSD4 that do not have O_SYNC in fcntl.h,
  * but do have O_FSYNC! */
@@ -57,7 +60,6 @@
 #include "batch_request.h"
 #include "alps_constants.h"
 
-#include "../lib/Libutils/u_lock_ctl.h" /* lock_ss, unlock_ss */
 
 
 extern int array_upgrade(job_array *, int, int, int *);
@@ -197,6 +199,81 @@ job_array *get_array(
 
 
 
+/*
+ * find_or_create_array_subjob()
+ *
+ * Finds the job with job_id. If job_id names an array sub job that hasn't
+ * been created yet it is created from the array's template first, so that
+ * requests against a single sub job (run, hold, alter, status) work no matter
+ * how far the array has been instantiated.
+ *
+ * @param job_id - the id of the job to find
+ * @return the job, locked, or NULL if it doesn't exist and couldn't be created
+ */
+
+job *find_or_create_array_subjob(
+
+  const char *job_id)
+
+  {
+  job       *pjob;
+  job_array *pa;
+  char      *bracket;
+  char      *end;
+  char       jobid[PBS_MAXSVRJOBID + 1];
+  char       array_id[PBS_MAXSVRJOBID + 1];
+  long       index;
+  int        rc;
+
+  if ((pjob = svr_find_job(job_id, FALSE)) != NULL)
+    return(pjob);
+
+  snprintf(jobid, sizeof(jobid), "%s", job_id);
+
+  if (((bracket = strchr(jobid, '[')) == NULL) ||
+      (!isdigit(bracket[1])))
+    return(NULL);
+
+  index = strtol(bracket + 1, &end, 10);
+
+  if (*end != ']')
+    return(NULL);
+
+  array_get_parent_id(jobid, array_id);
+
+  if ((pa = get_array(array_id)) == NULL)
+    return(NULL);
+
+  mutex_mgr array_mgr(pa->ai_mutex, true);
+
+  if ((pa->is_deleted() == true) ||
+      (index >= pa->ai_qs.array_size) ||
+      (pa->job_ids[index] != NULL) ||
+      (pa->uncreated_ids.contains(index) == false))
+    return(NULL);
+
+  rc = pa->create_subjob(index, index == pa->uncreated_ids.front());
+
+  if (rc == FATAL_ERROR)
+    {
+    // the array went away while the sub job was being queued
+    array_mgr.set_unlock_on_exit(false);
+    return(NULL);
+    }
+
+  if ((rc == PBSE_NONE) &&
+      (LOGLEVEL >= 7))
+    {
+    log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, job_id, "created array sub job on demand");
+    }
+
+  array_mgr.unlock();
+
+  return(svr_find_job(job_id, FALSE));
+  } /* END find_or_create_array_subjob() */
+
+
+
 /*
  * get_and_remove_array()
  *
@@ -360,12 +437,8 @@ int array_save_xml(
         {
         if (xmlNewChild(root_node, NULL, (xmlChar *)RANGE_TAG, (xmlChar *)pa->ai_qs.range_str.c_str()))
           {
-          lock_ss();
-
           int lenwritten = xmlSaveFormatFileEnc(filename, doc, NULL, 1);
 
-          unlock_ss();
-
           if (!(lenwritten))
             {
             rc = -1;
@@ -388,6 +461,146 @@ int array_save_xml(
 
 
 
+/*
+ * array_counters_checksum()
+ *
+ * @return a checksum over every field of acr before ac_checksum
+ */
+
+unsigned int array_counters_checksum(
+
+  const array_counters_record *acr)
+
+  {
+  const unsigned char *p = (const unsigned char *)acr;
+  unsigned int         sum = 2166136261u;
+
+  for (size_t i = 0; i < offsetof(array_counters_record, ac_checksum); i++)
+    {
+    sum ^= p[i];
+    sum *= 16777619u;
+    }
+
+  return(sum);
+  } /* END array_counters_checksum() */
+
+
+
+/*
+ * array_save_counters()
+ *
+ * Overwrites the fixed size counters record for pa in place. This is all that
+ * needs to be written when sub-jobs change state; array_save() is only needed
+ * when something else in the array changes.
+ *
+ * @param pa - the array whose counters should be saved
+ * @return PBSE_NONE on success, -1 otherwise
+ */
+
+int array_save_counters(
+
+  job_array *pa)
+
+  {
+  char                  namebuf[MAXPATHLEN];
+  char                  log_buf[LOCAL_LOG_BUF_SIZE];
+  array_counters_record acr;
+  int                   fd;
+  int                   rc = PBSE_NONE;
+  std::string           adjusted_path_arrays = get_path_jobdata(pa->ai_qs.parent_id, path_arrays);
+
+  snprintf(namebuf, sizeof(namebuf), "%s%s%s",
+    adjusted_path_arrays.c_str(), pa->ai_qs.fileprefix, ARRAY_COUNTERS_SUFFIX);
+
+  memset(&acr, 0, sizeof(acr));
+  acr.ac_magic = ARRAY_COUNTERS_MAGIC;
+  acr.ac_version = ARRAY_COUNTERS_VERSION;
+  acr.ac_jobs_running = pa->ai_qs.jobs_running;
+  acr.ac_jobs_done = pa->ai_qs.jobs_done;
+  acr.ac_num_cloned = pa->ai_qs.num_cloned;
+  acr.ac_num_started = pa->ai_qs.num_started;
+  acr.ac_num_failed = pa->ai_qs.num_failed;
+  acr.ac_num_successful = pa->ai_qs.num_successful;
+  acr.ac_num_purged = pa->ai_qs.num_purged;
+  acr.ac_num_idle = pa->ai_qs.num_idle;
+  acr.ac_highest_id_created = pa->ai_qs.highest_id_created;
+  acr.ac_checksum = array_counters_checksum(&acr);
+
+  if ((fd = open(namebuf, O_WRONLY | O_CREAT, S_IRUSR | S_IWUSR)) < 0)
+    {
+    snprintf(log_buf, sizeof(log_buf), "unable to open %s", namebuf);
+    log_err(errno, __func__, log_buf);
+    return(-1);
+    }
+
+  if (pwrite(fd, &acr, sizeof(acr), 0) != (ssize_t)sizeof(acr))
+    {
+    snprintf(log_buf, sizeof(log_buf), "unable to write %s", namebuf);
+    log_err(errno, __func__, log_buf);
+    rc = -1;
+    }
+
+  close(fd);
+
+  return(rc);
+  } /* END array_save_counters() */
+
+
+
+/*
+ * array_recov_counters()
+ *
+ * Applies the counters record at path to pa if there is a valid one. A missing
+ * record isn't an error: arrays saved by older servers don't have one.
+ *
+ * @param pa - the array recovered from its array file
+ * @param path - the path to pa's counters record
+ * @return PBSE_NONE if the counters were applied, -1 otherwise
+ */
+
+int array_recov_counters(
+
+  job_array  *pa,
+  const char *path)
+
+  {
+  char                  log_buf[LOCAL_LOG_BUF_SIZE];
+  array_counters_record acr;
+  int                   fd;
+  ssize_t               len;
+
+  if ((fd = open(path, O_RDONLY, 0)) < 0)
+    return(-1);
+
+  len = pread(fd, &acr, sizeof(acr), 0);
+  close(fd);
+
+  if ((len != (ssize_t)sizeof(acr)) ||
+      (acr.ac_magic != ARRAY_COUNTERS_MAGIC) ||
+      (acr.ac_version != ARRAY_COUNTERS_VERSION) ||
+      (acr.ac_checksum != array_counters_checksum(&acr)))
+    {
+    snprintf(log_buf, sizeof(log_buf),
+      "ignoring invalid counters record %s, using the counters from the array file", path);
+    log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_JOB, pa->ai_qs.parent_id, log_buf);
+    return(-1);
+    }
+
+  pa->ai_qs.jobs_running = acr.ac_jobs_running;
+  pa->ai_qs.jobs_done = acr.ac_jobs_done;
+  pa->ai_qs.num_cloned = acr.ac_num_cloned;
+  pa->ai_qs.num_started = acr.ac_num_started;
+  pa->ai_qs.num_failed = acr.ac_num_failed;
+  pa->ai_qs.num_successful = acr.ac_num_successful;
+  pa->ai_qs.num_purged = acr.ac_num_purged;
+  pa->ai_qs.num_idle = acr.ac_num_idle;
+  pa->ai_qs.highest_id_created = acr.ac_highest_id_created;
+
+  return(PBSE_NONE);
+  } /* END array_recov_counters() */
+
+
+
 /* save a job array struct to disk returns zero if no errors*/
 int array_save(
     
@@ -402,6 +615,9 @@ int array_save(
   snprintf(namebuf, sizeof(namebuf), "%s%s%s",
     adjusted_path_arrays.c_str(), pa->ai_qs.fileprefix, ARRAY_FILE_SUFFIX);
 
+  /* the counters record goes first so that it's never older than the array file */
+  array_save_counters(pa);
+
   /* error buf is filled in array_save_xml or its subroutines */
   if (array_save_xml((const job_array *)pa, namebuf, log_buf, sizeof(log_buf)) != PBSE_NONE)
     {
@@ -1027,8 +1243,22 @@ int array_recov(
     }
 
   if (binary_conversion)
+    {
     if (array_save_xml((const job_array *)pa, path, log_buf, sizeof(log_buf)) != PBSE_NONE)
       log_event(PBSEVENT_SYSTEM,PBS_EVENTCLASS_JOB,pa->ai_qs.parent_id,log_buf);
+    }
+  else
+    {
+    /* counters saved since the array file was last written are in the record */
+    std::string counters_path(path);
+    size_t      suffix = counters_path.rfind(ARRAY_FILE_SUFFIX);
+
+    if (suffix != std::string::npos)
+      {
+      counters_path.replace(suffix, std::string::npos, ARRAY_COUNTERS_SUFFIX);
+      array_recov_counters(pa, counters_path.c_str());
+      }
+    }
 
   lock_ai_mutex(pa, __func__, NULL, LOGLEVEL);
 
@@ -1079,6 +1309,16 @@ int array_delete(
     log_err(errno, __func__, log_buf);
     }
 
+  snprintf(path, sizeof(path), "%s%s%s",
+    adjusted_path_arrays.c_str(), pa->ai_qs.fileprefix, ARRAY_COUNTERS_SUFFIX);
+
+  if ((unlink(path)) &&
+      (errno != ENOENT))
+    {
+    sprintf(log_buf, "unable to delete %s", path);
+    log_err(errno, __func__, log_buf);
+    }
+
   /* purge the "template" job, 
      this also deletes the shared script file for the array*/
   if (pa->ai_qs.parent_id[0] != '\0')
@@ -1849,7 +2089,7 @@ void set_slot_hold(
     if ((pjob->ji_wattr[JOB_ATR_hold].at_val.at_long & HOLD_l) == 0)
       {
       pjob->ji_wattr[JOB_ATR_hold].at_val.at_long |= HOLD_l;
-      pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET;
+      pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
       difference++;
       }
@@ -1876,8 +2116,9 @@ void release_slot_hold(
     if (pjob->ji_wattr[JOB_ATR_hold].at_val.at_long & HOLD_l)
       {
       pjob->ji_wattr[JOB_ATR_hold].at_val.at_long &= ~HOLD_l;
+      pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_MODIFY;
       if (pjob->ji_wattr[JOB_ATR_hold].at_val.at_long == 0)
-        pjob->ji_wattr[JOB_ATR_hold].at_flags &= ~ATR_VFLAG_SET;
+        pjob->ji_wattr[JOB_ATR_hold].at_flags = (pjob->ji_wattr[JOB_ATR_hold].at_flags & ~ATR_VFLAG_SET) | ATR_VFLAG_MODIFY;
 
       difference--;
       }
@@ -12,6 +12,10 @@ int is_array(char *id);
 
 int array_save(job_array *pa);
 
+int array_save_counters(job_array *pa);
+
+int array_recov_counters(job_array *pa, const char *path);
+
 void array_get_parent_id(char *job_id, char *parent_id);
 
 int set_slot_limit(char *request, job_array *pa);
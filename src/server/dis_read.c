@@ -313,6 +313,12 @@ int dis_request_read(
 
       break;
 
+    case PBS_BATCH_RunJobs:
+
+      rc = decode_DIS_RunJobs(chan, request);
+
+      break;
+
     case PBS_BATCH_SelectJobs:
 
     case PBS_BATCH_SelStat:
@@ -344,6 +350,12 @@ int dis_request_read(
 
       break;
 
+    case PBS_BATCH_StatusSnapshot:
+
+      rc = decode_DIS_StatusSnapshot(chan, request);
+
+      break;
+
     case PBS_BATCH_TrackJob:
 
       rc = decode_DIS_TrackJob(chan, request);
@@ -1,5 +1,6 @@
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
 
 #include "execution_slot_tracker.hpp"
 #include "pbs_error.h"
@@ -11,15 +12,18 @@ const int  SUBSET_TOO_LARGE = -3;
 const bool OCCUPIED = true;
 const bool FREE = false;
 
+#define SLOTS_PER_WORD 64
+
 execution_slot_tracker::execution_slot_tracker(const execution_slot_tracker& est)
   {
   this->slots = est.slots;
+  this->slot_count = est.slot_count;
   this->open_count = est.open_count;
   } /* END copy constructor */
 
 
 
-execution_slot_tracker::execution_slot_tracker() : open_count(0)
+execution_slot_tracker::execution_slot_tracker() : slots(), slot_count(0), open_count(0)
   {
   } /* END default contructor */
 
@@ -30,10 +34,15 @@ execution_slot_tracker::execution_slot_tracker(
   const int size)
 
   {
+  this->slot_count = 0;
   this->open_count = 0;
-  
-  for (int i = 0; i < size; i++)
-    this->add_execution_slot();
+
+  if (size > 0)
+    {
+    this->slots.resize((size + SLOTS_PER_WORD - 1) / SLOTS_PER_WORD, 0);
+    this->slot_count = size;
+    this->open_count = size;
+    }
   }
 
 
@@ -46,12 +55,33 @@ execution_slot_tracker& execution_slot_tracker::operator= (
     return(*this);
 
   this->slots = est.slots;
+  this->slot_count = est.slot_count;
   this->open_count = est.open_count;
   return(*this);
   } /* END = operator */
 
 
 
+/*
+ * valid_mask()
+ * @return the bits of slots[word] that are real slots. Only the last word can
+ * be partly used.
+ */
+unsigned long long execution_slot_tracker::valid_mask(
+
+  size_t word) const
+
+  {
+  int in_word = this->slot_count - (word * SLOTS_PER_WORD);
+
+  if (in_word >= SLOTS_PER_WORD)
+    return(~0ULL);
+
+  return((1ULL << in_word) - 1);
+  }
+
+
+
 /*
  * unset_subset()
  * @pre-cond: subset must be of an equal or smaller size than this execution slot tracker object
@@ -65,10 +95,15 @@ int execution_slot_tracker::unset_subset(
   if (subset.get_total_execution_slots() > this->get_total_execution_slots())
     return(SUBSET_TOO_LARGE);
 
-  for (int i = 0; i < subset.get_total_execution_slots(); i++)
+  for (size_t i = 0; i < subset.slots.size(); i++)
     {
-    if (subset.slots[i] == OCCUPIED)
-      this->mark_as_free(i);
+    unsigned long long freed = this->slots[i] & subset.slots[i];
+
+    if (freed != 0)
+      {
+      this->slots[i] &= ~freed;
+      this->open_count += __builtin_popcountll(freed);
+      }
     }
 
   return(PBSE_NONE);
@@ -88,26 +123,20 @@ int execution_slot_tracker::mark_as_used (
   int index)
 
   {
-  int size = this->slots.size();
-
   if ((index < 0) ||
-      (index >= size))
+      (index >= this->slot_count))
     return(OUT_OF_RANGE);
 
-  try 
-    {
-    if (this->slots[index] == FREE)
-      {
-      this->slots[index] = OCCUPIED;
-      this->open_count--;
-      }
+  unsigned long long &word = this->slots[index / SLOTS_PER_WORD];
+  unsigned long long  bit = 1ULL << (index % SLOTS_PER_WORD);
 
-    return(PBSE_NONE);
-    }
-  catch (std::out_of_range &oor)
+  if ((word & bit) == 0)
     {
-    return(OUT_OF_RANGE);
+    word |= bit;
+    this->open_count--;
     }
+
+  return(PBSE_NONE);
   }
 
 
@@ -124,28 +153,110 @@ int execution_slot_tracker::mark_as_free (
   int index)
 
   {
-  int size = this->slots.size();
-
   if ((index < 0) ||
-      (index >= size))
+      (index >= this->slot_count))
     return(OUT_OF_RANGE);
-  
-  try
+
+  unsigned long long &word = this->slots[index / SLOTS_PER_WORD];
+  unsigned long long  bit = 1ULL << (index % SLOTS_PER_WORD);
+
+  if ((word & bit) != 0)
     {
-    if (this->slots[index] == OCCUPIED)
-      {
-      this->slots[index] = FREE;
-      this->open_count++;
-      }
+    word &= ~bit;
+    this->open_count++;
+    }
+
+  return(PBSE_NONE);
+  }
+
+
+
+/*
+ * mark_range_as_used()
+ * marks count slots starting at first as occupied, a word at a time
+ * @post-cond: the slots in the range that exist are occupied
+ * @return PBSE_NONE on success or OUT_OF_RANGE if part of the range doesn't exist
+ */
+int execution_slot_tracker::mark_range_as_used(
+
+  int first,
+  int count)
 
-    return(PBSE_NONE);
+  {
+  int rc = PBSE_NONE;
+  int last = first + count;
+
+  if (first < 0)
+    {
+    first = 0;
+    rc = OUT_OF_RANGE;
     }
-  catch (std::out_of_range &oor)
+
+  if (last > this->slot_count)
     {
-    return(OUT_OF_RANGE);
+    last = this->slot_count;
+    rc = OUT_OF_RANGE;
+    }
+
+  while (first < last)
+    {
+    int                 offset = first % SLOTS_PER_WORD;
+    int                 in_word = std::min(last - first, SLOTS_PER_WORD - offset);
+    unsigned long long  mask = (in_word == SLOTS_PER_WORD) ? ~0ULL : (((1ULL << in_word) - 1) << offset);
+    unsigned long long &word = this->slots[first / SLOTS_PER_WORD];
+
+    this->open_count -= __builtin_popcountll(mask & ~word);
+    word |= mask;
+    first += in_word;
     }
+
+  return(rc);
   }
-  
+
+
+
+/*
+ * mark_range_as_free()
+ * marks count slots starting at first as free, a word at a time
+ * @post-cond: the slots in the range that exist are free
+ * @return PBSE_NONE on success or OUT_OF_RANGE if part of the range doesn't exist
+ */
+int execution_slot_tracker::mark_range_as_free(
+
+  int first,
+  int count)
+
+  {
+  int rc = PBSE_NONE;
+  int last = first + count;
+
+  if (first < 0)
+    {
+    first = 0;
+    rc = OUT_OF_RANGE;
+    }
+
+  if (last > this->slot_count)
+    {
+    last = this->slot_count;
+    rc = OUT_OF_RANGE;
+    }
+
+  while (first < last)
+    {
+    int                 offset = first % SLOTS_PER_WORD;
+    int                 in_word = std::min(last - first, SLOTS_PER_WORD - offset);
+    unsigned long long  mask = (in_word == SLOTS_PER_WORD) ? ~0ULL : (((1ULL << in_word) - 1) << offset);
+    unsigned long long &word = this->slots[first / SLOTS_PER_WORD];
+
+    this->open_count += __builtin_popcountll(mask & word);
+    word &= ~mask;
+    first += in_word;
+    }
+
+  return(rc);
+  }
+
 
 
 int execution_slot_tracker::reserve_execution_slot(
@@ -181,6 +292,7 @@ int execution_slot_tracker::reserve_execution_slot(
  * @pre-cond: est must be a valid execution_slot_tracker object
  * @post-cond: both this and est will have num_slots_to_reserve more slots set as
  * occupied. est will be resized if necessary to accomodate this functionality.
+ * The lowest numbered free slots are the ones reserved.
  * @returns INSUFFICIENT_FREE_EXECUTION_SLOTS if this object doesn't have enough
  * slots to accomodate the requested reservation or PBSE_NONE on success.
  */
@@ -195,18 +307,43 @@ int execution_slot_tracker::reserve_execution_slots(
   if (this->open_count < num_slots_to_reserve)
     return(INSUFFICIENT_FREE_EXECUTION_SLOTS);
 
-  while (est.get_total_execution_slots() < this->get_total_execution_slots())
-    est.add_execution_slot();
+  if (est.slot_count < this->slot_count)
+    {
+    est.slots.resize(this->slots.size(), 0);
+    est.open_count += this->slot_count - est.slot_count;
+    est.slot_count = this->slot_count;
+    }
 
-  for (int i = 0; i < this->slots.size() && reserved_so_far < num_slots_to_reserve; i++)
+  for (size_t i = 0; (i < this->slots.size()) && (reserved_so_far < num_slots_to_reserve); i++)
     {
-    if (this->slots[i] == FREE)
+    unsigned long long free_bits = ~this->slots[i] & this->valid_mask(i);
+    int                available = __builtin_popcountll(free_bits);
+
+    if (available == 0)
+      continue;
+
+    /* take the whole word when we can, otherwise just its lowest free slots */
+    if (available > num_slots_to_reserve - reserved_so_far)
       {
-      reserved_so_far++;
-      this->mark_as_used(i);
+      unsigned long long take = 0;
+
+      for (int needed = num_slots_to_reserve - reserved_so_far; needed > 0; needed--)
+        {
+        take |= free_bits & -free_bits;
+        free_bits &= free_bits - 1;
+        }
 
-      est.mark_as_used(i);
+      free_bits = take;
+      available = __builtin_popcountll(take);
       }
+
+    this->slots[i] |= free_bits;
+    this->open_count -= available;
+
+    est.open_count -= __builtin_popcountll(free_bits & ~est.slots[i]);
+    est.slots[i] |= free_bits;
+
+    reserved_so_far += available;
     }
 
   return(PBSE_NONE);
@@ -226,16 +363,7 @@ int execution_slot_tracker::unreserve_execution_slots(
   const execution_slot_tracker &subset)
 
   {
-  if (this->slots.size() < subset.slots.size())
-    return(SUBSET_TOO_LARGE);
-
-  for (int i = 0; i < subset.slots.size(); i++)
-    {
-    if (subset.slots[i] == OCCUPIED)
-      this->mark_as_free(i);
-    }
-
-  return(PBSE_NONE);
+  return(this->unset_subset(subset));
   }
 
 
@@ -249,7 +377,7 @@ int execution_slot_tracker::get_number_free() const
 
 int execution_slot_tracker::get_total_execution_slots() const
   {
-  return(this->slots.size());
+  return(this->slot_count);
   }
 
 
@@ -257,7 +385,10 @@ int execution_slot_tracker::get_total_execution_slots() const
 void execution_slot_tracker::add_execution_slot ()
 
   {
-  this->slots.push_back(FREE);
+  if ((this->slot_count % SLOTS_PER_WORD) == 0)
+    this->slots.push_back(0);
+
+  this->slot_count++;
   this->open_count++;
   }
 
@@ -265,19 +396,22 @@ void execution_slot_tracker::add_execution_slot ()
 
 int execution_slot_tracker::remove_execution_slot ()
   {
-  try
-    {
-    if (this->slots[this->slots.size() - 1] == FREE)
-      this->open_count--;
+  if (this->slot_count == 0)
+    return(-4);
 
+  int last = this->slot_count - 1;
+
+  if (this->is_occupied(last) == false)
+    this->open_count--;
+  else
+    this->slots[last / SLOTS_PER_WORD] &= ~(1ULL << (last % SLOTS_PER_WORD));
+
+  this->slot_count--;
+
+  if ((this->slot_count % SLOTS_PER_WORD) == 0)
     this->slots.pop_back();
 
-    return(PBSE_NONE);
-    }
-  catch (...)
-    {
-    return(-4);
-    }
+  return(PBSE_NONE);
   }
 
 
@@ -292,23 +426,31 @@ int execution_slot_tracker::get_next_occupied_index(
   int &iterator) const
 
   {
-  int occupied_index = -1;
-
   if (iterator == -1)
     iterator = 0;
 
-  while (iterator < this->slots.size())
+  if ((iterator < 0) ||
+      (iterator >= this->slot_count))
+    return(-1);
+
+  size_t             word = iterator / SLOTS_PER_WORD;
+  unsigned long long bits = this->slots[word] & (~0ULL << (iterator % SLOTS_PER_WORD));
+
+  while (bits == 0)
     {
-    if (this->slots[iterator] == OCCUPIED)
+    if (++word >= this->slots.size())
       {
-      occupied_index = iterator;
-      iterator++;
-      break;
+      iterator = this->slot_count;
+      return(-1);
       }
-    else
-      iterator++;
+
+    bits = this->slots[word];
     }
 
+  int occupied_index = (word * SLOTS_PER_WORD) + __builtin_ctzll(bits);
+
+  iterator = occupied_index + 1;
+
   return(occupied_index);
   }
 
@@ -317,21 +459,9 @@ bool execution_slot_tracker::is_occupied(
   int index) const
 
   {
-  int  size = this->slots.size();
-  bool occupied = false;
-
   if ((index < 0) ||
-      (index >= size))
+      (index >= this->slot_count))
     return(false);
   
-  try
-    {
-    occupied = this->slots[index] == OCCUPIED;
-    }
-  catch (std::out_of_range &oor)
-    {
-    return(false);
-    }
-
-  return(occupied);
+  return((this->slots[index / SLOTS_PER_WORD] & (1ULL << (index % SLOTS_PER_WORD))) != 0);
   }
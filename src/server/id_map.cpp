@@ -133,6 +133,50 @@ int id_map::get_id(
 
 
 
+/*
+ * rename_id()
+ *
+ * Moves an existing id to a new name so that the new name maps to the same id
+ * and the old name no longer maps to anything.
+ * @param id - the id to re-key
+ * @param name - the new name for id
+ * @return 0 on success, -1 if id was never handed out
+ */
+
+int id_map::rename_id(
+
+  int         id,
+  const char *name)
+
+  {
+  int rc = -1;
+
+  if (id < 0)
+    return(rc);
+
+  pthread_mutex_lock(&this->mutex);
+
+  if (id < (int)this->names->size())
+    {
+    std::string nname(name);
+    std::map<std::string, int>::iterator it = this->str_map->find(this->names->at(id));
+
+    if ((it != this->str_map->end()) &&
+        (it->second == id))
+      this->str_map->erase(it);
+
+    (*this->str_map)[nname] = id;
+    this->names->at(id) = nname;
+    rc = 0;
+    }
+
+  pthread_mutex_unlock(&this->mutex);
+
+  return(rc);
+  } /* END rename_id() */
+
+
+
 const char *id_map::get_name(
 
   int id)
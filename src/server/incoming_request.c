@@ -85,6 +85,15 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <map>
+#include <vector>
 #include "server_comm.h"
 #include "dis.h"
 #include "threadpool.h"
@@ -93,8 +102,11 @@
 #include "libpbs.h"
 #include "net_connect.h"
 #include "batch_request.h"
+#include "server.h"
+#include "svrfunc.h"
 
 const int SHORT_TIMEOUT = 5;
+const int STATUS_STREAM_POLL_TIMEOUT = 60;
 
 char *netaddr(struct sockaddr_in *ap);
 void netcounter_incr();
@@ -103,6 +115,20 @@ void netcounter_incr();
 // outgoing connections.
 time_t pbs_incoming_tcp_timeout = PBS_TCPINTIMEOUT;
 
+// MOMs that stream their status keep their connection between updates. While
+// they wait for the next update the connections are parked here, watched by
+// poll_status_streams(), instead of each holding a request_pool thread.
+typedef struct parked_stream
+  {
+  long   args[3];
+  time_t parked_time;
+  } parked_stream;
+
+std::map<int, parked_stream> parked_streams;
+pthread_mutex_t              parked_streams_mutex = PTHREAD_MUTEX_INITIALIZER;
+int                          parked_streams_wake[2] = { -1, -1 };
+bool                         parked_streams_polled = false; /* poll_status_streams() is watching */
+
 int get_protocol_type(
 
   struct tcp_chan *chan,
@@ -173,9 +199,16 @@ int process_pbs_server_port(
 
       isr.chan = chan;
       isr.args = args;
+      isr.keep_open = false;
   
       if (threadpool_is_too_busy(request_pool, ATR_DFLAG_MGRD) == false)
+        {
         svr_is_request(&isr);
+
+        // unless the mom is streaming its status and will send the next update here
+        if (isr.keep_open == true)
+          rc = PBSE_STATUS_STREAM;
+        }
       else
         {
         write_tcp_reply(chan, IS_PROTOCOL, IS_PROTOCOL_VER, IS_STATUS, PBSE_SERVER_BUSY);
@@ -263,16 +296,292 @@ void *start_process_pbs_server_port(
          (rc != PBSE_SYSTEM) &&
          (rc != PBSE_MEM_MALLOC) &&
          (rc != PBSE_SOCKET_CLOSE) &&
-         (rc != PBSE_TIMEOUT))
+         (rc != PBSE_TIMEOUT) &&
+         (rc != PBSE_STATUS_STREAM))
     {
     netcounter_incr();
 
     rc = process_pbs_server_port(sock, FALSE, args);
     }
 
+  if (rc == PBSE_STATUS_STREAM)
+    park_status_stream(sock, args);
+  else
+    close_conn(sock, FALSE);
+
   free(new_sock);
-  close_conn(sock, FALSE);
 
   /* Thread exit */
   return(NULL);
   }
+
+
+
+
+/*
+ * park_status_stream()
+ *
+ * Hands a mom's status stream to poll_status_streams() until its next update.
+ * If nothing is polling the streams the connection is closed instead, and the
+ * mom reconnects for its next update.
+ *
+ * @param sock - the connection the mom is streaming its status over
+ * @param args - the socket, address and port of the connection
+ */
+
+void park_status_stream(
+
+  int   sock,
+  long *args)
+
+  {
+  parked_stream ps;
+
+  memcpy(ps.args, args, sizeof(ps.args));
+  ps.parked_time = time(NULL);
+
+  pthread_mutex_lock(&parked_streams_mutex);
+
+  if (parked_streams_polled == false)
+    {
+    pthread_mutex_unlock(&parked_streams_mutex);
+    close_conn(sock, FALSE);
+    return;
+    }
+
+  parked_streams[sock] = ps;
+  pthread_mutex_unlock(&parked_streams_mutex);
+
+  // make the poller pick up the new socket
+  if (parked_streams_wake[1] != -1)
+    {
+    if (write(parked_streams_wake[1], "", 1) < 0)
+      {
+      // the pipe is full, so the poller is already due to wake up
+      }
+    }
+  } /* END park_status_stream() */
+
+
+
+/*
+ * process_status_stream()
+ *
+ * Reads the next status update from a parked status stream, and parks it
+ * again if the mom is still streaming
+ *
+ * @param vp - the socket, address and port of the connection, freed here
+ */
+
+void *process_status_stream(
+
+  void *vp)
+
+  {
+  long *args = (long *)vp;
+  int   sock = (int)args[0];
+
+  netcounter_incr();
+
+  if (process_pbs_server_port(sock, FALSE, args) == PBSE_STATUS_STREAM)
+    park_status_stream(sock, args);
+  else
+    close_conn(sock, FALSE);
+
+  free(args);
+
+  return(NULL);
+  } /* END process_status_stream() */
+
+
+
+/*
+ * check_parked_streams()
+ *
+ * Waits once on every parked status stream and hands each one with an update
+ * to read to the request_pool. Streams that haven't sent anything for
+ * PBS_NET_MAXCONNECTIDLE seconds are closed; their moms reconnect.
+ *
+ * @param timeout - the most seconds to wait for an update
+ */
+
+void check_parked_streams(
+
+  int timeout)
+
+  {
+  std::vector<struct pollfd> fds;
+  std::vector<int>           idle;
+  struct pollfd              pfd;
+  char                       log_buf[LOCAL_LOG_BUF_SIZE];
+  char                       drain[64];
+  time_t                     now = time(NULL);
+
+  pfd.fd = parked_streams_wake[0];
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  fds.push_back(pfd);
+
+  pthread_mutex_lock(&parked_streams_mutex);
+
+  for (std::map<int, parked_stream>::iterator it = parked_streams.begin(); it != parked_streams.end();)
+    {
+    if (now - it->second.parked_time > PBS_NET_MAXCONNECTIDLE)
+      {
+      idle.push_back(it->first);
+      parked_streams.erase(it++);
+      continue;
+      }
+
+    pfd.fd = it->first;
+    fds.push_back(pfd);
+    it++;
+    }
+
+  pthread_mutex_unlock(&parked_streams_mutex);
+
+  /* close_conn() takes its own locks, so don't hold ours */
+  for (unsigned int i = 0; i < idle.size(); i++)
+    {
+    snprintf(log_buf, sizeof(log_buf),
+      "Closing status stream on socket %d, no update for %d seconds",
+      idle[i], PBS_NET_MAXCONNECTIDLE);
+    log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_REQUEST, __func__, log_buf);
+
+    close_conn(idle[i], FALSE);
+    }
+
+  if (poll(&fds[0], fds.size(), timeout * 1000) < 0)
+    {
+    if (errno != EINTR)
+      log_err(errno, __func__, "Unable to poll mom status streams");
+
+    return;
+    }
+
+  if (fds[0].revents != 0)
+    {
+    while (read(parked_streams_wake[0], drain, sizeof(drain)) > 0)
+      ;
+    }
+
+  for (unsigned int i = 1; i < fds.size(); i++)
+    {
+    long *args = NULL;
+
+    if (fds[i].revents == 0)
+      continue;
+
+    pthread_mutex_lock(&parked_streams_mutex);
+
+    std::map<int, parked_stream>::iterator it = parked_streams.find(fds[i].fd);
+
+    if (it != parked_streams.end())
+      {
+      if ((args = (long *)calloc(3, sizeof(long))) != NULL)
+        {
+        memcpy(args, it->second.args, sizeof(it->second.args));
+        parked_streams.erase(it);
+        }
+      }
+
+    pthread_mutex_unlock(&parked_streams_mutex);
+
+    if (args != NULL)
+      enqueue_threadpool_request(process_status_stream, args, request_pool);
+    }
+  } /* END check_parked_streams() */
+
+
+
+/*
+ * init_status_stream_poller()
+ *
+ * Creates the pipe that wakes poll_status_streams() for newly parked streams.
+ * Must succeed before the thread is started.
+ *
+ * @return PBSE_NONE on success, PBSE_SYSTEM if the pipe couldn't be created
+ */
+
+int init_status_stream_poller()
+
+  {
+  if (pipe(parked_streams_wake) != 0)
+    {
+    log_err(errno, __func__, "Unable to create a pipe, mom status streams won't be parked");
+    return(PBSE_SYSTEM);
+    }
+
+  fcntl(parked_streams_wake[0], F_SETFL, O_NONBLOCK);
+  fcntl(parked_streams_wake[1], F_SETFL, O_NONBLOCK);
+
+  return(PBSE_NONE);
+  } /* END init_status_stream_poller() */
+
+
+
+/*
+ * stop_parking_status_streams()
+ *
+ * Stops status streams from being parked and closes the ones that are
+ */
+
+void stop_parking_status_streams()
+
+  {
+  std::vector<int> parked;
+
+  pthread_mutex_lock(&parked_streams_mutex);
+
+  parked_streams_polled = false;
+
+  for (std::map<int, parked_stream>::iterator it = parked_streams.begin(); it != parked_streams.end(); it++)
+    parked.push_back(it->first);
+
+  parked_streams.clear();
+
+  pthread_mutex_unlock(&parked_streams_mutex);
+
+  for (unsigned int i = 0; i < parked.size(); i++)
+    close_conn(parked[i], FALSE);
+  } /* END stop_parking_status_streams() */
+
+
+
+/*
+ * poll_status_streams()
+ *
+ * Thread that waits on the parked mom status streams until the server shuts
+ * down. Streams are only parked while it runs.
+ */
+
+void *poll_status_streams(
+
+  void *vp)
+
+  {
+  long state = SV_STATE_RUN;
+  bool polled;
+
+  pthread_mutex_lock(&parked_streams_mutex);
+  polled = parked_streams_polled = (parked_streams_wake[0] != -1);
+  pthread_mutex_unlock(&parked_streams_mutex);
+
+  if (polled == false)
+    {
+    log_err(-1, __func__, "init_status_stream_poller() wasn't called, mom status streams won't be parked");
+    return(NULL);
+    }
+
+  while (state <= SV_STATE_RUN)
+    {
+    check_parked_streams(STATUS_STREAM_POLL_TIMEOUT);
+
+    get_svr_attr_l(SRV_ATR_State, &state);
+    }
+
+  stop_parking_status_streams();
+
+  return(NULL);
+  } /* END poll_status_streams() */
+
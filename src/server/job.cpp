@@ -14,7 +14,7 @@ job::job() : ji_plugin_usage_info(), ji_momstat(0), ji_modified(0), ji_momhandle
              ji_have_nodes_request(false), ji_external_clone(NULL),
              ji_cray_clone(NULL), ji_parent_job(NULL), ji_internal_id(-1),
              ji_being_recycled(false), ji_last_reported_time(0), ji_mod_time(0),
-             ji_queue_counted(0), ji_being_deleted(false), ji_commit_done(false)
+             ji_status_gen(0), ji_queue_counted(0), ji_being_deleted(false), ji_commit_done(false)
 
   {
   memset(this->ji_arraystructid, 0, sizeof(ji_arraystructid));
@@ -186,3 +186,112 @@ void job::set_plugin_resource_usage_from_json(
   if (reader.parse(json_str, resources) == true)
     this->set_plugin_resource_usage_from_json(resources);
   }
+
+
+
+/*
+ * defer_attr()
+ *
+ * Keeps the encoded value of an attribute instead of decoding it. Recovery
+ * uses this for bulky attributes that most jobs never read again; the value
+ * is decoded by hydrate_attr() when something needs it. While an attribute
+ * is deferred it is not set in ji_wattr, and a value set there in the
+ * meantime supersedes the deferred one.
+ *
+ * @param index - the attribute's index in job_attr_def
+ * @param value - the attribute's value as it was saved
+ * @param flags - the attribute's saved at_flags
+ */
+
+void job::defer_attr(
+
+  int           index,
+  const char   *value,
+  unsigned int  flags)
+
+  {
+  std::pair<std::string, unsigned int> &deferred = this->ji_deferred_attrs[index];
+
+  deferred.first = value;
+  deferred.second = flags;
+  } // END defer_attr()
+
+
+
+/*
+ * get_deferred_attr()
+ *
+ * @param index - the attribute's index in job_attr_def
+ * @param value - set to the deferred value
+ * @param flags - set to the deferred value's flags
+ * @return true if index has a deferred value that hasn't been superseded
+ */
+
+bool job::get_deferred_attr(
+
+  int           index,
+  std::string  &value,
+  unsigned int &flags) const
+
+  {
+  std::map<int, std::pair<std::string, unsigned int> >::const_iterator it;
+
+  if ((this->ji_deferred_attrs.size() == 0) ||
+      (this->ji_wattr[index].at_flags & ATR_VFLAG_SET) ||
+      ((it = this->ji_deferred_attrs.find(index)) == this->ji_deferred_attrs.end()))
+    return(false);
+
+  value = it->second.first;
+  flags = it->second.second;
+
+  return(true);
+  } // END get_deferred_attr()
+
+
+
+/*
+ * hydrate_attr()
+ *
+ * Decodes the attribute at index if its decoding was deferred. Anything that
+ * reads a deferrable attribute directly out of ji_wattr must call this first.
+ */
+
+void job::hydrate_attr(
+
+  int index)
+
+  {
+  std::map<int, std::pair<std::string, unsigned int> >::iterator it;
+
+  if ((this->ji_deferred_attrs.size() == 0) ||
+      ((it = this->ji_deferred_attrs.find(index)) == this->ji_deferred_attrs.end()))
+    return;
+
+  if ((this->ji_wattr[index].at_flags & ATR_VFLAG_SET) == 0)
+    {
+    job_attr_def[index].at_decode(&this->ji_wattr[index],
+                                  job_attr_def[index].at_name,
+                                  NULL,
+                                  it->second.first.c_str(),
+                                  ATR_DFLAG_ACCESS);
+
+    this->ji_wattr[index].at_flags = it->second.second & ~ATR_VFLAG_MODIFY;
+    }
+
+  this->ji_deferred_attrs.erase(it);
+  } // END hydrate_attr()
+
+
+
+/*
+ * hydrate_attrs()
+ *
+ * Decodes every deferred attribute, for code that walks all of ji_wattr
+ */
+
+void job::hydrate_attrs()
+
+  {
+  while (this->ji_deferred_attrs.size() != 0)
+    this->hydrate_attr(this->ji_deferred_attrs.begin()->first);
+  } // END hydrate_attrs()
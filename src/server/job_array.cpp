@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <algorithm>
 
 #include "array.h"
 #include "list_link.h"
@@ -238,16 +239,18 @@ int job_array::parse_array_request(
   int  rc = PBSE_NONE;
   long max_array_size;
   char log_buf[LOCAL_LOG_BUF_SIZE];
-  this->uncreated_ids.clear();
 
-  if ((rc = translate_range_string_to_vector(request, this->uncreated_ids)) != PBSE_NONE)
+  if ((rc = this->uncreated_ids.set_from_string(request, 0)) != PBSE_NONE)
     return(rc);
 
+  if (this->uncreated_ids.empty())
+    return(-1);
+
   this->ai_qs.range_str = request;
   this->ai_qs.num_jobs = this->uncreated_ids.size();
 
   // size of array is the biggest index + 1
-  this->ai_qs.array_size = this->uncreated_ids[this->uncreated_ids.size() - 1] + 1;
+  this->ai_qs.array_size = this->uncreated_ids.get_ranges().back().second + 1;
 
   if (get_svr_attr_l(SRV_ATR_MaxArraySize, &max_array_size) == PBSE_NONE)
     {
@@ -284,94 +287,119 @@ bool job_array::need_to_update_slot_limits() const
  *
  * Determines the index of the next subjob that should be created
  *
- * @param internal_index - the index of uncreated_ids that corresponds to the subjob index returned
  * @return the index of the next subjob to be created, or -1 if no job should be created
  * at this time.
  */
 
-int job_array::get_next_index_to_create(
-    
-  int &internal_index)
+int job_array::get_next_index_to_create()
 
   {
-  int index = -1;
-  internal_index = -1;
-
   // Don't instantiate new jobs after we've been deleted
-  if (this->being_deleted == false)
+  if (this->being_deleted == true)
+    return(-1);
+
+  if ((this->ai_qs.idle_slot_limit != NO_SLOT_LIMIT) &&
+      (this->ai_qs.num_idle >= this->ai_qs.idle_slot_limit))
+    return(-1);
+
+  // skip sub jobs that already exist, e.g. ones that were created on demand
+  while (this->uncreated_ids.empty() == false)
     {
-    if ((this->ai_qs.idle_slot_limit == NO_SLOT_LIMIT) ||
-        (this->ai_qs.num_idle < this->ai_qs.idle_slot_limit))
-      {
-      for (size_t i = 0; i < this->uncreated_ids.size(); i++)
-        {
-        if (this->uncreated_ids[i] != -1)
-          {
-          index = this->uncreated_ids[i];
-          internal_index = i;
-          break;
-          }
-        }
-      }
+    int index = this->uncreated_ids.front();
+
+    if ((this->job_ids == NULL) ||
+        (index >= this->ai_qs.array_size) ||
+        (this->job_ids[index] == NULL))
+      return(index);
+
+    this->uncreated_ids.pop_front();
     }
 
-  return(index);
+  return(-1);
   } // END get_next_index_to_create()
 
 
 
 /*
- * create_job_if_needed()
+ * create_subjob()
  *
- * Creates a new array subjob if the array's idle count is below the idle slot limit
+ * Creates and queues the subjob at index from the array's template. The array must be
+ * locked by the caller and is still locked when this returns.
+ *
+ * @param index - the index of the subjob to create
+ * @param in_order - true if index is the lowest uncreated index. Sub jobs created out of
+ * order, e.g. because someone asked for that sub job specifically, don't advance
+ * highest_id_created so the ones before them are still created after a restart.
+ * @return PBSE_NONE on success, or the error from create_and_queue_array_subjob()
  */
 
-void job_array::create_job_if_needed()
+int job_array::create_subjob(
+
+  int  index,
+  bool in_order)
 
   {
-  int  uncreated_ids_index;
-  int  next_index = this->get_next_index_to_create(uncreated_ids_index);
+  int  rc;
+  job *template_job = svr_find_job(this->ai_qs.parent_id, FALSE);
 
-  if (next_index >= 0)
-    {
-    job *template_job = svr_find_job(this->ai_qs.parent_id, FALSE);
+  if (template_job == NULL)
+    return(PBSE_JOBNOTFOUND);
 
-    if (template_job != NULL)
-      {
-      mutex_mgr template_mgr(template_job->ji_mutex, true);
-      mutex_mgr array_mgr(this->ai_mutex, true);
+  mutex_mgr template_mgr(template_job->ji_mutex, true);
+  mutex_mgr array_mgr(this->ai_mutex, true);
 
-      char  old_id[PBS_MAXSVRJOBID + 1];
-      char  prev_job_id[PBS_MAXSVRJOBID + 1];
-      char *hostname_extension;
-      char *bracket;
+  // the caller still holds the array
+  array_mgr.set_unlock_on_exit(false);
 
-      strcpy(old_id, template_job->ji_qs.ji_jobid);
-      hostname_extension = strchr(old_id, '.');
-      bracket = strchr(old_id, '[');
+  char  old_id[PBS_MAXSVRJOBID + 1];
+  char  prev_job_id[PBS_MAXSVRJOBID + 1];
+  char *hostname_extension;
+  char *bracket;
 
-      if (bracket != NULL)
-        *bracket = '\0';
+  strcpy(old_id, template_job->ji_qs.ji_jobid);
+  hostname_extension = strchr(old_id, '.');
+  bracket = strchr(old_id, '[');
 
-      if (hostname_extension != NULL)
-        snprintf(prev_job_id, sizeof(prev_job_id), "%s[%d]%s",
-          old_id, this->ai_qs.highest_id_created, hostname_extension);
-      else
-        snprintf(prev_job_id, sizeof(prev_job_id), "%s[%d]", old_id, this->ai_qs.highest_id_created);
+  if (bracket != NULL)
+    *bracket = '\0';
 
-      std::string prev_id(prev_job_id);
-      
-      int rc = create_and_queue_array_subjob(this, array_mgr, template_job, template_mgr,
-                                             next_index, prev_id, false);
+  if (hostname_extension != NULL)
+    snprintf(prev_job_id, sizeof(prev_job_id), "%s[%d]%s",
+      old_id, this->ai_qs.highest_id_created, hostname_extension);
+  else
+    snprintf(prev_job_id, sizeof(prev_job_id), "%s[%d]", old_id, this->ai_qs.highest_id_created);
 
-      if (rc == PBSE_NONE)
-        {
-        this->uncreated_ids[uncreated_ids_index] = -1;
-        this->ai_qs.highest_id_created = next_index;
-        }
-      }
+  std::string prev_id(prev_job_id);
+  
+  rc = create_and_queue_array_subjob(this, array_mgr, template_job, template_mgr,
+                                     index, prev_id, false);
+
+  if (rc == PBSE_NONE)
+    {
+    this->uncreated_ids.remove(index);
+
+    if (in_order == true)
+      this->ai_qs.highest_id_created = index;
     }
 
+  return(rc);
+  } // END create_subjob()
+
+
+
+/*
+ * create_job_if_needed()
+ *
+ * Creates a new array subjob if the array's idle count is below the idle slot limit
+ */
+
+void job_array::create_job_if_needed()
+
+  {
+  int next_index = this->get_next_index_to_create();
+
+  if (next_index >= 0)
+    this->create_subjob(next_index, true);
   } // END create_job_if_needed()
 
 
@@ -452,8 +480,6 @@ void job_array::update_array_values(
       else
         this->ai_qs.num_failed++;
 
-      array_save(this);
-
       /* update slot limit hold if necessary */
       if (get_svr_attr_b(SRV_ATR_MoabArrayCompatible, &moab_compatible) != PBSE_NONE)
         moab_compatible = false;
@@ -530,7 +556,8 @@ void job_array::update_array_values(
 
   set_array_depend_holds(this);
 
-  array_save(this);
+  /* only the counters changed, the rest of the array file is still current */
+  array_save_counters(this);
   } /* END update_array_values() */
 
 
@@ -538,22 +565,14 @@ void job_array::update_array_values(
 /*
  * initialize_uncreated_ids()
  *
- * Populates the uncreated ids vector, usually called after a restart
+ * Populates the uncreated ids, usually called after a restart
  */
 
 void job_array::initialize_uncreated_ids()
 
   {
-  std::vector<int> temp;
-  translate_range_string_to_vector(this->ai_qs.range_str.c_str(), temp);
-
-  this->uncreated_ids.clear();
-
-  for (size_t i = 0; i < temp.size(); i++)
-    {
-    if (temp[i] > this->ai_qs.highest_id_created)
-      this->uncreated_ids.push_back(temp[i]);
-    }
+  this->uncreated_ids.set_from_string(this->ai_qs.range_str.c_str(),
+                                      this->ai_qs.highest_id_created + 1);
   }
 
 
@@ -570,3 +589,218 @@ bool job_array::is_deleted() const
 
 
 
+
+
+
+array_index_ranges::array_index_ranges() : ranges(), count(0)
+
+  {
+  }
+
+
+
+/*
+ * set_from_string()
+ *
+ * Replaces the contents with the indices in a range string like "0-99,200,300-310"
+ *
+ * @param range_str - the range string
+ * @param lowest - indices below this are left out
+ * @return PBSE_NONE, or -1 if range_str is malformed
+ */
+
+int array_index_ranges::set_from_string(
+
+  const char *range_str,
+  int         lowest)
+
+  {
+  std::vector<int> indices;
+  int              rc;
+
+  this->clear();
+
+  if ((rc = translate_range_string_to_vector(range_str, indices)) != PBSE_NONE)
+    return(rc);
+
+  std::sort(indices.begin(), indices.end());
+
+  for (size_t i = 0; i < indices.size(); i++)
+    {
+    if (indices[i] < lowest)
+      continue;
+
+    if ((this->ranges.size() != 0) &&
+        (indices[i] <= this->ranges.back().second + 1))
+      {
+      if (indices[i] == this->ranges.back().second + 1)
+        {
+        this->ranges.back().second++;
+        this->count++;
+        }
+      }
+    else
+      {
+      this->ranges.push_back(std::pair<int, int>(indices[i], indices[i]));
+      this->count++;
+      }
+    }
+
+  return(PBSE_NONE);
+  } // END set_from_string()
+
+
+
+void array_index_ranges::clear()
+
+  {
+  this->ranges.clear();
+  this->count = 0;
+  }
+
+
+
+size_t array_index_ranges::size() const
+
+  {
+  return(this->count);
+  }
+
+
+
+bool array_index_ranges::empty() const
+
+  {
+  return(this->count == 0);
+  }
+
+
+
+/*
+ * front()
+ *
+ * @return the lowest index, or -1 if there are none
+ */
+
+int array_index_ranges::front() const
+
+  {
+  if (this->ranges.size() == 0)
+    return(-1);
+
+  return(this->ranges.front().first);
+  }
+
+
+
+/*
+ * pop_front()
+ *
+ * Removes the lowest index
+ *
+ * @return the index removed, or -1 if there were none
+ */
+
+int array_index_ranges::pop_front()
+
+  {
+  int index = this->front();
+
+  if (index >= 0)
+    this->remove(index);
+
+  return(index);
+  }
+
+
+
+/*
+ * find_range()
+ *
+ * @return the position of the range containing index, or ranges.size() if no range does
+ */
+
+static size_t find_range(
+
+  const std::deque<std::pair<int, int> > &ranges,
+  int                                     index)
+
+  {
+  size_t low = 0;
+  size_t high = ranges.size();
+
+  while (low < high)
+    {
+    size_t mid = low + (high - low) / 2;
+
+    if (ranges[mid].second < index)
+      low = mid + 1;
+    else
+      high = mid;
+    }
+
+  if ((low < ranges.size()) &&
+      (ranges[low].first <= index))
+    return(low);
+
+  return(ranges.size());
+  } // END find_range()
+
+
+
+bool array_index_ranges::contains(
+
+  int index) const
+
+  {
+  return(find_range(this->ranges, index) != this->ranges.size());
+  }
+
+
+
+/*
+ * remove()
+ *
+ * Removes index, splitting the range that holds it if needed
+ *
+ * @return true if index was present
+ */
+
+bool array_index_ranges::remove(
+
+  int index)
+
+  {
+  size_t pos = find_range(this->ranges, index);
+
+  if (pos == this->ranges.size())
+    return(false);
+
+  std::pair<int, int> &r = this->ranges[pos];
+
+  if (r.first == r.second)
+    this->ranges.erase(this->ranges.begin() + pos);
+  else if (index == r.first)
+    r.first++;
+  else if (index == r.second)
+    r.second--;
+  else
+    {
+    std::pair<int, int> upper(index + 1, r.second);
+
+    r.second = index - 1;
+    this->ranges.insert(this->ranges.begin() + pos + 1, upper);
+    }
+
+  this->count--;
+
+  return(true);
+  } // END remove()
+
+
+
+const std::deque<std::pair<int, int> > &array_index_ranges::get_ranges() const
+
+  {
+  return(this->ranges);
+  }
@@ -940,3 +940,45 @@ int swap_jobs(
   
   return(rc);
   } /* END swap_jobs() */
+
+
+
+/*
+ * rerank_job()
+ *
+ * Moves pjob to the spot its current queue rank belongs in aj. Used when a
+ * job's qrank changes while it is in a container ordered by rank.
+ *
+ * @return PBSE_NONE, or THING_NOT_FOUND if pjob isn't in aj
+ */
+
+int rerank_job(
+
+  all_jobs *aj,
+  job      *pjob)
+
+  {
+  int rc;
+
+  if ((aj == NULL) ||
+      (pjob == NULL))
+    {
+    rc = PBSE_BAD_PARAMETER;
+    log_err(rc, __func__, "null input pointer");
+    return(rc);
+    }
+
+  aj->lock();
+
+  if (aj->find(pjob->ji_qs.ji_jobid) == NULL)
+    rc = THING_NOT_FOUND;
+  else
+    {
+    aj->remove(pjob->ji_qs.ji_jobid);
+    rc = aj->insert_by_rank(pjob, pjob->ji_qs.ji_jobid, pjob->ji_wattr[JOB_ATR_qrank].at_val.at_long);
+    }
+
+  aj->unlock();
+
+  return(rc);
+  } /* END rerank_job() */
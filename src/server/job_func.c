@@ -150,6 +150,10 @@
 #include "id_map.hpp"
 #include "completed_jobs_map.h"
 #include "utils.h"
+#include "policy_values.h"
+#include "job_journal.hpp"
+#include "job_writer.hpp"
+#include "status_generation.hpp"
 
 #ifndef TRUE
 #define TRUE 1
@@ -210,6 +214,8 @@ static void send_qsub_delmsg(
   pbs_attribute *pattri;
   int            qsub_sock;
 
+  pjob->hydrate_attr(JOB_ATR_variables);
+
   phost = arst_string((char *)"PBS_O_HOST", &pjob->ji_wattr[JOB_ATR_variables]);
 
   if ((phost == NULL) || ((phost = strchr(phost, '=')) == NULL))
@@ -441,13 +447,13 @@ void handle_aborted_job(
         }
       else
         {
-        pjob->ji_wattr[JOB_ATR_Comment].at_flags |= ATR_VFLAG_SET;
+        pjob->ji_wattr[JOB_ATR_Comment].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
         pjob->ji_wattr[JOB_ATR_Comment].at_val.at_str = strdup(text);
         }
       }
 
     pjob->ji_wattr[JOB_ATR_exitstat].at_val.at_long = 271;
-    pjob->ji_wattr[JOB_ATR_exitstat].at_flags |= ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_exitstat].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     set_task(WORK_Immed, KeepSeconds, add_to_completed_jobs, strdup(pjob->ji_qs.ji_jobid), FALSE);
     }
   } /* handle_aborted_job */
@@ -849,6 +855,8 @@ job *copy_job(
   memcpy(&pnewjob->ji_qs, &parent->ji_qs, sizeof(struct jobfix));
 
   /* copy job attributes. some of these are going to have to be modified */
+  parent->hydrate_attrs();
+
   for (i = 0; i < JOB_ATR_LAST; i++)
     {
     if (parent->ji_wattr[i].at_flags & ATR_VFLAG_SET)
@@ -1012,6 +1020,7 @@ job *job_clone(
   strcpy(pnewjob->ji_qs.ji_fileprefix, basename);
 
   /* copy job attributes. some of these are going to have to be modified */
+  template_job->hydrate_attrs();
 
   for (i = 0; i < JOB_ATR_LAST; i++)
     {
@@ -1066,12 +1075,12 @@ job *job_clone(
      * a problem during setting up the array and want to abort before any of
      * the jobs run */
     pnewjob->ji_wattr[JOB_ATR_hold].at_val.at_long |= HOLD_a;
-    pnewjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET;
+    pnewjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     }
 
   /* set JOB_ATR_job_array_id */
   pnewjob->ji_wattr[JOB_ATR_job_array_id].at_val.at_long = taskid;
-  pnewjob->ji_wattr[JOB_ATR_job_array_id].at_flags |= ATR_VFLAG_SET;
+  pnewjob->ji_wattr[JOB_ATR_job_array_id].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
   /* set PBS_ARRAYID enironment variable */
   clear_attr(&tempattr, &job_attr_def[JOB_ATR_variables]);
@@ -1177,10 +1186,10 @@ int create_and_queue_array_subjob(
   svr_setjobstate(pjobclone, newstate, newsub, FALSE);
 
   pjobclone->ji_wattr[JOB_ATR_qrank].at_val.at_long = ++queue_rank;
-  pjobclone->ji_wattr[JOB_ATR_qrank].at_flags |= ATR_VFLAG_SET;
+  pjobclone->ji_wattr[JOB_ATR_qrank].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
   // Clear this so that the jobs get a queued entry in the accounting file
-  pjobclone->ji_wattr[JOB_ATR_qtime].at_flags &= ~ATR_VFLAG_SET;
+  pjobclone->ji_wattr[JOB_ATR_qtime].at_flags = (pjobclone->ji_wattr[JOB_ATR_qtime].at_flags & ~ATR_VFLAG_SET) | ATR_VFLAG_MODIFY;
 
   array_mgr.unlock();
 
@@ -1288,6 +1297,7 @@ int perform_array_postprocessing(
 
       get_svr_attr_b(SRV_ATR_MoabArrayCompatible, &moab_compatible);
       pjob->ji_wattr[JOB_ATR_hold].at_val.at_long &= ~HOLD_a;
+      pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_MODIFY;
       
       if (moab_compatible == true)
         {
@@ -1302,11 +1312,11 @@ int perform_array_postprocessing(
       
       if (pjob->ji_wattr[JOB_ATR_hold].at_val.at_long == 0)
         {
-        pjob->ji_wattr[JOB_ATR_hold].at_flags &= ~ATR_VFLAG_SET;
+        pjob->ji_wattr[JOB_ATR_hold].at_flags = (pjob->ji_wattr[JOB_ATR_hold].at_flags & ~ATR_VFLAG_SET) | ATR_VFLAG_MODIFY;
         }
       else
         {
-        pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET;
+        pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
         }
       
       pjob->ji_modified = TRUE;
@@ -1420,13 +1430,9 @@ void *job_clone_wt(
 
   template_job_mgr.unlock();
 
-  for (size_t i = 0; i < pa->uncreated_ids.size(); i++)
+  while (pa->uncreated_ids.empty() == false)
     {
-    if (pa->uncreated_ids[i] == -1)
-      continue;
-
-    int index = pa->uncreated_ids[i];
-    pa->uncreated_ids[i] = -1;
+    int index = pa->uncreated_ids.pop_front();
     pa->ai_qs.highest_id_created = index;
 
     /* This job already exists. This can happen when trying to recover a job
@@ -1446,7 +1452,7 @@ void *job_clone_wt(
     if ((pa->ai_qs.idle_slot_limit != NO_SLOT_LIMIT) &&
         (pa->ai_qs.idle_slot_limit <= pa->ai_qs.num_idle))
       break;
-    }  /* END for (i) */
+    }  /* END while (uncreated ids) */
 
   array_save(pa);
 
@@ -1765,6 +1771,8 @@ int record_jobinfo(
   bf += pjob->ji_qs.ji_jobid;
   bf += "</Job_Id>\n";
 
+  pjob->hydrate_attrs();
+
   for (i = 0; i < JOB_ATR_LAST; i++)
     {
     pattr = &(pjob->ji_wattr[i]);
@@ -1957,7 +1965,7 @@ int svr_job_purge(
           do_delete_array = true;
           }
         else
-          array_save(pa);
+          array_save_counters(pa);
         
         unlock_ai_mutex(pa, __func__, "1", LOGLEVEL);
         }
@@ -1999,10 +2007,27 @@ int svr_job_purge(
     pjob_mutex.set_unlock_on_exit(false); /* job_free will release lock */
     }
 
+  status_gen.record_deleted(STATUS_GEN_JOB, job_id);
+
   // get the adjusted path_jobs
   //  using the preserved job id in job_id
   adjusted_path_jobs = get_path_jobdata(job_id, path_jobs);
 
+  /* a queued save would recreate the job's files after we remove them */
+  if (job_writer_threads > 0)
+    server_job_writer.forget(job_id);
+
+  /* make sure a replay of the journal doesn't bring the job back */
+  if (job_journal_enabled == true)
+    {
+    unsigned long seq = server_job_journal.append(JOURNAL_PURGE, job_id, job_fileprefix,
+                                                  job_is_array_template, NULL, 0);
+
+    if ((seq == 0) ||
+        (server_job_journal.commit(seq) != PBSE_NONE))
+      log_err(-1, __func__, "Unable to journal the purge of this job");
+    }
+
   /* pjob->ji_mutex is unlocked at this point */
   /* delete the script file */
   if ((job_has_arraystruct == false) || 
@@ -2100,6 +2125,14 @@ int svr_job_purge(
     log_record(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, job_id, log_buf);
     }
 
+  /* delete the quick save record, if any */
+  snprintf(namebuf, sizeof(namebuf), "%s%s%s", 
+    adjusted_path_jobs.c_str(), job_fileprefix, JOB_FILE_QUICK);
+
+  if ((unlink(namebuf) < 0) &&
+      (errno != ENOENT))
+    log_err(errno, __func__, msg_err_purgejob);
+
   if (do_delete_array == true)
     array_delete(array_id);
 
@@ -2306,18 +2339,19 @@ int fix_external_exec_hosts(
     {
     free(pjob->ji_wattr[JOB_ATR_login_node_id].at_val.at_str);
     pjob->ji_wattr[JOB_ATR_login_node_id].at_val.at_str = NULL;
-    pjob->ji_wattr[JOB_ATR_login_node_id].at_flags &= ~ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_login_node_id].at_flags = (pjob->ji_wattr[JOB_ATR_login_node_id].at_flags & ~ATR_VFLAG_SET) | ATR_VFLAG_MODIFY;
     }
 
   if (pjob->ji_wattr[JOB_ATR_login_prop].at_val.at_str != NULL)
     {
     free(pjob->ji_wattr[JOB_ATR_login_prop].at_val.at_str);
     pjob->ji_wattr[JOB_ATR_login_prop].at_val.at_str = NULL;
-    pjob->ji_wattr[JOB_ATR_login_prop].at_flags &= ~ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_login_prop].at_flags = (pjob->ji_wattr[JOB_ATR_login_prop].at_flags & ~ATR_VFLAG_SET) | ATR_VFLAG_MODIFY;
     }
 
   free(exec_host);
   pjob->ji_wattr[JOB_ATR_exec_host].at_val.at_str = strdup(external_execs.c_str());
+  pjob->ji_wattr[JOB_ATR_exec_host].at_flags |= ATR_VFLAG_MODIFY;
 
   return(PBSE_NONE);
   } /* END fix_external_exec_hosts() */
@@ -2365,6 +2399,7 @@ int fix_cray_exec_hosts(
 
   free(exec);
   pjob->ji_wattr[JOB_ATR_exec_host].at_val.at_str = new_exec;
+  pjob->ji_wattr[JOB_ATR_exec_host].at_flags |= ATR_VFLAG_MODIFY;
 
   return(PBSE_NONE);
   } /* END fix_cray_exec_hosts() */
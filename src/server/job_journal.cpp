@@ -0,0 +1,692 @@
+/*
+ * job_journal.cpp - an optional write-ahead log for job images
+ *
+ * When the job_journal server parameter is set, job_save() appends each job
+ * image to a single sequential journal instead of rewriting the job's own
+ * file. Saves that arrive while the journal is being synced are written and
+ * synced together (group commit). A background thread periodically rotates
+ * the journal and compacts it into the regular .JB/.TA/.JQ files, writing
+ * each job once no matter how many times it was saved. pbsd_init() replays
+ * any journal left behind the same way before recovering jobs.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "job_journal.hpp"
+#include "pbs_error.h"
+#include "log.h"
+#include "../lib/Liblog/pbs_log.h"
+
+job_journal server_job_journal;
+
+int write_journal_entry(const std::string &jobid, const journal_entry &je);
+
+
+
+journal_entry::journal_entry() : purged(false), is_template(false), fileprefix(), image(), quick()
+  {
+  }
+
+
+
+job_journal::job_journal() : jj_path(), jj_fd(-1), jj_size(0), jj_last_compact(0), jj_pending(),
+                             jj_next_seq(0), jj_durable_seq(0), jj_failed(),
+                             jj_flushing(false), jj_purged()
+
+  {
+  pthread_mutex_init(&this->jj_mutex, NULL);
+  pthread_mutex_init(&this->jj_compact_mutex, NULL);
+  pthread_mutex_init(&this->jj_purge_mutex, NULL);
+  pthread_cond_init(&this->jj_cond, NULL);
+  }
+
+
+
+job_journal::~job_journal()
+
+  {
+  this->close_journal();
+  }
+
+
+
+/*
+ * checksum()
+ *
+ * FNV-1a hash of a record payload, used to find a torn record at the end of
+ * a journal.
+ */
+
+unsigned long job_journal::checksum(
+
+  const char *buf,
+  size_t      len)
+
+  {
+  unsigned long hash = 2166136261UL;
+
+  for (size_t i = 0; i < len; i++)
+    {
+    hash ^= (unsigned char)buf[i];
+    hash *= 16777619UL;
+    }
+
+  return(hash);
+  } /* END checksum() */
+
+
+
+/*
+ * open_journal()
+ *
+ * Opens (creating if needed) the journal for appending
+ * @param path - the path to the journal
+ * @return PBSE_NONE on success, -1 on failure
+ */
+
+int job_journal::open_journal(
+
+  const char *path)
+
+  {
+  int fd;
+
+  pthread_mutex_lock(&this->jj_mutex);
+
+  if ((fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0600)) < 0)
+    {
+    pthread_mutex_unlock(&this->jj_mutex);
+    log_err(errno, __func__, "cannot open the job journal");
+    return(-1);
+    }
+
+  this->jj_path = path;
+  this->jj_fd = fd;
+  this->jj_size = lseek(fd, 0, SEEK_END);
+  this->jj_last_compact = time(NULL);
+
+  pthread_mutex_unlock(&this->jj_mutex);
+
+  return(PBSE_NONE);
+  } /* END open_journal() */
+
+
+
+void job_journal::close_journal()
+
+  {
+  pthread_mutex_lock(&this->jj_mutex);
+
+  while (this->jj_flushing == true)
+    pthread_cond_wait(&this->jj_cond, &this->jj_mutex);
+
+  if (this->jj_fd >= 0)
+    {
+    if ((this->jj_pending.size() != 0) &&
+        (this->write_pending(this->jj_pending) != PBSE_NONE))
+      this->record_failed(this->jj_durable_seq + 1, this->jj_next_seq);
+
+    this->jj_pending.clear();
+    close(this->jj_fd);
+    this->jj_fd = -1;
+    }
+
+  this->jj_durable_seq = this->jj_next_seq;
+  pthread_cond_broadcast(&this->jj_cond);
+
+  pthread_mutex_unlock(&this->jj_mutex);
+  } /* END close_journal() */
+
+
+
+bool job_journal::is_open()
+
+  {
+  bool open;
+
+  pthread_mutex_lock(&this->jj_mutex);
+  open = this->jj_fd >= 0;
+  pthread_mutex_unlock(&this->jj_mutex);
+
+  return(open);
+  } /* END is_open() */
+
+
+
+/*
+ * append()
+ *
+ * Queues a record for the next group commit. The record isn't durable until
+ * commit() has returned for its sequence number.
+ *
+ * @return the record's sequence number, or 0 if the journal isn't open
+ */
+
+unsigned long job_journal::append(
+
+  int         type,
+  const char *jobid,
+  const char *fileprefix,
+  bool        is_template,
+  const char *payload,
+  size_t      len)
+
+  {
+  journal_record_header jr;
+  unsigned long         seq;
+
+  memset(&jr, 0, sizeof(jr));
+  jr.jr_magic = JOURNAL_MAGIC;
+  jr.jr_type = type;
+  jr.jr_is_template = is_template;
+  jr.jr_length = len;
+  jr.jr_checksum = checksum(payload, len);
+  snprintf(jr.jr_jobid, sizeof(jr.jr_jobid), "%s", jobid);
+  snprintf(jr.jr_fileprefix, sizeof(jr.jr_fileprefix), "%s", fileprefix);
+
+  /* wait out any compaction write of this job so it can't land after the purge */
+  if (type == JOURNAL_PURGE)
+    pthread_mutex_lock(&this->jj_purge_mutex);
+
+  pthread_mutex_lock(&this->jj_mutex);
+
+  if (this->jj_fd < 0)
+    {
+    pthread_mutex_unlock(&this->jj_mutex);
+
+    if (type == JOURNAL_PURGE)
+      pthread_mutex_unlock(&this->jj_purge_mutex);
+
+    return(0);
+    }
+
+  this->jj_pending.append((const char *)&jr, sizeof(jr));
+
+  if (len > 0)
+    this->jj_pending.append(payload, len);
+
+  if (type == JOURNAL_PURGE)
+    this->jj_purged.insert(jobid);
+
+  seq = ++this->jj_next_seq;
+
+  pthread_mutex_unlock(&this->jj_mutex);
+
+  if (type == JOURNAL_PURGE)
+    pthread_mutex_unlock(&this->jj_purge_mutex);
+
+  return(seq);
+  } /* END append() */
+
+
+
+/*
+ * write_pending()
+ *
+ * Writes and syncs a batch of records. If that fails, whatever part of the
+ * batch reached the file is cut off again so that later records aren't
+ * appended after a torn one, where replay could never reach them.
+ * The caller must be the only thread writing to jj_fd, and accounts for
+ * the batch in jj_size.
+ */
+
+int job_journal::write_pending(
+
+  const std::string &batch)
+
+  {
+  size_t  written = 0;
+  ssize_t rc;
+  int     ret = PBSE_NONE;
+
+  while (written < batch.size())
+    {
+    rc = write(this->jj_fd, batch.c_str() + written, batch.size() - written);
+
+    if (rc < 0)
+      {
+      if (errno == EINTR)
+        continue;
+
+      log_err(errno, __func__, "cannot write to the job journal");
+      ret = -1;
+      break;
+      }
+
+    written += rc;
+    }
+
+  if ((ret == PBSE_NONE) &&
+      (fdatasync(this->jj_fd) != 0))
+    {
+    log_err(errno, __func__, "cannot sync the job journal");
+    ret = -1;
+    }
+
+  if (ret != PBSE_NONE)
+    {
+    /* the descriptor is O_APPEND, so the next write goes to the new end */
+    if ((ftruncate(this->jj_fd, this->jj_size) != 0) ||
+        (lseek(this->jj_fd, this->jj_size, SEEK_SET) < 0))
+      log_err(errno, __func__, "cannot remove a failed write from the job journal");
+    }
+
+  return(ret);
+  } /* END write_pending() */
+
+
+
+/*
+ * record_failed()
+ *
+ * Remembers that the records from low to high never reached the disk, so
+ * that every waiter on one of them is told so, however late it wakes up.
+ * Consecutive failed batches are merged into one range.
+ * The caller must hold jj_mutex.
+ */
+
+void job_journal::record_failed(
+
+  unsigned long low,
+  unsigned long high)
+
+  {
+  std::map<unsigned long, unsigned long>::iterator it;
+
+  if (low > high)
+    return;
+
+  it = this->jj_failed.find(low - 1);
+
+  if (it != this->jj_failed.end())
+    {
+    low = it->second;
+    this->jj_failed.erase(it);
+    }
+
+  this->jj_failed[high] = low;
+  } /* END record_failed() */
+
+
+
+/*
+ * has_failed()
+ *
+ * @return true if the record with this sequence number failed to write.
+ * The caller must hold jj_mutex.
+ */
+
+bool job_journal::has_failed(
+
+  unsigned long seq)
+
+  {
+  std::map<unsigned long, unsigned long>::iterator it = this->jj_failed.lower_bound(seq);
+
+  return((it != this->jj_failed.end()) &&
+         (it->second <= seq));
+  } /* END has_failed() */
+
+
+
+/*
+ * commit()
+ *
+ * Waits until the record with this sequence number is on disk. The first
+ * waiter writes and syncs everything pending, so concurrent saves share
+ * one write and one fdatasync.
+ *
+ * @param seq - the sequence number returned by append()
+ * @return PBSE_NONE if the record is durable, -1 otherwise
+ */
+
+int job_journal::commit(
+
+  unsigned long seq)
+
+  {
+  int rc = PBSE_NONE;
+
+  if (seq == 0)
+    return(-1);
+
+  pthread_mutex_lock(&this->jj_mutex);
+
+  while (this->jj_durable_seq < seq)
+    {
+    if (this->jj_flushing == false)
+      {
+      std::string   batch;
+      unsigned long batch_low = this->jj_durable_seq + 1;
+      unsigned long batch_high = this->jj_next_seq;
+      int           write_rc;
+
+      batch.swap(this->jj_pending);
+      this->jj_flushing = true;
+      pthread_mutex_unlock(&this->jj_mutex);
+
+      write_rc = this->write_pending(batch);
+
+      pthread_mutex_lock(&this->jj_mutex);
+      this->jj_flushing = false;
+      this->jj_durable_seq = batch_high;
+
+      if (write_rc == PBSE_NONE)
+        this->jj_size += batch.size();
+      else
+        this->record_failed(batch_low, batch_high);
+
+      pthread_cond_broadcast(&this->jj_cond);
+      }
+    else
+      pthread_cond_wait(&this->jj_cond, &this->jj_mutex);
+    }
+
+  if (this->has_failed(seq) == true)
+    rc = -1;
+
+  pthread_mutex_unlock(&this->jj_mutex);
+
+  return(rc);
+  } /* END commit() */
+
+
+
+bool job_journal::needs_compaction(
+
+  time_t time_now)
+
+  {
+  bool needed;
+
+  pthread_mutex_lock(&this->jj_mutex);
+  needed = (this->jj_fd >= 0) &&
+           ((this->jj_size >= JOURNAL_COMPACT_SIZE) ||
+            ((this->jj_size > 0) &&
+             (time_now - this->jj_last_compact >= JOURNAL_COMPACT_INTERVAL)));
+  pthread_mutex_unlock(&this->jj_mutex);
+
+  return(needed);
+  } /* END needs_compaction() */
+
+
+
+/*
+ * read_journal()
+ *
+ * Reads a journal and collapses its records into the final state of each job.
+ * Reading stops at the first incomplete or corrupt record, which can only be
+ * a write that was never committed.
+ *
+ * @param path - the journal to read
+ * @param entries - populated with the final state of each job in the journal
+ * @return the number of records read, or -1 if the journal can't be opened
+ */
+
+int job_journal::read_journal(
+
+  const char                           *path,
+  std::map<std::string, journal_entry> &entries)
+
+  {
+  FILE                  *fp;
+  journal_record_header  jr;
+  int                    records = 0;
+  char                   log_buf[LOCAL_LOG_BUF_SIZE];
+
+  if ((fp = fopen(path, "r")) == NULL)
+    return(-1);
+
+  while (fread(&jr, sizeof(jr), 1, fp) == 1)
+    {
+    std::string payload;
+
+    if ((jr.jr_magic != JOURNAL_MAGIC) ||
+        (jr.jr_length < 0))
+      break;
+
+    jr.jr_jobid[sizeof(jr.jr_jobid) - 1] = '\0';
+    jr.jr_fileprefix[sizeof(jr.jr_fileprefix) - 1] = '\0';
+
+    if (jr.jr_length > 0)
+      {
+      payload.resize(jr.jr_length);
+
+      if (fread(&payload[0], jr.jr_length, 1, fp) != 1)
+        break;
+      }
+
+    if (checksum(payload.c_str(), payload.size()) != jr.jr_checksum)
+      break;
+
+    journal_entry &je = entries[jr.jr_jobid];
+
+    je.fileprefix = jr.jr_fileprefix;
+    je.is_template = jr.jr_is_template;
+
+    switch (jr.jr_type)
+      {
+      case JOURNAL_SAVE:
+
+        je.purged = false;
+        je.image.swap(payload);
+        je.quick.clear();
+        break;
+
+      case JOURNAL_QUICK:
+
+        je.purged = false;
+        je.quick.swap(payload);
+        break;
+
+      case JOURNAL_PURGE:
+
+        je.purged = true;
+        je.image.clear();
+        je.quick.clear();
+        break;
+      }
+
+    records++;
+    }
+
+  if (!feof(fp))
+    {
+    snprintf(log_buf, sizeof(log_buf),
+      "ignoring incomplete record after %d records in job journal %s", records, path);
+    log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, log_buf);
+    }
+
+  fclose(fp);
+
+  return(records);
+  } /* END read_journal() */
+
+
+
+/*
+ * replay()
+ *
+ * Writes out the final state of every job in a journal and then removes
+ * the journal.
+ *
+ * @param path - the journal to replay
+ * @param apply - writes one job's final state to its job files
+ * @return PBSE_NONE on success (or if there's no journal), -1 on failure
+ */
+
+int job_journal::replay(
+
+  const char         *path,
+  journal_apply_func  apply)
+
+  {
+  std::map<std::string, journal_entry>           entries;
+  std::map<std::string, journal_entry>::iterator it;
+  int                                            rc = PBSE_NONE;
+  int                                            records;
+  char                                           log_buf[LOCAL_LOG_BUF_SIZE];
+
+  if ((records = read_journal(path, entries)) < 0)
+    return(PBSE_NONE);
+
+  for (it = entries.begin(); it != entries.end(); it++)
+    {
+    if (apply(it->first, it->second) != PBSE_NONE)
+      rc = -1;
+    }
+
+  if (rc == PBSE_NONE)
+    unlink(path);
+
+  snprintf(log_buf, sizeof(log_buf), "replayed %d records for %d jobs from %s",
+    records, (int)entries.size(), path);
+  log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, log_buf);
+
+  return(rc);
+  } /* END replay() */
+
+
+
+/*
+ * compact()
+ *
+ * Rotates the journal and folds the rotated records into the job files.
+ * Saves made while compacting go to the new journal, and jobs purged since
+ * the rotation are skipped so their files aren't recreated.
+ *
+ * @param apply - writes one job's final state to its job files
+ * @return PBSE_NONE on success, -1 on failure
+ */
+
+int job_journal::compact(
+
+  journal_apply_func apply)
+
+  {
+  std::map<std::string, journal_entry>           entries;
+  std::map<std::string, journal_entry>::iterator it;
+  std::string                                    old_path;
+  int                                            rc = PBSE_NONE;
+
+  pthread_mutex_lock(&this->jj_compact_mutex);
+  pthread_mutex_lock(&this->jj_mutex);
+
+  if (this->jj_fd < 0)
+    {
+    pthread_mutex_unlock(&this->jj_mutex);
+    pthread_mutex_unlock(&this->jj_compact_mutex);
+    return(-1);
+    }
+
+  old_path = this->jj_path + JOB_JOURNAL_OLD_SUFFIX;
+
+  /* a previous compaction didn't finish, so finish it before rotating */
+  if (access(old_path.c_str(), F_OK) == 0)
+    {
+    pthread_mutex_unlock(&this->jj_mutex);
+
+    if (replay(old_path.c_str(), apply) != PBSE_NONE)
+      {
+      pthread_mutex_unlock(&this->jj_compact_mutex);
+      return(-1);
+      }
+
+    pthread_mutex_lock(&this->jj_mutex);
+    }
+
+  while (this->jj_flushing == true)
+    pthread_cond_wait(&this->jj_cond, &this->jj_mutex);
+
+  if ((this->jj_pending.size() != 0) &&
+      (this->write_pending(this->jj_pending) != PBSE_NONE))
+    this->record_failed(this->jj_durable_seq + 1, this->jj_next_seq);
+
+  this->jj_pending.clear();
+
+  this->jj_durable_seq = this->jj_next_seq;
+  pthread_cond_broadcast(&this->jj_cond);
+
+  if (rename(this->jj_path.c_str(), old_path.c_str()) != 0)
+    rc = -1;
+  else
+    {
+    close(this->jj_fd);
+
+    if ((this->jj_fd = open(this->jj_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0600)) < 0)
+      rc = -1;
+
+    this->jj_size = 0;
+    this->jj_purged.clear();
+    }
+
+  this->jj_last_compact = time(NULL);
+  pthread_mutex_unlock(&this->jj_mutex);
+
+  if (rc != PBSE_NONE)
+    {
+    log_err(errno, __func__, "cannot rotate the job journal");
+    pthread_mutex_unlock(&this->jj_compact_mutex);
+    return(rc);
+    }
+
+  job_journal::read_journal(old_path.c_str(), entries);
+
+  for (it = entries.begin(); it != entries.end(); it++)
+    {
+    bool purged_since_rotation;
+
+    /* a purge can't be journaled between this check and the write */
+    pthread_mutex_lock(&this->jj_purge_mutex);
+
+    pthread_mutex_lock(&this->jj_mutex);
+    purged_since_rotation = this->jj_purged.find(it->first) != this->jj_purged.end();
+    pthread_mutex_unlock(&this->jj_mutex);
+
+    if ((purged_since_rotation == false) &&
+        (apply(it->first, it->second) != PBSE_NONE))
+      rc = -1;
+
+    pthread_mutex_unlock(&this->jj_purge_mutex);
+    }
+
+  if (rc == PBSE_NONE)
+    unlink(old_path.c_str());
+
+  pthread_mutex_unlock(&this->jj_compact_mutex);
+
+  return(rc);
+  } /* END compact() */
+
+
+
+/*
+ * compact_job_journal()
+ *
+ * Thread that compacts the job journal when it grows large or old
+ */
+
+void *compact_job_journal(
+
+  void *vp)
+
+  {
+  while (1)
+    {
+    if (server_job_journal.needs_compaction(time(NULL)) == true)
+      server_job_journal.compact(write_journal_entry);
+
+    sleep(JOURNAL_COMPACT_SLEEP_TIME);
+    }
+
+  return(NULL);
+  } /* END compact_job_journal() */
+
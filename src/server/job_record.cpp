@@ -0,0 +1,412 @@
+/*
+ * job_record.cpp - the binary job record format
+ *
+ * See job_record.hpp for the layout. This file only knows the format; the
+ * job's attributes are encoded and decoded by job_recov.c.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "job_record.hpp"
+#include "pbs_error.h"
+
+
+
+/*
+ * job_record_checksum() - 64 bit FNV-1a hash used to detect torn or
+ * corrupted records
+ */
+
+uint64_t job_record_checksum(
+
+  const char *buf, /* I */
+  size_t      len) /* I */
+
+  {
+  const unsigned char *p = (const unsigned char *)buf;
+  uint64_t             hash = 14695981039346656037ULL;
+
+  for (size_t i = 0; i < len; i++)
+    {
+    hash ^= p[i];
+    hash *= 1099511628211ULL;
+    }
+
+  return(hash);
+  } /* END job_record_checksum() */
+
+
+
+/*
+ * is_job_record() - true if buf starts with a job record's magic
+ */
+
+bool is_job_record(
+
+  const char *buf, /* I */
+  size_t      len) /* I */
+
+  {
+  uint32_t magic;
+
+  if (len < sizeof(magic))
+    return(false);
+
+  memcpy(&magic, buf, sizeof(magic));
+
+  return(magic == JOB_RECORD_MAGIC);
+  } /* END is_job_record() */
+
+
+
+job_record_builder::job_record_builder(
+
+  const struct jobfix &qs)
+
+  : jb_image(), jb_attr_count(0), jb_attr_start(0)
+
+  {
+  job_record_header jr;
+
+  memset(&jr, 0, sizeof(jr));
+  jb_image.reserve(4096);
+  jb_image.append((const char *)&jr, sizeof(jr));
+  jb_image.append((const char *)&qs, sizeof(qs));
+  }
+
+
+
+/*
+ * end_attr() - fill in the size of the open attribute block
+ */
+
+void job_record_builder::end_attr()
+
+  {
+  uint32_t size;
+
+  if (this->jb_attr_start == 0)
+    return;
+
+  size = this->jb_image.size() - this->jb_attr_start;
+  this->jb_image.replace(this->jb_attr_start + offsetof(job_record_attr, ja_size),
+                         sizeof(size), (const char *)&size, sizeof(size));
+
+  this->jb_attr_start = 0;
+  } /* END end_attr() */
+
+
+
+/*
+ * begin_attr() - start the block for an attribute
+ *
+ * @param index - the attribute's index in job_attr_def, or JOB_RECORD_NO_INDEX
+ * @param name - the attribute's name
+ */
+
+void job_record_builder::begin_attr(
+
+  int         index, /* I */
+  const char *name)  /* I */
+
+  {
+  job_record_attr ja;
+
+  this->end_attr();
+
+  memset(&ja, 0, sizeof(ja));
+  ja.ja_index = ((index < 0) || (index >= JOB_RECORD_NO_INDEX)) ? JOB_RECORD_NO_INDEX : index;
+  ja.ja_name_len = strlen(name) + 1;
+
+  this->jb_attr_start = this->jb_image.size();
+  this->jb_image.append((const char *)&ja, sizeof(ja));
+  this->jb_image.append(name, ja.ja_name_len);
+  this->jb_attr_count++;
+  } /* END begin_attr() */
+
+
+
+/*
+ * add_value() - add a value to the open attribute block
+ *
+ * @param resc - the resource name for resource lists, otherwise NULL
+ * @param value - the encoded value
+ * @param flags - the value's at_flags
+ */
+
+void job_record_builder::add_value(
+
+  const char   *resc,  /* I */
+  const char   *value, /* I */
+  unsigned int  flags) /* I */
+
+  {
+  job_record_value jv;
+  uint32_t         count;
+  size_t           count_offset;
+
+  if (this->jb_attr_start == 0)
+    return;
+
+  jv.jv_flags = flags;
+  jv.jv_resc_len = (resc != NULL) ? strlen(resc) + 1 : 0;
+  jv.jv_value_len = strlen(value) + 1;
+
+  this->jb_image.append((const char *)&jv, sizeof(jv));
+
+  if (resc != NULL)
+    this->jb_image.append(resc, jv.jv_resc_len);
+
+  this->jb_image.append(value, jv.jv_value_len);
+
+  count_offset = this->jb_attr_start + offsetof(job_record_attr, ja_value_count);
+  memcpy(&count, this->jb_image.data() + count_offset, sizeof(count));
+  count++;
+  this->jb_image.replace(count_offset, sizeof(count), (const char *)&count, sizeof(count));
+  } /* END add_value() */
+
+
+
+/*
+ * finish() - close the record and return its image
+ */
+
+const std::string &job_record_builder::finish()
+
+  {
+  job_record_header jr;
+  struct jobfix     qs;
+
+  this->end_attr();
+
+  memcpy(&qs, this->jb_image.data() + sizeof(jr), sizeof(qs));
+
+  jr.jr_magic = JOB_RECORD_MAGIC;
+  jr.jr_version = JOB_RECORD_VERSION;
+  jr.jr_header_size = sizeof(jr);
+  jr.jr_qs_version = qs.qs_version;
+  jr.jr_qs_size = sizeof(qs);
+  jr.jr_attr_count = this->jb_attr_count;
+  jr.jr_reserved = 0;
+  jr.jr_size = this->jb_image.size();
+  jr.jr_checksum = job_record_checksum(this->jb_image.data() + sizeof(jr),
+                                       this->jb_image.size() - sizeof(jr));
+
+  this->jb_image.replace(0, sizeof(jr), (const char *)&jr, sizeof(jr));
+
+  return(this->jb_image);
+  } /* END finish() */
+
+
+
+job_record_reader::job_record_reader() : jr_buf(NULL), jr_len(0), jr_offset(0),
+                                         jr_attr_end(0), jr_attrs_left(0),
+                                         jr_values_left(0), jr_qs(NULL)
+
+  {
+  }
+
+
+
+/*
+ * open_record() - check a record's header and checksum
+ *
+ * @param buf - the record
+ * @param len - the number of bytes in buf
+ * @return PBSE_NONE if the record can be read, PBSE_INVALID_SYNTAX if buf
+ * isn't a job record, -1 if it is a record that can't be read
+ */
+
+int job_record_reader::open_record(
+
+  const char *buf,     /* I */
+  size_t      len,     /* I */
+  char       *log_buf, /* O */
+  size_t      buf_len) /* I */
+
+  {
+  job_record_header jr;
+
+  if (is_job_record(buf, len) == false)
+    return(PBSE_INVALID_SYNTAX);
+
+  if (len < sizeof(jr))
+    {
+    snprintf(log_buf, buf_len, "job record is truncated");
+    return(-1);
+    }
+
+  memcpy(&jr, buf, sizeof(jr));
+
+  /* newer versions may only append to the header */
+  if ((jr.jr_version > JOB_RECORD_VERSION) ||
+      (jr.jr_header_size < sizeof(jr)))
+    {
+    snprintf(log_buf, buf_len, "unsupported job record version %d", (int)jr.jr_version);
+    return(-1);
+    }
+
+  if ((jr.jr_size != len) ||
+      (jr.jr_header_size > len))
+    {
+    snprintf(log_buf, buf_len, "job record is %lu bytes, expected %lu",
+      (unsigned long)len, (unsigned long)jr.jr_size);
+    return(-1);
+    }
+
+  if (jr.jr_checksum != job_record_checksum(buf + jr.jr_header_size, len - jr.jr_header_size))
+    {
+    snprintf(log_buf, buf_len, "job record checksum mismatch");
+    return(-1);
+    }
+
+  if ((jr.jr_qs_version != PBS_QS_VERSION) ||
+      (jr.jr_qs_size != sizeof(struct jobfix)) ||
+      (jr.jr_header_size + jr.jr_qs_size > len))
+    {
+    snprintf(log_buf, buf_len, "job record has an incompatible ji_qs (version %#010x size %u)",
+      jr.jr_qs_version, jr.jr_qs_size);
+    return(-1);
+    }
+
+  this->jr_buf = buf;
+  this->jr_len = len;
+  this->jr_qs = buf + jr.jr_header_size;
+  this->jr_offset = jr.jr_header_size + jr.jr_qs_size;
+  this->jr_attr_end = this->jr_offset;
+  this->jr_attrs_left = jr.jr_attr_count;
+  this->jr_values_left = 0;
+
+  return(PBSE_NONE);
+  } /* END open_record() */
+
+
+
+void job_record_reader::get_qs(
+
+  struct jobfix &qs) const
+
+  {
+  memcpy(&qs, this->jr_qs, sizeof(qs));
+  } /* END get_qs() */
+
+
+
+/*
+ * next_attr() - move to the next attribute block. Any values of the current
+ * block that weren't read are skipped.
+ *
+ * @return false when there are no more blocks or the block is malformed
+ */
+
+bool job_record_reader::next_attr(
+
+  int         &index, /* O */
+  const char *&name)  /* O */
+
+  {
+  job_record_attr ja;
+
+  if (this->jr_attrs_left == 0)
+    return(false);
+
+  this->jr_offset = this->jr_attr_end;
+
+  if (this->jr_len - this->jr_offset < sizeof(ja))
+    return(false);
+
+  memcpy(&ja, this->jr_buf + this->jr_offset, sizeof(ja));
+
+  if ((ja.ja_size < sizeof(ja) + ja.ja_name_len) ||
+      (ja.ja_size > this->jr_len - this->jr_offset) ||
+      (ja.ja_name_len == 0) ||
+      (this->jr_buf[this->jr_offset + sizeof(ja) + ja.ja_name_len - 1] != '\0'))
+    return(false);
+
+  name = this->jr_buf + this->jr_offset + sizeof(ja);
+  index = (ja.ja_index == JOB_RECORD_NO_INDEX) ? -1 : ja.ja_index;
+
+  this->jr_attr_end = this->jr_offset + ja.ja_size;
+  this->jr_offset += sizeof(ja) + ja.ja_name_len;
+  this->jr_values_left = ja.ja_value_count;
+  this->jr_attrs_left--;
+
+  return(true);
+  } /* END next_attr() */
+
+
+
+/*
+ * next_value() - read the next value of the current attribute block
+ *
+ * @return false when the block has no more values or is malformed
+ */
+
+bool job_record_reader::next_value(
+
+  const char   *&resc,  /* O */
+  const char   *&value, /* O */
+  unsigned int  &flags) /* O */
+
+  {
+  job_record_value jv;
+  size_t           left;
+
+  if (this->jr_values_left == 0)
+    return(false);
+
+  left = this->jr_attr_end - this->jr_offset;
+
+  if (left < sizeof(jv))
+    return(false);
+
+  memcpy(&jv, this->jr_buf + this->jr_offset, sizeof(jv));
+  left -= sizeof(jv);
+
+  if ((jv.jv_value_len == 0) ||
+      (jv.jv_resc_len > left) ||
+      (jv.jv_value_len > left - jv.jv_resc_len))
+    return(false);
+
+  this->jr_offset += sizeof(jv);
+
+  if (jv.jv_resc_len != 0)
+    {
+    if (this->jr_buf[this->jr_offset + jv.jv_resc_len - 1] != '\0')
+      return(false);
+
+    resc = this->jr_buf + this->jr_offset;
+    this->jr_offset += jv.jv_resc_len;
+    }
+  else
+    resc = NULL;
+
+  if (this->jr_buf[this->jr_offset + jv.jv_value_len - 1] != '\0')
+    return(false);
+
+  value = this->jr_buf + this->jr_offset;
+  this->jr_offset += jv.jv_value_len;
+  flags = jv.jv_flags;
+  this->jr_values_left--;
+
+  return(true);
+  } /* END next_value() */
+
+
+
+/*
+ * is_complete() - true once every block has been read and nothing follows
+ * the last one
+ */
+
+bool job_record_reader::is_complete() const
+
+  {
+  return((this->jr_attrs_left == 0) &&
+         (this->jr_values_left == 0) &&
+         (this->jr_attr_end == this->jr_len));
+  } /* END is_complete() */
@@ -101,6 +101,8 @@
 #include <stdio.h>
 #include <time.h>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 #include <pthread.h>
@@ -120,8 +122,10 @@
 #endif
 #ifndef PBS_MOM
 #include "array.h"
-#include "../lib/Libutils/u_lock_ctl.h" /* lock_ss, unlock_ss */
 #include "job_func.h"
+#include "job_writer.hpp"
+#include "job_record.hpp"
+#include "status_generation.hpp"
 #else
 #include "../resmom/mom_job_func.h"
 #endif
@@ -469,28 +473,63 @@ int assign_job_field(
   } /* END assign_job_field */
 
 
-void decode_attribute(
+#ifndef PBS_MOM
+/*
+ * defer_on_recovery() - true for the attributes whose decoding is put off
+ * when a job is recovered (see job::defer_attr()). These are large, are
+ * not used for scheduling and most jobs never read them again.
+ */
 
-  svrattrl *pal,
-  job **pjob,
-  bool freeExisting)
+bool defer_on_recovery(
+
+  int index)
 
   {
-  int index;
-  job *pj = *pjob;
+  switch (index)
+    {
+    case JOB_ATR_variables:
+    case JOB_ATR_submit_args:
 
-  /* find the pbs_attribute definition based on the name */
+      return(job_attr_def[index].at_action == NULL);
 
-  index = find_attr(job_attr_def, pal->al_name, JOB_ATR_LAST);
+    default:
 
-  if (index < 0)
-    index = JOB_ATR_UNKN;
+      return(false);
+    }
+  } /* END defer_on_recovery() */
+#endif
+
+
+
+/*
+ * decode_attribute_at() - decode pal into the job's attribute at index
+ */
+
+void decode_attribute_at(
+
+  int       index,
+  svrattrl *pal,
+  job     **pjob,
+  bool      freeExisting)
+
+  {
+  job *pj = *pjob;
 
   if (freeExisting)
     {
     job_attr_def[index].at_free(&pj->ji_wattr[index]);
     }
 
+#ifndef PBS_MOM
+  if ((pal->al_resc == NULL) &&
+      (pal->al_value != NULL) &&
+      (defer_on_recovery(index) == true))
+    {
+    pj->defer_attr(index, pal->al_value, pal->al_flags);
+    return;
+    }
+#endif
+
   if (index == JOB_ATR_hold)
     {
     // JOB_ATR_hold is written to file as a number so it won't decode correctly
@@ -510,6 +549,26 @@ void decode_attribute(
     job_attr_def[index].at_action(&pj->ji_wattr[index], pj, ATR_ACTION_RECOV);
 
   pj->ji_wattr[index].at_flags =  pal->al_flags & ~ATR_VFLAG_MODIFY;
+  } // END decode_attribute_at()
+
+
+void decode_attribute(
+
+  svrattrl *pal,
+  job **pjob,
+  bool freeExisting)
+
+  {
+  int index;
+
+  /* find the pbs_attribute definition based on the name */
+
+  index = find_attr(job_attr_def, pal->al_name, JOB_ATR_LAST);
+
+  if (index < 0)
+    index = JOB_ATR_UNKN;
+
+  decode_attribute_at(index, pal, pjob, freeExisting);
   } // END decode_attribute()
 
 
@@ -972,7 +1031,11 @@ int add_encoded_attributes(
           attr_to_str(value, job_attr_def + i, pattr[i], true);
 
         if (value.size() == 0)
+          {
+          /* an empty value isn't written, but it mustn't keep the job from quick saves */
+          (pattr + i)->at_flags &= ~ATR_VFLAG_MODIFY;
           continue;
+          }
 
         pal_xmlNode = xmlNewChild(attributeNode,
                                   NULL,
@@ -1037,12 +1100,58 @@ int add_encoded_attributes(
           }
         }
       }
+    else
+      {
+      /* an unset value is saved by its absence, clearing it is saved too */
+      (pattr + i)->at_flags &= ~ATR_VFLAG_MODIFY;
+      }
     }
 
   return (0);
   } /* END add_encoded_attributes */
 
 
+#ifndef PBS_MOM
+/*
+ * add_deferred_attributes() - add xml nodes for the attributes that were
+ * recovered but haven't been decoded yet. Their saved values are written
+ * back as they are.
+ */
+
+int add_deferred_attributes(
+
+  xmlNodePtr  attributeNode, /* M attribute node */
+  job        *pjob)          /* I */
+
+  {
+  std::string   value;
+  unsigned int  flags;
+  char          buf[BUFSIZE];
+  xmlNodePtr    pal_xmlNode;
+
+  for (int i = 0; i < JOB_ATR_LAST; i++)
+    {
+    if ((defer_on_recovery(i) == false) ||
+        (pjob->get_deferred_attr(i, value, flags) == false))
+      continue;
+
+    pal_xmlNode = xmlNewChild(attributeNode,
+                              NULL,
+                              (xmlChar *)job_attr_def[i].at_name,
+                              (const xmlChar *)value.c_str());
+
+    if (pal_xmlNode == NULL)
+      return(-1);
+
+    snprintf(buf, sizeof(buf), "%u", flags & ~ATR_VFLAG_MODIFY);
+    xmlSetProp(pal_xmlNode, (const xmlChar *)AL_FLAGS_ATTR, (const xmlChar *)buf);
+    }
+
+  return(PBSE_NONE);
+  } /* END add_deferred_attributes() */
+#endif
+
+
 /*
  * add_attributes () - add xml nodes (that correspond to job's encoded attributes to the document.
  */
@@ -1062,6 +1171,10 @@ int add_attributes(
    {
    xmlAddChild(root_node, attributeNode);
    rc = add_encoded_attributes(&attributeNode, pjob->ji_wattr);
+#ifndef PBS_MOM
+   if (rc == PBSE_NONE)
+     rc = add_deferred_attributes(attributeNode, pjob);
+#endif
    }
   else
    rc = -1;
@@ -1103,18 +1216,18 @@ void add_mom_fields(
 #endif /* PBS_MOM */
 
 /*
- * saveJobToXML() - save job to disk in xml format
+ * create_job_xml_doc() - build the xml document that represents the job
+ *
+ * @return the document, which the caller must free, or NULL on failure
  */
 
-int saveJobToXML(
+xmlDocPtr create_job_xml_doc(
 
-  job *pjob,      /* I - pointer to job */
-  const char *filename) /* I - filename to save to */
+  job *pjob) /* I - pointer to job */
 
   {
   xmlDocPtr  doc = NULL;       /* document pointer */
   xmlNodePtr root_node = NULL;
-  int        lenwritten = 0, rc = PBSE_NONE;
   char       log_buf[LOCAL_LOG_BUF_SIZE];
 
   if ((doc = xmlNewDoc((const xmlChar*) "1.0")))
@@ -1127,24 +1240,12 @@ int saveJobToXML(
     if (add_attributes(&root_node, pjob))
       {
       xmlFreeDoc(doc);
-      return -1;
+      return(NULL);
       }
 
 #ifdef PBS_MOM
     add_mom_fields(&root_node, (const job*)pjob);
 #endif /* PBS_MOM */
-
-#ifndef PBS_MOM
-    lock_ss();
-#endif /* !defined PBS_MOM */
-
-    lenwritten = xmlSaveFormatFileEnc(filename, doc, NULL, 1);
-
-#ifndef PBS_MOM
-    unlock_ss();
-#endif /* !defined PBS_MOM */
-
-    xmlFreeDoc(doc);
     }
   else
     {
@@ -1154,9 +1255,34 @@ int saveJobToXML(
     PBS_EVENTCLASS_JOB,
     pjob->ji_qs.ji_jobid,
     log_buf);
-    rc = -1;     
     }
 
+  return(doc);
+  } /* END create_job_xml_doc() */
+
+
+/*
+ * saveJobToXML() - save job to disk in xml format
+ */
+
+int saveJobToXML(
+
+  job *pjob,      /* I - pointer to job */
+  const char *filename) /* I - filename to save to */
+
+  {
+  xmlDocPtr  doc = NULL;       /* document pointer */
+  int        lenwritten = 0, rc = PBSE_NONE;
+  char       log_buf[LOCAL_LOG_BUF_SIZE];
+
+  if ((doc = create_job_xml_doc(pjob)))
+    {
+    lenwritten = xmlSaveFormatFileEnc(filename, doc, NULL, 1);
+    xmlFreeDoc(doc);
+    }
+  else
+    rc = -1;
+
   if (lenwritten <= 0)
     {
     snprintf(log_buf, sizeof(log_buf), "failed writing job to the xml file %s", filename);
@@ -1173,167 +1299,795 @@ int saveJobToXML(
   } /* saveJobToXML */
 
 
+#ifndef PBS_MOM
 /*
- * job_save() - Saves (or updates) a job structure image on disk
- *
- * Save does either - a quick update for state changes only,
- *    - a full update for an existing file, or
- *    - a full write for a new job
- *
- * For a quick update, the data written is less than a disk block
- * size and no size change occurs; so it is rewritten in place.
- *
- * For a full update (usually following modify job request), to
- * insure no data is ever lost due to system crash:
- * 1. write new image to a new file using a temp name
- * 2. unlink the old (image) file
- * 3. link the correct name to the new file
- * 4. unlink the temp name
- *
- * For a new file write, first time, the data is written directly to
- * the file.
- *
- *      RETURN:  0 - success, -1 - failure
+ * job_has_dirty_attributes() - returns true if any of the job's attributes
+ * have been modified since the last full save.
  */
 
-int job_save(
+bool job_has_dirty_attributes(
 
-  job *pjob,  /* pointer to job structure */
-  int  updatetype, /* 0=quick, 1=full, 2=new     */
-  int  mom_port)   /* if 0 ignore otherwise append to end of job name. this is for multi-mom mode */
+  const job *pjob) /* I */
 
   {
-  pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, 0);
+  for (int i = 0; i < JOB_ATR_LAST; i++)
+    {
+    if (pjob->ji_wattr[i].at_flags & ATR_VFLAG_MODIFY)
+      return(true);
+    }
 
-  char    namebuf1[MAXPATHLEN];
-  char    namebuf2[MAXPATHLEN];
-  const char   *tmp_ptr = NULL;
+  return(false);
+  } /* END job_has_dirty_attributes() */
 
-  time_t  time_now = time(NULL);
-#ifndef PBS_MOM
-  // get the adjusted path_jobs path
-  std::string   adjusted_path_jobs = get_path_jobdata(pjob->ji_qs.ji_jobid, path_jobs);
-#endif
 
 
-#ifdef PBS_MOM
-  tmp_ptr = JOB_FILE_SUFFIX;
-#else
-  if (pjob->ji_is_array_template == true)
-    tmp_ptr = (char *)JOB_FILE_TMP_SUFFIX;
-  else
-    tmp_ptr = (char *)JOB_FILE_SUFFIX;
-#endif
+/*
+ * quick_record_checksum() - FNV-1a hash over the saved ji_qs image. Used to
+ * detect a torn or stale quick save record.
+ */
 
-  if (mom_port)
-    {
-#ifdef PBS_MOM
-    snprintf(namebuf1, MAXPATHLEN, "%s%s%d%s",
-        path_jobs, pjob->ji_qs.ji_fileprefix, mom_port, tmp_ptr);
-    snprintf(namebuf2, MAXPATHLEN, "%s%s%d%s",
-        path_jobs, pjob->ji_qs.ji_fileprefix, mom_port, JOB_FILE_COPY);
-#else
-    snprintf(namebuf1, MAXPATHLEN, "%s%s%d%s",
-        adjusted_path_jobs.c_str(), pjob->ji_qs.ji_fileprefix, mom_port, tmp_ptr);
-    snprintf(namebuf2, MAXPATHLEN, "%s%s%d%s",
-        adjusted_path_jobs.c_str(), pjob->ji_qs.ji_fileprefix, mom_port, JOB_FILE_COPY);
-#endif
-    }
-  else
-    {
-#ifdef PBS_MOM
-    snprintf(namebuf1, MAXPATHLEN, "%s%s%s",
-        path_jobs, pjob->ji_qs.ji_fileprefix, tmp_ptr);
-    snprintf(namebuf2, MAXPATHLEN, "%s%s%s",
-        path_jobs, pjob->ji_qs.ji_fileprefix, JOB_FILE_COPY);
-#else
-    snprintf(namebuf1, MAXPATHLEN, "%s%s%s",
-        adjusted_path_jobs.c_str(), pjob->ji_qs.ji_fileprefix, tmp_ptr);
-    snprintf(namebuf2, MAXPATHLEN, "%s%s%s",
-        adjusted_path_jobs.c_str(), pjob->ji_qs.ji_fileprefix, JOB_FILE_COPY);
-#endif
-    }
+unsigned long quick_record_checksum(
 
-  /* if ji_modified is set, ie an pbs_attribute changed, then update mtime */
+  const job_quick_record *jq) /* I */
 
-  if (pjob->ji_modified)
+  {
+  const unsigned char *p = (const unsigned char *)&jq->jq_qs;
+  unsigned long        hash = 2166136261UL;
+
+  for (size_t i = 0; i < sizeof(jq->jq_qs); i++)
     {
-    pjob->ji_wattr[JOB_ATR_mtime].at_val.at_long = time_now;
+    hash ^= p[i];
+    hash *= 16777619UL;
     }
 
-  if (!(saveJobToXML(pjob, namebuf2)))
-    {
-    unlink(namebuf1);
+  return(hash);
+  } /* END quick_record_checksum() */
 
-    if (link(namebuf2, namebuf1) == -1)
-      {
-      log_event(
-        PBSEVENT_ERROR | PBSEVENT_SECURITY,
-        PBS_EVENTCLASS_JOB,
-        pjob->ji_qs.ji_jobid,
-        (char *)"Link in job_save failed");
-      }
-    else
-      {
-      unlink(namebuf2);
-      }
-    }
-  else /* saveJobToXML failed */
-    {
-    log_event(PBSEVENT_ERROR | PBSEVENT_SECURITY, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid,
-      "call to saveJobToXML in job_save failed");
-    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, 0);
-    return -1;
-    }
 
-  pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, 0);
 
-  return(PBSE_NONE);
-  }  /* END job_save() */
+void fill_job_quick_record(
+
+  const job        *pjob, /* I */
+  job_quick_record &jq)   /* O */
+
+  {
+  memset(&jq, 0, sizeof(jq));
+  jq.jq_magic = JOB_QUICK_MAGIC;
+  jq.jq_size = sizeof(jq.jq_qs);
+  memcpy(&jq.jq_qs, &pjob->ji_qs, sizeof(jq.jq_qs));
+  jq.jq_checksum = quick_record_checksum(&jq);
+  } /* END fill_job_quick_record() */
+
 
 
-#ifndef PBS_MOM
 /*
- * ghost_create_jobs_array()
- *
- * Automatically creates an array for pjob so that it doesn't have to be deleted. This job's array
- * was not properly recovered, and we don't want to lose the jobs.
+ * save_job_quick_record() - writes the job's ji_qs to its fixed size quick save
+ * record. The record is always the same size and is rewritten in place, so no
+ * temp file, link or unlink is needed.
  *
- * @param pjob - the job whose array wasn't recovered.
- * @param array_id - the id of the array to be created.
- * @return - a pointer to the new job array
+ * @param pjob - the job to save
+ * @param filename - the path of the quick save record
+ * @return PBSE_NONE on success, -1 on failure
  */
 
-job_array *ghost_create_jobs_array(
+int save_job_quick_record(
 
-  job        *pjob,
-  const char *array_id)
+  job        *pjob,     /* I */
+  const char *filename) /* I */
 
   {
-  job_array   *pa = new job_array();
-  long         array_size = DEFAULT_ARRAY_RECOV_SIZE;
-  char         log_buf[LOCAL_LOG_BUF_SIZE];
-  char         file_prefix_work[PBS_JOBBASE + 1];
-  long         slot_limit = NO_SLOT_LIMIT;
+  job_quick_record jq;
+  int              fds;
+  ssize_t          written;
 
-  if (LOGLEVEL >= 2)
+  fill_job_quick_record(pjob, jq);
+
+  if ((fds = open(filename, O_WRONLY | O_CREAT | O_Sync, 0600)) < 0)
     {
-    snprintf(log_buf, sizeof(log_buf),
-      "Array %s was not successfully recovered, but we are creating it automatically to not lose the sub-jobs. Slot limits and or dependencies may not work correctly. This behavior can be disabled by setting ghost_array_recovery to false in qmgr.", array_id);
-    log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, log_buf);
+    log_err(errno, __func__, "cannot open quick save record");
+    return(-1);
     }
-  
-  lock_ai_mutex(pa, __func__, NULL, LOGLEVEL);
 
-  pa->set_array_id(array_id);
-  
-  get_svr_attr_l(SRV_ATR_MaxSlotLimit, &slot_limit);
-  pa->ai_qs.slot_limit = slot_limit;
+  written = pwrite(fds, &jq, sizeof(jq), 0);
+  close(fds);
 
-  // Remove the [] from the file prefix
-  snprintf(file_prefix_work, sizeof(file_prefix_work), "%s", array_id);
-  char *open = strchr(file_prefix_work, '[');
-  char *dot = strchr(file_prefix_work, '.');
+  if (written != (ssize_t)sizeof(jq))
+    {
+    log_err(errno, __func__, "cannot write quick save record");
+    return(-1);
+    }
+
+  return(PBSE_NONE);
+  } /* END save_job_quick_record() */
+
+
+
+/*
+ * apply_job_quick_record() - if a valid quick save record exists for this job,
+ * it is newer than the .JB file, so overlay its ji_qs onto the recovered job.
+ *
+ * @param pjob - the job recovered from its .JB file
+ * @param filename - the path of the quick save record
+ * @return PBSE_NONE if a record was applied, -1 otherwise
+ */
+
+int apply_job_quick_record(
+
+  job        *pjob,     /* M */
+  const char *filename) /* I */
+
+  {
+  job_quick_record jq;
+  int              fds;
+  ssize_t          bytes_read;
+  char             log_buf[LOCAL_LOG_BUF_SIZE];
+
+  if ((fds = open(filename, O_RDONLY, 0)) < 0)
+    return(-1);
+
+  bytes_read = pread(fds, &jq, sizeof(jq), 0);
+  close(fds);
+
+  if ((bytes_read != (ssize_t)sizeof(jq)) ||
+      (jq.jq_magic != JOB_QUICK_MAGIC) ||
+      (jq.jq_size != sizeof(jq.jq_qs)) ||
+      (jq.jq_checksum != quick_record_checksum(&jq)) ||
+      (jq.jq_qs.qs_version != PBS_QS_VERSION) ||
+      (strcmp(jq.jq_qs.ji_jobid, pjob->ji_qs.ji_jobid)))
+    {
+    snprintf(log_buf, sizeof(log_buf), "ignoring invalid quick save record %s", filename);
+    log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, log_buf);
+    return(-1);
+    }
+
+  memcpy(&pjob->ji_qs, &jq.jq_qs, sizeof(pjob->ji_qs));
+  pjob->ji_wattr[JOB_ATR_substate].at_val.at_long = pjob->ji_qs.ji_substate;
+
+  return(PBSE_NONE);
+  } /* END apply_job_quick_record() */
+
+
+
+/*
+ * job_xml_image() - serialize the job's xml document into memory
+ *
+ * @param pjob - the job to serialize
+ * @param image - set to the serialized document
+ * @return PBSE_NONE on success, -1 on failure
+ */
+
+int job_xml_image(
+
+  job         *pjob,  /* I */
+  std::string &image) /* O */
+
+  {
+  xmlDocPtr  doc;
+  xmlChar   *buf = NULL;
+  int        size = 0;
+
+  if ((doc = create_job_xml_doc(pjob)) == NULL)
+    return(-1);
+
+  xmlDocDumpFormatMemoryEnc(doc, &buf, &size, NULL, 1);
+  xmlFreeDoc(doc);
+
+  if ((buf == NULL) ||
+      (size <= 0))
+    {
+    xmlFree(buf);
+    return(-1);
+    }
+
+  image.assign((const char *)buf, size);
+  xmlFree(buf);
+
+  return(PBSE_NONE);
+  } /* END job_xml_image() */
+
+
+
+/*
+ * job_record_image() - serialize the job as a binary job record (see
+ * job_record.hpp). Attributes are encoded the same way they are written
+ * to xml.
+ *
+ * @param pjob - the job to serialize
+ * @param image - set to the record
+ * @return PBSE_NONE on success, -1 on failure
+ */
+
+int job_record_image(
+
+  job         *pjob,  /* I */
+  std::string &image) /* O */
+
+  {
+  job_record_builder  jrb(pjob->ji_qs);
+  pbs_attribute      *pattr = pjob->ji_wattr;
+  tlist_head          lhead;
+  svrattrl           *pal;
+  std::string         deferred;
+  unsigned int        flags;
+
+  CLEAR_HEAD(lhead);
+
+  for (int i = 0; i < JOB_ATR_LAST; i++)
+    {
+    if (job_attr_def[i].at_type == ATR_TYPE_ACL)
+      {
+      pattr[i].at_flags &= ~ATR_VFLAG_MODIFY;
+      continue;
+      }
+
+    if ((pattr[i].at_flags & ATR_VFLAG_SET) == 0)
+      {
+      pattr[i].at_flags &= ~ATR_VFLAG_MODIFY;
+
+      /* write back values recovery didn't decode as they were read */
+      if ((defer_on_recovery(i) == true) &&
+          (pjob->get_deferred_attr(i, deferred, flags) == true))
+        {
+        jrb.begin_attr(i, job_attr_def[i].at_name);
+        jrb.add_value(NULL, deferred.c_str(), flags & ~ATR_VFLAG_MODIFY);
+        }
+
+      continue;
+      }
+
+    if ((i != JOB_ATR_resource) &&
+        (i != JOB_ATR_resc_used) &&
+        (i != JOB_ATR_req_information))
+      {
+      std::string value;
+
+      if (i == JOB_ATR_depend)
+        translate_dependency_to_string(pattr + i, value);
+      else
+        attr_to_str(value, job_attr_def + i, pattr[i], true);
+
+      if (value.size() == 0)
+        {
+        pattr[i].at_flags &= ~ATR_VFLAG_MODIFY;
+        continue;
+        }
+
+      jrb.begin_attr(i, job_attr_def[i].at_name);
+      jrb.add_value(NULL, value.c_str(), pattr[i].at_flags);
+      }
+    else
+      {
+      bool first = true;
+
+      if (job_attr_def[i].at_encode(pattr + i,
+                                    &lhead,
+                                    job_attr_def[i].at_name,
+                                    NULL,
+                                    ATR_ENCODE_SAVE,
+                                    ATR_DFLAG_ACCESS) < 0)
+        {
+        free_attrlist(&lhead);
+        return(-1);
+        }
+
+      while ((pal = (svrattrl *)GET_NEXT(lhead)) != NULL)
+        {
+        if (pal->al_resc != NULL)
+          {
+          if (first == true)
+            {
+            jrb.begin_attr(i, job_attr_def[i].at_name);
+            first = false;
+            }
+
+          jrb.add_value(pal->al_resc, (pal->al_value != NULL) ? pal->al_value : "", pal->al_flags);
+          }
+
+        delete_link(&pal->al_link);
+        free(pal);
+        }
+      }
+
+    pattr[i].at_flags &= ~ATR_VFLAG_MODIFY;
+    }
+
+  image = jrb.finish();
+
+  return(PBSE_NONE);
+  } /* END job_record_image() */
+
+
+
+/*
+ * job_file_image() - serialize the job in the format job_binary_records
+ * selects for its job file
+ */
+
+int job_file_image(
+
+  job         *pjob,  /* I */
+  std::string &image) /* O */
+
+  {
+  if (job_binary_records == true)
+    return(job_record_image(pjob, image));
+
+  return(job_xml_image(pjob, image));
+  } /* END job_file_image() */
+
+
+
+/*
+ * job_save_payload() - build what gets saved for the job: its job file
+ * image, or for a quick save just its job_quick_record
+ *
+ * @return PBSE_NONE on success, -1 on failure
+ */
+
+int job_save_payload(
+
+  job         *pjob,    /* I */
+  bool         quick,   /* I */
+  std::string &payload) /* O */
+
+  {
+  if (quick == true)
+    {
+    job_quick_record jq;
+
+    fill_job_quick_record(pjob, jq);
+    payload.assign((const char *)&jq, sizeof(jq));
+
+    return(PBSE_NONE);
+    }
+
+  return(job_file_image(pjob, payload));
+  } /* END job_save_payload() */
+
+
+
+/*
+ * journal_job_save() - append the job to the job journal instead of
+ * rewriting its file. A quick save only journals ji_qs.
+ *
+ * @return PBSE_NONE once the record is durable, -1 otherwise
+ */
+
+int journal_job_save(
+
+  job  *pjob,  /* I */
+  bool  quick) /* I */
+
+  {
+  std::string   payload;
+  unsigned long seq;
+
+  if (job_save_payload(pjob, quick, payload) != PBSE_NONE)
+    return(-1);
+
+  seq = server_job_journal.append(quick ? JOURNAL_QUICK : JOURNAL_SAVE,
+                                  pjob->ji_qs.ji_jobid, pjob->ji_qs.ji_fileprefix,
+                                  pjob->ji_is_array_template, payload.c_str(), payload.size());
+
+  if (server_job_journal.commit(seq) != PBSE_NONE)
+    return(-1);
+
+  if (quick == false)
+    pjob->ji_modified = 0;
+
+  return(PBSE_NONE);
+  } /* END journal_job_save() */
+
+
+
+/*
+ * queue_job_save() - serialize the job and queue it for the job writer
+ * threads instead of writing it here. The caller holds the job's mutex, so
+ * the image is consistent; only the disk write is deferred.
+ *
+ * @return PBSE_NONE once queued, -1 otherwise
+ */
+
+int queue_job_save(
+
+  job  *pjob,  /* I */
+  bool  quick) /* I */
+
+  {
+  std::string payload;
+
+  if (job_save_payload(pjob, quick, payload) != PBSE_NONE)
+    return(-1);
+
+  server_job_writer.queue_save(pjob->ji_qs.ji_jobid, pjob->ji_qs.ji_fileprefix,
+                               pjob->ji_is_array_template, payload, quick);
+
+  if (quick == false)
+    pjob->ji_modified = 0;
+
+  return(PBSE_NONE);
+  } /* END queue_job_save() */
+
+
+
+/*
+ * write_whole_file() - create or truncate filename and write image to it
+ */
+
+int write_whole_file(
+
+  const char        *filename, /* I */
+  const std::string &image)    /* I */
+
+  {
+  int    fds;
+  size_t written = 0;
+
+  if ((fds = open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_Sync, 0600)) < 0)
+    return(-1);
+
+  while (written < image.size())
+    {
+    ssize_t rc = write(fds, image.c_str() + written, image.size() - written);
+
+    if (rc < 0)
+      {
+      if (errno == EINTR)
+        continue;
+
+      close(fds);
+      unlink(filename);
+      return(-1);
+      }
+
+    written += rc;
+    }
+
+  close(fds);
+
+  return(PBSE_NONE);
+  } /* END write_whole_file() */
+
+
+
+/*
+ * write_file_image() - atomically replace filename with the contents of image
+ */
+
+int write_file_image(
+
+  const std::string &filename,  /* I */
+  const std::string &tmp_name,  /* I */
+  const std::string &image)     /* I */
+
+  {
+  if (write_whole_file(tmp_name.c_str(), image) != PBSE_NONE)
+    return(-1);
+
+  if (rename(tmp_name.c_str(), filename.c_str()) != 0)
+    {
+    unlink(tmp_name.c_str());
+    return(-1);
+    }
+
+  return(PBSE_NONE);
+  } /* END write_file_image() */
+
+
+
+/*
+ * write_journal_entry() - write a job's final state from the job journal to
+ * its .JB (or .TA) and .JQ files, or remove them if the job was purged.
+ *
+ * @param jobid - the job's id
+ * @param je - the job's collapsed journal records
+ * @return PBSE_NONE on success, -1 on failure
+ */
+
+int write_journal_entry(
+
+  const std::string   &jobid, /* I */
+  const journal_entry &je)    /* I */
+
+  {
+  std::string base = get_path_jobdata(jobid.c_str(), path_jobs) + je.fileprefix;
+  std::string job_file = base + (je.is_template ? JOB_FILE_TMP_SUFFIX : JOB_FILE_SUFFIX);
+  std::string quick_file = base + JOB_FILE_QUICK;
+  char        log_buf[LOCAL_LOG_BUF_SIZE];
+
+  if (je.purged == true)
+    {
+    unlink(job_file.c_str());
+    unlink(quick_file.c_str());
+    return(PBSE_NONE);
+    }
+
+  if (je.image.size() != 0)
+    {
+    if (write_file_image(job_file, base + JOB_FILE_COPY, je.image) != PBSE_NONE)
+      {
+      snprintf(log_buf, sizeof(log_buf), "cannot write %s from the job journal", job_file.c_str());
+      log_err(errno, __func__, log_buf);
+      return(-1);
+      }
+
+    unlink(quick_file.c_str());
+    }
+
+  if ((je.quick.size() != 0) &&
+      (write_file_image(quick_file, quick_file + JOB_FILE_COPY, je.quick) != PBSE_NONE))
+    {
+    snprintf(log_buf, sizeof(log_buf), "cannot write %s from the job journal", quick_file.c_str());
+    log_err(errno, __func__, log_buf);
+    return(-1);
+    }
+
+  return(PBSE_NONE);
+  } /* END write_journal_entry() */
+#endif /* !PBS_MOM */
+
+
+
+/*
+ * save_job_file() - write the job to filename. The server writes a binary
+ * job record when job_binary_records is set, and xml otherwise.
+ */
+
+int save_job_file(
+
+  job        *pjob,     /* I */
+  const char *filename) /* I */
+
+  {
+#ifndef PBS_MOM
+  if (job_binary_records == true)
+    {
+    std::string image;
+    char        log_buf[LOCAL_LOG_BUF_SIZE];
+
+    if ((job_record_image(pjob, image) != PBSE_NONE) ||
+        (write_whole_file(filename, image) != PBSE_NONE))
+      {
+      snprintf(log_buf, sizeof(log_buf), "failed writing job to the job record %s", filename);
+      log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, log_buf);
+      return(-1);
+      }
+
+    return(PBSE_NONE);
+    }
+#endif
+
+  return(saveJobToXML(pjob, filename));
+  } /* END save_job_file() */
+
+
+/*
+ * job_save() - Saves (or updates) a job structure image on disk
+ *
+ * Save does either - a quick update for state changes only,
+ *    - a full update for an existing file, or
+ *    - a full write for a new job
+ *
+ * For a quick update, the data written is less than a disk block
+ * size and no size change occurs; so it is rewritten in place.
+ * On the server only ji_qs is written, to a fixed size record
+ * beside the .JB file (see save_job_quick_record()). If any
+ * attribute is dirty the quick update becomes a full update.
+ *
+ * When job_writer_threads is set the server only serializes the job
+ * here and a writer thread writes it (see queue_job_save()). A new job
+ * is always written here, since the client is told it was queued as
+ * soon as this returns.
+ *
+ * For a full update (usually following modify job request), to
+ * insure no data is ever lost due to system crash:
+ * 1. write new image to a new file using a temp name
+ * 2. unlink the old (image) file
+ * 3. link the correct name to the new file
+ * 4. unlink the temp name
+ *
+ * For a new file write, first time, the data is written directly to
+ * the file.
+ *
+ *      RETURN:  0 - success, -1 - failure
+ */
+
+int job_save(
+
+  job *pjob,  /* pointer to job structure */
+  int  updatetype, /* 0=quick, 1=full, 2=new     */
+  int  mom_port)   /* if 0 ignore otherwise append to end of job name. this is for multi-mom mode */
+
+  {
+  pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, 0);
+
+  char    namebuf1[MAXPATHLEN];
+  char    namebuf2[MAXPATHLEN];
+#ifndef PBS_MOM
+  char    quickbuf[MAXPATHLEN];
+#endif
+  const char   *tmp_ptr = NULL;
+
+  time_t  time_now = time(NULL);
+#ifndef PBS_MOM
+  // get the adjusted path_jobs path
+  std::string   adjusted_path_jobs = get_path_jobdata(pjob->ji_qs.ji_jobid, path_jobs);
+#endif
+
+
+#ifdef PBS_MOM
+  tmp_ptr = JOB_FILE_SUFFIX;
+#else
+  if (pjob->ji_is_array_template == true)
+    tmp_ptr = (char *)JOB_FILE_TMP_SUFFIX;
+  else
+    tmp_ptr = (char *)JOB_FILE_SUFFIX;
+#endif
+
+  if (mom_port)
+    {
+#ifdef PBS_MOM
+    snprintf(namebuf1, MAXPATHLEN, "%s%s%d%s",
+        path_jobs, pjob->ji_qs.ji_fileprefix, mom_port, tmp_ptr);
+    snprintf(namebuf2, MAXPATHLEN, "%s%s%d%s",
+        path_jobs, pjob->ji_qs.ji_fileprefix, mom_port, JOB_FILE_COPY);
+#else
+    snprintf(namebuf1, MAXPATHLEN, "%s%s%d%s",
+        adjusted_path_jobs.c_str(), pjob->ji_qs.ji_fileprefix, mom_port, tmp_ptr);
+    snprintf(namebuf2, MAXPATHLEN, "%s%s%d%s",
+        adjusted_path_jobs.c_str(), pjob->ji_qs.ji_fileprefix, mom_port, JOB_FILE_COPY);
+#endif
+    }
+  else
+    {
+#ifdef PBS_MOM
+    snprintf(namebuf1, MAXPATHLEN, "%s%s%s",
+        path_jobs, pjob->ji_qs.ji_fileprefix, tmp_ptr);
+    snprintf(namebuf2, MAXPATHLEN, "%s%s%s",
+        path_jobs, pjob->ji_qs.ji_fileprefix, JOB_FILE_COPY);
+#else
+    snprintf(namebuf1, MAXPATHLEN, "%s%s%s",
+        adjusted_path_jobs.c_str(), pjob->ji_qs.ji_fileprefix, tmp_ptr);
+    snprintf(namebuf2, MAXPATHLEN, "%s%s%s",
+        adjusted_path_jobs.c_str(), pjob->ji_qs.ji_fileprefix, JOB_FILE_COPY);
+#endif
+    }
+
+#ifndef PBS_MOM
+  if (mom_port)
+    snprintf(quickbuf, sizeof(quickbuf), "%s%s%d%s",
+      adjusted_path_jobs.c_str(), pjob->ji_qs.ji_fileprefix, mom_port, JOB_FILE_QUICK);
+  else
+    snprintf(quickbuf, sizeof(quickbuf), "%s%s%s",
+      adjusted_path_jobs.c_str(), pjob->ji_qs.ji_fileprefix, JOB_FILE_QUICK);
+
+  bool quick = (updatetype == SAVEJOB_QUICK) &&
+               (pjob->ji_is_array_template == false) &&
+               (pjob->ji_modified == 0) &&
+               (job_has_dirty_attributes(pjob) == false);
+#endif
+
+  /* if ji_modified is set, ie an pbs_attribute changed, then update mtime */
+
+  if (pjob->ji_modified)
+    {
+    pjob->ji_wattr[JOB_ATR_mtime].at_val.at_long = time_now;
+    }
+
+#ifndef PBS_MOM
+  /* whatever is being saved changed, so delta status reports the job */
+  pjob->ji_status_gen = status_gen.next();
+
+  if ((job_journal_enabled == true) &&
+      (journal_job_save(pjob, quick) == PBSE_NONE))
+    {
+    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, 0);
+    return(PBSE_NONE);
+    }
+
+  if (updatetype == SAVEJOB_NEW)
+    {
+    /* an older image still queued mustn't replace this one */
+    if (job_writer_threads > 0)
+      server_job_writer.forget(pjob->ji_qs.ji_jobid);
+    }
+  else if ((job_writer_threads > 0) &&
+           (mom_port == 0) &&
+           (queue_job_save(pjob, quick) == PBSE_NONE))
+    {
+    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, 0);
+    return(PBSE_NONE);
+    }
+
+  if ((quick == true) &&
+      (save_job_quick_record(pjob, quickbuf) == PBSE_NONE))
+    {
+    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, 0);
+    return(PBSE_NONE);
+    }
+
+  /* fall back to a full save */
+#endif
+
+  if (!(save_job_file(pjob, namebuf2)))
+    {
+#ifndef PBS_MOM
+    /* the full image supersedes any quick save record */
+    unlink(quickbuf);
+    pjob->ji_modified = 0;
+#endif
+
+    unlink(namebuf1);
+
+    if (link(namebuf2, namebuf1) == -1)
+      {
+      log_event(
+        PBSEVENT_ERROR | PBSEVENT_SECURITY,
+        PBS_EVENTCLASS_JOB,
+        pjob->ji_qs.ji_jobid,
+        (char *)"Link in job_save failed");
+      }
+    else
+      {
+      unlink(namebuf2);
+      }
+    }
+  else /* save_job_file failed */
+    {
+    log_event(PBSEVENT_ERROR | PBSEVENT_SECURITY, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid,
+      "call to save_job_file in job_save failed");
+    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, 0);
+    return -1;
+    }
+
+  pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, 0);
+
+  return(PBSE_NONE);
+  }  /* END job_save() */
+
+
+#ifndef PBS_MOM
+/*
+ * ghost_create_jobs_array()
+ *
+ * Automatically creates an array for pjob so that it doesn't have to be deleted. This job's array
+ * was not properly recovered, and we don't want to lose the jobs.
+ *
+ * @param pjob - the job whose array wasn't recovered.
+ * @param array_id - the id of the array to be created.
+ * @return - a pointer to the new job array
+ */
+
+job_array *ghost_create_jobs_array(
+
+  job        *pjob,
+  const char *array_id)
+
+  {
+  job_array   *pa = new job_array();
+  long         array_size = DEFAULT_ARRAY_RECOV_SIZE;
+  char         log_buf[LOCAL_LOG_BUF_SIZE];
+  char         file_prefix_work[PBS_JOBBASE + 1];
+  long         slot_limit = NO_SLOT_LIMIT;
+
+  if (LOGLEVEL >= 2)
+    {
+    snprintf(log_buf, sizeof(log_buf),
+      "Array %s was not successfully recovered, but we are creating it automatically to not lose the sub-jobs. Slot limits and or dependencies may not work correctly. This behavior can be disabled by setting ghost_array_recovery to false in qmgr.", array_id);
+    log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, log_buf);
+    }
+  
+  lock_ai_mutex(pa, __func__, NULL, LOGLEVEL);
+
+  pa->set_array_id(array_id);
+  
+  get_svr_attr_l(SRV_ATR_MaxSlotLimit, &slot_limit);
+  pa->ai_qs.slot_limit = slot_limit;
+
+  // Remove the [] from the file prefix
+  snprintf(file_prefix_work, sizeof(file_prefix_work), "%s", array_id);
+  char *open = strchr(file_prefix_work, '[');
+  char *dot = strchr(file_prefix_work, '.');
 
   if (open != NULL)
     {
@@ -1533,7 +2287,7 @@ int set_array_job_ids(
           (pj->ji_qs.ji_substate == JOB_SUBSTATE_HELD))
         {
         pj->ji_wattr[JOB_ATR_hold].at_val.at_long = HOLD_l;
-        pj->ji_wattr[JOB_ATR_hold].at_flags = ATR_VFLAG_SET;
+        pj->ji_wattr[JOB_ATR_hold].at_flags = ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
         }
       }
 
@@ -1732,6 +2486,229 @@ int job_recov_binary(
 
 
 
+#ifndef PBS_MOM
+/*
+ * decode_job_record() - fill in the job from a binary job record
+ *
+ * The attribute values are decoded straight out of the record, which is
+ * usually mapped from the job file.
+ */
+
+int decode_job_record(
+
+  const char         *filename, /* I */
+  job_record_reader  &jrr,      /* I */
+  job               **pjob,     /* M */
+  char               *log_buf,  /* O */
+  size_t              buf_len)  /* I */
+
+  {
+  const char   *name;
+  const char   *resc;
+  const char   *value;
+  unsigned int  flags;
+  int           index;
+  int           rc;
+
+  jrr.get_qs((*pjob)->ji_qs);
+
+  if ((rc = check_fileprefix(filename, pjob, log_buf, buf_len)) != PBSE_NONE)
+    return(rc);
+
+  while (jrr.next_attr(index, name) == true)
+    {
+    bool freeExisting = true;
+
+    if ((index < 0) ||
+        (index >= JOB_ATR_LAST) ||
+        (strcmp(job_attr_def[index].at_name, name)))
+      {
+      if ((index = find_attr(job_attr_def, name, JOB_ATR_LAST)) < 0)
+        index = JOB_ATR_UNKN;
+      }
+
+    while (jrr.next_value(resc, value, flags) == true)
+      {
+      svrattrl pal;
+
+      /* decoding copies what it keeps, so point into the record */
+      memset(&pal, 0, sizeof(pal));
+      pal.al_name = (char *)name;
+      pal.al_resc = (char *)resc;
+      pal.al_value = (char *)value;
+      pal.al_flags = flags;
+
+      decode_attribute_at(index, &pal, pjob, freeExisting);
+      freeExisting = false;
+      }
+    }
+
+  if (jrr.is_complete() == false)
+    {
+    snprintf(log_buf, buf_len, "job record %s is corrupted", filename);
+    return(-1);
+    }
+
+  return(PBSE_NONE);
+  } /* END decode_job_record() */
+
+
+
+/*
+ * job_recov_record() - recover a job from a binary job record
+ *
+ * The file is mapped rather than read, and nothing is parsed beyond the
+ * record's fixed headers.
+ *
+ * @return PBSE_NONE on success, PBSE_INVALID_SYNTAX if filename isn't a
+ * binary job record, -1 if it is one that couldn't be recovered
+ */
+
+int job_recov_record(
+
+  const char  *filename, /* I */
+  job        **pjob,     /* M */
+  char        *log_buf,  /* O */
+  size_t       buf_len)  /* I */
+
+  {
+  job_record_reader  jrr;
+  struct stat        sb;
+  char              *buf;
+  char               err_buf[LOCAL_LOG_BUF_SIZE];
+  uint32_t           magic;
+  int                fds;
+  int                rc;
+
+  if ((fds = open(filename, O_RDONLY, 0)) < 0)
+    return(PBSE_INVALID_SYNTAX);
+
+  /* don't map xml files just to find out they aren't records */
+  if ((fstat(fds, &sb) != 0) ||
+      (pread(fds, &magic, sizeof(magic), 0) != (ssize_t)sizeof(magic)) ||
+      (is_job_record((const char *)&magic, sizeof(magic)) == false))
+    {
+    close(fds);
+    return(PBSE_INVALID_SYNTAX);
+    }
+
+  buf = (char *)mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fds, 0);
+  close(fds);
+
+  if (buf == MAP_FAILED)
+    {
+    snprintf(log_buf, buf_len, "unable to map %s", filename);
+    return(-1);
+    }
+
+  if ((rc = jrr.open_record(buf, sb.st_size, err_buf, sizeof(err_buf))) == PBSE_NONE)
+    rc = decode_job_record(filename, jrr, pjob, log_buf, buf_len);
+  else
+    snprintf(log_buf, buf_len, "%s: %s", filename, err_buf);
+
+  munmap(buf, sb.st_size);
+
+  return(rc);
+  } /* END job_recov_record() */
+
+
+
+/*
+ * job_recov_read() - read a job from its save file and apply its quick save
+ * record, without linking it to its array or rewriting it. This only touches
+ * the new job, so several threads can read jobs at once.
+ *
+ * @param filename - the job's save file, relative to the current directory
+ * @return the job, or NULL if it couldn't be read
+ */
+
+job *job_recov_read(
+
+  const char *filename) /* I */
+
+  {
+  job    *pj;
+  char    log_buf[LOCAL_LOG_BUF_SIZE];
+  int     rc;
+  size_t  len;
+
+  if ((pj = job_alloc()) == NULL)
+    return(NULL);
+
+  /* binary job records, then xml, then the old binary format */
+  if ((rc = job_recov_record(filename, &pj, log_buf, sizeof(log_buf))) == PBSE_INVALID_SYNTAX)
+    {
+    if ((rc = job_recov_xml(filename, &pj, log_buf, sizeof(log_buf))) &&
+        (rc == PBSE_INVALID_SYNTAX))
+      rc = job_recov_binary(filename, &pj, log_buf, sizeof(log_buf));
+    }
+
+  if (rc != PBSE_NONE)
+    {
+    if (rc == -1)
+      {
+      log_err(errno, __func__, log_buf);
+      delete pj;
+      }
+
+    return(NULL);
+    }
+
+  /* state changes since the last full save live in the quick save record */
+  len = strlen(filename);
+
+  if ((len > strlen(JOB_FILE_SUFFIX)) &&
+      (!strcmp(filename + len - strlen(JOB_FILE_SUFFIX), JOB_FILE_SUFFIX)))
+    {
+    std::string quick_path(filename, len - strlen(JOB_FILE_SUFFIX));
+    quick_path += JOB_FILE_QUICK;
+    apply_job_quick_record(pj, quick_path.c_str());
+    }
+
+  return(pj);
+  } /* END job_recov_read() */
+
+
+
+/*
+ * job_recov_link() - finish recovering a job read by job_recov_read(): link
+ * it to its array and save it. Must be called by one thread at a time.
+ *
+ * @param pjob - the job, which is set to NULL if it is aborted
+ * @return PBSE_NONE on success
+ */
+
+int job_recov_link(
+
+  job **pjob) /* M */
+
+  {
+  char log_buf[LOCAL_LOG_BUF_SIZE];
+  int  rc;
+
+  if ((rc = set_array_job_ids(pjob, log_buf, sizeof(log_buf))) != PBSE_NONE)
+    {
+    if (rc == -1)
+      {
+      log_err(errno, __func__, log_buf);
+
+      delete *pjob;
+      }
+
+    *pjob = NULL;
+    return(rc);
+    }
+
+  (*pjob)->ji_commit_done = 1;
+
+  job_save(*pjob, SAVEJOB_FULL, 0);
+
+  return(PBSE_NONE);
+  } /* END job_recov_link() */
+#endif /* !PBS_MOM */
+
+
+
 /*
  * job_recov() - recover (read in) a job from its save file
  *
@@ -1751,17 +2728,13 @@ job *job_recov(
 
   {
   job  *pj;
+#ifdef PBS_MOM
   char  log_buf[LOCAL_LOG_BUF_SIZE];
   int   rc;
-#ifdef PBS_MOM
-  char namebuf[MAXPATHLEN];
+  char  namebuf[MAXPATHLEN];
 
   pj = mom_job_alloc();
 
-#else
-  pj = job_alloc(); /* allocate & initialize job structure space */
-#endif
-
   if (pj == NULL)
     {
     /* FAILURE - cannot alloc memory */
@@ -1770,22 +2743,13 @@ job *job_recov(
     }
 
   size_t logBufLen = sizeof(log_buf);
-#ifdef PBS_MOM
+
   // job directory path, filename
   snprintf(namebuf, MAXPATHLEN, "%s%s", path_jobs, filename);
   
   if ((rc = job_recov_xml(namebuf, &pj, log_buf, logBufLen)) &&
       (rc == PBSE_INVALID_SYNTAX))
     rc = job_recov_binary(namebuf, &pj, log_buf, logBufLen);
-#else
-  if ((rc = job_recov_xml(filename, &pj, log_buf, logBufLen)) &&
-      (rc == PBSE_INVALID_SYNTAX))
-    rc = job_recov_binary(filename, &pj, log_buf, logBufLen);
-
-  if (rc == PBSE_NONE)
-    rc = set_array_job_ids(&pj, log_buf, logBufLen);
-#endif
-
 
   if (rc != PBSE_NONE) 
     {
@@ -1793,11 +2757,7 @@ job *job_recov(
       {
       log_err(errno, __func__, log_buf);
 
-#ifndef PBS_MOM
-      delete pj;
-#else
       free(pj);
-#endif
       } /* sometime pjob is freed by abt_job() */
     return(NULL);
     }
@@ -1806,10 +2766,13 @@ job *job_recov(
 
   /* all done recovering the job */
 
-#ifdef PBS_MOM
   job_save(pj, SAVEJOB_FULL, (multi_mom == 0)?0:pbs_rm_port);
 #else
-  job_save(pj, SAVEJOB_FULL, 0);
+  if ((pj = job_recov_read(filename)) == NULL)
+    return(NULL);
+
+  if (job_recov_link(&pj) != PBSE_NONE)
+    return(NULL);
 #endif
 
   return(pj);
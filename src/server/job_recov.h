@@ -2,6 +2,10 @@
 #define _JOB_RECOV_H
 #include "license_pbs.h" /* See here for the software license */
 #include "job_recovery.h"
+#ifndef PBS_MOM
+#include <string>
+#include "job_journal.hpp"
+#endif
 
 
 
@@ -13,4 +17,32 @@ void   add_fix_fields(xmlNodePtr *rnode, const job *pjob);
 void   add_union_fields(xmlNodePtr *rnode, const job *pjob);
 int    saveJobToXML(job *pjob, const char *filename);
 
+#ifndef PBS_MOM
+/* fixed size record written by a quick job_save() */
+#define JOB_QUICK_MAGIC 0x4a515331 /* "JQS1" */
+
+typedef struct job_quick_record
+  {
+  int            jq_magic;
+  int            jq_size;     /* sizeof(struct jobfix) when written */
+  unsigned long  jq_checksum; /* checksum of jq_qs */
+  struct jobfix  jq_qs;
+  } job_quick_record;
+
+bool          job_has_dirty_attributes(const job *pjob);
+unsigned long quick_record_checksum(const job_quick_record *jq);
+int           save_job_quick_record(job *pjob, const char *filename);
+int           apply_job_quick_record(job *pjob, const char *filename);
+
+job          *job_recov_read(const char *filename);
+int           job_recov_link(job **pjob);
+int           job_xml_image(job *pjob, std::string &image);
+int           job_record_image(job *pjob, std::string &image);
+int           job_file_image(job *pjob, std::string &image);
+int           job_recov_record(const char *filename, job **pjob, char *log_buf, size_t buf_len);
+int           write_file_image(const std::string &filename, const std::string &tmp_name,
+                               const std::string &image);
+int           write_journal_entry(const std::string &jobid, const journal_entry &je);
+#endif
+
 #endif /* _JOB_RECOV_H */
@@ -751,6 +751,7 @@ int initialize_procct(
       procctp->rs_value.at_val.at_long += pprocsp->rs_value.at_val.at_long;
       }
     procctp->rs_value.at_flags |= ATR_VFLAG_SET;
+    pattr->at_flags |= ATR_VFLAG_MODIFY;
     }
   else
     {
@@ -0,0 +1,291 @@
+/*
+ * job_writer.cpp - writes job files in the background
+ *
+ * When the job_writer_threads server parameter is set, job_save() serializes
+ * the job while the caller holds the job's mutex and hands the image to the
+ * job writer instead of writing it. The writer threads write the queued
+ * images to the job's .JB/.TA/.JQ files, so request threads no longer wait
+ * on the disk during submit storms or bulk deletes.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdio.h>
+
+#include "job_writer.hpp"
+#include "pbs_error.h"
+#include "log.h"
+#include "../lib/Liblog/pbs_log.h"
+
+job_writer server_job_writer;
+
+int write_journal_entry(const std::string &jobid, const journal_entry &je);
+
+
+
+job_writer::job_writer() : jw_dirty(), jw_writing()
+  {
+  pthread_mutex_init(&this->jw_mutex, NULL);
+  pthread_cond_init(&this->jw_work_cond, NULL);
+  pthread_cond_init(&this->jw_done_cond, NULL);
+  }
+
+
+
+job_writer::~job_writer()
+  {
+  pthread_cond_destroy(&this->jw_done_cond);
+  pthread_cond_destroy(&this->jw_work_cond);
+  pthread_mutex_destroy(&this->jw_mutex);
+  }
+
+
+
+/*
+ * queue_save()
+ *
+ * Queues a job image for the writer threads. A full image replaces anything
+ * already queued for the job, and a quick record is written after the queued
+ * image, the same way the job journal collapses its records.
+ *
+ * @param jobid - the job's id
+ * @param fileprefix - the job's file prefix
+ * @param is_template - true if the job is an array template (.TA)
+ * @param payload - the job's xml image, or its job_quick_record
+ * @param quick - true if payload is a quick record
+ */
+
+void job_writer::queue_save(
+
+  const char        *jobid,
+  const char        *fileprefix,
+  bool               is_template,
+  const std::string &payload,
+  bool               quick)
+
+  {
+  pthread_mutex_lock(&this->jw_mutex);
+
+  journal_entry &je = this->jw_dirty[jobid];
+
+  je.purged = false;
+  je.is_template = is_template;
+  je.fileprefix = fileprefix;
+
+  if (quick == true)
+    je.quick = payload;
+  else
+    {
+    je.image = payload;
+    je.quick.clear();
+    }
+
+  pthread_cond_signal(&this->jw_work_cond);
+  pthread_mutex_unlock(&this->jw_mutex);
+  } /* END queue_save() */
+
+
+
+/*
+ * forget()
+ *
+ * Drops any queued image for a job that is being purged and waits for a
+ * writer that is already writing the job to finish, so the caller can remove
+ * the job's files without them being recreated.
+ */
+
+void job_writer::forget(
+
+  const char *jobid)
+
+  {
+  std::string id(jobid);
+
+  pthread_mutex_lock(&this->jw_mutex);
+
+  this->jw_dirty.erase(id);
+
+  while (this->jw_writing.find(id) != this->jw_writing.end())
+    pthread_cond_wait(&this->jw_done_cond, &this->jw_mutex);
+
+  pthread_mutex_unlock(&this->jw_mutex);
+  } /* END forget() */
+
+
+
+/*
+ * take_batch()
+ *
+ * Moves up to JOB_WRITER_BATCH_SIZE queued jobs into batch, skipping jobs
+ * another writer is still writing. jw_mutex must be held.
+ */
+
+void job_writer::take_batch(
+
+  job_write_batch &batch)
+
+  {
+  std::map<std::string, journal_entry>::iterator it = this->jw_dirty.begin();
+
+  while ((it != this->jw_dirty.end()) &&
+         (batch.size() < JOB_WRITER_BATCH_SIZE))
+    {
+    if (this->jw_writing.find(it->first) != this->jw_writing.end())
+      {
+      it++;
+      continue;
+      }
+
+    batch.push_back(std::pair<std::string, journal_entry>(it->first, journal_entry()));
+    batch.back().second.is_template = it->second.is_template;
+    batch.back().second.fileprefix.swap(it->second.fileprefix);
+    batch.back().second.image.swap(it->second.image);
+    batch.back().second.quick.swap(it->second.quick);
+
+    this->jw_writing.insert(it->first);
+    this->jw_dirty.erase(it++);
+    }
+  } /* END take_batch() */
+
+
+
+/*
+ * finish_batch()
+ *
+ * Marks the jobs in batch as written and wakes anyone waiting on them.
+ * jw_mutex must be held.
+ */
+
+void job_writer::finish_batch(
+
+  const job_write_batch &batch)
+
+  {
+  for (size_t i = 0; i < batch.size(); i++)
+    this->jw_writing.erase(batch[i].first);
+
+  pthread_cond_broadcast(&this->jw_done_cond);
+
+  /* jobs that were saved again while being written can be taken now */
+  if (this->jw_dirty.size() != 0)
+    pthread_cond_signal(&this->jw_work_cond);
+  } /* END finish_batch() */
+
+
+
+/*
+ * write_batch()
+ *
+ * Writes one batch of queued jobs.
+ *
+ * @param apply - writes one job's image to its job files
+ * @param wait - if true, wait for work when nothing can be taken
+ * @return the number of jobs written
+ */
+
+int job_writer::write_batch(
+
+  journal_apply_func apply,
+  bool               wait)
+
+  {
+  job_write_batch batch;
+  char            log_buf[LOCAL_LOG_BUF_SIZE];
+
+  pthread_mutex_lock(&this->jw_mutex);
+
+  this->take_batch(batch);
+
+  while ((wait == true) &&
+         (batch.size() == 0))
+    {
+    pthread_cond_wait(&this->jw_work_cond, &this->jw_mutex);
+    this->take_batch(batch);
+    }
+
+  pthread_mutex_unlock(&this->jw_mutex);
+
+  for (size_t i = 0; i < batch.size(); i++)
+    {
+    if (apply(batch[i].first, batch[i].second) != PBSE_NONE)
+      {
+      snprintf(log_buf, sizeof(log_buf), "could not write job %s to disk", batch[i].first.c_str());
+      log_err(-1, __func__, log_buf);
+      }
+    }
+
+  pthread_mutex_lock(&this->jw_mutex);
+  this->finish_batch(batch);
+  pthread_mutex_unlock(&this->jw_mutex);
+
+  return(batch.size());
+  } /* END write_batch() */
+
+
+
+/*
+ * flush()
+ *
+ * Writes every queued job and waits for the writer threads to finish the
+ * jobs they have taken. Used at shutdown.
+ */
+
+void job_writer::flush(
+
+  journal_apply_func apply)
+
+  {
+  while (this->write_batch(apply, false) > 0)
+    ;
+
+  pthread_mutex_lock(&this->jw_mutex);
+
+  while ((this->jw_writing.size() != 0) ||
+         (this->jw_dirty.size() != 0))
+    {
+    if (this->jw_writing.size() == 0)
+      {
+      /* saved again after we emptied the queue */
+      pthread_mutex_unlock(&this->jw_mutex);
+      this->write_batch(apply, false);
+      pthread_mutex_lock(&this->jw_mutex);
+      }
+    else
+      pthread_cond_wait(&this->jw_done_cond, &this->jw_mutex);
+    }
+
+  pthread_mutex_unlock(&this->jw_mutex);
+  } /* END flush() */
+
+
+
+size_t job_writer::dirty_count()
+
+  {
+  size_t count;
+
+  pthread_mutex_lock(&this->jw_mutex);
+  count = this->jw_dirty.size();
+  pthread_mutex_unlock(&this->jw_mutex);
+
+  return(count);
+  } /* END dirty_count() */
+
+
+
+/*
+ * write_dirty_jobs()
+ *
+ * Writer thread: writes queued jobs to disk as they are saved
+ */
+
+void *write_dirty_jobs(
+
+  void *vp)
+
+  {
+  while (1)
+    server_job_writer.write_batch(write_journal_entry, true);
+
+  return(NULL);
+  } /* END write_dirty_jobs() */
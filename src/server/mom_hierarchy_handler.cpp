@@ -79,6 +79,7 @@
 #include "node_manager.h"
 #include "threadpool.h"
 #include "id_map.hpp"
+#include "status_generation.hpp"
 
 mom_hierarchy_handler hierarchy_handler; //The global declaration.
 
@@ -481,12 +482,16 @@ void mom_hierarchy_handler::initialLoadHierarchy(void)
     if(sendOnDemand)
       {
       pnode->nd_lastHierarchySent = time(NULL); //Pretend the hierarchy was already sent.
-      pnode->nd_state &= ~INUSE_NOHIERARCHY;
       }
     else
       {
       pnode->nd_lastHierarchySent = 0;
+      }
+
+    if (pnode->nd_state & INUSE_NOHIERARCHY)
+      {
       pnode->nd_state &= ~INUSE_NOHIERARCHY;
+      pnode->nd_status_gen = status_gen.next();
       }
     pnode->unlock_node(__func__, NULL, LOGLEVEL);
     }
@@ -752,6 +757,7 @@ void mom_hierarchy_handler::checkAndSendHierarchy(
           {
           // This was created as a dynamic node and it now has a good ok host list.
           pnode->nd_state &= ~(INUSE_NOHIERARCHY|INUSE_OFFLINE);
+          pnode->nd_status_gen = status_gen.next();
           }
         pnode->unlock_node(__func__, NULL, LOGLEVEL);
         }
@@ -0,0 +1,493 @@
+/*
+ * node_change_log.cpp - an append-only log of node state and note changes
+ *
+ * Marking a node offline or setting its note used to rewrite node_status or
+ * node_note in full, walking and locking every node to do it. Those changes
+ * are now appended to the node_changes log instead, one line per node, and
+ * changes that arrive close together are written with a single write. Once
+ * the log holds NODE_CHANGES_COMPACT_RECORDS records the full files are
+ * rewritten and the log is truncated. setup_nodes() replays the log over the
+ * full files at startup.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fstream>
+
+#include "node_change_log.hpp"
+#include "pbs_error.h"
+#include "log.h"
+#include "../lib/Liblog/pbs_log.h"
+
+node_change_log node_changes;
+
+
+
+node_change_log::node_change_log() : ncl_path(), ncl_fd(-1), ncl_size(0), ncl_records(0),
+                                     ncl_flush_queued(false), ncl_states(), ncl_notes()
+
+  {
+  pthread_mutex_init(&this->ncl_mutex, NULL);
+  pthread_mutex_init(&this->ncl_write_mutex, NULL);
+  }
+
+
+
+node_change_log::~node_change_log()
+
+  {
+  this->close_log();
+  }
+
+
+
+/*
+ * complete_length()
+ *
+ * @param fd - an open node change log
+ * @return the length of the log up to and including its last newline, which
+ *         is where the last complete record ends, or -1 if it can't be read
+ */
+
+off_t node_change_log::complete_length(
+
+  int fd)
+
+  {
+  char    buf[4096];
+  off_t   pos;
+  size_t  chunk;
+
+  if ((pos = lseek(fd, 0, SEEK_END)) < 0)
+    return(-1);
+
+  while (pos > 0)
+    {
+    chunk = (pos < (off_t)sizeof(buf)) ? (size_t)pos : sizeof(buf);
+    pos -= chunk;
+
+    if (pread(fd, buf, chunk, pos) != (ssize_t)chunk)
+      return(-1);
+
+    for (size_t i = chunk; i > 0; i--)
+      {
+      if (buf[i - 1] == '\n')
+        return(pos + i);
+      }
+    }
+
+  return(0);
+  } /* END complete_length() */
+
+
+
+/*
+ * open_log()
+ *
+ * Opens the log for appending. A record left incomplete by a crash is cut
+ * off first, so the next record doesn't get appended onto it.
+ *
+ * @param path - the log to append to
+ * @param existing_records - the number of records already in the log, as
+ *                           counted by replay()
+ * @return PBSE_NONE on success, -1 if the log can't be opened
+ */
+
+int node_change_log::open_log(
+
+  const char *path,
+  int         existing_records)
+
+  {
+  int   fd;
+  off_t size;
+  off_t complete;
+
+  if ((fd = open(path, O_RDWR | O_CREAT | O_APPEND, 0600)) < 0)
+    {
+    log_err(errno, __func__, "cannot open the node change log");
+    return(-1);
+    }
+
+  size = lseek(fd, 0, SEEK_END);
+
+  if (((complete = complete_length(fd)) < 0) ||
+      ((complete < size) &&
+       (ftruncate(fd, complete) != 0)))
+    {
+    log_err(errno, __func__, "cannot remove an incomplete record from the node change log");
+    close(fd);
+    return(-1);
+    }
+
+  pthread_mutex_lock(&this->ncl_mutex);
+  this->ncl_path = path;
+  this->ncl_fd = fd;
+  this->ncl_size = complete;
+  this->ncl_records = (existing_records > 0) ? existing_records : 0;
+  pthread_mutex_unlock(&this->ncl_mutex);
+
+  return(PBSE_NONE);
+  } /* END open_log() */
+
+
+
+void node_change_log::close_log()
+
+  {
+  this->flush();
+
+  pthread_mutex_lock(&this->ncl_write_mutex);
+  pthread_mutex_lock(&this->ncl_mutex);
+
+  if (this->ncl_fd >= 0)
+    {
+    close(this->ncl_fd);
+    this->ncl_fd = -1;
+    }
+
+  pthread_mutex_unlock(&this->ncl_mutex);
+  pthread_mutex_unlock(&this->ncl_write_mutex);
+  } /* END close_log() */
+
+
+
+bool node_change_log::is_open()
+
+  {
+  bool open;
+
+  pthread_mutex_lock(&this->ncl_mutex);
+  open = this->ncl_fd >= 0;
+  pthread_mutex_unlock(&this->ncl_mutex);
+
+  return(open);
+  } /* END is_open() */
+
+
+
+/*
+ * record_state()
+ *
+ * Queues the new persistent state bits for a node. Only the last value
+ * recorded before the next flush() is written.
+ *
+ * @return true if the change was queued, false if the log isn't open and the
+ *         caller needs to save the state some other way
+ */
+
+bool node_change_log::record_state(
+
+  const char *node_name,
+  int         state)
+
+  {
+  bool queued = false;
+
+  pthread_mutex_lock(&this->ncl_mutex);
+
+  if (this->ncl_fd >= 0)
+    {
+    this->ncl_states[node_name] = state;
+    queued = true;
+    }
+
+  pthread_mutex_unlock(&this->ncl_mutex);
+
+  return(queued);
+  } /* END record_state() */
+
+
+
+/*
+ * record_note()
+ *
+ * Queues the new note for a node, see record_state().
+ */
+
+bool node_change_log::record_note(
+
+  const char        *node_name,
+  const std::string &note)
+
+  {
+  bool queued = false;
+
+  pthread_mutex_lock(&this->ncl_mutex);
+
+  if (this->ncl_fd >= 0)
+    {
+    this->ncl_notes[node_name] = note;
+    queued = true;
+    }
+
+  pthread_mutex_unlock(&this->ncl_mutex);
+
+  return(queued);
+  } /* END record_note() */
+
+
+
+/*
+ * needs_flush_task()
+ *
+ * @return true if there are pending changes and no flush has been scheduled
+ *         for them yet. The caller is then responsible for calling flush().
+ */
+
+bool node_change_log::needs_flush_task()
+
+  {
+  bool needed = false;
+
+  pthread_mutex_lock(&this->ncl_mutex);
+
+  if ((this->ncl_flush_queued == false) &&
+      ((this->ncl_states.size() != 0) ||
+       (this->ncl_notes.size() != 0)))
+    {
+    this->ncl_flush_queued = true;
+    needed = true;
+    }
+
+  pthread_mutex_unlock(&this->ncl_mutex);
+
+  return(needed);
+  } /* END needs_flush_task() */
+
+
+
+/*
+ * flush()
+ *
+ * Appends every pending change to the log with one write and syncs it.
+ *
+ * @return PBSE_NONE on success, -1 if the write failed
+ */
+
+int node_change_log::flush()
+
+  {
+  std::map<std::string, int>         states;
+  std::map<std::string, std::string> notes;
+  std::string                        batch;
+  char                               buf[64];
+  int                                rc = PBSE_NONE;
+  size_t                             written = 0;
+  ssize_t                            len;
+
+  pthread_mutex_lock(&this->ncl_write_mutex);
+
+  pthread_mutex_lock(&this->ncl_mutex);
+  states.swap(this->ncl_states);
+  notes.swap(this->ncl_notes);
+  this->ncl_flush_queued = false;
+  pthread_mutex_unlock(&this->ncl_mutex);
+
+  for (std::map<std::string, int>::iterator it = states.begin(); it != states.end(); it++)
+    {
+    snprintf(buf, sizeof(buf), " %d\n", it->second);
+    batch += NODE_CHANGE_STATE " ";
+    batch += it->first;
+    batch += buf;
+    }
+
+  for (std::map<std::string, std::string>::iterator it = notes.begin(); it != notes.end(); it++)
+    {
+    std::string note(it->second);
+
+    /* a record is one line */
+    for (size_t i = 0; i < note.size(); i++)
+      {
+      if ((note[i] == '\n') ||
+          (note[i] == '\r'))
+        note[i] = ' ';
+      }
+
+    batch += NODE_CHANGE_NOTE " ";
+    batch += it->first;
+    batch += " ";
+    batch += note;
+    batch += "\n";
+    }
+
+  while ((written < batch.size()) &&
+         (this->ncl_fd >= 0))
+    {
+    len = write(this->ncl_fd, batch.c_str() + written, batch.size() - written);
+
+    if (len < 0)
+      {
+      if (errno == EINTR)
+        continue;
+
+      log_err(errno, __func__, "cannot write to the node change log");
+      rc = -1;
+      break;
+      }
+
+    written += len;
+    }
+
+  if ((rc == PBSE_NONE) &&
+      (written > 0) &&
+      (fdatasync(this->ncl_fd) != 0))
+    {
+    log_err(errno, __func__, "cannot sync the node change log");
+    rc = -1;
+    }
+
+  if (rc == PBSE_NONE)
+    {
+    pthread_mutex_lock(&this->ncl_mutex);
+    this->ncl_size += written;
+    this->ncl_records += states.size() + notes.size();
+    pthread_mutex_unlock(&this->ncl_mutex);
+    }
+  else if (ftruncate(this->ncl_fd, this->ncl_size) != 0)
+    {
+    /* appending after part of a record would garble the next one */
+    log_err(errno, __func__, "cannot remove a failed write from the node change log");
+    }
+
+  pthread_mutex_unlock(&this->ncl_write_mutex);
+
+  return(rc);
+  } /* END flush() */
+
+
+
+bool node_change_log::needs_compaction()
+
+  {
+  bool needed;
+
+  pthread_mutex_lock(&this->ncl_mutex);
+  needed = (this->ncl_fd >= 0) &&
+           (this->ncl_records >= NODE_CHANGES_COMPACT_RECORDS);
+  pthread_mutex_unlock(&this->ncl_mutex);
+
+  return(needed);
+  } /* END needs_compaction() */
+
+
+
+/*
+ * compact()
+ *
+ * Writes the full node files and truncates the log. No records are appended
+ * while this runs; changes made meanwhile stay pending, and since every
+ * record holds a complete value, replaying one that's also in the full files
+ * is harmless.
+ *
+ * @param write_snapshot - writes the current state and notes of every node
+ * @return PBSE_NONE on success, -1 if the log was left as it was
+ */
+
+int node_change_log::compact(
+
+  node_snapshot_func write_snapshot)
+
+  {
+  int rc = -1;
+
+  pthread_mutex_lock(&this->ncl_write_mutex);
+
+  if ((this->ncl_fd >= 0) &&
+      (write_snapshot() == PBSE_NONE))
+    {
+    if (ftruncate(this->ncl_fd, 0) != 0)
+      log_err(errno, __func__, "cannot truncate the node change log");
+    else
+      {
+      pthread_mutex_lock(&this->ncl_mutex);
+      this->ncl_size = 0;
+      this->ncl_records = 0;
+      pthread_mutex_unlock(&this->ncl_mutex);
+
+      rc = PBSE_NONE;
+      }
+    }
+
+  pthread_mutex_unlock(&this->ncl_write_mutex);
+
+  return(rc);
+  } /* END compact() */
+
+
+
+/*
+ * replay()
+ *
+ * Applies every record in a node change log, oldest first. An incomplete
+ * last line (a write cut short) is ignored.
+ *
+ * @param path - the log to read
+ * @param apply_state - called for each state record
+ * @param apply_note - called for each note record
+ * @return the number of records applied, 0 if there is no log
+ */
+
+int node_change_log::replay(
+
+  const char            *path,
+  node_state_apply_func  apply_state,
+  node_note_apply_func   apply_note)
+
+  {
+  std::ifstream log_file(path);
+  std::string   line;
+  int           count = 0;
+
+  while (std::getline(log_file, line))
+    {
+    /* getline() hitting end of file means the line had no newline */
+    if (log_file.eof())
+      break;
+
+    size_t type_end = line.find(' ');
+
+    if (type_end == std::string::npos)
+      continue;
+
+    size_t      name_end = line.find(' ', type_end + 1);
+    std::string type = line.substr(0, type_end);
+    std::string name;
+    std::string value;
+
+    if (name_end == std::string::npos)
+      continue;
+
+    name = line.substr(type_end + 1, name_end - type_end - 1);
+    value = line.substr(name_end + 1);
+
+    if (name.size() == 0)
+      continue;
+
+    if (type == NODE_CHANGE_STATE)
+      {
+      char *end;
+      long  state = strtol(value.c_str(), &end, 10);
+
+      if ((value.size() == 0) ||
+          (*end != '\0'))
+        continue;
+
+      apply_state(name.c_str(), (int)state);
+      }
+    else if (type == NODE_CHANGE_NOTE)
+      apply_note(name.c_str(), value.c_str());
+    else
+      continue;
+
+    count++;
+    }
+
+  return(count);
+  } /* END replay() */
@@ -66,6 +66,8 @@
 #include "runjob_help.hpp"
 #include "policy_values.h"
 #include "authorized_hosts.hpp"
+#include "node_change_log.hpp"
+#include "status_generation.hpp"
 
 #if !defined(H_ERRNO_DECLARED) && !defined(_AIX)
 /*extern int h_errno;*/
@@ -83,6 +85,7 @@ extern char            *path_nodes;
 extern char            *path_nodestate;
 extern char            *path_nodepowerstate;
 extern char            *path_nodenote;
+extern char            *path_nodechanges;
 extern int              LOGLEVEL;
 extern attribute_def    node_attr_def[];   /* node attributes defs */
 
@@ -421,6 +424,9 @@ int chk_characteristic(
     return(PBSE_BAD_PARAMETER);
     }
 
+  /* a manager just changed the node */
+  pnode->nd_status_gen = status_gen.next();
+
   tmpLine[0] = '\0';
 
   if (pnode->nd_state != nci->state)
@@ -442,6 +448,12 @@ int chk_characteristic(
   
     if (tmpLine[0] != '\0')
       {
+      /* only offline nodes are kept in node_status, along with their reserve bit */
+      if (pnode->nd_state & INUSE_OFFLINE)
+        node_changes.record_state(pnode->get_name(), pnode->nd_state & (INUSE_OFFLINE | INUSE_RESERVE));
+      else
+        node_changes.record_state(pnode->get_name(), 0);
+
       if (LOGLEVEL >= 3)
         {
         snprintf(log_buf, LOCAL_LOG_BUF_SIZE, "node %s state modified (%s)\n",
@@ -467,6 +479,8 @@ int chk_characteristic(
   if (pnode->nd_note != nci->note)    /* not the same string */
     {
     *pneed_todo |= WRITENODE_NOTE;        /*node's note changed*/
+
+    node_changes.record_note(pnode->get_name(), pnode->nd_note);
     }
 
   nci->note.clear();
@@ -870,6 +884,12 @@ void effective_node_delete(
   if (remove_node(&allnodes, pnode) != PBSE_NONE)
     return;
 
+  status_gen.record_deleted(STATUS_GEN_NODE, pnode->get_name());
+
+  /* a node created later with this name mustn't get this one's logged state */
+  if (node_changes.record_state(pnode->get_name(), 0) == true)
+    node_changes.record_note(pnode->get_name(), "");
+
   pnode->unlock_node(__func__, NULL, LOGLEVEL);
 
   //The node has been removed from the allnodes array.
@@ -1322,7 +1342,10 @@ int add_execution_slot(
 
   if (((pnode->nd_state & INUSE_JOB) != 0) &&
        (!job_exclusive_on_use))
+    {
     pnode->nd_state &= ~INUSE_JOB;
+    pnode->nd_status_gen = status_gen.next();
+    }
 
   return(PBSE_NONE);
   }  /* END add_execution_slot() */
@@ -2017,6 +2040,101 @@ void load_node_notes()
 
 
 
+/*
+ * find_node_for_recovery()
+ *
+ * @return the named node, locked, creating it if it looks like a Cray subnode
+ */
+
+struct pbsnode *find_node_for_recovery(
+
+  const char *node_name)
+
+  {
+  struct pbsnode *np = find_nodebyname(node_name);
+
+  if ((np == NULL) &&
+      (cray_enabled == true) &&
+      (isdigit(node_name[0])))
+    np = create_alps_subnode(alps_reporter, node_name);
+
+  return(np);
+  } // END find_node_for_recovery()
+
+
+
+/*
+ * apply_node_state_change()
+ *
+ * Applies a state record from the node change log: state holds the complete
+ * set of persistent state bits for the node.
+ */
+
+void apply_node_state_change(
+
+  const char *node_name,
+  int         state)
+
+  {
+  struct pbsnode *np = find_node_for_recovery(node_name);
+
+  if (np != NULL)
+    {
+    np->nd_state &= ~(INUSE_OFFLINE | INUSE_RESERVE);
+    np->nd_state |= state & (INUSE_OFFLINE | INUSE_RESERVE);
+    np->nd_status_gen = status_gen.next();
+    np->unlock_node(__func__, NULL, LOGLEVEL);
+    }
+  } // END apply_node_state_change()
+
+
+
+/*
+ * apply_node_note_change()
+ *
+ * Applies a note record from the node change log
+ */
+
+void apply_node_note_change(
+
+  const char *node_name,
+  const char *note)
+
+  {
+  struct pbsnode *np = find_node_for_recovery(node_name);
+
+  if (np != NULL)
+    {
+    np->nd_note = note;
+    np->unlock_node(__func__, NULL, LOGLEVEL);
+    }
+  } // END apply_node_note_change()
+
+
+
+/*
+ * load_node_changes()
+ *
+ * Replays the node change log over the state and notes loaded from
+ * node_status and node_note, then opens it for new changes.
+ */
+
+void load_node_changes()
+
+  {
+  int records;
+
+  if (node_changes.is_open() == true)
+    return;
+
+  records = node_change_log::replay(path_nodechanges, apply_node_state_change, apply_node_note_change);
+
+  if (node_changes.open_log(path_nodechanges, records) != PBSE_NONE)
+    log_err(-1, __func__, "node state and note changes will rewrite node_status and node_note");
+  } // END load_node_changes()
+
+
+
 int add_node_attribute_to_list(
     
   char        *token,
@@ -2575,6 +2693,7 @@ int setup_nodes(void)
 
         /* exclusive bits are calculated later in set_old_nodes() */
         np->nd_state &= ~INUSE_JOB;
+        np->nd_status_gen = status_gen.next();
         np->unlock_node(__func__, "no match", LOGLEVEL);
         }
       }
@@ -2612,6 +2731,8 @@ int setup_nodes(void)
 
   load_node_notes();
 
+  load_node_changes();
+
   /* SUCCESS */
 
   return(0);
@@ -3482,7 +3603,10 @@ int remove_node(
   if (an->remove(pnode->get_name()) == false)
     rc = -1;
   else
+    {
+    remove_from_node_index(pnode);
     rc = PBSE_NONE;
+    }
 
   an->unlock();
 
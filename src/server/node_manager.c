@@ -142,6 +142,9 @@
 #include "plugin_internal.h"
 #include "json/json.h"
 #include "authorized_hosts.hpp"
+#include "node_change_log.hpp"
+#include "node_select_index.hpp"
+#include "status_generation.hpp"
 
 #define IS_VALID_STR(STR)  (((STR) != NULL) && ((STR)[0] != '\0'))
 
@@ -350,6 +353,7 @@ void update_node_state(
 
   {
   char            log_buf[LOCAL_LOG_BUF_SIZE];
+  int             oldstate = np->nd_state;
 
   /* No need to do anything if newstate == oldstate */
   if (np->nd_state == newstate)
@@ -439,6 +443,12 @@ void update_node_state(
     log_record(PBSEVENT_SCHED, PBS_EVENTCLASS_REQUEST, __func__, log_buf);
     }
 
+  if (np->nd_state != oldstate)
+    np->nd_status_gen = status_gen.next();
+
+  /* some callers release the node without unlock_node() */
+  update_node_index(np);
+
   return;
   }  /* END update_node_state() */
 
@@ -883,6 +893,8 @@ void process_job_attribute_information(
           }
         }
 
+      pjob->ji_status_gen = status_gen.next();
+
       // Only update the last reported time if the mother superior is reporting it.
       if (node_addr == pjob->ji_qs.ji_un.ji_exect.ji_momaddr)
         pjob->ji_last_reported_time = time(NULL);
@@ -942,6 +954,8 @@ void process_legacy_job_attribute_information(
       attr_val = threadsafe_tokenizer(&attr_work, ",");
       }
 
+    pjob->ji_status_gen = status_gen.next();
+
     // Only update the last reported time if the mother superior is reporting it.
     if (node_addr == pjob->ji_qs.ji_un.ji_exect.ji_momaddr)
       pjob->ji_last_reported_time = time(NULL);
@@ -1266,6 +1280,7 @@ void setup_notification(
       {
       /* call it offline until after all nodes get the new ipaddr */
       pnode->nd_state |= INUSE_OFFLINE;
+      pnode->nd_status_gen = status_gen.next();
       
       pnode->unlock_node(__func__, "nnew != NULL", LOGLEVEL);
       }
@@ -1518,21 +1533,28 @@ void check_nodes(
 
 
 
-void *write_node_state_work(
+/*
+ * save_node_state()
+ *
+ * Rewrites the node_status file with the persistent state of every node.
+ *
+ * @return PBSE_NONE on success, -1 otherwise
+ */
 
-  void *vp)
+int save_node_state()
 
   {
   struct pbsnode *np = NULL;
   static char    *fmt = (char *)"%s %d\n";
   static FILE    *nstatef = NULL;
   int             savemask;
+  int             rc = PBSE_NONE;
 
   pthread_mutex_lock(node_state_mutex);
 
   if (LOGLEVEL >= 5)
     {
-    DBPRT(("write_node_state_work: entered\n"))
+    DBPRT(("save_node_state: entered\n"))
     }
 
   /* don't store volatile states like down and unknown */
@@ -1549,7 +1571,7 @@ void *write_node_state_work(
 
       pthread_mutex_unlock(node_state_mutex);
       
-      return(NULL);
+      return(-1);
       }
     }
   else
@@ -1562,7 +1584,7 @@ void *write_node_state_work(
 
       pthread_mutex_unlock(node_state_mutex);
       
-      return(NULL);
+      return(-1);
       }
     }
 
@@ -1606,6 +1628,7 @@ void *write_node_state_work(
   if (fflush(nstatef) != 0)
     {
     log_err(errno, __func__, "failed saving node state to disk");
+    rc = -1;
     }
 
   fclose(nstatef);
@@ -1613,6 +1636,48 @@ void *write_node_state_work(
 
   pthread_mutex_unlock(node_state_mutex);
 
+  return(rc);
+  } /* END save_node_state() */
+
+
+
+/*
+ * write_node_snapshot()
+ *
+ * Rewrites node_status and node_note in full. Used to compact the node change
+ * log.
+ */
+
+int write_node_snapshot()
+
+  {
+  int rc = save_node_state();
+
+  if (write_node_note() != PBSE_NONE)
+    rc = -1;
+
+  return(rc);
+  } /* END write_node_snapshot() */
+
+
+
+void *write_node_state_work(
+
+  void *vp)
+
+  {
+  /* with the change log open the changes are already recorded there, so
+   * only write them out and leave the full rewrite to compaction */
+  if (node_changes.is_open() == true)
+    {
+    node_changes.flush();
+
+    if (node_changes.needs_compaction() == true)
+      node_changes.compact(write_node_snapshot);
+    }
+  else
+    save_node_state();
+
   return(NULL);
   } /* END write_node_state_work() */
 
@@ -1708,6 +1773,66 @@ void write_node_state(void)
     }
   }  /* END write_node_state() */
 
+/*
+ * flush_node_changes()
+ *
+ * Timed task that appends the node changes recorded since it was scheduled
+ * to the node change log, and folds the log back into node_status and
+ * node_note once it has grown large enough.
+ */
+
+void flush_node_changes(
+
+  struct work_task *ptask)
+
+  {
+  node_changes.flush();
+
+  if (node_changes.needs_compaction() == true)
+    node_changes.compact(write_node_snapshot);
+
+  free(ptask->wt_mutex);
+  free(ptask);
+  }  /* END flush_node_changes() */
+
+
+
+/*
+ * write_node_changes()
+ *
+ * Saves the node state and note changes flagged in need_todo. When the node
+ * change log is open chk_characteristic() has already recorded them there and
+ * they are written after a short delay, together with any others that arrive
+ * in the meantime. Otherwise node_status and node_note are rewritten.
+ *
+ * @param need_todo - WRITENODE_* bits from chk_characteristic()
+ */
+
+void write_node_changes(
+
+  int need_todo)
+
+  {
+  if (node_changes.is_open() == true)
+    {
+    if (node_changes.needs_flush_task() == true)
+      {
+      if (set_task(WORK_Timed, time(NULL) + NODE_CHANGES_DELAY, flush_node_changes, NULL, FALSE) == NULL)
+        node_changes.flush();
+      }
+
+    return;
+    }
+
+  if (need_todo & WRITENODE_STATE)
+    write_node_state();
+
+  if (need_todo & WRITENODE_NOTE)
+    write_node_note();
+  }  /* END write_node_changes() */
+
+
+
 void write_node_power_state(void)
 
   {
@@ -2239,6 +2364,9 @@ int proplist(
     else
       {
       prop p(pname);
+
+      /* look the name up once here instead of for every node it's checked against */
+      resolve_property(p);
       plist.push_back(p);
       }
 
@@ -2435,6 +2563,128 @@ bool node_is_spec_acceptable(
 
 
 
+/*
+ * update_node_index()
+ *
+ * Tells node_index what node_is_spec_acceptable() would see if it looked at
+ * pnode now. Called with pnode locked, right before it's unlocked, so the
+ * index hears about every change to the node.
+ */
+
+void update_node_index(
+
+  struct pbsnode *pnode)
+
+  {
+  node_index_summary summary;
+  node_index_inputs  inputs;
+
+  /* subnodes are reached through their parent, and a node that was removed
+   * must not come back */
+  if ((pnode->parent != NULL) ||
+      (pnode->nd_id < 0) ||
+      (pnode->nd_index_summary.removed == true))
+    return;
+
+  inputs.state = pnode->nd_state;
+  inputs.power_state = pnode->nd_power_state;
+  inputs.has_subnodes = (pnode->num_node_boards != 0) ||
+                        (pnode->alps_subnodes != NULL);
+  inputs.slots_total = pnode->nd_slots.get_total_execution_slots();
+  inputs.slots_free = pnode->nd_slots.get_number_free();
+  inputs.np_to_be_used = pnode->nd_np_to_be_used;
+  inputs.gpus_real = pnode->nd_gpus_real;
+  inputs.ngpus = pnode->nd_ngpus;
+  inputs.ngpus_free = pnode->nd_ngpus_free;
+  inputs.ngpus_to_be_used = pnode->nd_ngpus_to_be_used;
+  inputs.gpus_generation = pnode->nd_gpus_generation;
+  inputs.nmics = pnode->nd_nmics;
+  inputs.nmics_free = pnode->nd_nmics_free;
+  inputs.nmics_to_be_used = pnode->nd_nmics_to_be_used;
+  inputs.props_generation = pnode->nd_props_generation;
+
+  /* nothing the summary depends on has changed since it was computed */
+  if ((pnode->nd_index_summary.valid == true) &&
+      (inputs.same_as(pnode->nd_index_summary.inputs) == true))
+    return;
+
+  summary.valid = true;
+  summary.inputs = inputs;
+  summary.indexable = (inputs.has_subnodes == false);
+  summary.available = ((pnode->nd_state & (INUSE_DOWN | INUSE_UNKNOWN | INUSE_OFFLINE |
+                                           INUSE_NOT_READY | INUSE_RESERVE | INUSE_JOB)) == 0) &&
+                      (pnode->nd_power_state == POWER_STATE_RUNNING);
+  summary.total_slots = inputs.slots_total;
+  summary.free_slots = inputs.slots_free - pnode->nd_np_to_be_used;
+  summary.all_slots_free = (inputs.slots_free == summary.total_slots);
+
+  /* the same rules as gpu_count(), except that shared gpus always count as
+   * free since gpu_mode_rqstd depends on the job */
+  if (((pnode->nd_state & (INUSE_OFFLINE | INUSE_UNKNOWN | INUSE_NOT_READY)) == 0) &&
+      (pnode->nd_power_state == POWER_STATE_RUNNING))
+    {
+    if (pnode->nd_gpus_real)
+      {
+      for (int j = 0; j < pnode->nd_ngpus; j++)
+        {
+        struct gpusubn &gn = pnode->nd_gpusn[j];
+
+        if (gn.state == gpu_unavailable)
+          continue;
+
+        summary.gpus_total++;
+
+        if ((gn.state == gpu_unallocated) ||
+            (gn.state == gpu_shared))
+          summary.gpus_free++;
+        }
+      }
+    else
+      {
+      summary.gpus_total = pnode->nd_ngpus;
+      summary.gpus_free = pnode->nd_ngpus_free;
+      }
+
+    summary.gpus_free -= pnode->nd_ngpus_to_be_used;
+    }
+
+  summary.mics_total = pnode->nd_nmics;
+  summary.mics_free = pnode->nd_nmics_free - pnode->nd_nmics_to_be_used;
+  summary.props_generation = pnode->nd_props_generation;
+
+  if (summary.same_as(pnode->nd_index_summary) == true)
+    {
+    pnode->nd_index_summary.inputs = inputs;
+    return;
+    }
+
+  /* what the node can run is part of its status too */
+  pnode->nd_status_gen = status_gen.next();
+
+  node_index.update_node(pnode->nd_id, pnode->get_name(), pnode->get_properties(), summary);
+  pnode->nd_index_summary = summary;
+  } /* END update_node_index() */
+
+
+
+/*
+ * remove_from_node_index()
+ *
+ * Takes a node that's been removed from allnodes out of node_index for good.
+ * Called with pnode locked.
+ */
+
+void remove_from_node_index(
+
+  struct pbsnode *pnode)
+
+  {
+  pnode->nd_index_summary.removed = true;
+  node_index.remove_node(pnode->nd_id);
+  } /* END remove_from_node_index() */
+
+
+
 
 int parse_req_data(
     
@@ -3031,6 +3281,117 @@ int select_nodes_using_hostlist(
 
 
 
+/*
+ * select_from_indexed_nodes()
+ *
+ * Selects nodes the way select_from_all_nodes() does, but only locks the nodes
+ * that node_index says may be able to run one of the requests right now. They
+ * are visited in the order they were indexed, which is the order they were
+ * added to the server. With node_select_threads set, big clusters have their
+ * candidates found by several threads; the order, and so the placement, is
+ * the same either way.
+ *
+ * @pre-cond: node_index.is_usable() is true
+ * @post-cond: the nodes in the list are saved in naji to be added for the job later
+ */
+
+int select_from_indexed_nodes(
+
+  complete_spec_data            &all_reqs,        /* I */
+  std::list<node_job_add_info>  *naji_list,       /* O (optional) */
+  int                           *eligible_nodes,  /* O */
+  alps_req_data                **ard_array,       /* O (optional) */
+  int                            first_node_id,   /* I */
+  int                            num_alps_reqs,   /* I */
+  enum job_types                 job_type,        /* I */
+  char                          *ProcBMStr,       /* I (optional) */
+  bool                           job_is_exclusive)
+
+  {
+  std::map<unsigned long, std::string>           candidates;
+  std::map<unsigned long, std::string>::iterator it;
+  std::set<std::string>                          visited;
+  struct pbsnode                                *pnode;
+  int                                            num = 0;
+
+  if ((node_select_threads > 1) &&
+      (node_index.size() >= NODE_SELECT_PARALLEL_MIN_NODES))
+    {
+    std::vector<node_index_request> reqs;
+
+    for (int i = 0; i < all_reqs.num_reqs; i++)
+      {
+      single_spec_data &req = all_reqs.reqs[i];
+
+      if (req.nodes > 0)
+        reqs.push_back(node_index_request(&req.plist, req.ppn, req.gpu, req.mic));
+      }
+
+    node_index.find_candidates_parallel(reqs, job_is_exclusive, node_select_threads, candidates);
+    }
+  else
+    {
+    for (int i = 0; i < all_reqs.num_reqs; i++)
+      {
+      single_spec_data &req = all_reqs.reqs[i];
+
+      if (req.nodes > 0)
+        node_index.find_candidates(req.plist, req.ppn, req.gpu, req.mic, job_is_exclusive, candidates);
+      }
+    }
+
+  /* the candidates are only as current as the index, so each one is checked
+   * again under its lock, in order, and recorded until the job is satisfied */
+  for (it = candidates.begin(); it != candidates.end(); it++)
+    {
+    if ((pnode = find_nodebyname(it->second.c_str())) == NULL)
+      continue;
+
+    visited.insert(it->second);
+
+    /* check each req against this node to see if it satisfies it */
+    for (int i = 0; i < all_reqs.num_reqs; i++)
+      {
+      single_spec_data &req = all_reqs.reqs[i];
+
+      if (req.nodes > 0)
+        {
+        if (node_is_spec_acceptable(pnode, req, ProcBMStr, eligible_nodes,job_is_exclusive) == true)
+          {
+          record_fitting_node(num, pnode, naji_list, req, first_node_id, req.req_id, num_alps_reqs, job_type, all_reqs, ard_array);
+
+          /* are all reqs satisfied? */
+          if (all_reqs.total_nodes == 0)
+            break;
+          }
+        }
+      }
+
+    pnode->unlock_node(__func__, NULL, LOGLEVEL);
+
+    /* are all reqs satisfied? */
+    if (all_reqs.total_nodes == 0)
+      break;
+    }
+
+  /* node_spec() tells a job that will never run from one that has to wait by
+   * the eligible nodes, so count the ones that were never locked */
+  if (all_reqs.total_nodes > 0)
+    {
+    for (int i = 0; i < all_reqs.num_reqs; i++)
+      {
+      single_spec_data &req = all_reqs.reqs[i];
+
+      if (req.nodes > 0)
+        *eligible_nodes += node_index.count_eligible(req.plist, req.ppn, req.gpu, req.mic, visited);
+      }
+    }
+
+  return(num);
+  } /* END select_from_indexed_nodes() */
+
+
+
 /*
  * select_from_all_nodes()
  *
@@ -3058,6 +3419,14 @@ int select_from_all_nodes(
   node_iterator   iter;
   struct pbsnode *pnode = NULL;
   int             num = 0;
+
+  /* cray and geometry requests, and nodes with numa subnodes, still need the
+   * full scan */
+  if ((cray_enabled == false) &&
+      ((ProcBMStr == NULL) ||
+       (ProcBMStr[0] == '\0')) &&
+      (node_index.is_usable() == true))
+    return(select_from_indexed_nodes(all_reqs, naji_list, eligible_nodes, ard_array, first_node_id, num_alps_reqs, job_type, ProcBMStr, job_is_exclusive));
   
   reinitialize_node_iterator(&iter);
 
@@ -3351,6 +3720,37 @@ int node_spec(
     return(rc);
     }
 
+  /* a property no node has and that names no node can never be satisfied */
+  for (unsigned int r = 0; r < all_reqs.reqs.size(); r++)
+    {
+    std::vector<prop> &plist = all_reqs.reqs[r].plist;
+
+    for (unsigned int p = 0; p < plist.size(); p++)
+      {
+      if (plist[p].id != PROP_UNKNOWN)
+        continue;
+
+      /* FAILURE */
+
+      sprintf(log_buf, "job requests unknown node property '%s'",
+        plist[p].name.c_str());
+
+      free(spec);
+
+      if (LOGLEVEL >= 6)
+        {
+        log_record(PBSEVENT_SCHED, PBS_EVENTCLASS_REQUEST, __func__, log_buf);
+        }
+
+      if (EMsg != NULL)
+        {
+        snprintf(EMsg, 1024, "%s", log_buf);
+        }
+
+      return(-1);
+      }
+    }
+
   num = all_reqs.total_nodes;
 
 #ifndef CRAY_MOAB_PASSTHRU
@@ -3703,6 +4103,7 @@ int reserve_node(
     
   /* mark the node as exclusive */
   pnode->nd_state = INUSE_JOB;
+  pnode->nd_status_gen = status_gen.next();
 
   return(PBSE_NONE);
   }
@@ -3908,6 +4309,7 @@ int place_gpus_in_hostlist(
            (gpu_mode_rqstd == gpu_exclusive_process)))))
       {
       gn.state = gpu_exclusive;
+      pnode->nd_gpus_generation++;
       
       sprintf(log_buf,
         "Setting gpu %s/%d to state EXCLUSIVE for job %s",
@@ -3931,6 +4333,7 @@ int place_gpus_in_hostlist(
         (gpu_mode_rqstd == gpu_normal) && (gn.state == gpu_unallocated))
       {
       gn.state = gpu_shared;
+      pnode->nd_gpus_generation++;
       
       sprintf(log_buf,
         "Setting gpu %s/%d to state SHARED for job %s",
@@ -4032,7 +4435,7 @@ void save_cpus_and_memory_cpusets(
     if (cpus.size() != 0)
       formatted += ":" + cpus;
     pjob->ji_wattr[JOB_ATR_cpuset_string].at_val.at_str = strdup(formatted.c_str());
-    pjob->ji_wattr[JOB_ATR_cpuset_string].at_flags |= ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_cpuset_string].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     }
   else
     {
@@ -4043,6 +4446,7 @@ void save_cpus_and_memory_cpusets(
       all_cpus += ":" + cpus;
     free(pjob->ji_wattr[JOB_ATR_cpuset_string].at_val.at_str);
     pjob->ji_wattr[JOB_ATR_cpuset_string].at_val.at_str = strdup(all_cpus.c_str());
+    pjob->ji_wattr[JOB_ATR_cpuset_string].at_flags |= ATR_VFLAG_MODIFY;
     }
   
   if (pjob->ji_wattr[JOB_ATR_memset_string].at_val.at_str == NULL)
@@ -4051,7 +4455,7 @@ void save_cpus_and_memory_cpusets(
     if (mems.size() != 0)
       formatted += ":" + mems;
     pjob->ji_wattr[JOB_ATR_memset_string].at_val.at_str = strdup(formatted.c_str());
-    pjob->ji_wattr[JOB_ATR_memset_string].at_flags |= ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_memset_string].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     }
   else
     {
@@ -4062,6 +4466,7 @@ void save_cpus_and_memory_cpusets(
       all_mems += ":" + mems;
     free(pjob->ji_wattr[JOB_ATR_memset_string].at_val.at_str);
     pjob->ji_wattr[JOB_ATR_memset_string].at_val.at_str = strdup(all_mems.c_str());
+    pjob->ji_wattr[JOB_ATR_memset_string].at_flags |= ATR_VFLAG_MODIFY;
     }
 
   } // END save_cpus_and_memory_cpusets()
@@ -4143,7 +4548,7 @@ void update_req_hostlist(
     get_svr_attr_l(SRV_ATR_LegacyVmem, &legacy_vmem);
     cr = new complete_req(pjob->ji_wattr[JOB_ATR_resource].at_val.at_ptr, ppn_needed, (bool)legacy_vmem);
     pjob->ji_wattr[JOB_ATR_req_information].at_val.at_ptr = cr; 
-    pjob->ji_wattr[JOB_ATR_req_information].at_flags |= ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_req_information].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     }
   else
     {
@@ -4220,7 +4625,10 @@ int place_subnodes_in_hostlist(
     if ((pnode->nd_slots.get_number_free() <= 0) ||
         (pjob->ji_wattr[JOB_ATR_node_exclusive].at_val.at_long == TRUE) ||
         (job_exclusive_on_use))
+      {
       pnode->nd_state |= INUSE_JOB;
+      pnode->nd_status_gen = status_gen.next();
+      }
 
 #ifdef PENABLE_LINUX_CGROUPS
     std::string       cpus;
@@ -4477,7 +4885,7 @@ int record_external_node(
   if (pjob->ji_wattr[JOB_ATR_external_nodes].at_val.at_str == NULL)
     {
     pjob->ji_wattr[JOB_ATR_external_nodes].at_val.at_str = strdup(pnode->get_name());
-    pjob->ji_wattr[JOB_ATR_external_nodes].at_flags |= ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_external_nodes].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     }
   else
     {
@@ -4490,6 +4898,7 @@ int record_external_node(
     free(pjob->ji_wattr[JOB_ATR_external_nodes].at_val.at_str);
 
     pjob->ji_wattr[JOB_ATR_external_nodes].at_val.at_str = external_nodes;
+    pjob->ji_wattr[JOB_ATR_external_nodes].at_flags |= ATR_VFLAG_MODIFY;
     }
 
   return(PBSE_NONE);
@@ -4702,7 +5111,7 @@ int add_multi_reqs_to_job(
     free(pjob->ji_wattr[JOB_ATR_multi_req_alps].at_val.at_str);
 
   pjob->ji_wattr[JOB_ATR_multi_req_alps].at_val.at_str = strdup(attr_str.c_str());
-  pjob->ji_wattr[JOB_ATR_multi_req_alps].at_flags |= ATR_VFLAG_SET;
+  pjob->ji_wattr[JOB_ATR_multi_req_alps].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
   return(PBSE_NONE);
   } /* END add_multi_reqs_to_job() */
@@ -4966,9 +5375,9 @@ int set_nodes(
         (naji_list.size() > 1))
       {
       pjob->ji_wattr[JOB_ATR_login_node_id].at_val.at_str = strdup(node_mapper.get_name(naji_list.begin()->node_id));
-      pjob->ji_wattr[JOB_ATR_login_node_id].at_flags = ATR_VFLAG_SET;
+      pjob->ji_wattr[JOB_ATR_login_node_id].at_flags = ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
       pjob->ji_wattr[JOB_ATR_login_node_key].at_val.at_long = naji_list.begin()->node_id;
-      pjob->ji_wattr[JOB_ATR_login_node_key].at_flags = ATR_VFLAG_SET;
+      pjob->ji_wattr[JOB_ATR_login_node_key].at_flags = ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
       }
     }
 
@@ -5455,7 +5864,10 @@ int node_reserve(
 
 
       if (pnode->nd_np_to_be_used == pnode->nd_slots.get_total_execution_slots())
+        {
         pnode->nd_state |= INUSE_RESERVE;
+        pnode->nd_status_gen = status_gen.next();
+        }
       } /* END for each node */
     }
   else
@@ -5556,6 +5968,7 @@ int remove_job_from_nodes_gpus(
                (gn.job_count == 0)))
             {
             gn.state = gpu_unallocated;
+            pnode->nd_gpus_generation++;
             
             if (LOGLEVEL >= 7)
               {
@@ -5617,6 +6030,7 @@ int remove_job_from_node(
         }
 
       pnode->nd_state &= ~INUSE_JOB;
+      pnode->nd_status_gen = status_gen.next();
 
       i--; /* the array has shrunk by 1 so we need to reduce i by one */
       }
@@ -5725,14 +6139,14 @@ void free_nodes(
     {
     free(pjob->ji_wattr[JOB_ATR_cpuset_string].at_val.at_str);
     pjob->ji_wattr[JOB_ATR_cpuset_string].at_val.at_str = NULL;
-    pjob->ji_wattr[JOB_ATR_cpuset_string].at_flags &= ~ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_cpuset_string].at_flags = (pjob->ji_wattr[JOB_ATR_cpuset_string].at_flags & ~ATR_VFLAG_SET) | ATR_VFLAG_MODIFY;
     }
 
   if (pjob->ji_wattr[JOB_ATR_memset_string].at_val.at_str != NULL)
     {
     free(pjob->ji_wattr[JOB_ATR_memset_string].at_val.at_str);
     pjob->ji_wattr[JOB_ATR_memset_string].at_val.at_str = NULL;
-    pjob->ji_wattr[JOB_ATR_memset_string].at_flags &= ~ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_memset_string].at_flags = (pjob->ji_wattr[JOB_ATR_memset_string].at_flags & ~ATR_VFLAG_SET) | ATR_VFLAG_MODIFY;
     }
 #endif
 
@@ -5842,11 +6256,8 @@ int set_one_old(
         while (last >= jui.est.get_total_execution_slots())
           jui.est.add_execution_slot();
 
-        for (int index = first; index <= last; index++)
-          {
-          jui.est.mark_as_used(index);
-          pnode->nd_slots.mark_as_used(index);
-          }
+        jui.est.mark_range_as_used(first, last - first + 1);
+        pnode->nd_slots.mark_range_as_used(first, last - first + 1);
         }
       }
 
@@ -5857,17 +6268,17 @@ int set_one_old(
       while (last >= jui.est.get_total_execution_slots())
         jui.est.add_execution_slot();
 
-      for (int index = first; index <= last; index++)
-        {
-        jui.est.mark_as_used(index);
-        pnode->nd_slots.mark_as_used(index);
-        }
+      jui.est.mark_range_as_used(first, last - first + 1);
+      pnode->nd_slots.mark_range_as_used(first, last - first + 1);
 
       pnode->nd_job_usages.push_back(jui);
       }
 
     if (pnode->nd_slots.get_number_free() <= 0)
+      {
       pnode->nd_state |= INUSE_JOB;
+      pnode->nd_status_gen = status_gen.next();
+      }
 
     pnode->unlock_node(__func__, NULL, LOGLEVEL);
     }
@@ -5978,6 +6389,7 @@ void remove_temporary_hold_on_node(
       pnode->get_name());
     log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_NODE, __func__, log_buf);
     pnode->remove_node_state_flag(INUSE_NETWORK_FAIL);
+    pnode->nd_status_gen = status_gen.next();
 
     pnode->unlock_node(__func__, NULL, LOGLEVEL);
     }
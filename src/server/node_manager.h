@@ -29,6 +29,10 @@ void check_nodes(struct work_task *ptask);
 
 int svr_is_request(struct tcp_chan *chan, int version, long *args);
 
+int save_node_state();
+
+int write_node_snapshot();
+
 void *write_node_state_work(void *vp);
 
 void write_node_state(void);
@@ -39,6 +43,10 @@ void write_node_power_state(void);
 
 int write_node_note(void);
 
+void flush_node_changes(struct work_task *ptask);
+
+void write_node_changes(int need_todo);
+
 void *node_unreserve_work(void *vp);
 
 void node_unreserve(resource_t handle);
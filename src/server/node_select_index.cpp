@@ -0,0 +1,786 @@
+/*
+ * node_select_index.cpp - the node index used to pick nodes for a job
+ *
+ * select_from_all_nodes() used to lock every node in the cluster to find the
+ * ones a job could use. Each node now updates its entry here whenever it's
+ * unlocked (see update_node_index()), and a request only locks the nodes
+ * whose property set matches and whose free execution slots, gpus and mics
+ * are enough.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdlib.h>
+#include <algorithm>
+
+#include "node_select_index.hpp"
+#include "runjob_help.hpp"
+#include "threadpool.h"
+#include "pbs_error.h"
+
+node_select_index node_index;
+
+
+
+/*
+ * same_as()
+ *
+ * @return true if a summary computed from this would be the same as one
+ *         computed from other
+ */
+
+bool node_index_inputs::same_as(
+
+  const node_index_inputs &other) const
+
+  {
+  return((this->state == other.state) &&
+         (this->power_state == other.power_state) &&
+         (this->has_subnodes == other.has_subnodes) &&
+         (this->slots_total == other.slots_total) &&
+         (this->slots_free == other.slots_free) &&
+         (this->np_to_be_used == other.np_to_be_used) &&
+         (this->gpus_real == other.gpus_real) &&
+         (this->ngpus == other.ngpus) &&
+         (this->ngpus_free == other.ngpus_free) &&
+         (this->ngpus_to_be_used == other.ngpus_to_be_used) &&
+         (this->gpus_generation == other.gpus_generation) &&
+         (this->nmics == other.nmics) &&
+         (this->nmics_free == other.nmics_free) &&
+         (this->nmics_to_be_used == other.nmics_to_be_used) &&
+         (this->props_generation == other.props_generation));
+  } /* END same_as() */
+
+
+
+/*
+ * same_as()
+ *
+ * @return true if the index doesn't need to hear about the difference between
+ *         this and other
+ */
+
+bool node_index_summary::same_as(
+
+  const node_index_summary &other) const
+
+  {
+  return((this->valid == other.valid) &&
+         (this->indexable == other.indexable) &&
+         (this->available == other.available) &&
+         (this->all_slots_free == other.all_slots_free) &&
+         (this->total_slots == other.total_slots) &&
+         (this->free_slots == other.free_slots) &&
+         (this->gpus_total == other.gpus_total) &&
+         (this->gpus_free == other.gpus_free) &&
+         (this->mics_total == other.mics_total) &&
+         (this->mics_free == other.mics_free) &&
+         (this->props_generation == other.props_generation));
+  } /* END same_as() */
+
+
+
+/*
+ * is_eligible()
+ *
+ * @return true if the node is big enough for the request, whether or not it
+ *         has room for it right now
+ */
+
+bool node_index_summary::is_eligible(
+
+  int ppn,
+  int gpus,
+  int mics) const
+
+  {
+  return((this->total_slots >= ppn) &&
+         (this->gpus_total >= gpus) &&
+         (this->mics_total >= mics));
+  } /* END is_eligible() */
+
+
+
+/*
+ * can_run()
+ *
+ * @return true if the node may have room for the request right now
+ */
+
+bool node_index_summary::can_run(
+
+  int  ppn,
+  int  gpus,
+  int  mics,
+  bool exclusive) const
+
+  {
+  if ((this->available == false) ||
+      (this->is_eligible(ppn, gpus, mics) == false))
+    return(false);
+
+  if ((this->free_slots < ppn) ||
+      (this->gpus_free < gpus) ||
+      (this->mics_free < mics))
+    return(false);
+
+  if ((exclusive == true) &&
+      (this->all_slots_free == false))
+    return(false);
+
+  return(true);
+  } /* END can_run() */
+
+
+
+node_select_index::node_select_index() : nsi_nodes(), nsi_names(), nsi_ordered(), nsi_groups(),
+                                         nsi_group_ids(), nsi_next_seq(0), nsi_unindexable(0)
+
+  {
+  pthread_mutex_init(&this->nsi_mutex, NULL);
+  }
+
+
+
+node_select_index::~node_select_index()
+
+  {
+  pthread_mutex_destroy(&this->nsi_mutex);
+  }
+
+
+
+bool node_select_index::seq_less(
+
+  const indexed_node *a,
+  const indexed_node *b)
+
+  {
+  return(a->seq < b->seq);
+  }
+
+
+
+/*
+ * get_group()
+ *
+ * @return the index of the group for this property set, creating it if needed
+ */
+
+int node_select_index::get_group(
+
+  const std::vector<std::string> &properties)
+
+  {
+  std::map<std::vector<std::string>, int>::iterator it = this->nsi_group_ids.find(properties);
+
+  if (it != this->nsi_group_ids.end())
+    return(it->second);
+
+  property_group pg;
+
+  pg.properties = properties;
+  this->nsi_groups.push_back(pg);
+  this->nsi_group_ids[properties] = this->nsi_groups.size() - 1;
+
+  return(this->nsi_groups.size() - 1);
+  } /* END get_group() */
+
+
+
+void node_select_index::unlink_node(
+
+  int           id,
+  indexed_node &in)
+
+  {
+  property_group &pg = this->nsi_groups[in.group];
+
+  pg.members.erase(id);
+
+  if (in.summary.available == true)
+    {
+    std::map<int, std::set<int> >::iterator it = pg.by_free_slots.find(in.summary.free_slots);
+
+    if (it != pg.by_free_slots.end())
+      {
+      it->second.erase(id);
+
+      if (it->second.size() == 0)
+        pg.by_free_slots.erase(it);
+      }
+    }
+
+  if (in.summary.indexable == false)
+    this->nsi_unindexable--;
+  } /* END unlink_node() */
+
+
+
+void node_select_index::link_node(
+
+  int           id,
+  indexed_node &in)
+
+  {
+  property_group &pg = this->nsi_groups[in.group];
+
+  pg.members.insert(id);
+
+  if (in.summary.available == true)
+    pg.by_free_slots[in.summary.free_slots].insert(id);
+
+  if (in.summary.indexable == false)
+    this->nsi_unindexable++;
+  } /* END link_node() */
+
+
+
+/*
+ * update_node()
+ *
+ * Records a node's current summary.
+ *
+ * @param id - the node's id
+ * @param name - the node's name
+ * @param properties - the node's properties. Only read when the summary's
+ *                     props_generation differs from the one last recorded.
+ * @param summary - the node's summary
+ */
+
+void node_select_index::update_node(
+
+  int                             id,
+  const char                     *name,
+  const std::vector<std::string> &properties,
+  const node_index_summary       &summary)
+
+  {
+  pthread_mutex_lock(&this->nsi_mutex);
+
+  std::map<int, indexed_node>::iterator it = this->nsi_nodes.find(id);
+  bool                                  new_props = true;
+
+  if (it == this->nsi_nodes.end())
+    {
+    indexed_node in;
+
+    in.seq = this->nsi_next_seq++;
+    in.id = id;
+    in.group = -1;
+    it = this->nsi_nodes.insert(std::pair<int, indexed_node>(id, in)).first;
+    this->nsi_ordered.push_back(&it->second);
+    }
+  else
+    {
+    new_props = (it->second.summary.props_generation != summary.props_generation) ||
+                (it->second.name != name);
+
+    this->unlink_node(id, it->second);
+    }
+
+  indexed_node &in = it->second;
+
+  if (in.name != name)
+    {
+    if (in.name.size() != 0)
+      this->nsi_names.erase(in.name);
+
+    in.name = name;
+    this->nsi_names[in.name] = id;
+    }
+
+  if (new_props == true)
+    {
+    std::vector<std::string> group_props;
+
+    /* every node has its own name as a property, leave it out so nodes with
+     * the same properties share a group */
+    for (size_t i = 0; i < properties.size(); i++)
+      {
+      if (properties[i] != in.name)
+        group_props.push_back(properties[i]);
+      }
+
+    std::sort(group_props.begin(), group_props.end());
+    group_props.erase(std::unique(group_props.begin(), group_props.end()), group_props.end());
+
+    in.group = this->get_group(group_props);
+    }
+
+  in.summary = summary;
+  this->link_node(id, in);
+
+  pthread_mutex_unlock(&this->nsi_mutex);
+  } /* END update_node() */
+
+
+
+void node_select_index::remove_node(
+
+  int id)
+
+  {
+  pthread_mutex_lock(&this->nsi_mutex);
+
+  std::map<int, indexed_node>::iterator it = this->nsi_nodes.find(id);
+
+  if (it != this->nsi_nodes.end())
+    {
+    this->unlink_node(id, it->second);
+
+    std::map<std::string, int>::iterator name_it = this->nsi_names.find(it->second.name);
+
+    if ((name_it != this->nsi_names.end()) &&
+        (name_it->second == id))
+      this->nsi_names.erase(name_it);
+
+    std::vector<indexed_node *>::iterator ordered_it;
+
+    ordered_it = std::lower_bound(this->nsi_ordered.begin(), this->nsi_ordered.end(), &it->second, seq_less);
+
+    if ((ordered_it != this->nsi_ordered.end()) &&
+        (*ordered_it == &it->second))
+      this->nsi_ordered.erase(ordered_it);
+
+    this->nsi_nodes.erase(it);
+    }
+
+  pthread_mutex_unlock(&this->nsi_mutex);
+  } /* END remove_node() */
+
+
+
+/*
+ * is_usable()
+ *
+ * @return true if every node can be found through the index. Nodes with numa
+ * or alps subnodes are selected subnode by subnode, which the index doesn't
+ * track, so their presence means scanning all nodes.
+ */
+
+bool node_select_index::is_usable()
+
+  {
+  bool usable;
+
+  pthread_mutex_lock(&this->nsi_mutex);
+  usable = (this->nsi_nodes.size() != 0) &&
+           (this->nsi_unindexable == 0);
+  pthread_mutex_unlock(&this->nsi_mutex);
+
+  return(usable);
+  } /* END is_usable() */
+
+
+
+int node_select_index::size()
+
+  {
+  int count;
+
+  pthread_mutex_lock(&this->nsi_mutex);
+  count = this->nsi_nodes.size();
+  pthread_mutex_unlock(&this->nsi_mutex);
+
+  return(count);
+  } /* END size() */
+
+
+
+/*
+ * matching_nodes()
+ *
+ * Checks a group against the properties a request needs. A property the
+ * group doesn't have can still be the name of one of its nodes.
+ *
+ * @param pg - the group to check
+ * @param plist - the requested properties
+ * @param only_id - set to the one node in the group that matches, or -1 if
+ *                  every node in the group matches
+ * @return false if no node in the group matches
+ */
+
+bool node_select_index::matching_nodes(
+
+  const property_group    &pg,
+  const std::vector<prop> &plist,
+  int                     &only_id)
+
+  {
+  const std::string *name = NULL;
+
+  only_id = -1;
+
+  for (size_t i = 0; i < plist.size(); i++)
+    {
+    if (plist[i].mark == 0)
+      continue;
+
+    if (std::binary_search(pg.properties.begin(), pg.properties.end(), plist[i].name))
+      continue;
+
+    if ((name != NULL) &&
+        (*name != plist[i].name))
+      return(false);
+
+    name = &plist[i].name;
+    }
+
+  if (name != NULL)
+    {
+    std::map<std::string, int>::const_iterator it = this->nsi_names.find(*name);
+
+    if ((it == this->nsi_names.end()) ||
+        (pg.members.find(it->second) == pg.members.end()))
+      return(false);
+
+    only_id = it->second;
+    }
+
+  return(true);
+  } /* END matching_nodes() */
+
+
+
+/*
+ * find_candidates()
+ *
+ * Adds the nodes that may be able to run this request right now to
+ * candidates, keyed so they come out in the order they were indexed.
+ */
+
+void node_select_index::find_candidates(
+
+  const std::vector<prop>              &plist,
+  int                                   ppn,
+  int                                   gpus,
+  int                                   mics,
+  bool                                  exclusive,
+  std::map<unsigned long, std::string> &candidates)
+
+  {
+  int only_id;
+
+  pthread_mutex_lock(&this->nsi_mutex);
+
+  for (size_t g = 0; g < this->nsi_groups.size(); g++)
+    {
+    property_group &pg = this->nsi_groups[g];
+
+    if (this->matching_nodes(pg, plist, only_id) == false)
+      continue;
+
+    if (only_id != -1)
+      {
+      indexed_node &in = this->nsi_nodes[only_id];
+
+      if (in.summary.can_run(ppn, gpus, mics, exclusive) == true)
+        candidates[in.seq] = in.name;
+
+      continue;
+      }
+
+    for (std::map<int, std::set<int> >::iterator bucket = pg.by_free_slots.lower_bound(ppn);
+         bucket != pg.by_free_slots.end();
+         bucket++)
+      {
+      for (std::set<int>::iterator id = bucket->second.begin(); id != bucket->second.end(); id++)
+        {
+        indexed_node &in = this->nsi_nodes[*id];
+
+        if (in.summary.can_run(ppn, gpus, mics, exclusive) == true)
+          candidates[in.seq] = in.name;
+        }
+      }
+    }
+
+  pthread_mutex_unlock(&this->nsi_mutex);
+  } /* END find_candidates() */
+
+
+
+/*
+ * The state find_candidates_parallel() shares with the threads helping it.
+ * A thread that gets to it after every partition has been claimed only drops
+ * its reference, so the last one out frees it.
+ */
+
+class node_select_index::partitioned_scan
+  {
+  public:
+  std::vector<indexed_node>                     nodes;    /* copied from the index, by seq */
+  const std::vector<node_index_request>        *reqs;
+  bool                                          exclusive;
+  std::vector<std::vector<int> >                matches;  /* per request and group, see below */
+  std::vector<std::vector<indexed_node *> >     results;  /* the candidates in each partition */
+  int                                           next;     /* the next partition to claim */
+  int                                           active;   /* partitions claimed but not done */
+  int                                           refs;
+  pthread_mutex_t                               mutex;
+  pthread_cond_t                                done;
+  };
+
+/* the values in partitioned_scan::matches besides a node id */
+#define GROUP_MATCHES_ALL  -1
+#define GROUP_MATCHES_NONE -2
+
+
+
+/*
+ * scan_partitions()
+ *
+ * Claims partitions of the scan's copy of the index and checks their nodes
+ * until none are left. Nothing here touches the index itself, so nsi_mutex
+ * isn't held while the nodes are checked.
+ */
+
+void node_select_index::scan_partitions(
+
+  partitioned_scan *scan)
+
+  {
+  int parts = scan->results.size();
+  int part;
+
+  while (1)
+    {
+    pthread_mutex_lock(&scan->mutex);
+
+    if (scan->next >= parts)
+      {
+      pthread_mutex_unlock(&scan->mutex);
+      break;
+      }
+
+    part = scan->next++;
+    scan->active++;
+    pthread_mutex_unlock(&scan->mutex);
+
+    size_t                       first = scan->nodes.size() * part / parts;
+    size_t                       last = scan->nodes.size() * (part + 1) / parts;
+    std::vector<indexed_node *> &found = scan->results[part];
+
+    for (size_t i = first; i < last; i++)
+      {
+      indexed_node *in = &scan->nodes[i];
+
+      for (size_t r = 0; r < scan->reqs->size(); r++)
+        {
+        const node_index_request &req = scan->reqs->at(r);
+        int                       match = scan->matches[r][in->group];
+
+        if ((match == GROUP_MATCHES_NONE) ||
+            ((match != GROUP_MATCHES_ALL) &&
+             (match != in->id)))
+          continue;
+
+        if (in->summary.can_run(req.ppn, req.gpus, req.mics, scan->exclusive) == true)
+          {
+          found.push_back(in);
+          break;
+          }
+        }
+      }
+
+    pthread_mutex_lock(&scan->mutex);
+    scan->active--;
+    pthread_cond_signal(&scan->done);
+    pthread_mutex_unlock(&scan->mutex);
+    }
+  } /* END scan_partitions() */
+
+
+
+void node_select_index::release_scan(
+
+  partitioned_scan *scan)
+
+  {
+  bool last;
+
+  pthread_mutex_lock(&scan->mutex);
+  last = (--scan->refs == 0);
+  pthread_mutex_unlock(&scan->mutex);
+
+  if (last == true)
+    {
+    pthread_mutex_destroy(&scan->mutex);
+    pthread_cond_destroy(&scan->done);
+    delete scan;
+    }
+  } /* END release_scan() */
+
+
+
+void *node_select_index::scan_partitions_task(
+
+  void *vp)
+
+  {
+  partitioned_scan *scan = (partitioned_scan *)vp;
+
+  scan_partitions(scan);
+  release_scan(scan);
+
+  return(NULL);
+  } /* END scan_partitions_task() */
+
+
+
+/*
+ * find_candidates_parallel()
+ *
+ * Finds the same candidates as calling find_candidates() for each request,
+ * but checks every node against all of the requests in one pass, split into
+ * partitions that threads from the task pool check alongside this one. Only
+ * copying the nodes out of the index is done under nsi_mutex, so updates to
+ * the index aren't held up by the scan. Each partition's candidates are
+ * already in seq order, so they're appended in partition order.
+ *
+ * @param reqs - the job's requests
+ * @param exclusive - the job needs whole nodes
+ * @param threads - the most threads to check nodes with, this one included
+ * @param candidates - the nodes that may be able to run one of the requests
+ */
+
+void node_select_index::find_candidates_parallel(
+
+  const std::vector<node_index_request> &reqs,
+  bool                                   exclusive,
+  int                                    threads,
+  std::map<unsigned long, std::string>  &candidates)
+
+  {
+  partitioned_scan *scan = new partitioned_scan();
+  int               parts;
+  int               only_id;
+
+  pthread_mutex_lock(&this->nsi_mutex);
+
+  parts = this->nsi_ordered.size() / NODE_SELECT_MIN_PARTITION;
+
+  if (parts > threads)
+    parts = threads;
+
+  if (parts < 1)
+    parts = 1;
+
+  scan->nodes.reserve(this->nsi_ordered.size());
+
+  for (size_t i = 0; i < this->nsi_ordered.size(); i++)
+    scan->nodes.push_back(*this->nsi_ordered[i]);
+
+  scan->reqs = &reqs;
+  scan->exclusive = exclusive;
+  scan->results.resize(parts);
+  scan->next = 0;
+  scan->active = 0;
+  scan->refs = 1;
+  pthread_mutex_init(&scan->mutex, NULL);
+  pthread_cond_init(&scan->done, NULL);
+
+  /* which nodes of each group a request can use doesn't depend on the node */
+  scan->matches.resize(reqs.size());
+
+  for (size_t r = 0; r < reqs.size(); r++)
+    {
+    scan->matches[r].resize(this->nsi_groups.size());
+
+    for (size_t g = 0; g < this->nsi_groups.size(); g++)
+      {
+      if (this->matching_nodes(this->nsi_groups[g], *reqs[r].plist, only_id) == false)
+        scan->matches[r][g] = GROUP_MATCHES_NONE;
+      else if (only_id == -1)
+        scan->matches[r][g] = GROUP_MATCHES_ALL;
+      else
+        scan->matches[r][g] = only_id;
+      }
+    }
+
+  pthread_mutex_unlock(&this->nsi_mutex);
+
+  for (int i = 1; i < parts; i++)
+    {
+    pthread_mutex_lock(&scan->mutex);
+    scan->refs++;
+    pthread_mutex_unlock(&scan->mutex);
+
+    if (enqueue_threadpool_request(scan_partitions_task, scan, task_pool) != PBSE_NONE)
+      {
+      pthread_mutex_lock(&scan->mutex);
+      scan->refs--;
+      pthread_mutex_unlock(&scan->mutex);
+      break;
+      }
+    }
+
+  /* this thread scans too, so a busy pool only means fewer helpers */
+  scan_partitions(scan);
+
+  pthread_mutex_lock(&scan->mutex);
+
+  while (scan->active > 0)
+    pthread_cond_wait(&scan->done, &scan->mutex);
+
+  pthread_mutex_unlock(&scan->mutex);
+
+  for (int p = 0; p < parts; p++)
+    {
+    std::vector<indexed_node *> &found = scan->results[p];
+
+    for (size_t i = 0; i < found.size(); i++)
+      candidates.insert(candidates.end(), std::pair<unsigned long, std::string>(found[i]->seq, found[i]->name));
+    }
+
+  release_scan(scan);
+  } /* END find_candidates_parallel() */
+
+
+
+/*
+ * count_eligible()
+ *
+ * @return the number of nodes that match the request's properties and are
+ *         big enough for it, busy or not, leaving out the nodes in skip
+ */
+
+int node_select_index::count_eligible(
+
+  const std::vector<prop>     &plist,
+  int                          ppn,
+  int                          gpus,
+  int                          mics,
+  const std::set<std::string> &skip)
+
+  {
+  int count = 0;
+  int only_id;
+
+  pthread_mutex_lock(&this->nsi_mutex);
+
+  for (size_t g = 0; g < this->nsi_groups.size(); g++)
+    {
+    property_group &pg = this->nsi_groups[g];
+
+    if (this->matching_nodes(pg, plist, only_id) == false)
+      continue;
+
+    for (std::set<int>::iterator id = pg.members.begin(); id != pg.members.end(); id++)
+      {
+      if ((only_id != -1) &&
+          (*id != only_id))
+        continue;
+
+      indexed_node &in = this->nsi_nodes[*id];
+
+      if ((in.summary.is_eligible(ppn, gpus, mics) == true) &&
+          (skip.find(in.name) == skip.end()))
+        count++;
+      }
+    }
+
+  pthread_mutex_unlock(&this->nsi_mutex);
+
+  return(count);
+  } /* END count_eligible() */
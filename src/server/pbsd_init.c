@@ -134,9 +134,13 @@
 #include "alps_constants.h"
 #include <string>
 #include <vector>
+#include <algorithm>
 #include "id_map.hpp"
 #include "exiting_jobs.h"
 #include "mom_hierarchy_handler.h"
+#include "job_journal.hpp"
+#include "node_change_log.hpp"
+#include "job_recov.h" /* write_journal_entry */
 
 
 /*#ifndef SIGKILL*/
@@ -197,6 +201,7 @@ extern char *path_nodestate;
 extern char *path_nodepowerstate;
 extern char *path_nodenote;
 extern char *path_nodenote_new;
+extern char *path_nodechanges;
 extern char *path_checkpoint;
 extern char *path_jobinfo_log;
 extern char *path_pbs_environment;
@@ -229,6 +234,7 @@ extern pthread_mutex_t         *check_tasks_mutex;
 extern pthread_mutex_t         *reroute_job_mutex;
 //extern mom_hierarchy_t         *mh;
 id_map                          node_mapper;
+id_map                          property_mapper;
 
 extern int a_opt_init;
 extern int paused;
@@ -271,13 +277,19 @@ void  resume_net_move(struct work_task *);
 void  rm_files(char *);
 void  stop_me(int);
 void  change_logs_handler(int sig);
-int   process_jobs_dirent(const char *);
+void  add_job_file(const char *, const char *, std::vector<std::string> &);
+void  read_job_files(std::vector<std::string> &, std::vector<job *> &);
+int   link_recovered_job(const char *, job *);
 int   process_arrays_dirent(const char *, int);
 long  jobid_to_long(std::string);
 bool  is_array_job(std::string);
 
 bool  cray_enabled = false;
 bool  ghost_array_recovery = true;
+bool  job_journal_enabled = false;
+long  job_writer_threads = 0;
+bool  job_binary_records = false;
+long  node_select_threads = 0;
 
 /* private data */
 
@@ -320,6 +332,30 @@ struct sort_string_by_number
 std::map<std::string, job *, sort_string_by_number> JobArray;
 int recovered_job_count; /* Count of recovered jobs */
 
+/* how many job files a recovery thread claims at once */
+#define JOB_READ_CHUNK_SIZE 32
+
+/* shared by the threads reading job files at startup */
+typedef struct job_file_reader
+  {
+  std::vector<std::string> *jfr_files;
+  std::vector<job *>       *jfr_jobs;    /* the job read from each file */
+  size_t                    jfr_next;    /* next file to hand out */
+  int                       jfr_running; /* readers that haven't finished */
+  pthread_mutex_t           jfr_mutex;
+  pthread_cond_t            jfr_done;
+  } job_file_reader;
+
+/* orders recovered jobs by queue rank */
+bool job_rank_less(
+
+  job *a,
+  job *b)
+
+  {
+  return(a->ji_wattr[JOB_ATR_qrank].at_val.at_long < b->ji_wattr[JOB_ATR_qrank].at_val.at_long);
+  }
+
 #define CHANGE_STATE 1
 #define KEEP_STATE   0
 
@@ -826,6 +862,7 @@ int initialize_paths()
   path_nodepowerstate = build_path(path_priv, NODE_POWER_STATE,  NULL);
   path_nodenote      = build_path(path_priv, NODE_NOTE,    NULL);
   path_nodenote_new  = build_path(path_priv, NODE_NOTE, new_tag);
+  path_nodechanges   = build_path(path_priv, NODE_CHANGES, NULL);
   path_mom_hierarchy = build_path(path_priv, PBS_MOM_HIERARCHY, NULL);
 
 #ifdef SERVER_CHKPTDIR
@@ -1325,17 +1362,19 @@ int load_node_usages()
       continue;
       }
 
-    try
+    if ((pnode = find_nodebyname(pdirent->d_name)) != NULL)
       {
-      if ((pnode = find_nodebyname(pdirent->d_name)) != NULL)
+      try
         {
-        mutex_mgr nd_mutex(&pnode->nd_mutex, true);
         load_node_usage(pnode, pdirent->d_name);
         }
-      }
-    catch (int caught_err)
-      {
-      log_err(caught_err, __func__, "");
+      catch (int caught_err)
+        {
+        log_err(caught_err, __func__, "");
+        }
+
+      /* unlock_node() lets node_index see the loaded usage */
+      pnode->unlock_node(__func__, NULL, LOGLEVEL);
       }
     }
 
@@ -1666,6 +1705,11 @@ int handle_job_recovery(
   time_t            time_now = time(NULL);
   char              basen[MAXPATHLEN+1];
   bool              use_jobs_subdirs = false;
+  std::vector<std::string> job_files;
+  std::vector<job *>       recovered_jobs;
+  struct timeval    start_time;
+  struct timeval    end_time;
+  double            elapsed;
 
   JobArray.clear();
   recovered_job_count = 0;
@@ -1755,7 +1799,7 @@ int handle_job_recovery(
           {
           while ((pdirent_sub = readdir(dir_sub)) != NULL)
             {
-            process_jobs_dirent(pdirent_sub->d_name);
+            add_job_file(pdirent->d_name, pdirent_sub->d_name, job_files);
             }
 
           closedir(dir_sub);
@@ -1776,20 +1820,45 @@ int handle_job_recovery(
         }
       else
         {
-        process_jobs_dirent(pdirent->d_name);
+        add_job_file(NULL, pdirent->d_name, job_files);
         }
       }
 
-    snprintf(log_buf, LOCAL_LOG_BUF_SIZE, "%d total files read from disk", recovered_job_count);
-    log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, msg_daemonname, log_buf);
     closedir(dir);
 
-    int Index = 0;
+    /* parse the job files in parallel, then link them in one thread */
+    gettimeofday(&start_time, NULL);
+
+    read_job_files(job_files, recovered_jobs);
+
+    for (size_t i = 0; i < job_files.size(); i++)
+      link_recovered_job(job_files[i].c_str(), recovered_jobs[i]);
+
+    gettimeofday(&end_time, NULL);
+    elapsed = (end_time.tv_sec - start_time.tv_sec) +
+              (end_time.tv_usec - start_time.tv_usec) / 1000000.0;
+
+    snprintf(log_buf, LOCAL_LOG_BUF_SIZE,
+      "%d total files read from disk, %d job files recovered in %.2f seconds (%.0f files/sec)",
+      recovered_job_count, (int)job_files.size(), elapsed,
+      (elapsed > 0) ? job_files.size() / elapsed : (double)job_files.size());
+    log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, msg_daemonname, log_buf);
+
+    /* queue the jobs in rank order so each one is appended to its queue */
+    std::vector<job *>                     by_rank;
     std::map<std::string, job *>::iterator JobArray_iter;
-    /*for (Index = 0; Index < JobArray.AppendIndex; Index++)*/
+
+    by_rank.reserve(JobArray.size());
+
     for (JobArray_iter = JobArray.begin(); JobArray_iter != JobArray.end(); JobArray_iter++)
+      by_rank.push_back(JobArray_iter->second);
+
+    std::stable_sort(by_rank.begin(), by_rank.end(), job_rank_less);
+
+    int Index = 0;
+    for (size_t i = 0; i < by_rank.size(); i++)
       {
-      job *pjob = JobArray_iter->second;
+      job *pjob = by_rank[i];
 
       lock_ji_mutex(pjob, __func__, NULL, LOGLEVEL);
 
@@ -1899,24 +1968,26 @@ int handle_job_recovery(
   return(rc);
   } /* END handle_job_recovery() */
 
-/**
- * Process a jobs directory entry
+/*
+ * add_job_file()
+ *
+ * Adds a job or array template file found in path_jobs to the list of
+ * files to recover.
+ *
+ * @param subdir - the jobs subdirectory the file is in, or NULL
  * @param dirent_name - name of the entry
+ * @param job_files - the list of files to recover
  */
 
-int process_jobs_dirent(
+void add_job_file(
 
-  const char *dirent_name)
+  const char               *subdir,
+  const char               *dirent_name,
+  std::vector<std::string> &job_files)
 
   {
-  char              log_buf[LOCAL_LOG_BUF_SIZE];
-  int               rc = PBSE_NONE;
-  int               baselen = 0;
-  job              *pjob;
-  char             *psuffix;
-  const char       *job_suffix = JOB_FILE_SUFFIX;
-  int               job_suf_len = strlen(job_suffix);
-  char              basen[MAXPATHLEN+1];
+  char   log_buf[LOCAL_LOG_BUF_SIZE];
+  size_t len = strlen(dirent_name);
 
   recovered_job_count++;
   if ((recovered_job_count % 1000) == 0)
@@ -1925,58 +1996,327 @@ int process_jobs_dirent(
     log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, msg_daemonname, log_buf);
     }
 
-  if (chk_save_file(dirent_name) == 0)
+  if ((*dirent_name == '.') ||
+      (len <= strlen(JOB_FILE_SUFFIX)) ||
+      ((strcmp(dirent_name + len - strlen(JOB_FILE_SUFFIX), JOB_FILE_SUFFIX)) &&
+       (strcmp(dirent_name + len - strlen(JOB_FILE_TMP_SUFFIX), JOB_FILE_TMP_SUFFIX))))
+    return;
+
+  if (subdir != NULL)
+    {
+    std::string path(subdir);
+
+    path += "/";
+    path += dirent_name;
+    job_files.push_back(path);
+    }
+  else
+    job_files.push_back(dirent_name);
+  } /* END add_job_file() */
+
+
+
+/*
+ * read_job_files_task()
+ *
+ * Reads job files until there are none left. Run by the main thread and by
+ * threadpool threads at the same time.
+ *
+ * @param vp - the job_file_reader shared by all of the readers
+ */
+
+void *read_job_files_task(
+
+  void *vp)
+
+  {
+  job_file_reader *jfr = (job_file_reader *)vp;
+  size_t           first;
+  size_t           last;
+
+  while (1)
     {
-    /* recover the jobs */
-    baselen = strlen(dirent_name) - job_suf_len;
+    pthread_mutex_lock(&jfr->jfr_mutex);
+    first = jfr->jfr_next;
+    last = MIN(first + JOB_READ_CHUNK_SIZE, jfr->jfr_files->size());
+    jfr->jfr_next = last;
+    pthread_mutex_unlock(&jfr->jfr_mutex);
+
+    if (first >= last)
+      break;
 
-    psuffix = (char *)dirent_name + baselen;
-    if (!strcmp(psuffix, JOB_FILE_TMP_SUFFIX))
+    for (size_t i = first; i < last; i++)
       {
-      if ((pjob = job_recov(dirent_name)) != NULL)
+      const char *filename = jfr->jfr_files->at(i).c_str();
+      job        *pjob;
+
+      if (chk_save_file(filename) != 0)
+        continue;
+
+      if ((pjob = job_recov_read(filename)) != NULL)
         {
-        pjob->ji_is_array_template = true;
+        /* the linking thread locks it again */
+        unlock_ji_mutex(pjob, __func__, NULL, LOGLEVEL);
+        }
 
+      jfr->jfr_jobs->at(i) = pjob;
+      }
+    }
 
-        JobArray[pjob->ji_qs.ji_jobid] = pjob;
+  pthread_mutex_lock(&jfr->jfr_mutex);
+  jfr->jfr_running--;
+  pthread_cond_signal(&jfr->jfr_done);
+  pthread_mutex_unlock(&jfr->jfr_mutex);
 
-        unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
-        }
+  return(NULL);
+  } /* END read_job_files_task() */
 
-      return(rc);
+
+
+/*
+ * read_job_files()
+ *
+ * Parses the job files with the task threadpool's help. Parsing the xml is
+ * most of the cost of recovering a job and each file is independent, so the
+ * files are shared out in chunks. Everything that touches other jobs or the
+ * arrays is left to link_recovered_job().
+ *
+ * @param job_files - the files to read
+ * @param jobs - set to the job read from each file, or NULL if it couldn't be
+ */
+
+void read_job_files(
+
+  std::vector<std::string> &job_files,
+  std::vector<job *>       &jobs)
+
+  {
+  job_file_reader jfr;
+  long            helpers = sysconf(_SC_NPROCESSORS_ONLN) - 1;
+  long            chunks = (job_files.size() + JOB_READ_CHUNK_SIZE - 1) / JOB_READ_CHUNK_SIZE;
+
+  jobs.assign(job_files.size(), NULL);
+
+  jfr.jfr_files = &job_files;
+  jfr.jfr_jobs = &jobs;
+  jfr.jfr_next = 0;
+  jfr.jfr_running = 1;
+  pthread_mutex_init(&jfr.jfr_mutex, NULL);
+  pthread_cond_init(&jfr.jfr_done, NULL);
+
+  if (helpers > chunks - 1)
+    helpers = chunks - 1;
+
+  for (long i = 0; i < helpers; i++)
+    {
+    pthread_mutex_lock(&jfr.jfr_mutex);
+    jfr.jfr_running++;
+    pthread_mutex_unlock(&jfr.jfr_mutex);
+
+    if (enqueue_threadpool_request(read_job_files_task, &jfr, task_pool) != PBSE_NONE)
+      {
+      pthread_mutex_lock(&jfr.jfr_mutex);
+      jfr.jfr_running--;
+      pthread_mutex_unlock(&jfr.jfr_mutex);
+      break;
       }
+    }
 
-    if (strcmp(psuffix, job_suffix))
-      return(rc);
+  /* this thread reads too, so recovery finishes even if the pool is busy */
+  read_job_files_task(&jfr);
+
+  pthread_mutex_lock(&jfr.jfr_mutex);
+  while (jfr.jfr_running > 0)
+    pthread_cond_wait(&jfr.jfr_done, &jfr.jfr_mutex);
+  pthread_mutex_unlock(&jfr.jfr_mutex);
+
+  pthread_cond_destroy(&jfr.jfr_done);
+  pthread_mutex_destroy(&jfr.jfr_mutex);
+  } /* END read_job_files() */
+
+
+
+/*
+ * link_recovered_job()
+ *
+ * Finishes recovering a job read by read_job_files() and adds it to JobArray.
+ * A job file that couldn't be read is renamed to .BD.
+ *
+ * @param filename - the job's file, relative to path_jobs
+ * @param pjob - the job read from the file, or NULL
+ */
+
+int link_recovered_job(
+
+  const char *filename,
+  job        *pjob)
+
+  {
+  char              log_buf[LOCAL_LOG_BUF_SIZE];
+  int               rc = PBSE_NONE;
+  size_t            len = strlen(filename);
+  bool              is_template;
+  char              basen[MAXPATHLEN+1];
+
+  is_template = !strcmp(filename + len - strlen(JOB_FILE_TMP_SUFFIX), JOB_FILE_TMP_SUFFIX);
+
+  if (pjob != NULL)
+    {
+    lock_ji_mutex(pjob, __func__, NULL, LOGLEVEL);
 
-    if ((pjob = job_recov(dirent_name)) != NULL)
+    if (job_recov_link(&pjob) == PBSE_NONE)
       {
+      if (is_template)
+        pjob->ji_is_array_template = true;
+
       JobArray[pjob->ji_qs.ji_jobid] = pjob;
 
-      unlock_ji_mutex(pjob, __func__, "2", LOGLEVEL);
+      unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
+      return(rc);
+      }
+    }
+
+  if ((is_template == false) &&
+      (chk_save_file(filename) == 0))
+    {
+    sprintf(log_buf, msg_init_badjob, filename);
+
+    log_err(-1, __func__, log_buf);
+
+    /* remove corrupt job */
+    snprintf(basen, sizeof(basen), "%s%s", filename, JOB_BAD_SUFFIX);
+
+    if (link(filename, basen) < 0)
+      {
+      log_err(errno, __func__, "failed to link corrupt .JB file to .BD");
       }
     else
       {
-      sprintf(log_buf, msg_init_badjob, dirent_name);
+      unlink(filename);
+      }
+    }
 
-      log_err(-1, __func__, log_buf);
+  return(rc);
+  } /* END link_recovered_job() */
 
-      /* remove corrupt job */
-      snprintf(basen, sizeof(basen), "%s%s", dirent_name, JOB_BAD_SUFFIX);
 
-      if (link(dirent_name, basen) < 0)
+
+/*
+ * convert_job_files()
+ *
+ * Rewrites every job and array template file in path_jobs, and in the jobs
+ * subdirectories, as binary job records or as xml. pbs_server runs this for
+ * --convert-jobs while the server is down and then exits. Any job journal is
+ * replayed into the job files first. Files already in the requested format
+ * are rewritten unchanged.
+ *
+ * @param to_binary - true to write binary job records, false to write xml
+ * @return PBSE_NONE if every file was converted, -1 otherwise
+ */
+
+int convert_job_files(
+
+  bool to_binary)
+
+  {
+  std::vector<std::string>  job_files;
+  DIR                      *dir;
+  DIR                      *dir_sub;
+  struct dirent            *pdirent;
+  struct dirent            *pdirent_sub;
+  int                       converted = 0;
+  int                       failed = 0;
+
+  if (initialize_paths() != PBSE_NONE)
+    return(-1);
+
+  /* decoding Resource_List needs the resource definitions, and the server
+   * attributes are recovered now so they include extra_resc */
+  if (init_resc_defs() != PBSE_NONE)
+    {
+    fprintf(stderr, "cannot initialize the resource definitions\n");
+    return(-1);
+    }
+
+  /* saves still in the journal are newer than the job files */
+  if (handle_job_journal() != PBSE_NONE)
+    {
+    fprintf(stderr, "cannot replay the job journal, no jobs converted\n");
+    return(-1);
+    }
+
+  if ((chdir(path_jobs) != 0) ||
+      ((dir = opendir(".")) == NULL))
+    {
+    fprintf(stderr, "cannot read the jobs directory %s: %s\n", path_jobs, strerror(errno));
+    return(-1);
+    }
+
+  while ((pdirent = readdir(dir)) != NULL)
+    {
+    if ((strlen(pdirent->d_name) == 1) &&
+        (isdigit(pdirent->d_name[0])))
+      {
+      if ((dir_sub = opendir(pdirent->d_name)) != NULL)
         {
-        log_err(errno, __func__, "failed to link corrupt .JB file to .BD");
+        while ((pdirent_sub = readdir(dir_sub)) != NULL)
+          add_job_file(pdirent->d_name, pdirent_sub->d_name, job_files);
+
+        closedir(dir_sub);
         }
-      else
+      }
+    else
+      add_job_file(NULL, pdirent->d_name, job_files);
+    }
+
+  closedir(dir);
+
+  job_binary_records = to_binary;
+
+  for (size_t i = 0; i < job_files.size(); i++)
+    {
+    const char  *filename = job_files[i].c_str();
+    std::string  image;
+    job         *pjob;
+
+    if ((pjob = job_recov_read(filename)) == NULL)
+      {
+      fprintf(stderr, "cannot read %s, not converted\n", filename);
+      failed++;
+      continue;
+      }
+
+    /* the image includes any quick save record job_recov_read() applied */
+    if ((job_file_image(pjob, image) != PBSE_NONE) ||
+        (write_file_image(job_files[i], job_files[i] + JOB_FILE_COPY, image) != PBSE_NONE))
+      {
+      fprintf(stderr, "cannot write %s, not converted\n", filename);
+      failed++;
+      }
+    else
+      {
+      size_t len = job_files[i].size();
+
+      if (!strcmp(filename + len - strlen(JOB_FILE_SUFFIX), JOB_FILE_SUFFIX))
         {
-        unlink(dirent_name);
+        std::string quick_file(job_files[i], 0, len - strlen(JOB_FILE_SUFFIX));
+
+        quick_file += JOB_FILE_QUICK;
+        unlink(quick_file.c_str());
         }
+
+      converted++;
       }
+
+    unlock_ji_mutex(pjob, __func__, NULL, LOGLEVEL);
+    delete pjob;
     }
 
-  return(rc);
-  } /* END process_jobs_dirent() */
+  fprintf(stdout, "converted %d job files to %s, %d failed\n",
+    converted, (to_binary == true) ? "binary job records" : "xml", failed);
+
+  return((failed == 0) ? PBSE_NONE : -1);
+  } /* END convert_job_files() */
 
 
 int cleanup_recovered_arrays()
@@ -2081,6 +2421,48 @@ int cleanup_recovered_arrays()
 
 
 
+/*
+ * handle_job_journal()
+ *
+ * Replays any job journal left by a previous run into the job files so that
+ * they can be recovered normally, then opens the journal if it is enabled.
+ * Journals are replayed even if job_journal has since been turned off.
+ */
+
+int handle_job_journal()
+
+  {
+  std::string journal_path(path_priv);
+  std::string old_path;
+  int         rc = PBSE_NONE;
+
+  journal_path += JOB_JOURNAL;
+  old_path = journal_path + JOB_JOURNAL_OLD_SUFFIX;
+
+  /* the rotated journal is older, so it must be applied first */
+  if ((job_journal::replay(old_path.c_str(), write_journal_entry) != PBSE_NONE) ||
+      (job_journal::replay(journal_path.c_str(), write_journal_entry) != PBSE_NONE))
+    {
+    log_err(-1, __func__, "could not replay the job journal");
+    rc = -1;
+    }
+
+  if (job_journal_enabled == true)
+    {
+    if ((rc != PBSE_NONE) ||
+        (server_job_journal.open_journal(journal_path.c_str()) != PBSE_NONE))
+      {
+      /* keep the unreplayed journal intact and fall back to per-job files */
+      log_err(-1, __func__, "job journal disabled, saving jobs to individual files");
+      job_journal_enabled = false;
+      }
+    }
+
+  return(rc);
+  } /* END handle_job_journal() */
+
+
+
 /*
  * handle_job_and_array_recovery()
  *
@@ -2095,6 +2477,8 @@ int handle_job_and_array_recovery(
   int rc;
   int tmp_rc;
 
+  handle_job_journal();
+
   rc = handle_array_recovery(type);
   
   if ((tmp_rc = handle_job_recovery(type)) != PBSE_NONE)
@@ -2222,6 +2606,10 @@ void set_server_policies()
   {
   bool cray = false;
   bool recover_subjobs = false;
+  bool journal = false;
+  long writers = 0;
+  bool binary_records = false;
+  long selectors = 0;
 
   if (get_svr_attr_b(SRV_ATR_CrayEnabled, &cray) == PBSE_NONE)
     cray_enabled = cray;
@@ -2229,6 +2617,20 @@ void set_server_policies()
   if (get_svr_attr_b(SRV_ATR_GhostArrayRecovery, &recover_subjobs) == PBSE_NONE)
     ghost_array_recovery = recover_subjobs;
 
+  if (get_svr_attr_b(SRV_ATR_JobJournal, &journal) == PBSE_NONE)
+    job_journal_enabled = journal;
+
+  if ((get_svr_attr_l(SRV_ATR_JobWriterThreads, &writers) == PBSE_NONE) &&
+      (writers > 0))
+    job_writer_threads = writers;
+
+  if (get_svr_attr_b(SRV_ATR_JobBinaryRecords, &binary_records) == PBSE_NONE)
+    job_binary_records = binary_records;
+
+  if ((get_svr_attr_l(SRV_ATR_NodeSelectThreads, &selectors) == PBSE_NONE) &&
+      (selectors > 0))
+    node_select_threads = selectors;
+
   } // END set_server_policies()
 
 
@@ -2564,7 +2966,7 @@ int pbsd_init_job(
         {
         /* corrupt job file. job is in running state without exec_host list */
         pjob->ji_wattr[JOB_ATR_hold].at_val.at_long |= HOLD_s;
-        pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET;
+        pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
         pjob->ji_qs.ji_state = JOB_STATE_QUEUED;
         pjob->ji_qs.ji_substate = JOB_SUBSTATE_QUEUED;
 
@@ -2577,7 +2979,7 @@ int pbsd_init_job(
           {
           free(pjob->ji_wattr[JOB_ATR_Comment].at_val.at_str);
           pjob->ji_wattr[JOB_ATR_Comment].at_val.at_str = strdup(log_buf);
-          pjob->ji_wattr[JOB_ATR_Comment].at_flags |= ATR_VFLAG_SET;
+          pjob->ji_wattr[JOB_ATR_Comment].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
           }
 
         rc = pbsd_init_reque(pjob, CHANGE_STATE);
@@ -51,4 +51,8 @@ int pbsd_init(int type);
 
 int recov_svr_attr(int type);
 
+int handle_job_journal();
+
+int convert_job_files(bool to_binary);
+
 #endif /* _PBSD_INIT_H */
@@ -147,6 +147,11 @@
 #include "node_func.h"
 #include "mom_hierarchy_handler.h"
 #include "completed_jobs_map.h"
+#include "policy_values.h"
+#include "job_journal.hpp"
+#include "node_change_log.hpp"
+#include "job_writer.hpp"
+#include "job_recov.h" /* write_journal_entry */
 
 
 #define TASK_CHECK_INTERVAL      10
@@ -161,6 +166,7 @@
 extern char *msg_startup3;
 extern void job_log_roll(int max_depth);
 extern int  pbsd_init(int);
+extern int  convert_job_files(bool);
 extern void shutdown_ack();
 extern void tcp_settimeout(long);
 extern int  schedule_jobs(void);
@@ -220,6 +226,7 @@ time_t                  last_task_check_time = 0;
 int                     lockfds = -1;
 int                     ForceCreation = FALSE;
 int                     high_availability_mode = FALSE;
+const char             *convert_jobs_to = NULL;  /* set by --convert-jobs */
 int                     paused;
 char                   *acct_file = NULL;
 char                   *log_file  = NULL;
@@ -246,6 +253,7 @@ char                   *path_nodestate;
 char                   *path_nodepowerstate;
 char                   *path_nodenote;
 char                   *path_nodenote_new;
+char                   *path_nodechanges;
 char                   *path_checkpoint;
 char                   *path_jobinfo_log;
 extern char            *msg_daemonname;
@@ -471,6 +479,7 @@ int PBSShowUsage(
   fprintf(stderr, "  -t <TYPE> \\\\ Startup Type (create)\n");
   fprintf(stderr, "  -v        \\\\ Version\n");
   fprintf(stderr, "  --about   \\\\ Print information about pbs_server\n");
+  fprintf(stderr, "  --convert-jobs=<binary|xml> \\\\ Rewrite the job files and exit\n");
   fprintf(stderr, "  --ha      \\\\ High Availability MODE\n");
   fprintf(stderr, "  --help    \\\\ Print Usage\n");
   fprintf(stderr, "  --version \\\\ Version and commit\n");
@@ -564,6 +573,21 @@ void parse_command_line(
           break;
           }
 
+        if (!strncmp(optarg, "convert-jobs=", strlen("convert-jobs=")))
+          {
+          convert_jobs_to = optarg + strlen("convert-jobs=");
+
+          if ((strcmp(convert_jobs_to, "binary")) &&
+              (strcmp(convert_jobs_to, "xml")))
+            {
+            PBSShowUsage("--convert-jobs must be binary or xml");
+
+            exit(1);
+            }
+
+          break;
+          }
+
         PBSShowUsage("invalid command line arg");
 
         exit(1);
@@ -1358,12 +1382,23 @@ void main_loop(void)
 #endif
 
   time_now = time(NULL);
+
+  /* without the poller, moms' status streams are closed instead of parked */
+  if (init_status_stream_poller() == PBSE_NONE)
+    start_generic_thread(NULL, poll_status_streams);
+
   start_accept_thread();
   start_routing_retry_thread();
   start_exiting_retry_thread();
   start_generic_thread(NULL, remove_extra_recycle_jobs);
   start_generic_thread(NULL, remove_completed_jobs);
 
+  if (job_journal_enabled == true)
+    start_generic_thread(NULL, compact_job_journal);
+
+  for (long i = 0; i < job_writer_threads; i++)
+    start_generic_thread(NULL, write_dirty_jobs);
+
   while (state != SV_STATE_DOWN)
     {
     /* first process any task whose time delay has expired */
@@ -1464,6 +1499,8 @@ void main_loop(void)
 
   track_save(NULL);                     /* save tracking data */
 
+  node_changes.flush();                 /* node changes not written yet */
+
   /* let any array jobs that might still be cloning finish */
   int sem_val;
   do
@@ -1498,6 +1535,9 @@ void main_loop(void)
 
   delete iter;
 
+  /* make sure everything the writer threads haven't written yet gets written */
+  server_job_writer.flush(write_journal_entry);
+
   if (svr_chngNodesfile)
     {
     /*nodes created/deleted, or props changed and*/
@@ -1844,6 +1884,10 @@ int main(
       }
     }
 
+  /* the lock file and the bound port keep a running server out of the way */
+  if (convert_jobs_to != NULL)
+    exit((convert_job_files(!strcmp(convert_jobs_to, "binary")) == PBSE_NONE) ? 0 : 1);
+
   /* handle running in the background or not if we're debugging */
   if (!high_availability_mode)
     {
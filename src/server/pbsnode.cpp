@@ -19,7 +19,7 @@ int record_node_property_list(std::string const &, tlist_head *);
 
 extern AvlTree          ipaddrs;
 
-pbsnode::pbsnode() : nd_error(0), nd_properties(), nd_version(0), nd_plugin_generic_resources(),
+pbsnode::pbsnode() : nd_error(0), nd_properties(), nd_property_ids(), nd_version(0), nd_plugin_generic_resources(),
                      nd_plugin_generic_metrics(), nd_plugin_varattrs(), nd_plugin_features(),
                      nd_proximal_failures(0), nd_consecutive_successes(0),
                      nd_mutex(), nd_id(-1), nd_f_st(), nd_addrs(), nd_prop(NULL), nd_status(),
@@ -42,7 +42,9 @@ pbsnode::pbsnode() : nd_error(0), nd_properties(), nd_version(0), nd_plugin_gene
                      nd_is_alps_login(0), nd_ms_jobs(NULL), alps_subnodes(NULL),
                      max_subnode_nppn(0), nd_power_state(0),
                      nd_power_state_change_time(0), nd_acl(NULL),
-                     nd_requestid(), nd_tmp_unlock_count(0)
+                     nd_requestid(), nd_tmp_unlock_count(0), nd_props_generation(0),
+                     nd_gpus_generation(0), nd_index_summary(), nd_status_gen(0), nd_status_strings(),
+                     nd_status_seq(0)
 #ifdef PENABLE_LINUX_CGROUPS
                     , nd_layout()
 #endif
@@ -66,7 +68,7 @@ pbsnode::pbsnode(
 
   const char *pname,
   u_long     *pul,
-  bool        skip_address_lookup) : nd_error(0), nd_properties(), nd_version(0),
+  bool        skip_address_lookup) : nd_error(0), nd_properties(), nd_property_ids(), nd_version(0),
                                      nd_plugin_generic_resources(), nd_plugin_generic_metrics(),
                                      nd_plugin_varattrs(), nd_plugin_features(),
                                      nd_proximal_failures(0), nd_consecutive_successes(0),
@@ -91,7 +93,10 @@ pbsnode::pbsnode(
                                      nd_is_alps_login(0), nd_ms_jobs(NULL), alps_subnodes(NULL),
                                      max_subnode_nppn(0), nd_power_state(0),
                                      nd_power_state_change_time(0), nd_acl(NULL),
-                                     nd_requestid(), nd_tmp_unlock_count(0)
+                                     nd_requestid(), nd_tmp_unlock_count(0),
+                                     nd_props_generation(0), nd_gpus_generation(0),
+                                     nd_index_summary(),
+                                     nd_status_gen(0), nd_status_strings(), nd_status_seq(0)
 #ifdef PENABLE_LINUX_CGROUPS
                                      , nd_layout()
 #endif
@@ -169,6 +174,7 @@ pbsnode &pbsnode::operator =(
   this->nd_id = other.nd_id;
   this->nd_f_st = other.nd_f_st;
   this->nd_properties = other.nd_properties;
+  this->nd_property_ids = other.nd_property_ids;
   this->nd_version = other.nd_version;
   this->nd_plugin_generic_resources = other.nd_plugin_generic_resources;
   this->nd_plugin_generic_metrics = other.nd_plugin_generic_metrics;
@@ -245,6 +251,12 @@ pbsnode &pbsnode::operator =(
 
   this->nd_requestid = other.nd_requestid;
   this->nd_tmp_unlock_count = other.nd_tmp_unlock_count;
+  this->nd_props_generation = other.nd_props_generation;
+  this->nd_gpus_generation = other.nd_gpus_generation;
+  this->nd_index_summary = node_index_summary();
+  this->nd_status_gen = other.nd_status_gen;
+  this->nd_status_strings = other.nd_status_strings;
+  this->nd_status_seq = other.nd_status_seq;
 #ifdef PENABLE_LINUX_CGROUPS
   this->nd_layout = other.nd_layout;
 #endif
@@ -260,6 +272,7 @@ pbsnode &pbsnode::operator =(
 pbsnode::pbsnode(
 
   const pbsnode &other) : nd_error(other.nd_error), nd_properties(other.nd_properties),
+                          nd_property_ids(other.nd_property_ids),
                           nd_version(other.nd_version),
                           nd_plugin_generic_resources(other.nd_plugin_generic_resources),
                           nd_plugin_generic_metrics(other.nd_plugin_generic_metrics),
@@ -298,7 +311,12 @@ pbsnode::pbsnode(
                           nd_power_state(other.nd_power_state),
                           nd_power_state_change_time(other.nd_power_state_change_time),
                           nd_requestid(other.nd_requestid),
-                          nd_tmp_unlock_count(other.nd_tmp_unlock_count)
+                          nd_tmp_unlock_count(other.nd_tmp_unlock_count),
+                          nd_props_generation(other.nd_props_generation),
+                          nd_gpus_generation(other.nd_gpus_generation), nd_index_summary(),
+                          nd_status_gen(other.nd_status_gen),
+                          nd_status_strings(other.nd_status_strings),
+                          nd_status_seq(other.nd_status_seq)
 #ifdef PENABLE_LINUX_CGROUPS
                           , nd_layout(other.nd_layout)
 #endif
@@ -403,6 +421,9 @@ int pbsnode::unlock_node(
     log_record(PBSEVENT_DEBUG, PBS_EVENTCLASS_NODE, __func__, err_msg);
     }
 
+  /* whoever held the lock may have changed what the node can run */
+  update_node_index(this);
+
   if (pthread_mutex_unlock(&this->nd_mutex) != 0)
     {
     if (logging >= 10)
@@ -448,6 +469,59 @@ int pbsnode::get_error() const
 
 
 
+/*
+ * resolve_property()
+ *
+ * Sets p.id to the property_mapper id for p.name, PROP_NODE_NAME if it's only
+ * a node name, or PROP_UNKNOWN if nothing could match it.
+ */
+
+void resolve_property(
+
+  prop &p)
+
+  {
+  p.id = property_mapper.get_id(p.name.c_str());
+
+  if (p.id < 0)
+    {
+    if (node_mapper.get_id(p.name.c_str()) >= 0)
+      p.id = PROP_NODE_NAME;
+    else
+      p.id = PROP_UNKNOWN;
+    }
+  } /* END resolve_property() */
+
+
+
+/*
+ * index_properties()
+ *
+ * Rebuilds nd_property_ids from nd_properties
+ */
+
+void pbsnode::index_properties()
+
+  {
+  this->nd_property_ids.clear();
+
+  for (unsigned int i = 0; i < this->nd_properties.size(); i++)
+    {
+    if (this->nd_properties[i] != this->nd_name)
+      this->nd_property_ids.add(property_mapper.get_new_id(this->nd_properties[i].c_str()));
+    }
+  } /* END index_properties() */
+
+
+
+const std::vector<std::string> &pbsnode::get_properties() const
+
+  {
+  return(this->nd_properties);
+  }
+
+
+
 bool pbsnode::hasprop(
 
   std::vector<prop> *props) const
@@ -462,19 +536,19 @@ bool pbsnode::hasprop(
     if (need.mark == 0) /* not marked, skip */
       continue;
 
-    bool found = false;
+    /* look the name up once per request rather than once per node */
+    if (need.id == PROP_UNRESOLVED)
+      resolve_property(need);
 
-    for (unsigned int i = 0; i < this->nd_properties.size(); i++)
-      {
-      if (this->nd_properties[i] == need.name)
-        {
-        found = true;
-        break;
-        }
-      }
+    if (need.id == PROP_UNKNOWN)
+      return(false);
 
-    if (found == false)
-      return(found);
+    if (this->nd_property_ids.contains(need.id))
+      continue;
+
+    /* every node also has its own name as a property */
+    if (need.name != this->nd_name)
+      return(false);
     }
 
   return(true);
@@ -522,6 +596,8 @@ void pbsnode::update_properties()
 
   /* now add in name as last prop */
   this->nd_properties.push_back(this->nd_name);
+  this->index_properties();
+  this->nd_props_generation++;
   } // END update_prop_list()
 
 
@@ -538,6 +614,12 @@ void pbsnode::change_name(
     }
 
   this->nd_name = name;
+  this->index_properties();
+  this->nd_props_generation++;
+
+  /* keep the node's id, now under its new name, see resolve_property() */
+  if (node_mapper.rename_id(this->nd_id, name) != 0)
+    this->nd_id = node_mapper.get_new_id(name);
   } // END change_name()
 
 
@@ -548,6 +630,11 @@ void pbsnode::add_property(
 
   {
   this->nd_properties.push_back(prop);
+
+  if (prop != this->nd_name)
+    this->nd_property_ids.add(property_mapper.get_new_id(prop.c_str()));
+
+  this->nd_props_generation++;
   }
 
 
@@ -707,6 +794,9 @@ int pbsnode::copy_properties(
       dest->nd_properties.push_back(this->nd_properties[i]);
     }
 
+  dest->index_properties();
+  dest->nd_props_generation++;
+
   return(PBSE_NONE);
   } /* END copy_properties() */
 
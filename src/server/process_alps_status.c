@@ -540,12 +540,13 @@ int record_reservation(
       {
       mutex_mgr job_mutex(pjob->ji_mutex, true);
       pjob->ji_wattr[JOB_ATR_reservation_id].at_val.at_str = strdup(rsv_id);
-      pjob->ji_wattr[JOB_ATR_reservation_id].at_flags = ATR_VFLAG_SET;
+      pjob->ji_wattr[JOB_ATR_reservation_id].at_flags = ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
       /* add environment variable BATCH_PARTITION_ID */
       char buf[1024];
       snprintf(buf, sizeof(buf), "BATCH_PARTITION_ID=%s", rsv_id);
       pbs_attribute  tempattr;
+      pjob->hydrate_attr(JOB_ATR_variables);
       clear_attr(&tempattr, &job_attr_def[JOB_ATR_variables]);
       job_attr_def[JOB_ATR_variables].at_decode(&tempattr,
         NULL, NULL, buf, 0);
@@ -98,6 +98,8 @@
 #include "mutex_mgr.hpp"
 #include "id_map.hpp"
 #include "plugin_internal.h"
+#include "status_generation.hpp"
+#include "mom_update.h"
 
 
 extern attribute_def    node_attr_def[];   /* node attributes defs */
@@ -730,12 +732,143 @@ int save_node_status(
   new_status += date_attrib;
 
   np->nd_status = new_status;
+  np->nd_status_gen = status_gen.next();
 
   return(rc);
   } /* END save_node_status() */
 
 
 
+/*
+ * status_key_matches()
+ *
+ * @return true if status is key=value for this key
+ */
+
+bool status_key_matches(
+
+  const std::string &status,
+  const std::string &key)
+
+  {
+  return((status.compare(0, key.size(), key) == 0) &&
+         ((status.size() == key.size()) ||
+          (status[key.size()] == '=')));
+  } /* END status_key_matches() */
+
+
+
+/*
+ * apply_status_delta()
+ *
+ * Replaces the strings in cached with the ones in changed that have the same key,
+ * adds the rest and drops the ones whose key is in removed
+ *
+ * @param cached - the node's strings from its last status update (modified)
+ * @param changed - the strings sent in a status delta
+ * @param removed - keys the mom no longer reports
+ */
+
+void apply_status_delta(
+
+  std::vector<std::string>       &cached,
+  const std::vector<std::string> &changed,
+  const std::vector<std::string> &removed)
+
+  {
+  for (size_t i = 0; i < changed.size(); i++)
+    {
+    std::string key = changed[i].substr(0, changed[i].find('='));
+    size_t      j;
+
+    for (j = 0; j < cached.size(); j++)
+      {
+      if (status_key_matches(cached[j], key))
+        {
+        cached[j] = changed[i];
+        break;
+        }
+      }
+
+    if (j == cached.size())
+      cached.push_back(changed[i]);
+    }
+
+  for (size_t i = 0; i < removed.size(); i++)
+    {
+    for (size_t j = 0; j < cached.size(); j++)
+      {
+      if (status_key_matches(cached[j], removed[i]))
+        {
+        cached.erase(cached.begin() + j);
+        break;
+        }
+      }
+    }
+  } /* END apply_status_delta() */
+
+
+
+/*
+ * save_status_block()
+ *
+ * Saves one node's part of a status update as its nd_status. A delta is applied
+ * to the strings kept from the node's last update; it only follows on from them
+ * if its sequence number is the next one, otherwise an update was missed or
+ * the server has restarted and the mom is asked for all of its status.
+ *
+ * @param np - the node the block is for
+ * @param block - the strings sent for the node (its strings may be taken)
+ * @return PBSE_NONE, or SEND_FULL_STATUS if the delta didn't follow on from the last update
+ */
+
+int save_status_block(
+
+  struct pbsnode *np,
+  status_block   &block)
+
+  {
+  std::string status;
+
+  if (block.delta == false)
+    {
+    np->nd_status_strings.swap(block.strings);
+    np->nd_status_seq = block.seq;
+    }
+  else if ((np->nd_status_seq == 0) ||
+           (block.seq != np->nd_status_seq + 1))
+    {
+    /* keep the node's status as it is until the mom resends all of it */
+    np->nd_status_strings.clear();
+    np->nd_status_seq = 0;
+
+    return(SEND_FULL_STATUS);
+    }
+  else
+    {
+    apply_status_delta(np->nd_status_strings, block.strings, block.removed);
+    np->nd_status_seq = block.seq;
+    }
+
+  for (size_t i = 0; i < np->nd_status_strings.size(); i++)
+    {
+    if (i != 0)
+      status += ",";
+
+    status += np->nd_status_strings[i];
+    }
+
+  /* there's nothing to apply a delta to if the mom doesn't number its updates */
+  if (np->nd_status_seq == 0)
+    np->nd_status_strings.clear();
+
+  save_node_status(np, status);
+
+  return(PBSE_NONE);
+  } /* END save_status_block() */
+
+
+
 #ifdef PENABLE_LINUX_CGROUPS
 /*
  * update_layout_if_needed()
@@ -823,7 +956,7 @@ int process_status_info(
   int             dont_change_state = FALSE;
   int             rc = PBSE_NONE;
   bool            send_hello = false;
-  std::string     temp;
+  status_block    temp;
 
   get_svr_attr_b(SRV_ATR_MomJobSync, &mom_job_sync);
   get_svr_attr_b(SRV_ATR_AutoNodeNP, &auto_np);
@@ -858,7 +991,9 @@ int process_status_info(
       /* if we've already processed some, save this before moving on */
       if (i != 0)
         {
-        save_node_status(current, temp);
+        if (save_status_block(current, temp) == SEND_FULL_STATUS)
+          rc = SEND_FULL_STATUS;
+
         temp.clear();
         }
       
@@ -874,7 +1009,9 @@ int process_status_info(
       /* if we've already processed some, save this before moving on */
       if (i != 0)
         {
-        save_node_status(current, temp);
+        if (save_status_block(current, temp) == SEND_FULL_STATUS)
+          rc = SEND_FULL_STATUS;
+
         temp.clear();
         }
 
@@ -901,6 +1038,28 @@ int process_status_info(
         }
       }
 
+    else if (!strncmp(str, STATUS_SEQ, strlen(STATUS_SEQ)))
+      {
+      temp.seq = strtoul(str + strlen(STATUS_SEQ), NULL, 10);
+      continue;
+      }
+    else if (!strncmp(str, STATUS_DELTA, strlen(STATUS_DELTA)))
+      {
+      temp.seq = strtoul(str + strlen(STATUS_DELTA), NULL, 10);
+      temp.delta = true;
+      continue;
+      }
+    else if (!strncmp(str, STATUS_REMOVED, strlen(STATUS_REMOVED)))
+      {
+      std::stringstream removed(str + strlen(STATUS_REMOVED));
+      std::string       key;
+
+      while (std::getline(removed, key, ','))
+        temp.removed.push_back(key);
+
+      continue;
+      }
+
     /* add the info to the "temp" pbs_attribute */
     else if (!strcmp(str, START_GPU_STATUS))
       {
@@ -950,9 +1109,6 @@ int process_status_info(
       }
     else 
       {
-      if (temp.size() > 0)
-        temp += ",";
-
       if (!strncmp(str, "message=", 8))
         {
         std::string no_newlines(str);
@@ -964,10 +1120,10 @@ int process_status_info(
           pos = no_newlines.find('\n');
           }
 
-        temp += no_newlines;
+        temp.strings.push_back(no_newlines);
         }
       else
-        temp += str;
+        temp.strings.push_back(str);
       }
 
     if (!strncmp(str, "state", 5))
@@ -1018,7 +1174,9 @@ int process_status_info(
 
   if (current != NULL)
     {
-    save_node_status(current, temp);
+    if (save_status_block(current, temp) == SEND_FULL_STATUS)
+      rc = SEND_FULL_STATUS;
+
     current->unlock_node(__func__, NULL, LOGLEVEL);
     }
   
@@ -1237,6 +1395,8 @@ int is_gpustat_get(
     
     if (!memcmp(str, "gpu_mode=", 9))
       {
+      np->nd_gpus_generation++;
+
       if ((!memcmp(str + 9, "Normal", 6)) || (!memcmp(str + 9, "Default", 7)))
         {
         np->nd_gpusn[gpuidx].mode = gpu_normal;
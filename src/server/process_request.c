@@ -684,6 +684,7 @@ int process_request(
       case PBS_BATCH_QueueJob:
       case PBS_BATCH_QueueJob2:
       case PBS_BATCH_RunJob:
+      case PBS_BATCH_RunJobs:
       case PBS_BATCH_StageIn:
       case PBS_BATCH_jobscript:
       case PBS_BATCH_jobscript2:
@@ -905,6 +906,13 @@ int dispatch_request(
 
       break;
 
+    case PBS_BATCH_RunJobs:
+
+      globalset_del_sock(request->rq_conn);
+      rc = req_runjobs(request);
+
+      break;
+
     case PBS_BATCH_SelectJobs:
 
     case PBS_BATCH_SelStat:
@@ -964,6 +972,12 @@ int dispatch_request(
 
       break;
 
+    case PBS_BATCH_StatusSnapshot:
+
+      rc = req_stat_snapshot(request);
+
+      break;
+
       /* DIAGTODO: handle PBS_BATCH_StatusDiag and define req_stat_diag() */
 
     case PBS_BATCH_TrackJob:
@@ -1239,6 +1253,13 @@ void free_br(
 
       break;
 
+    case PBS_BATCH_StatusSnapshot:
+
+      for (int i = 0; i < SNAPSHOT_OBJ_COUNT; i++)
+        free_attrlist(&preq->rq_ind.rq_snapshot.rq_attr[i]);
+
+      break;
+
     case PBS_BATCH_JobObit:
 
       free_attrlist(&preq->rq_ind.rq_jobobit.rq_attr);
@@ -1298,6 +1319,21 @@ void free_br(
         }
       break;
 
+    case PBS_BATCH_RunJobs:
+
+      if (preq->rq_ind.rq_runjobs.rq_jobs != NULL)
+        {
+        for (int i = 0; i < preq->rq_ind.rq_runjobs.rq_count; i++)
+          {
+          if (preq->rq_ind.rq_runjobs.rq_jobs[i].rq_destin != NULL)
+            free(preq->rq_ind.rq_runjobs.rq_jobs[i].rq_destin);
+          }
+
+        free(preq->rq_ind.rq_runjobs.rq_jobs);
+        preq->rq_ind.rq_runjobs.rq_jobs = NULL;
+        }
+      break;
+
     default:
 
       /* NO-OP */
@@ -272,6 +272,7 @@ const char *PBSServerCmds2[] =
   "UPDATE",
   "STATUS",
   "GPU_STATUS",
+  "STATUS_STREAM",
   NULL
   };
 
@@ -286,6 +287,9 @@ const char *PBSServerCmds2[] =
  *         for a successful return. But which ever retun 
  *         code is iused it must terminate the while loop
  *         in start_process_pbs_server_port.
+ *         The exception is a successful IS_STATUS_STREAM,
+ *         where isr->keep_open is set instead and the
+ *         connection is left open for the next update.
  *************************************************/
 void *svr_is_request(
   
@@ -495,6 +499,7 @@ void *svr_is_request(
       break;
 
     case IS_STATUS:
+    case IS_STATUS_STREAM:
 
       {
       std::string node_name = node->get_name();
@@ -502,7 +507,9 @@ void *svr_is_request(
       if (LOGLEVEL >= 2)
         {
         snprintf(log_buf, LOCAL_LOG_BUF_SIZE,
-            "IS_STATUS received from %s", node->get_name());
+            "%s received from %s",
+            (command == IS_STATUS) ? "IS_STATUS" : "IS_STATUS_STREAM",
+            node->get_name());
 
         log_event(PBSEVENT_ADMIN, PBS_EVENTCLASS_SERVER, __func__, log_buf);
         }
@@ -526,6 +533,12 @@ void *svr_is_request(
           hierarchy_handler.sendHierarchyToANode(node);
           ret = DIS_SUCCESS;
           }
+        else if (ret == SEND_FULL_STATUS)
+          {
+          /* the mom resends all of its status on this connection */
+          write_tcp_reply(chan, IS_PROTOCOL, IS_PROTOCOL_VER, IS_STATUS, SEND_FULL_STATUS);
+          ret = DIS_SUCCESS;
+          }
         else
           write_tcp_reply(chan,IS_PROTOCOL,IS_PROTOCOL_VER,IS_STATUS,ret);
         }
@@ -560,6 +573,16 @@ void *svr_is_request(
       break;
     }  /* END switch (command) */
 
+  if ((command == IS_STATUS_STREAM) &&
+      (node != NULL))
+    {
+    /* the mom sends its next status update over this connection */
+    isr->keep_open = true;
+    DIS_tcp_cleanup(chan);
+
+    return(NULL);
+    }
+
   /* must be closed because mom opens and closes this connection each time */
   close_conn(chan->sock, FALSE);
   DIS_tcp_cleanup(chan);
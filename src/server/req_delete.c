@@ -682,7 +682,7 @@ jump:
     pjob->ji_qs.ji_un.ji_exect.ji_exitstat = status_cancel_queue;
 
     pjob->ji_wattr[JOB_ATR_exitstat].at_val.at_long = status_cancel_queue;
-    pjob->ji_wattr[JOB_ATR_exitstat].at_flags |= ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_exitstat].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     }
 
   // Update the array book-keeping values if this is an array subjob
@@ -1331,7 +1331,7 @@ void change_restart_comment_if_needed(
       if (isupper(*ptr))
         {
         *ptr = tolower(*ptr);
-        pjob->ji_wattr[JOB_ATR_checkpoint_restart_status].at_flags |= ATR_VFLAG_SET;
+        pjob->ji_wattr[JOB_ATR_checkpoint_restart_status].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
         pjob->ji_modified = 1;
         }
       }
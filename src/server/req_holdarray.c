@@ -50,7 +50,7 @@ void hold_job(
   hold_val = &pjob->ji_wattr[JOB_ATR_hold].at_val.at_long;
   old_hold = *hold_val;
   *hold_val |= temphold->at_val.at_long;
-  pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET;
+  pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
   
   pattr = &pjob->ji_wattr[JOB_ATR_checkpoint];
   
@@ -210,7 +210,7 @@ int req_holdjob(
 
   old_hold = *hold_val;
   *hold_val |= temphold.at_val.at_long;
-  pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET;
+  pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
   sprintf(log_buf, msg_jobholdset, pset, preq->rq_user, preq->rq_host);
 
   pattr = &pjob->ji_wattr[JOB_ATR_checkpoint];
@@ -815,7 +815,7 @@ int check_if_checkpoint_restart_failed(
         /* put job on hold */
         hold_val = &pjob->ji_wattr[JOB_ATR_hold].at_val.at_long;
         *hold_val |= HOLD_s;
-        pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET;
+        pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
         pjob->ji_modified = 1;
         svr_setjobstate(pjob, JOB_STATE_HELD, JOB_SUBSTATE_HELD, FALSE);
 
@@ -1644,7 +1644,7 @@ int handle_complete_subjob(
         {
         svr_setjobstate(parent_job, JOB_STATE_COMPLETE, JOB_SUBSTATE_COMPLETE, FALSE);
         parent_job->ji_wattr[JOB_ATR_comp_time].at_val.at_long = (long)time(NULL);
-        parent_job->ji_wattr[JOB_ATR_comp_time].at_flags |= ATR_VFLAG_SET;
+        parent_job->ji_wattr[JOB_ATR_comp_time].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
         rel_resc(parent_job);
         
         handle_complete_first_time(parent_job);
@@ -1855,7 +1855,7 @@ int handle_complete_first_time(
     struct timezone  tz;
     
     pjob->ji_wattr[JOB_ATR_comp_time].at_val.at_long = (long)time(NULL);
-    pjob->ji_wattr[JOB_ATR_comp_time].at_flags |= ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_comp_time].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     
     if (gettimeofday(&tv, &tz) == 0)
       {
@@ -1863,7 +1863,7 @@ int handle_complete_first_time(
       timeval_subtract(&result, &tv, tv_attr);
       pjob->ji_wattr[JOB_ATR_total_runtime].at_val.at_timeval.tv_sec = result.tv_sec;
       pjob->ji_wattr[JOB_ATR_total_runtime].at_val.at_timeval.tv_usec = result.tv_usec;
-      pjob->ji_wattr[JOB_ATR_total_runtime].at_flags |= ATR_VFLAG_SET;
+      pjob->ji_wattr[JOB_ATR_total_runtime].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
       }
     else
       {
@@ -2875,7 +2875,7 @@ int add_comment_to_parent(
     free(parent_job->ji_wattr[JOB_ATR_Comment].at_val.at_str);
 
   parent_job->ji_wattr[JOB_ATR_Comment].at_val.at_str = comment;
-  parent_job->ji_wattr[JOB_ATR_Comment].at_flags |= ATR_VFLAG_SET;
+  parent_job->ji_wattr[JOB_ATR_Comment].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
   return(PBSE_NONE);
   } /* END add_comment_to_parent() */
@@ -3212,7 +3212,7 @@ void set_job_comment(
     }
 
   pjob->ji_wattr[JOB_ATR_Comment].at_val.at_str = strdup(cmt);
-  pjob->ji_wattr[JOB_ATR_Comment].at_flags |= ATR_VFLAG_SET;
+  pjob->ji_wattr[JOB_ATR_Comment].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
   } // END set_job_comment()
 
 
@@ -3407,8 +3407,6 @@ bool is_job_finished(
 
   if (pnode != NULL)
     {
-    mutex_mgr  node_mutex(&pnode->nd_mutex, true);
-
     // Must be a version 6.1.0 node or higher for the mom to have cleaned up the job
     if (pnode->get_version() >= 610)
       {
@@ -3417,18 +3415,21 @@ bool is_job_finished(
         {
         if (depend_on_term(pjob) == PBSE_JOBNOTFOUND)
           {
+          pnode->unlock_node(__func__, NULL, LOGLEVEL);
           done = true;
           return(done);
           }
         }
 
-      node_mutex.unlock();
+      pnode->unlock_node(__func__, NULL, LOGLEVEL);
 
       rel_resc(pjob);
       svr_setjobstate(pjob, JOB_STATE_COMPLETE, JOB_SUBSTATE_COMPLETE, FALSE);
       handle_complete_first_time(pjob);
       done = true;
       }
+    else
+      pnode->unlock_node(__func__, NULL, LOGLEVEL);
     }
 
   return(done);
@@ -3608,7 +3609,7 @@ int req_jobobit(
     pjob->ji_qs.ji_un.ji_exect.ji_exitstat = exitstatus;
 
     pjob->ji_wattr[JOB_ATR_exitstat].at_val.at_long = exitstatus;
-    pjob->ji_wattr[JOB_ATR_exitstat].at_flags |= ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_exitstat].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     }
   else
     {
@@ -3616,7 +3617,7 @@ int req_jobobit(
     exitstatus = status_cancel_queue;
 
     pjob->ji_wattr[JOB_ATR_exitstat].at_val.at_long = status_cancel_queue;
-    pjob->ji_wattr[JOB_ATR_exitstat].at_flags |= ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_exitstat].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     }
 
   if ((exitstatus != JOB_EXEC_RETRY) &&
@@ -140,6 +140,7 @@
 #include "req_delete.h"
 #include "mom_hierarchy_handler.h"
 #include "attr_req_info.hpp"
+#include "status_generation.hpp"
 
 
 #define PERM_MANAGER (ATR_DFLAG_MGWR | ATR_DFLAG_MGRD)
@@ -976,6 +977,7 @@ int mgr_set_node_attr(
     }
 
   *pnode              = tnode;        /* updates all data including linking in props */
+  pnode->nd_status_gen = status_gen.next();
 
   free(new_attr);  /*any new  prop list has been put on pnode*/
 
@@ -1900,12 +1902,12 @@ void mgr_node_set(
     pnode->unlock_node(__func__, "single_node", LOGLEVEL);
     } /* END single node case */
 
-  if (need_todo & WRITENODE_STATE)
+  if (need_todo & (WRITENODE_STATE | WRITENODE_NOTE))
     {
-    /*some nodes set to "offline"*/
-    write_node_state();
+    /*some nodes set to "offline" or have new "note"s*/
+    write_node_changes(need_todo);
 
-    need_todo &= ~(WRITENODE_STATE);
+    need_todo &= ~(WRITENODE_STATE | WRITENODE_NOTE);
     }
 
   if (need_todo & WRITENODE_POWER_STATE)
@@ -1916,14 +1918,6 @@ void mgr_node_set(
     need_todo &= ~(WRITENODE_POWER_STATE);
     }
 
-  if (need_todo & WRITENODE_NOTE)
-    {
-    /*some nodes have new "note"s*/
-    write_node_note();
-
-    need_todo &= ~(WRITENODE_NOTE);
-    }
-
   if (need_todo & WRITE_NEW_NODESFILE)
     {
     /*create/delete/prop/ntype change*/
@@ -113,6 +113,7 @@
 #include "mutex_mgr.hpp"
 #include "threadpool.h"
 #include "mutex_mgr.hpp"
+#include "status_generation.hpp"
 #include <string>
 
 #define CHK_HOLD 1
@@ -1119,6 +1120,8 @@ int modify_job_attr(
     return(PBSE_JOBNOTFOUND);
     }
 
+  pjob->hydrate_attrs();
+
   if (pjob->ji_parent_job != NULL)
     {
     allow_unkn = JOB_ATR_UNKN;
@@ -1345,6 +1348,7 @@ int modify_job_attr(
   /* note, the newattr[] attributes are on the stack, they go away automatically */
 
   pjob->ji_modified = 1;
+  pjob->ji_status_gen = status_gen.next();
 
   return(PBSE_NONE);
   }  /* END modify_job_attr() */
@@ -405,12 +405,12 @@ void mgr_node_modify(
     pnode = NULL;
     }
 
-  if (need_todo & WRITENODE_STATE)
+  if (need_todo & (WRITENODE_STATE | WRITENODE_NOTE))
     {
-    /*some nodes set to "offline"*/
-    write_node_state();
+    /*some nodes set to "offline" or have new "note"s*/
+    write_node_changes(need_todo);
 
-    need_todo &= ~(WRITENODE_STATE);
+    need_todo &= ~(WRITENODE_STATE | WRITENODE_NOTE);
     }
 
   if (need_todo & WRITENODE_POWER_STATE)
@@ -421,14 +421,6 @@ void mgr_node_modify(
     need_todo &= ~(WRITENODE_POWER_STATE);
     }
 
-  if (need_todo & WRITENODE_NOTE)
-    {
-    /*some nodes have new "note"s*/
-    write_node_note();
-
-    need_todo &= ~(WRITENODE_NOTE);
-    }
-
   if (need_todo & WRITE_NEW_NODESFILE)
     {
     /*create/delete/prop/ntype change*/
@@ -367,6 +367,14 @@ int req_orderjob(
       mutex_mgr pque1_mutex = mutex_mgr(pque1->qu_mutex, true);
       swap_jobs(pque1->qu_jobs,pjob1,pjob2);
       swap_jobs(NULL,pjob1,pjob2);
+
+      /* the array summary is kept in rank order too. An array sub-job isn't
+       * in it, so then only the other job moves, to its new rank */
+      if (swap_jobs(pque1->qu_jobs_array_sum,pjob1,pjob2) != PBSE_NONE)
+        {
+        rerank_job(pque1->qu_jobs_array_sum,pjob1);
+        rerank_job(pque1->qu_jobs_array_sum,pjob2);
+        }
       }
     }
 
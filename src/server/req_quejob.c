@@ -278,6 +278,8 @@ void sum_select_mem_request(
 
   unsigned long mem_total = 0;
 
+  pj->hydrate_attr(JOB_ATR_submit_args);
+
   if ((!(pj->ji_wattr[JOB_ATR_submit_args].at_flags & ATR_VFLAG_SET)) ||
       (pj->ji_wattr[JOB_ATR_submit_args].at_val.at_str == NULL))
     return;
@@ -1001,18 +1003,18 @@ int check_attribute_settings(
 
     /* set create time */
     pj->ji_wattr[JOB_ATR_ctime].at_val.at_long = time(NULL);
-    pj->ji_wattr[JOB_ATR_ctime].at_flags |= ATR_VFLAG_SET;
+    pj->ji_wattr[JOB_ATR_ctime].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
     /* set hop count = 1 */
     pj->ji_wattr[JOB_ATR_hopcount].at_val.at_long = 1;
-    pj->ji_wattr[JOB_ATR_hopcount].at_flags |= ATR_VFLAG_SET;
+    pj->ji_wattr[JOB_ATR_hopcount].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
     /* Interactive jobs are necessarily not rerunable */
     if ((pj->ji_wattr[JOB_ATR_interactive].at_flags & ATR_VFLAG_SET) &&
         pj->ji_wattr[JOB_ATR_interactive].at_val.at_long)
       {
       pj->ji_wattr[JOB_ATR_rerunable].at_val.at_long = 0;
-      pj->ji_wattr[JOB_ATR_rerunable].at_flags |= ATR_VFLAG_SET;
+      pj->ji_wattr[JOB_ATR_rerunable].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
       }
 
     buf = pbs_o_que;
@@ -1090,7 +1092,7 @@ int check_attribute_settings(
         free(pj->ji_wattr[JOB_ATR_outpath].at_val.at_str);
 
       pj->ji_wattr[JOB_ATR_outpath].at_val.at_str = strdup(prefix_std_file(pj, ds, (int)'o'));
-      pj->ji_wattr[JOB_ATR_outpath].at_flags |= ATR_VFLAG_SET;
+      pj->ji_wattr[JOB_ATR_outpath].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
       }
     /*
      * if the output path was specified and ends with a '/'
@@ -1144,7 +1146,7 @@ int check_attribute_settings(
         free(pj->ji_wattr[JOB_ATR_errpath].at_val.at_str);
 
       pj->ji_wattr[JOB_ATR_errpath].at_val.at_str = strdup(prefix_std_file(pj, ds, (int)'e'));
-      pj->ji_wattr[JOB_ATR_errpath].at_flags |= ATR_VFLAG_SET;
+      pj->ji_wattr[JOB_ATR_errpath].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
       }
     /*
      * if the error path was specified and ends with a '/'
@@ -1332,7 +1334,7 @@ int check_attribute_settings(
     resc_access_perm);
 
   // Set the request version 
-  pj->ji_wattr[JOB_ATR_request_version].at_flags |= ATR_VFLAG_SET;
+  pj->ji_wattr[JOB_ATR_request_version].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
   if (pj->ji_wattr[JOB_ATR_req_information].at_val.at_ptr != NULL)
     pj->ji_wattr[JOB_ATR_request_version].at_val.at_long = REQ_VERSION_2;
   else
@@ -1430,7 +1432,7 @@ int perform_commit_work(
     pj->ji_qs.ji_state    = JOB_STATE_TRANSIT;
     pj->ji_qs.ji_substate = JOB_SUBSTATE_TRANSICM;
     pj->ji_wattr[JOB_ATR_state].at_val.at_char = 'T';
-    pj->ji_wattr[JOB_ATR_state].at_flags |= ATR_VFLAG_SET;
+    pj->ji_wattr[JOB_ATR_state].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
     adjust_array_file_path(pj);
     }
@@ -1513,7 +1515,7 @@ int perform_commit_work(
 
   /* set the queue rank attribute */
   pj->ji_wattr[JOB_ATR_qrank].at_val.at_long = ++queue_rank;
-  pj->ji_wattr[JOB_ATR_qrank].at_flags |= ATR_VFLAG_SET;
+  pj->ji_wattr[JOB_ATR_qrank].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
   if ((rc = svr_enquejob(pj, FALSE, NULL, false, false)) != PBSE_NONE)
     {
@@ -1575,7 +1577,8 @@ int perform_commit_work(
         }
       }
 
-    if (job_save(pj, SAVEJOB_FULL, 0) != 0)
+    /* the job is acknowledged as queued next, so it has to be on disk */
+    if (job_save(pj, SAVEJOB_NEW, 0) != 0)
       {
       // unlock the queue so it can be purged
       pque_mutex.unlock();
@@ -1894,7 +1897,7 @@ int req_quejob(
   strcpy(pj->ji_qs.ji_queue, pque->qu_qs.qu_name);
 
   pj->ji_wattr[JOB_ATR_substate].at_val.at_long = JOB_SUBSTATE_TRANSIN;
-  pj->ji_wattr[JOB_ATR_substate].at_flags |= ATR_VFLAG_SET;
+  pj->ji_wattr[JOB_ATR_substate].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
   /* set remaining job structure elements */
 
@@ -1903,7 +1906,7 @@ int req_quejob(
   pj->ji_qs.ji_substate = JOB_SUBSTATE_TRANSIN;
 
   pj->ji_wattr[JOB_ATR_mtime].at_val.at_long = (long)time_now;
-  pj->ji_wattr[JOB_ATR_mtime].at_flags |= ATR_VFLAG_SET;
+  pj->ji_wattr[JOB_ATR_mtime].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
   pj->ji_qs.ji_un_type = JOB_UNION_TYPE_NEW;
 
@@ -2336,7 +2339,7 @@ int req_rdytocommit(
   pj->ji_qs.ji_state    = JOB_STATE_TRANSIT;
   pj->ji_qs.ji_substate = JOB_SUBSTATE_TRANSICM;
   pj->ji_wattr[JOB_ATR_state].at_val.at_char = 'T';
-  pj->ji_wattr[JOB_ATR_state].at_flags |= ATR_VFLAG_SET;
+  pj->ji_wattr[JOB_ATR_state].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
   /* if this is a job array template then we'll delete the .JB file that 
      was created for this job since we are going to save it with a different 
@@ -2424,7 +2427,7 @@ int set_interactive_job_roaming_policy(
         
         if (pnode != NULL)
           {
-          pjob->ji_wattr[JOB_ATR_login_prop].at_flags |= ATR_VFLAG_SET;
+          pjob->ji_wattr[JOB_ATR_login_prop].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
           pjob->ji_wattr[JOB_ATR_login_prop].at_val.at_str = strdup(pnode->get_name());
           
           pnode->unlock_node(__func__, NULL, LOGLEVEL);
@@ -534,7 +534,7 @@ int release_syncwith_dependency(
       free(pjob->ji_wattr[JOB_ATR_sched_hint].at_val.at_str);
 
     pjob->ji_wattr[JOB_ATR_sched_hint].at_val.at_str = strdup(tmpcoststr);
-    pjob->ji_wattr[JOB_ATR_sched_hint].at_flags |= ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_sched_hint].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     }
   else
     {
@@ -1215,7 +1215,7 @@ bool set_array_depend_holds(
           {
           /* hold */
           pjob->ji_wattr[JOB_ATR_hold].at_val.at_long |= HOLD_s;
-          pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET;
+          pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
           if (LOGLEVEL >= 8)
             {
@@ -1319,7 +1319,7 @@ void post_doq(
         if (preq->rq_reply.brp_code != PBSE_BADSTATE)
           {
           pjob->ji_wattr[JOB_ATR_hold].at_val.at_long |= HOLD_u;
-          pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET;
+          pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
           pjob->ji_modified = 1;
           }
 
@@ -2060,7 +2060,7 @@ void set_depend_hold(
     /* there are dependencies, set system hold accordingly */
 
     pjob->ji_wattr[JOB_ATR_hold].at_val.at_long |= HOLD_s;
-    pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
     if (LOGLEVEL >= 8)
       {
@@ -2158,7 +2158,7 @@ struct depend *make_depend(
   if (pdep != NULL)
     {
     append_link(&pattr->at_val.at_list, &pdep->dp_link, pdep);
-    pattr->at_flags |= ATR_VFLAG_SET;
+    pattr->at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     }
 
   return(pdep);
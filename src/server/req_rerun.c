@@ -591,8 +591,8 @@ int req_rerunjob(
 
     /* reset some job attributes */
     
-    pjob->ji_wattr[JOB_ATR_comp_time].at_flags &= ~ATR_VFLAG_SET;
-    pjob->ji_wattr[JOB_ATR_reported].at_flags &= ~ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_comp_time].at_flags = (pjob->ji_wattr[JOB_ATR_comp_time].at_flags & ~ATR_VFLAG_SET) | ATR_VFLAG_MODIFY;
+    pjob->ji_wattr[JOB_ATR_reported].at_flags = (pjob->ji_wattr[JOB_ATR_reported].at_flags & ~ATR_VFLAG_SET) | ATR_VFLAG_MODIFY;
 
     set_statechar(pjob);
 
@@ -146,9 +146,25 @@ int  svr_startjob(job *, struct batch_request **, char *, char *);
 
 int  svr_stagein(job **, struct batch_request **, int, int);
 int  svr_strtjob2(job **, struct batch_request *);
-job *chk_job_torun(struct batch_request *, int);
+job *chk_job_torun(struct batch_request *, int, int &);
 int  assign_hosts(job *, char *, int, char *, char *);
 
+/* the most request pool threads one RunJobs request uses besides its own */
+#define RUNJOBS_MAX_HELPERS 8
+
+/* how the jobs of a RunJobs request are shared out, see req_runjobs() */
+class runjobs_batch
+  {
+  public:
+  batch_request    *preq;
+  std::vector<int>  codes;    /* the result of each job */
+  int               next;     /* the next job to claim */
+  int               active;   /* jobs claimed but not yet started or rejected */
+  int               refs;
+  pthread_mutex_t   mutex;
+  pthread_cond_t    done;
+  };
+
 /* Global Data Items: */
 
 extern pbs_net_t        pbs_mom_addr;
@@ -176,6 +192,7 @@ job                    *DispatchJob[20];
 char                   *DispatchNode[20];
 
 extern job  *chk_job_request(char *, struct batch_request *);
+extern job  *chk_job_request(char *, struct batch_request *, int &);
 extern struct batch_request *cpy_checkpoint(struct batch_request *, job *, enum job_atr, int);
 void poll_job_task(work_task *);
 int  kill_job_on_mom(const char *job_id, struct pbsnode *pnode);
@@ -335,11 +352,11 @@ int req_runjob(
   else
     setneednodes = 0;
 
-  if ((pjob = chk_job_torun(preq, setneednodes)) == NULL)
+  if ((pjob = chk_job_torun(preq, setneednodes, rc)) == NULL)
     {
     /* FAILURE - chk_job_torun performs req_reject internally */
 
-    return(PBSE_UNKJOBID);
+    return(rc);
     }
 
   /* we don't currently allow running of an entire job array */
@@ -383,6 +400,210 @@ int req_runjob(
 
 
 
+/*
+ * run_batched_jobs()
+ *
+ * Claims jobs from a RunJobs request and runs each one as its own Run Job
+ * request until none are left. The requests are built like the one
+ * req_commit() makes for a job that runs at submit time, with no reply of
+ * their own; req_runjob()'s result is kept for the RunJobs reply instead.
+ */
+
+void run_batched_jobs(
+
+  runjobs_batch *batch)
+
+  {
+  batch_request *preq = batch->preq;
+  batch_request *run_req;
+  int            index;
+
+  while (1)
+    {
+    pthread_mutex_lock(&batch->mutex);
+
+    if (batch->next >= preq->rq_ind.rq_runjobs.rq_count)
+      {
+      pthread_mutex_unlock(&batch->mutex);
+      break;
+      }
+
+    index = batch->next++;
+    batch->active++;
+    pthread_mutex_unlock(&batch->mutex);
+
+    struct rq_runjob &run = preq->rq_ind.rq_runjobs.rq_jobs[index];
+
+    if ((run_req = alloc_br(PBS_BATCH_RunJob)) == NULL)
+      batch->codes[index] = PBSE_MEM_MALLOC;
+    else
+      {
+      run_req->rq_perm = preq->rq_perm;
+      run_req->rq_fromsvr = preq->rq_fromsvr;
+      run_req->rq_conn = preq->rq_conn; /* counts toward scheduler_jobct */
+      run_req->rq_noreply = TRUE;
+      strcpy(run_req->rq_user, preq->rq_user);
+      strcpy(run_req->rq_host, preq->rq_host);
+      strcpy(run_req->rq_ind.rq_run.rq_jid, run.rq_jid);
+      run_req->rq_ind.rq_run.rq_resch = run.rq_resch;
+
+      if ((run.rq_destin != NULL) &&
+          (run.rq_destin[0] != '\0'))
+        run_req->rq_ind.rq_run.rq_destin = strdup(run.rq_destin);
+
+      /* req_runjob() always consumes run_req */
+      batch->codes[index] = req_runjob(run_req);
+      }
+
+    pthread_mutex_lock(&batch->mutex);
+    batch->active--;
+    pthread_cond_signal(&batch->done);
+    pthread_mutex_unlock(&batch->mutex);
+    }
+  } /* END run_batched_jobs() */
+
+
+
+void release_runjobs_batch(
+
+  runjobs_batch *batch)
+
+  {
+  bool last;
+
+  pthread_mutex_lock(&batch->mutex);
+  last = (--batch->refs == 0);
+  pthread_mutex_unlock(&batch->mutex);
+
+  if (last == true)
+    {
+    pthread_mutex_destroy(&batch->mutex);
+    pthread_cond_destroy(&batch->done);
+    delete batch;
+    }
+  } /* END release_runjobs_batch() */
+
+
+
+void *run_batched_jobs_task(
+
+  void *vp)
+
+  {
+  runjobs_batch *batch = (runjobs_batch *)vp;
+
+  run_batched_jobs(batch);
+  release_runjobs_batch(batch);
+
+  return(NULL);
+  } /* END run_batched_jobs_task() */
+
+
+
+/*
+ * build_runjobs_reply()
+ *
+ * @param preq - the RunJobs request
+ * @param codes - the result of each of its jobs
+ * @param reply - set to one "<jobid> <code>" line per job, in request order
+ */
+
+void build_runjobs_reply(
+
+  batch_request    *preq,
+  std::vector<int> &codes,
+  std::string      &reply)
+
+  {
+  char buf[32];
+
+  reply.clear();
+
+  for (int i = 0; i < preq->rq_ind.rq_runjobs.rq_count; i++)
+    {
+    snprintf(buf, sizeof(buf), " %d\n", codes[i]);
+    reply += preq->rq_ind.rq_runjobs.rq_jobs[i].rq_jid;
+    reply += buf;
+    }
+  } /* END build_runjobs_reply() */
+
+
+
+/*
+ * req_runjobs - service the Run Jobs Request
+ *
+ * Starts each job in the request the way a Run Job request would, several at
+ * a time on the request pool with this thread helping, and replies once with
+ * the result for every job. A scheduler starting many jobs in a cycle pays
+ * for one round trip instead of one per job.
+ */
+
+int req_runjobs(
+
+  batch_request *preq)  /* I (freed) */
+
+  {
+  runjobs_batch *batch;
+  int            count = preq->rq_ind.rq_runjobs.rq_count;
+  int            helpers;
+  std::string    reply;
+
+  if (count <= 0)
+    {
+    req_reject(PBSE_IVALREQ, 0, preq, NULL, "no jobs to run");
+    return(PBSE_IVALREQ);
+    }
+
+  batch = new runjobs_batch();
+  batch->preq = preq;
+  batch->codes.assign(count, PBSE_NONE);
+  batch->next = 0;
+  batch->active = 0;
+  batch->refs = 1;
+  pthread_mutex_init(&batch->mutex, NULL);
+  pthread_cond_init(&batch->done, NULL);
+
+  helpers = count - 1;
+
+  if (helpers > RUNJOBS_MAX_HELPERS)
+    helpers = RUNJOBS_MAX_HELPERS;
+
+  for (int i = 0; i < helpers; i++)
+    {
+    pthread_mutex_lock(&batch->mutex);
+    batch->refs++;
+    pthread_mutex_unlock(&batch->mutex);
+
+    if (enqueue_threadpool_request(run_batched_jobs_task, batch, request_pool) != PBSE_NONE)
+      {
+      pthread_mutex_lock(&batch->mutex);
+      batch->refs--;
+      pthread_mutex_unlock(&batch->mutex);
+      break;
+      }
+    }
+
+  /* this thread runs jobs too, so a busy pool only means fewer at a time */
+  run_batched_jobs(batch);
+
+  pthread_mutex_lock(&batch->mutex);
+
+  while (batch->active > 0)
+    pthread_cond_wait(&batch->done, &batch->mutex);
+
+  pthread_mutex_unlock(&batch->mutex);
+
+  build_runjobs_reply(preq, batch->codes, reply);
+
+  release_runjobs_batch(batch);
+
+  reply_text(preq, PBSE_NONE, reply.c_str());
+
+  return(PBSE_NONE);
+  }  /* END req_runjobs() */
+
+
+
 /*
  * is_checkpoint_restart - Is this the restart of a checkpoint job
  */
@@ -449,7 +670,7 @@ void post_checkpointsend(
         {
         pwait->at_val.at_long = time_now + PBS_STAGEFAIL_WAIT;
 
-        pwait->at_flags |= ATR_VFLAG_SET;
+        pwait->at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
         job_set_wait(pwait, pjob, 0);
         }
@@ -604,9 +825,9 @@ int req_stagein(
   else
     setneednodes = 0;
 
-  if ((pjob = chk_job_torun(preq, setneednodes)) == NULL)
+  if ((pjob = chk_job_torun(preq, setneednodes, rc)) == NULL)
     {
-    return(PBSE_UNKJOBID);
+    return(rc);
     }
 
   if ((pjob->ji_wattr[JOB_ATR_stagein].at_flags & ATR_VFLAG_SET) == 0)
@@ -680,7 +901,7 @@ void post_stagein(
         {
         pwait->at_val.at_long = time_now + PBS_STAGEFAIL_WAIT;
 
-        pwait->at_flags |= ATR_VFLAG_SET;
+        pwait->at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
         job_set_wait(pwait, pjob, 0);
         }
@@ -1390,13 +1611,13 @@ int svr_strtjob2(
   if ((pjob->ji_wattr[JOB_ATR_restart_name].at_flags & ATR_VFLAG_SET) == 0)
     {
     pattr->at_val.at_long = time(NULL);
-    pattr->at_flags |= ATR_VFLAG_SET;
+    pattr->at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     }
 
   pattr = &pjob->ji_wattr[JOB_ATR_start_count];
 
   pattr->at_val.at_long++;
-  pattr->at_flags |= ATR_VFLAG_SET;
+  pattr->at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
   /* This marks the start of total run time from the server's perspective */
   pattr = &pjob->ji_wattr[JOB_ATR_total_runtime];
@@ -1492,7 +1713,7 @@ void finish_sendmom(
       if ((pjob->ji_wattr[JOB_ATR_restart_name].at_flags & ATR_VFLAG_SET) == 0)
         {
         pjob->ji_wattr[JOB_ATR_start_time].at_val.at_long = time(NULL);
-        pjob->ji_wattr[JOB_ATR_start_time].at_flags |= ATR_VFLAG_SET;
+        pjob->ji_wattr[JOB_ATR_start_time].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
         }
       
       /* accounting log for start or restart */
@@ -1628,20 +1849,21 @@ void finish_sendmom(
 /*
  * chk_job_torun - check state and past execution host of a job for which
  * files are about to be staged in or for a job that is about to be run.
- *  Returns pointer to job if all is ok, else returns NULL.
+ *  Returns pointer to job if all is ok, else returns NULL and sets rc to the
+ *  code the request was rejected with.
  */
 
 job *chk_job_torun(
 
   batch_request *preq,  /* I */
-  int            setnn) /* I */
+  int            setnn, /* I */
+  int           &rc)    /* O */
 
   {
   job              *pjob;
 
   struct rq_runjob *prun;
   pbs_queue        *pque;
-  int               rc;
 
   char              EMsg[1024];
   char              FailHost[1024];
@@ -1650,7 +1872,7 @@ job *chk_job_torun(
 
   prun = &preq->rq_ind.rq_run;
 
-  if ((pjob = chk_job_request(prun->rq_jid, preq)) == 0)
+  if ((pjob = chk_job_request(prun->rq_jid, preq, rc)) == 0)
     {
     /* FAILURE */
 
@@ -1666,7 +1888,8 @@ job *chk_job_torun(
       (pjob->ji_qs.ji_substate == JOB_SUBSTATE_RUNNING))
     {
     /* FAILURE - job already started */
-    req_reject(PBSE_BADSTATE, 0, preq, NULL, "job already running");
+    rc = PBSE_BADSTATE;
+    req_reject(rc, 0, preq, NULL, "job already running");
 
     return(NULL);
     }
@@ -1676,7 +1899,8 @@ job *chk_job_torun(
     if (pjob->ji_qs.ji_substate == JOB_SUBSTATE_STAGEIN)
       {
       /* FAILURE */
-      req_reject(PBSE_BADSTATE, 0, preq, NULL, NULL);
+      rc = PBSE_BADSTATE;
+      req_reject(rc, 0, preq, NULL, NULL);
 
       return(NULL);
       }
@@ -1685,7 +1909,8 @@ job *chk_job_torun(
   if ((pjob->ji_qs.ji_state != JOB_STATE_QUEUED) && (pjob->ji_qs.ji_state != JOB_STATE_HELD))
     {
     sprintf(EMsg, "job %s state %s", pjob->ji_qs.ji_jobid, PJobState[pjob->ji_qs.ji_state]);
-    req_reject(PBSE_BADSTATE, 0, preq, NULL, EMsg);
+    rc = PBSE_BADSTATE;
+    req_reject(rc, 0, preq, NULL, EMsg);
     return(NULL);
     }
 
@@ -1693,7 +1918,8 @@ job *chk_job_torun(
   if ((preq->rq_perm & (ATR_DFLAG_MGWR | ATR_DFLAG_OPWR)) == 0)
     {
     /* FAILURE - run request not authorized */
-    req_reject(PBSE_PERM, 0, preq, NULL, NULL);
+    rc = PBSE_PERM;
+    req_reject(rc, 0, preq, NULL, NULL);
 
     return(NULL);
     }
@@ -1711,7 +1937,8 @@ job *chk_job_torun(
         snprintf(EMsg, sizeof(EMsg), "attempt to start job in non-execution queue");
       log_err(-1, __func__, EMsg);
   
-      req_reject(PBSE_IVALREQ, 0, preq, NULL, EMsg);
+      rc = PBSE_IVALREQ;
+      req_reject(rc, 0, preq, NULL, EMsg);
   
       return(NULL);
       }
@@ -1719,7 +1946,8 @@ job *chk_job_torun(
   else if (pjob == NULL)
     {
     job_mutex.set_unlock_on_exit(false);
-    req_reject(PBSE_JOBNOTFOUND, 0, preq, NULL, "job vanished while trying to lock queue.");
+    rc = PBSE_JOBNOTFOUND;
+    req_reject(rc, 0, preq, NULL, "job vanished while trying to lock queue.");
     return(NULL);
     }
 
@@ -1739,14 +1967,16 @@ job *chk_job_torun(
       /* this can happen if running the job failed after stagein */
       if (pjob->ji_wattr[JOB_ATR_exec_host].at_val.at_str == NULL)
         {
-        req_reject(PBSE_EXECTHERE, 0, preq, NULL, "exec host not set but files staged in");
+        rc = PBSE_EXECTHERE;
+        req_reject(rc, 0, preq, NULL, "exec host not set but files staged in");
         return(NULL);
         }
 
       /* specified destination must match exec_host */
       if ((exec_host = strdup(pjob->ji_wattr[JOB_ATR_exec_host].at_val.at_str)) == NULL)
         {
-        req_reject(PBSE_RMSYSTEM, 0, preq, NULL, "Cannot allocate memory");
+        rc = PBSE_RMSYSTEM;
+        req_reject(rc, 0, preq, NULL, "Cannot allocate memory");
         return(NULL);
         }
 
@@ -1758,10 +1988,12 @@ job *chk_job_torun(
         /* FAILURE */
         free(exec_host);
 
+        rc = PBSE_EXECTHERE;
+
         if (pjob->ji_qs.ji_svrflags & (JOB_SVFLG_CHECKPOINT_FILE))
-          req_reject(PBSE_EXECTHERE, 0, preq, NULL, "allocated nodes must match checkpoint location");
+          req_reject(rc, 0, preq, NULL, "allocated nodes must match checkpoint location");
         else
-          req_reject(PBSE_EXECTHERE, 0, preq, NULL, "allocated nodes must match input file stagein location");
+          req_reject(rc, 0, preq, NULL, "allocated nodes must match input file stagein location");
         
         return(NULL);
         }
@@ -1780,7 +2012,8 @@ job *chk_job_torun(
                   FailHost,
                   EMsg)) != 0)   /* O */
         {
-        req_reject(PBSE_EXECTHERE, 0, preq, FailHost, EMsg);
+        rc = PBSE_EXECTHERE;
+        req_reject(rc, 0, preq, FailHost, EMsg);
         
         return(NULL);
         }
@@ -1855,6 +2088,7 @@ job *chk_job_torun(
               SET) == 0)
           {
           JRes->rs_value.at_flags |= ATR_VFLAG_SET;
+          Attr->at_flags |= ATR_VFLAG_MODIFY;
           }
         }
       }
@@ -4,9 +4,15 @@
 
 #include "pbs_job.h" /* job */
 #include "batch_request.h" /* batch_request */
+#include <string>
+#include <vector>
 
 int req_runjob(struct batch_request *preq);
 
+int req_runjobs(struct batch_request *preq);
+
+void build_runjobs_reply(struct batch_request *preq, std::vector<int> &codes, std::string &reply);
+
 /* static int is_checkpoint_restart(job *pjob); */
 
 /* static void post_checkpointsend(struct work_task *pwt); */
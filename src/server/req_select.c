@@ -589,6 +589,8 @@ static int select_job(
       }
     else
       {
+      pjob->hydrate_attr(psel->sl_atindx);
+
       if (!sel_attr(&pjob->ji_wattr[psel->sl_atindx], psel))
         {
         /* no match */
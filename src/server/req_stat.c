@@ -122,6 +122,7 @@
 #include "unistd.h"
 #include "log.h"
 #include "job_func.h"
+#include "status_generation.hpp"
 
 /* Global Data Items: */
 
@@ -151,6 +152,7 @@ extern void rel_resc(job*);
 
 static void update_state_ct(pbs_attribute *, int *, char *);
 static int  status_que(pbs_queue *, struct batch_request *, tlist_head *);
+static int  status_server(struct batch_request *, tlist_head *, int *);
 int         status_node(struct pbsnode *, struct batch_request *, int *, tlist_head *);
 static void req_stat_job_step2(struct stat_cntl *);
 
@@ -175,6 +177,136 @@ enum TJobStatTypeEnum
 
 
 
+/*
+ * add_marker_attr()
+ *
+ * @param phead - the attribute list of a status entry
+ * @param attr_name - the marker's name
+ * @param value - the marker's value
+ * @return PBSE_NONE or PBSE_SYSTEM if we're out of memory
+ */
+
+int add_marker_attr(
+
+  tlist_head *phead,
+  const char *attr_name,
+  const char *value)
+
+  {
+  svrattrl *pal;
+
+  if ((pal = attrlist_create(attr_name, NULL, strlen(value) + 1)) == NULL)
+    return(PBSE_SYSTEM);
+
+  strcpy(pal->al_value, value);
+  append_link(phead, &pal->al_link, pal);
+
+  return(PBSE_NONE);
+  } /* END add_marker_attr() */
+
+
+
+/*
+ * add_status_marker()
+ *
+ * Appends an entry that holds a single attribute to a status reply. The
+ * reply to a delta status (see STATUS_SINCE) marks the new generation and
+ * the deleted objects this way.
+ *
+ * @param pstathd - the reply's list of statuses
+ * @param objtype - MGR_OBJ_SERVER, MGR_OBJ_JOB or MGR_OBJ_NODE
+ * @param objname - the name of the object the entry is for
+ * @param attr_name - the marker's name
+ * @param value - the marker's value
+ * @return the new entry, or NULL if we're out of memory
+ */
+
+struct brp_status *add_status_marker(
+
+  tlist_head *pstathd,
+  int         objtype,
+  const char *objname,
+  const char *attr_name,
+  const char *value)
+
+  {
+  struct brp_status *pstat;
+
+  if ((pstat = (struct brp_status *)calloc(1, sizeof(struct brp_status))) == NULL)
+    return(NULL);
+
+  CLEAR_LINK(pstat->brp_stlink);
+  pstat->brp_objtype = objtype;
+  snprintf(pstat->brp_objname, sizeof(pstat->brp_objname), "%s", objname);
+  CLEAR_HEAD(pstat->brp_attr);
+
+  if (add_marker_attr(&pstat->brp_attr, attr_name, value) != PBSE_NONE)
+    {
+    free(pstat);
+    return(NULL);
+    }
+
+  append_link(pstathd, &pstat->brp_stlink, pstat);
+
+  return(pstat);
+  } /* END add_status_marker() */
+
+
+
+/*
+ * start_delta_status()
+ *
+ * Begins the reply to a delta status with the server's current generation,
+ * which the client sends as its since next time, followed by the objects of
+ * kind deleted after since, and for a queue the jobs that left it after
+ * since. If those deletions are no longer known the
+ * entry for the server also carries ATTR_status_resync and the caller must
+ * report every object instead of only the changed ones.
+ *
+ * @param pstathd - the reply's list of statuses
+ * @param kind - STATUS_GEN_JOB or STATUS_GEN_NODE
+ * @param since - the generation the client sent
+ * @param queue - the name of the queue whose jobs are reported, or NULL
+ * @param resync - O: true if the client gets a full status
+ * @return PBSE_NONE or PBSE_SYSTEM if we're out of memory
+ */
+
+int start_delta_status(
+
+  tlist_head         *pstathd,
+  int                 kind,
+  unsigned long long  since,
+  const char         *queue,
+  bool               &resync)
+
+  {
+  std::vector<std::string>  deleted;
+  char                      gen_buf[32];
+  struct brp_status        *pstat;
+  int                       objtype = (kind == STATUS_GEN_JOB) ? MGR_OBJ_JOB : MGR_OBJ_NODE;
+
+  /* objects stamped while the reply is built are reported again next time */
+  snprintf(gen_buf, sizeof(gen_buf), "%llu", status_gen.current());
+
+  resync = (status_gen.deleted_since(kind, since, deleted, queue) == false);
+
+  if ((pstat = add_status_marker(pstathd, MGR_OBJ_SERVER, server_name, ATTR_status_generation, gen_buf)) == NULL)
+    return(PBSE_SYSTEM);
+
+  if (resync == true)
+    return(add_marker_attr(&pstat->brp_attr, ATTR_status_resync, "True"));
+
+  for (size_t i = 0; i < deleted.size(); i++)
+    {
+    if (add_status_marker(pstathd, objtype, deleted[i].c_str(), ATTR_status_deleted, "True") == NULL)
+      return(PBSE_SYSTEM);
+    }
+
+  return(PBSE_NONE);
+  } /* END start_delta_status() */
+
+
+
 /**
  * req_stat_job - service the Status Job Request
  *
@@ -252,7 +384,7 @@ int req_stat_job(
       {
       type = tjstJob;
 
-      if ((pjob = svr_find_job(name, FALSE)) == NULL)
+      if ((pjob = find_or_create_array_subjob(name)) == NULL)
         {
         rc = PBSE_UNKJOBID;
         }
@@ -528,6 +660,209 @@ job *get_next_status_job(
 
 
 
+/*
+ * add_array_id_status()
+ *
+ * Appends the job_array_id an array sub job with this index would report.
+ */
+
+void add_array_id_status(
+
+  int         index,
+  tlist_head *phead)
+
+  {
+  char      buf[32];
+  svrattrl *pattr;
+
+  snprintf(buf, sizeof(buf), "%d", index);
+
+  if ((pattr = attrlist_create(ATTR_array_id, NULL, strlen(buf) + 1)) == NULL)
+    return;
+
+  strcpy(pattr->al_value, buf);
+  append_link(phead, &pattr->al_link, pattr);
+  } /* END add_array_id_status() */
+
+
+
+/*
+ * copy_template_status_attr()
+ *
+ * Copies one attribute of an array template's status into the status of one of
+ * its uncreated sub jobs, adjusting the attributes that job_clone() changes.
+ *
+ * @param pal - the template's attribute
+ * @param index - the sub job's index
+ * @param phead - the sub job's attribute list to append to
+ */
+
+void copy_template_status_attr(
+
+  svrattrl   *pal,
+  int         index,
+  tlist_head *phead)
+
+  {
+  std::string  value;
+  svrattrl    *copy;
+
+  /* sub jobs carry their index in place of the array request */
+  if (!strcmp(pal->al_name, ATTR_t))
+    {
+    add_array_id_status(index, phead);
+    return;
+    }
+
+  if (pal->al_value != NULL)
+    value = pal->al_value;
+
+  if ((!strcmp(pal->al_name, ATTR_N)) ||
+      (!strcmp(pal->al_name, ATTR_o)) ||
+      (!strcmp(pal->al_name, ATTR_e)))
+    {
+    char suffix[32];
+
+    snprintf(suffix, sizeof(suffix), "-%d", index);
+    value += suffix;
+    }
+  else if (!strcmp(pal->al_name, ATTR_v))
+    {
+    char arrayid[64];
+
+    snprintf(arrayid, sizeof(arrayid), ",PBS_ARRAYID=%d", index);
+    value += arrayid;
+    }
+  else if (!strcmp(pal->al_name, ATTR_state))
+    value = "Q";
+
+  copy = attrlist_create(pal->al_name, pal->al_resc, value.size() + 1);
+  strcpy(copy->al_value, value.c_str());
+  copy->al_flags = pal->al_flags;
+  append_link(phead, &copy->al_link, copy);
+  } /* END copy_template_status_attr() */
+
+
+
+/*
+ * status_uncreated_subjobs()
+ *
+ * Adds a status for each sub job of pa that hasn't been created. They aren't
+ * jobs yet, so their status is the template's status with the changes
+ * job_clone() would make.
+ *
+ * @param pa - the array, locked
+ * @param preq - the status request
+ * @param pal - the attributes requested, or NULL for all
+ * @param condensed - true if the status should be condensed
+ * @param bad - the index of a bad attribute, if any
+ * @return PBSE_NONE or the error from status_job()
+ */
+
+int status_uncreated_subjobs(
+
+  job_array     *pa,
+  batch_request *preq,
+  svrattrl      *pal,
+  bool           condensed,
+  int           *bad)
+
+  {
+  tlist_head          template_status;
+  struct brp_status  *ptemplate;
+  job                *template_job;
+  int                 rc;
+  char                id_prefix[PBS_MAXSVRJOBID + 1];
+  const char         *id_suffix;
+  char               *bracket;
+
+  if (pa->uncreated_ids.empty() == true)
+    return(PBSE_NONE);
+
+  if ((template_job = svr_find_job(pa->ai_qs.parent_id, FALSE)) == NULL)
+    return(PBSE_NONE);
+
+  CLEAR_HEAD(template_status);
+
+  rc = status_job(template_job, preq, pal, &template_status, condensed, bad);
+
+  unlock_ji_mutex(template_job, __func__, NULL, LOGLEVEL);
+
+  if ((ptemplate = (struct brp_status *)GET_NEXT(template_status)) == NULL)
+    return((rc == PBSE_PERM) ? PBSE_NONE : rc);
+
+  if (rc == PBSE_NONE)
+    {
+    bool has_array_request = false;
+    bool wants_array_id = false;
+
+    for (svrattrl *ptattr = (svrattrl *)GET_NEXT(ptemplate->brp_attr);
+         ptattr != NULL;
+         ptattr = (svrattrl *)GET_NEXT(ptattr->al_link))
+      {
+      if (!strcmp(ptattr->al_name, ATTR_t))
+        has_array_request = true;
+      }
+
+    for (svrattrl *preq_attr = pal; preq_attr != NULL; preq_attr = (svrattrl *)GET_NEXT(preq_attr->al_link))
+      {
+      if (!strcmp(preq_attr->al_name, ATTR_array_id))
+        wants_array_id = true;
+      }
+
+    // sub job ids are the array id with the index between the brackets
+    snprintf(id_prefix, sizeof(id_prefix), "%s", pa->ai_qs.parent_id);
+
+    if ((bracket = strchr(id_prefix, '[')) != NULL)
+      *bracket = '\0';
+
+    id_suffix = strchr(pa->ai_qs.parent_id, ']');
+    id_suffix = (id_suffix != NULL) ? id_suffix + 1 : "";
+
+    const std::deque<std::pair<int, int> > &ranges = pa->uncreated_ids.get_ranges();
+
+    for (size_t i = 0; i < ranges.size(); i++)
+      {
+      for (int index = ranges[i].first; index <= ranges[i].second; index++)
+        {
+        struct brp_status *pstat;
+
+        if ((pstat = (struct brp_status *)calloc(1, sizeof(struct brp_status))) == NULL)
+          {
+          rc = PBSE_SYSTEM;
+          break;
+          }
+
+        CLEAR_LINK(pstat->brp_stlink);
+        pstat->brp_objtype = MGR_OBJ_JOB;
+        snprintf(pstat->brp_objname, sizeof(pstat->brp_objname), "%s[%d]%s",
+          id_prefix, index, id_suffix);
+        CLEAR_HEAD(pstat->brp_attr);
+
+        for (svrattrl *ptattr = (svrattrl *)GET_NEXT(ptemplate->brp_attr);
+             ptattr != NULL;
+             ptattr = (svrattrl *)GET_NEXT(ptattr->al_link))
+          copy_template_status_attr(ptattr, index, &pstat->brp_attr);
+
+        /* the template has no job_array_id to copy if only that was asked for */
+        if ((has_array_request == false) &&
+            (wants_array_id == true))
+          add_array_id_status(index, &pstat->brp_attr);
+
+        append_link(&preq->rq_reply.brp_un.brp_status, &pstat->brp_stlink, pstat);
+        }
+      }
+    }
+
+  free_attrlist(&ptemplate->brp_attr);
+  delete_link(&ptemplate->brp_stlink);
+  free(ptemplate);
+
+  return(rc);
+  } /* END status_uncreated_subjobs() */
+
+
+
 /*
  * in_execution_queue()
  *
@@ -598,16 +933,22 @@ void req_stat_job_step2(
   bool                   exec_only = false;
 
   int                    bad = 0;
-  /* delta time - only report full pbs_attribute list if J->MTime > DTime */
+  /* delta status - only report jobs stamped after the client's generation */
+  bool                   delta = false;
+  unsigned long long     since = 0;
   int                    job_array_index = -1;
   job_array             *pa = NULL;
   all_jobs_iterator     *iter;
 
   if (preq->rq_extend != NULL)
     {
-    /* FORMAT:  { EXECQONLY } */
+    /* FORMAT:  { EXECQONLY } [since=<generation>] */
     if (strstr(preq->rq_extend, EXECQUEONLY))
       exec_only = true;
+
+    if ((type == tjstServer) ||
+        (type == tjstQueue))
+      delta = parse_status_since(preq->rq_extend, since);
     }
 
   if ((type == tjstTruncatedServer) || 
@@ -651,6 +992,21 @@ void req_stat_job_step2(
              (type == tjstSummarizeArraysServer))
       update_array_statuses();
 
+    if (delta == true)
+      {
+      bool        resync;
+      const char *queue = (type == tjstQueue) ? cntl->sc_pque->qu_qs.qu_name : NULL;
+
+      if ((rc = start_delta_status(&preply->brp_un.brp_status, STATUS_GEN_JOB, since, queue, resync)) != PBSE_NONE)
+        {
+        req_reject(rc, 0, preq, NULL, NULL);
+        return;
+        }
+
+      if (resync == true)
+        delta = false;
+      }
+
     iter = get_correct_status_iterator(cntl);
 
     for (pjob = get_next_status_job(cntl, job_array_index, pa, iter);
@@ -663,6 +1019,10 @@ void req_stat_job_step2(
       if (pjob->ji_being_recycled == true)
         continue;
 
+      if ((delta == true) &&
+          (pjob->ji_status_gen <= since))
+        continue;
+
       if (exec_only)
         {
         if (cntl->sc_pque != NULL)
@@ -694,6 +1054,15 @@ void req_stat_job_step2(
 
     if (pa != NULL)
       {
+      /* sub jobs that haven't been created are listed from the template */
+      if ((exec_only == false) &&
+          ((rc = status_uncreated_subjobs(pa, preq, pal, cntl->sc_condensed, &bad)) != PBSE_NONE))
+        {
+        unlock_ai_mutex(pa, __func__, "1", LOGLEVEL);
+        req_reject(rc, bad, preq, NULL, NULL);
+        return;
+        }
+
       unlock_ai_mutex(pa, __func__, "1", LOGLEVEL);
       }
    
@@ -1293,6 +1662,8 @@ int req_stat_node(
   int                   rc   = PBSE_NONE;
   int                   type = 0;
   int                   bad  = 0;
+  bool                  delta = false;
+  unsigned long long    since = 0;
 
   struct pbsnode       *pnode = NULL;
   struct batch_reply   *preply;
@@ -1375,6 +1746,19 @@ int req_stat_node(
 
     plist.push_back(props);
 
+    if (parse_status_since(preq->rq_extend, since) == true)
+      {
+      bool resync;
+
+      if ((rc = start_delta_status(&preply->brp_un.brp_status, STATUS_GEN_NODE, since, NULL, resync)) != PBSE_NONE)
+        {
+        req_reject(rc, 0, preq, NULL, NULL);
+        return(rc);
+        }
+
+      delta = (resync == false);
+      }
+
     while ((pnode = next_host(&allnodes,&iter,NULL)) != NULL)
       {
       if ((type == 2) && 
@@ -1384,6 +1768,17 @@ int req_stat_node(
         continue;
         }
 
+      /* numa boards and alps subnodes aren't stamped, so their nodes are
+       * always reported */
+      if ((delta == true) &&
+          (pnode->nd_status_gen <= since) &&
+          (pnode->num_node_boards == 0) &&
+          (pnode->nd_is_alps_reporter == FALSE))
+        {
+        pnode->unlock_node(__func__, "type != 0, unchanged", LOGLEVEL);
+        continue;
+        }
+
       /* get the status on all of the numa nodes */
       if (pnode->nd_is_alps_reporter == TRUE)
         rc = get_alps_statuses(pnode, preq, &bad, &preply->brp_un.brp_status);
@@ -1501,22 +1896,19 @@ int status_node(
 
 
 /*
- * req_stat_svr - service the Status Server Request
- *
- * This request processes the request for status of the Server
+ * status_server - Build the status reply for the server.
  */
 
-int req_stat_svr(
+static int status_server(
 
-  struct batch_request *preq) /* ptr to the decoded request */
+  struct batch_request *preq,
+  tlist_head           *pstathd,  /* head of list to append status to */
+  int                  *bad)      /* O */
 
   {
   svrattrl             *pal;
 
-  struct batch_reply   *preply;
-
   struct brp_status    *pstat;
-  int                   bad = 0;
   char                  nc_buf[128];
   int                   numjobs;
   int                   netrates[3];
@@ -1551,22 +1943,12 @@ int req_stat_svr(
     server.sv_attr[SRV_ATR_NetCounter].at_flags |= ATR_VFLAG_SET;
   pthread_mutex_unlock(server.sv_attr_mutex);
 
-  /* allocate a reply structure and a status sub-structure */
-
-  preply = &preq->rq_reply;
-  set_reply_type(preply, BATCH_REPLY_CHOICE_Status);
-
-  CLEAR_HEAD(preply->brp_un.brp_status);
+  /* allocate a status sub-structure */
 
   pstat = (struct brp_status *)calloc(1, sizeof(struct brp_status));
 
   if (pstat == NULL)
     {
-    reply_free(preply);
-
-    req_reject(PBSE_SYSTEM, 0, preq, NULL, NULL);
-    pthread_mutex_unlock(server.sv_attr_mutex);
-
     return(PBSE_SYSTEM);
     }
 
@@ -1578,7 +1960,7 @@ int req_stat_svr(
 
   CLEAR_HEAD(pstat->brp_attr);
 
-  append_link(&preply->brp_un.brp_status, &pstat->brp_stlink, pstat);
+  append_link(pstathd, &pstat->brp_stlink, pstat);
 
   /* add attributes to the status reply */
 
@@ -1592,20 +1974,269 @@ int req_stat_svr(
         preq->rq_perm,
         &pstat->brp_attr,
         false,
-        &bad,
+        bad,
         1))    /* IsOwner == TRUE */
     {
-    reply_badattr(PBSE_NOATTR, bad, pal, preq);
+    return(PBSE_NOATTR);
+    }
+
+  return(PBSE_NONE);
+  }  /* END status_server() */
+
+
+
+
+/*
+ * req_stat_svr - service the Status Server Request
+ *
+ * This request processes the request for status of the Server
+ */
+
+int req_stat_svr(
+
+  struct batch_request *preq) /* ptr to the decoded request */
+
+  {
+  struct batch_reply   *preply;
+  int                   bad = 0;
+  int                   rc;
+
+  /* allocate a reply structure and a status sub-structure */
+
+  preply = &preq->rq_reply;
+  set_reply_type(preply, BATCH_REPLY_CHOICE_Status);
+
+  CLEAR_HEAD(preply->brp_un.brp_status);
+
+  rc = status_server(preq, &preply->brp_un.brp_status, &bad);
+
+  if (rc == PBSE_SYSTEM)
+    {
+    reply_free(preply);
+
+    req_reject(PBSE_SYSTEM, 0, preq, NULL, NULL);
+
+    return(PBSE_SYSTEM);
+    }
+  else if (rc != PBSE_NONE)
+    {
+    reply_badattr(PBSE_NOATTR, bad, (svrattrl *)GET_NEXT(preq->rq_ind.rq_status.rq_attr), preq);
     }
   else
     {
     reply_send_svr(preq);
     }
-    
 
   return(PBSE_NONE);
   }  /* END req_stat_svr() */
 
+
+
+
+/*
+ * snapshot_queues - append the status of every queue the requestor may see
+ */
+
+static int snapshot_queues(
+
+  struct batch_request *preq,
+  tlist_head           *pstathd)
+
+  {
+  pbs_queue           *pque;
+  all_queues_iterator *iter;
+  int                  rc = PBSE_NONE;
+
+  svr_queues.lock();
+  iter = svr_queues.get_iterator();
+  svr_queues.unlock();
+
+  while ((pque = next_queue(&svr_queues, iter)) != NULL)
+    {
+    mutex_mgr pque_mutex = mutex_mgr(pque->qu_mutex, true);
+
+    if (((rc = status_que(pque, preq, pstathd)) != PBSE_NONE) &&
+        (rc != PBSE_PERM))
+      break;
+
+    rc = PBSE_NONE;
+    }
+
+  delete iter;
+
+  return(rc);
+  }  /* END snapshot_queues() */
+
+
+
+
+/*
+ * snapshot_jobs - append the status of every job the requestor may see
+ */
+
+static int snapshot_jobs(
+
+  struct batch_request *preq,
+  tlist_head           *pstathd,
+  int                  *bad)
+
+  {
+  svrattrl          *pal = (svrattrl *)GET_NEXT(preq->rq_ind.rq_status.rq_attr);
+  job               *pjob;
+  all_jobs_iterator *iter;
+  int                rc = PBSE_NONE;
+
+  alljobs.lock();
+  iter = alljobs.get_iterator();
+  alljobs.unlock();
+
+  while ((pjob = next_job(&alljobs, iter)) != NULL)
+    {
+    mutex_mgr job_mutex(pjob->ji_mutex, true);
+
+    if (pjob->ji_being_recycled == true)
+      continue;
+
+    if (((rc = status_job(pjob, preq, pal, pstathd, false, bad)) != PBSE_NONE) &&
+        (rc != PBSE_PERM))
+      break;
+
+    rc = PBSE_NONE;
+    }
+
+  delete iter;
+
+  return(rc);
+  }  /* END snapshot_jobs() */
+
+
+
+
+/*
+ * snapshot_nodes - append the status of every node, numa and alps sub-nodes
+ * included, as req_stat_node() does for ":ALL"
+ */
+
+static int snapshot_nodes(
+
+  struct batch_request *preq,
+  tlist_head           *pstathd,
+  int                  *bad)
+
+  {
+  struct pbsnode     *pnode;
+  all_nodes_iterator *iter = NULL;
+  int                 rc = PBSE_NONE;
+
+  if (svr_totnodes <= 0)
+    return(PBSE_NONE);
+
+  while ((pnode = next_host(&allnodes, &iter, NULL)) != NULL)
+    {
+    if (pnode->nd_is_alps_reporter == TRUE)
+      rc = get_alps_statuses(pnode, preq, bad, pstathd);
+    else
+      rc = get_numa_statuses(pnode, preq, bad, pstathd);
+
+    pnode->unlock_node(__func__, NULL, LOGLEVEL);
+
+    if (rc != PBSE_NONE)
+      break;
+    }
+
+  if (iter != NULL)
+    delete iter;
+
+  return(rc);
+  }  /* END snapshot_nodes() */
+
+
+
+
+/*
+ * req_stat_snapshot - service the Status Snapshot Request
+ *
+ * Returns the status of the server, its queues, jobs and nodes, in that
+ * order, in one reply so a scheduler sees the whole cluster at a single
+ * point of its cycle.  Every entry carries its object type.
+ */
+
+int req_stat_snapshot(
+
+  struct batch_request *preq)
+
+  {
+  struct batch_request *sub;
+  struct batch_reply   *preply = &preq->rq_reply;
+  tlist_head           *pstathd = &preply->brp_un.brp_status;
+  int                   rc = PBSE_NONE;
+  int                   bad = 0;
+  int                   i;
+
+  /* the status routines take the attribute list from rq_status, so each
+   * object type's list is lent to a status request with our credentials */
+  if ((sub = alloc_br(PBS_BATCH_StatusSvr)) == NULL)
+    {
+    req_reject(PBSE_SYSTEM, 0, preq, NULL, NULL);
+    return(PBSE_SYSTEM);
+    }
+
+  sub->rq_perm = preq->rq_perm;
+  sub->rq_fromsvr = preq->rq_fromsvr;
+  snprintf(sub->rq_user, sizeof(sub->rq_user), "%s", preq->rq_user);
+  snprintf(sub->rq_host, sizeof(sub->rq_host), "%s", preq->rq_host);
+  CLEAR_HEAD(sub->rq_ind.rq_status.rq_attr);
+
+  set_reply_type(preply, BATCH_REPLY_CHOICE_Status);
+
+  CLEAR_HEAD(preply->brp_un.brp_status);
+
+  for (i = 0; (i < SNAPSHOT_OBJ_COUNT) && (rc == PBSE_NONE); i++)
+    {
+    list_move(&preq->rq_ind.rq_snapshot.rq_attr[i], &sub->rq_ind.rq_status.rq_attr);
+
+    switch (i)
+      {
+      case SNAPSHOT_SERVER:
+
+        rc = status_server(sub, pstathd, &bad);
+        break;
+
+      case SNAPSHOT_QUEUE:
+
+        rc = snapshot_queues(sub, pstathd);
+        break;
+
+      case SNAPSHOT_JOB:
+
+        rc = snapshot_jobs(sub, pstathd, &bad);
+        break;
+
+      case SNAPSHOT_NODE:
+
+        rc = snapshot_nodes(sub, pstathd, &bad);
+        break;
+      }
+
+    list_move(&sub->rq_ind.rq_status.rq_attr, &preq->rq_ind.rq_snapshot.rq_attr[i]);
+    }
+
+  free_br(sub);
+
+  if (rc != PBSE_NONE)
+    {
+    reply_free(preply);
+
+    req_reject(rc, bad, preq, NULL, "status snapshot failed");
+    }
+  else
+    {
+    reply_send_svr(preq);
+    }
+
+  return(rc);
+  }  /* END req_stat_snapshot() */
+
 /* DIAGTODO: write req_stat_diag() */
 
 
@@ -29,6 +29,8 @@ int req_stat_node(struct batch_request *preq);
 
 int req_stat_svr(struct batch_request *preq);
 
+int req_stat_snapshot(struct batch_request *preq);
+
 /* static void update_state_ct(pbs_attribute *pattr, int *ct_array, char *buf); */
 
 #endif /* _REQ_STAT_H */
@@ -185,6 +185,15 @@ int status_job(
   /* add attributes to the status reply */
   *bad = 0;
 
+  /* decode anything recovery put off that the reply will include */
+  if (pal != NULL)
+    {
+    for (svrattrl *p = pal; p != NULL; p = (svrattrl *)GET_NEXT(p->al_link))
+      pjob->hydrate_attr(find_attr(job_attr_def, p->al_name, JOB_ATR_LAST));
+    }
+  else if (condensed == false)
+    pjob->hydrate_attrs();
+
   if (status_attrib(
         pal,
         job_attr_def,
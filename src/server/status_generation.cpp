@@ -0,0 +1,284 @@
+/*
+ * status_generation.cpp - the generation counter behind delta status
+ *
+ * qstat watchers, dashboards and schedulers poll the status of every job and
+ * node even though most of them haven't changed since the last poll. Jobs
+ * and nodes are now stamped with the next generation whenever they change,
+ * and deleted jobs and nodes are remembered with the generation they were
+ * deleted at, so req_stat_job() and req_stat_node() can answer "what changed
+ * since generation N" when the request's extension carries "since=<N>".
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "status_generation.hpp"
+#include "pbs_ifl.h"
+
+status_generation status_gen;
+
+
+
+status_generation::status_generation() : sg_current(((unsigned long long)time(NULL)) << 20),
+                                         sg_deleted_max(STATUS_GEN_DELETED_MAX)
+
+  {
+  for (int i = 0; i < STATUS_GEN_KINDS; i++)
+    this->sg_complete_since[i] = this->sg_current;
+
+  pthread_mutex_init(&this->sg_mutex, NULL);
+  }
+
+
+
+status_generation::status_generation(
+
+  unsigned long long start,
+  size_t             deleted_max) : sg_current(start), sg_deleted_max(deleted_max)
+
+  {
+  for (int i = 0; i < STATUS_GEN_KINDS; i++)
+    this->sg_complete_since[i] = this->sg_current;
+
+  pthread_mutex_init(&this->sg_mutex, NULL);
+  }
+
+
+
+status_generation::~status_generation()
+
+  {
+  pthread_mutex_destroy(&this->sg_mutex);
+  }
+
+
+
+/*
+ * next()
+ *
+ * @return a generation newer than every generation handed out before
+ */
+
+unsigned long long status_generation::next()
+
+  {
+  unsigned long long gen;
+
+  pthread_mutex_lock(&this->sg_mutex);
+  gen = ++this->sg_current;
+  pthread_mutex_unlock(&this->sg_mutex);
+
+  return(gen);
+  } /* END next() */
+
+
+
+/*
+ * current()
+ *
+ * @return the newest generation handed out. Every object stamped after this
+ * call gets a newer generation.
+ */
+
+unsigned long long status_generation::current()
+
+  {
+  unsigned long long gen;
+
+  pthread_mutex_lock(&this->sg_mutex);
+  gen = this->sg_current;
+  pthread_mutex_unlock(&this->sg_mutex);
+
+  return(gen);
+  } /* END current() */
+
+
+
+/*
+ * record_removal()
+ *
+ * Adds a removal to the history of its kind, forgetting the oldest one if the
+ * history is full.
+ *
+ * @param kind - STATUS_GEN_JOB or STATUS_GEN_NODE
+ * @param name - the job id or node name
+ * @param queue - the queue a job left, or NULL if the object was deleted
+ */
+
+void status_generation::record_removal(
+
+  int         kind,
+  const char *name,
+  const char *queue)
+
+  {
+  removal r;
+
+  if ((kind < 0) ||
+      (kind >= STATUS_GEN_KINDS) ||
+      (name == NULL))
+    return;
+
+  r.name = name;
+
+  if (queue != NULL)
+    r.queue = queue;
+
+  pthread_mutex_lock(&this->sg_mutex);
+
+  std::deque<removal> &deleted = this->sg_deleted[kind];
+
+  r.gen = ++this->sg_current;
+  deleted.push_back(r);
+
+  while (deleted.size() > this->sg_deleted_max)
+    {
+    /* a client that saw this removal's generation missed nothing */
+    this->sg_complete_since[kind] = deleted.front().gen;
+    deleted.pop_front();
+    }
+
+  pthread_mutex_unlock(&this->sg_mutex);
+  } /* END record_removal() */
+
+
+
+/*
+ * record_deleted()
+ *
+ * Remembers that the object called name was deleted
+ *
+ * @param kind - STATUS_GEN_JOB or STATUS_GEN_NODE
+ * @param name - the job id or node name
+ */
+
+void status_generation::record_deleted(
+
+  int         kind,
+  const char *name)
+
+  {
+  this->record_removal(kind, name, NULL);
+  } /* END record_deleted() */
+
+
+
+/*
+ * record_dequeued()
+ *
+ * Remembers that a job left queue, so that a delta status of that queue
+ * reports it as removed. A status of every job doesn't.
+ *
+ * @param job_id - the job's id
+ * @param queue - the name of the queue it left
+ */
+
+void status_generation::record_dequeued(
+
+  const char *job_id,
+  const char *queue)
+
+  {
+  if (queue == NULL)
+    return;
+
+  this->record_removal(STATUS_GEN_JOB, job_id, queue);
+  } /* END record_dequeued() */
+
+
+
+/*
+ * deleted_since()
+ *
+ * @param kind - STATUS_GEN_JOB or STATUS_GEN_NODE
+ * @param since - the generation the client last saw
+ * @param names - O: the objects of this kind deleted after since, plus the
+ *                jobs that left queue after since if queue isn't NULL
+ * @param queue - the queue being reported, or NULL for every object
+ * @return false if deletions after since were forgotten or happened before a
+ * restart, meaning the client has to resync from a full status
+ */
+
+bool status_generation::deleted_since(
+
+  int                       kind,
+  unsigned long long        since,
+  std::vector<std::string> &names,
+  const char               *queue)
+
+  {
+  bool                  complete;
+  std::set<std::string> seen;
+
+  if ((kind < 0) ||
+      (kind >= STATUS_GEN_KINDS))
+    return(false);
+
+  pthread_mutex_lock(&this->sg_mutex);
+
+  complete = (since >= this->sg_complete_since[kind]) &&
+             (since <= this->sg_current);
+
+  if (complete == true)
+    {
+    std::deque<removal> &deleted = this->sg_deleted[kind];
+
+    /* the history is in generation order, so walk back from the newest */
+    for (size_t i = deleted.size(); (i > 0) && (deleted[i - 1].gen > since); i--)
+      {
+      removal &r = deleted[i - 1];
+
+      if ((r.queue.size() != 0) &&
+          ((queue == NULL) ||
+           (r.queue != queue)))
+        continue;
+
+      /* a deleted job also left its queue, report it once */
+      if (seen.insert(r.name).second == true)
+        names.push_back(r.name);
+      }
+    }
+
+  pthread_mutex_unlock(&this->sg_mutex);
+
+  return(complete);
+  } /* END deleted_since() */
+
+
+
+/*
+ * parse_status_since()
+ *
+ * Finds STATUS_SINCE in a status request's extension, which may also hold
+ * other options such as EXECQUEONLY.
+ *
+ * @param extend - the request's extension, may be NULL
+ * @param since - O: the generation the client last saw
+ * @return true if the extension asks for a delta status
+ */
+
+bool parse_status_since(
+
+  const char         *extend,
+  unsigned long long &since)
+
+  {
+  const char *ptr;
+
+  if ((extend == NULL) ||
+      ((ptr = strstr(extend, STATUS_SINCE)) == NULL))
+    return(false);
+
+  ptr += strlen(STATUS_SINCE);
+
+  if ((*ptr < '0') ||
+      (*ptr > '9'))
+    return(false);
+
+  since = strtoull(ptr, NULL, 10);
+
+  return(true);
+  } /* END parse_status_since() */
@@ -1651,4 +1651,56 @@ attribute_def svr_attr_def[] =
    PARENT_TYPE_SERVER
   },
 
+  // SRV_ATR_JobJournal
+  {(char *)ATTR_job_journal, // "job_journal"
+   decode_b,
+   encode_b,
+   set_b,
+   comp_b,
+   free_null,
+   NULL_FUNC,
+   MGR_ONLY_SET,
+   ATR_TYPE_BOOL,
+   PARENT_TYPE_SERVER
+  },
+
+  // SRV_ATR_JobWriterThreads
+  {(char *)ATTR_job_writer_threads, // "job_writer_threads"
+   decode_l,
+   encode_l,
+   set_l,
+   comp_l,
+   free_null,
+   NULL_FUNC,
+   MGR_ONLY_SET,
+   ATR_TYPE_LONG,
+   PARENT_TYPE_SERVER
+  },
+
+  // SRV_ATR_JobBinaryRecords
+  {(char *)ATTR_job_binary_records, // "job_binary_records"
+   decode_b,
+   encode_b,
+   set_b,
+   comp_b,
+   free_null,
+   NULL_FUNC,
+   MGR_ONLY_SET,
+   ATR_TYPE_BOOL,
+   PARENT_TYPE_SERVER
+  },
+
+  // SRV_ATR_NodeSelectThreads
+  {(char *)ATTR_node_select_threads, // "node_select_threads"
+   decode_l,
+   encode_l,
+   set_l,
+   comp_l,
+   free_null,
+   NULL_FUNC,
+   MGR_ONLY_SET,
+   ATR_TYPE_LONG,
+   PARENT_TYPE_SERVER
+  },
+
   };
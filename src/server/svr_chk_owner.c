@@ -101,6 +101,7 @@
 #include "net_cache.h"
 #include "../lib/Libnet/lib_net.h"
 #include "ji_mutex.h"
+#include "array.h"
 
 /* Global Data */
 
@@ -564,7 +565,16 @@ int authenticate_user(
 
 
 
-void chk_job_req_permissions(
+/*
+ * check_job_req_permissions()
+ *
+ * Rejects the request and sets *pjob_ptr to NULL if it isn't authorized or the
+ * job has already completed.
+ *
+ * @return PBSE_NONE if the request may go ahead, else the code it was rejected with
+ */
+
+int check_job_req_permissions(
 
   job                  **pjob_ptr, /* M */
   struct batch_request  *preq) /* I */
@@ -573,6 +583,7 @@ void chk_job_req_permissions(
   job  *pjob = *pjob_ptr;
   char  tmpLine[MAXLINE];
   char  log_buf[LOCAL_LOG_BUF_SIZE];
+  int   rc = PBSE_NONE;
 
   if (svr_authorize_jobreq(preq, pjob) == -1)
     {
@@ -585,7 +596,9 @@ void chk_job_req_permissions(
 
     log_event(PBSEVENT_SECURITY,PBS_EVENTCLASS_JOB,pjob->ji_qs.ji_jobid,log_buf);
 
-    req_reject(PBSE_PERM, 0, preq, NULL, "operation not permitted");
+    rc = PBSE_PERM;
+
+    req_reject(rc, 0, preq, NULL, "operation not permitted");
 
     unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
 
@@ -618,7 +631,9 @@ void chk_job_req_permissions(
           "invalid state for job - %s",
           PJobState[pjob->ji_qs.ji_state]);
 
-        req_reject(PBSE_BADSTATE, 0, preq, NULL, tmpLine);
+        rc = PBSE_BADSTATE;
+
+        req_reject(rc, 0, preq, NULL, tmpLine);
 
         unlock_ji_mutex(pjob, __func__, "2", LOGLEVEL);
 
@@ -628,13 +643,82 @@ void chk_job_req_permissions(
       }  /* END switch (preq->rq_type) */
     }    /* END if (pjob->ji_qs.ji_state >= JOB_STATE_EXITING) */
 
-  /* SUCCESS - request is valid */
+  return(rc);
+  } /* END check_job_req_permissions() */
+
+
+
+void chk_job_req_permissions(
+
+  job                  **pjob_ptr, /* M */
+  struct batch_request  *preq) /* I */
+
+  {
+  check_job_req_permissions(pjob_ptr, preq);
   } /* END chk_job_req_permissions() */
 
 
 
 
 
+/*
+ * chk_uncreated_subjob_permissions()
+ *
+ * Checks a request against the template of the array that jobid belongs to,
+ * for a sub job that doesn't exist yet. Rejects the request if it isn't
+ * authorized.
+ *
+ * @param jobid - the id of the sub job
+ * @param preq - the request
+ * @return PBSE_NONE if the request may go ahead (or jobid isn't an array
+ * sub job), PBSE_PERM if it was rejected
+ */
+
+int chk_uncreated_subjob_permissions(
+
+  char                 *jobid,
+  struct batch_request *preq)
+
+  {
+  job  *ptemplate;
+  char  array_id[PBS_MAXSVRJOBID + 1];
+  char  log_buf[LOCAL_LOG_BUF_SIZE];
+  int   rc = PBSE_NONE;
+
+  if (strchr(jobid, '[') == NULL)
+    return(PBSE_NONE);
+
+  array_get_parent_id(jobid, array_id);
+
+  if ((ptemplate = svr_find_job(array_id, FALSE)) == NULL)
+    return(PBSE_NONE);
+
+  if (svr_authorize_jobreq(preq, ptemplate) == -1)
+    {
+    sprintf(log_buf, msg_permlog,
+      preq->rq_type,
+      "Job",
+      jobid,
+      preq->rq_user,
+      preq->rq_host);
+
+    log_event(PBSEVENT_SECURITY,PBS_EVENTCLASS_JOB,jobid,log_buf);
+
+    rc = PBSE_PERM;
+    }
+
+  unlock_ji_mutex(ptemplate, __func__, NULL, LOGLEVEL);
+
+  if (rc != PBSE_NONE)
+    req_reject(rc, 0, preq, NULL, "operation not permitted");
+
+  return(rc);
+  } /* END chk_uncreated_subjob_permissions() */
+
+
+
+
+
 /*
  * chk_job_request - check legality of a request against a job
  *
@@ -646,12 +730,25 @@ void chk_job_req_permissions(
 job *chk_job_request(
 
   char                 *jobid,  /* I */
-  struct batch_request *preq)   /* I */
+  struct batch_request *preq,   /* I */
+  int                  &rc)     /* O - the code the request was rejected with */
 
   {
   job *pjob = NULL;
 
+  rc = PBSE_NONE;
+
   if ((pjob = svr_find_job(jobid, FALSE)) == NULL)
+    {
+    /* array sub jobs that haven't been created yet are created on demand, but
+     * only once the request has passed the array's own permission check */
+    if ((rc = chk_uncreated_subjob_permissions(jobid, preq)) != PBSE_NONE)
+      return(NULL);
+
+    pjob = find_or_create_array_subjob(jobid);
+    }
+
+  if (pjob == NULL)
     {
     log_event(
       PBSEVENT_DEBUG,
@@ -659,16 +756,31 @@ job *chk_job_request(
       jobid,
       pbse_to_txt(PBSE_UNKJOBID));
 
-    req_reject(PBSE_UNKJOBID, 0, preq, NULL, "cannot locate job");
+    rc = PBSE_UNKJOBID;
+
+    req_reject(rc, 0, preq, NULL, "cannot locate job");
 
     return(NULL);
     }
 
-  /* if we aren't authorized, pjob will be set to NULL in chk_job_req_permissions */
-  chk_job_req_permissions(&pjob,preq);
+  /* if we aren't authorized, pjob will be set to NULL in check_job_req_permissions */
+  rc = check_job_req_permissions(&pjob, preq);
 
   return(pjob);
   }  /* END chk_job_request() */
 
 
 
+job *chk_job_request(
+
+  char                 *jobid,  /* I */
+  struct batch_request *preq)   /* I */
+
+  {
+  int rc;
+
+  return(chk_job_request(jobid, preq, rc));
+  }  /* END chk_job_request() */
+
+
+
@@ -18,8 +18,14 @@ int svr_get_privilege(char *user, char *host);
 
 int authenticate_user(struct batch_request *preq, struct credential *pcred, char **autherr);
 
+int check_job_req_permissions(job **pjob_ptr, struct batch_request *preq);
+
 void chk_job_req_permissions(job **pjob_ptr, struct batch_request *preq);
 
+int chk_uncreated_subjob_permissions(char *jobid, struct batch_request *preq);
+
 job *chk_job_request(char *jobid, struct batch_request *preq);
 
+job *chk_job_request(char *jobid, struct batch_request *preq, int &rc);
+
 #endif /* _SVR_CHK_OWNER_H */
@@ -152,6 +152,7 @@
 #include "utils.h"
 #include "pbs_nodes.h"
 #include "policy_values.h"
+#include "status_generation.hpp"
 
 #include "user_info.h" /* remove_server_suffix() */
 
@@ -303,6 +304,15 @@ const char *PJobSubState[] =
 
 
 
+/*
+ * insert_into_alljobs_by_rank()
+ *
+ * Inserts pjob into aj ordered by queue rank. The container keeps an index
+ * of its jobs' ranks, so no other job needs to be locked or compared.
+ *
+ * @return PBSE_NONE, ALREADY_IN_LIST if the job is already in aj, or -1
+ */
+
 int insert_into_alljobs_by_rank(
 
   all_jobs         *aj,
@@ -310,64 +320,13 @@ int insert_into_alljobs_by_rank(
   char            *jobid)
 
   {
-  job  *pjcur;
-  aj->lock();
-  all_jobs_iterator  *iter = aj->get_iterator(true);
-  long  job_qrank = pjob->ji_wattr[JOB_ATR_qrank].at_val.at_long;
-  std::string curJobid = "";
-  
-  unlock_ji_mutex(pjob, __func__, "4", LOGLEVEL);
-
-  while ((pjcur = iter->get_next_item()) != NULL)
-    {
-    mutex_mgr pjcur_mgr(pjcur->ji_mutex, true);
-    if (job_qrank > pjcur->ji_wattr[JOB_ATR_qrank].at_val.at_long)
-      {
-      pjcur_mgr.set_unlock_on_exit(false);
-      break;
-      }
-    
-    if (strcmp(jobid, pjcur->ji_qs.ji_jobid) == 0)
-      {
-      delete iter;
-
-      aj->unlock();
-      return(ALREADY_IN_LIST);
-      }
-    }
-
-  delete iter;
-
-  if (pjcur != NULL)
-    {
-    if (aj->find(pjcur->ji_qs.ji_jobid))
-      {
-      curJobid = pjcur->ji_qs.ji_jobid;
-      }
-    unlock_ji_mutex(pjcur, __func__, "8", LOGLEVEL);
-    pjcur = NULL;
-    }
-  aj->unlock();
-
-  if ((pjob = svr_find_job(jobid, FALSE)) == NULL)
-    {
-    return(PBSE_JOBNOTFOUND);
-    }
+  int rc;
 
   aj->lock();
-  if (curJobid.length() == 0)
-    {
-    /* link first in list */
-    aj->insert_first(pjob,pjob->ji_qs.ji_jobid);
-    }
-  else
-    {
-    /* link after 'current' job in list */
-    aj->insert_after(curJobid, pjob,pjob->ji_qs.ji_jobid);
-    }
+  rc = aj->insert_by_rank(pjob, jobid, pjob->ji_wattr[JOB_ATR_qrank].at_val.at_long);
   aj->unlock();
 
-  return(PBSE_NONE);
+  return(rc);
   } /* END insert_into_alljobs_by_rank() */
 
 
@@ -553,13 +512,10 @@ int svr_enquejob(
     {
     rc = insert_into_alljobs_by_rank(pque->qu_jobs, pjob, job_id);
 
-    if ((rc == ALREADY_IN_LIST) ||
-        (rc == PBSE_JOBNOTFOUND))
+    if (rc != PBSE_NONE)
       {
       if (rc == ALREADY_IN_LIST)
-        {
         rc = PBSE_NONE;
-        }
 
       return(rc);
       }
@@ -584,8 +540,7 @@ int svr_enquejob(
     {
     rc = insert_into_alljobs_by_rank(pque->qu_jobs_array_sum, pjob, job_id);
 
-    if ((rc == ALREADY_IN_LIST) ||
-        (rc == PBSE_JOBNOTFOUND))
+    if (rc != PBSE_NONE)
       {
       if (rc == ALREADY_IN_LIST)
         rc = PBSE_NONE;
@@ -606,14 +561,14 @@ int svr_enquejob(
   pjob->ji_wattr[JOB_ATR_queuetype].at_val.at_char =
     *pque->qu_attr[QA_ATR_QType].at_val.at_str;
 
-  pjob->ji_wattr[JOB_ATR_queuetype].at_flags |= ATR_VFLAG_SET;
+  pjob->ji_wattr[JOB_ATR_queuetype].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
   // The array template isn't a real job so it shouldn't have a queued accounting record.
   if (((pjob->ji_wattr[JOB_ATR_qtime].at_flags & ATR_VFLAG_SET) == 0) &&
       (!pjob->ji_is_array_template))
     {
     pjob->ji_wattr[JOB_ATR_qtime].at_val.at_long = time_now;
-    pjob->ji_wattr[JOB_ATR_qtime].at_flags |= ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_qtime].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
     /* issue enqueued accounting record */
 
@@ -677,7 +632,7 @@ int svr_enquejob(
         (pjob->ji_qs.ji_state == JOB_STATE_QUEUED))
       {
       pjob->ji_wattr[JOB_ATR_etime].at_val.at_long = time_now;
-      pjob->ji_wattr[JOB_ATR_etime].at_flags |= ATR_VFLAG_SET;
+      pjob->ji_wattr[JOB_ATR_etime].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
       }
       
     /* notify the scheduler we have a new job */
@@ -824,11 +779,15 @@ int svr_dequejob(
 
     pjob->ji_qhdr = NULL;
 
+    /* a delta status of this queue reports the job as removed */
+    pjob->ji_status_gen = status_gen.next();
+    status_gen.record_dequeued(jobid.c_str(), pque->qu_qs.qu_name);
+
     if (parent_queue_mutex_held == FALSE)
       unlock_queue(pque, __func__, NULL, LOGLEVEL);
     }
 
-  pjob->ji_wattr[JOB_ATR_qtime].at_flags &= ~ATR_VFLAG_SET;
+  pjob->ji_wattr[JOB_ATR_qtime].at_flags = (pjob->ji_wattr[JOB_ATR_qtime].at_flags & ~ATR_VFLAG_SET) | ATR_VFLAG_MODIFY;
 
   /* clear any default resource values.  */
 
@@ -997,6 +956,7 @@ void set_jobstate_basic(
   pjob.ji_qs.ji_substate = newsubstate;
 
   pjob.ji_wattr[JOB_ATR_substate].at_val.at_long = newsubstate;
+  pjob.ji_status_gen = status_gen.next();
 
   set_statechar(&pjob);
   } /* END set_jobstate_basic() */
@@ -1259,13 +1219,15 @@ int svr_setjobstate(
             if ((pjob->ji_wattr[JOB_ATR_etime].at_flags & ATR_VFLAG_SET) == 0)
               {
               pjob->ji_wattr[JOB_ATR_etime].at_val.at_long = time_now;
-              pjob->ji_wattr[JOB_ATR_etime].at_flags |= ATR_VFLAG_SET;
+              pjob->ji_wattr[JOB_ATR_etime].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
               }
             }
           else if ((newstate == JOB_STATE_HELD) ||
                    (newstate == JOB_STATE_WAITING))
             {
             /* on hold or wait, clear etime */
+            if (pjob->ji_wattr[JOB_ATR_etime].at_flags & ATR_VFLAG_SET)
+              pjob->ji_modified = 1;
 
             job_attr_def[JOB_ATR_etime].at_free(
               &pjob->ji_wattr[JOB_ATR_etime]);
@@ -1396,6 +1358,8 @@ char *get_variable(
   {
   char *pc;
 
+  pjob->hydrate_attr(JOB_ATR_variables);
+
   pc = arst_string(
          variable,
          &pjob->ji_wattr[JOB_ATR_variables]);
@@ -3469,6 +3433,7 @@ int add_required_features(
       if (features->rs_value.at_val.at_str != NULL)
         free(features->rs_value.at_val.at_str);
       features->rs_value.at_val.at_str = output_features;
+      pjob->ji_wattr[JOB_ATR_resource].at_flags |= ATR_VFLAG_MODIFY;
       }
     else
       {
@@ -3497,7 +3462,7 @@ int add_required_features(
       {
       char *new_prop = strdup(pque->qu_attr[QA_ATR_ReqLoginProperty].at_val.at_str);
       pjob->ji_wattr[JOB_ATR_login_prop].at_val.at_str = new_prop;
-      pjob->ji_wattr[JOB_ATR_login_prop].at_flags |= ATR_VFLAG_SET;
+      pjob->ji_wattr[JOB_ATR_login_prop].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
       }
 
     }
@@ -678,10 +678,12 @@ void encode_attributes(
   {
   pbs_attribute *pattr = pjob->ji_wattr;
 
+  pjob->hydrate_attrs();
+
   if (cpy_stdout_err_on_rerun)
     {
     pjob->ji_wattr[JOB_ATR_copystd_on_rerun].at_val.at_long = 1;
-    pjob->ji_wattr[JOB_ATR_copystd_on_rerun].at_flags = ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_copystd_on_rerun].at_flags = ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     }  
   else
     {
@@ -900,7 +902,7 @@ int save_jobs_sid(
   if ((pjob = svr_find_job(job_id, TRUE)) != NULL)
     {
     pjob->ji_wattr[JOB_ATR_session_id].at_val.at_long = sid;
-    pjob->ji_wattr[JOB_ATR_session_id].at_flags |= ATR_VFLAG_SET;
+    pjob->ji_wattr[JOB_ATR_session_id].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
     unlock_ji_mutex(pjob, __func__, "6", LOGLEVEL);
     }
   else
@@ -1028,8 +1030,8 @@ int get_mom_node_version(
   if (pnode == NULL)
     return(PBSE_UNKNODE);
 
-  mutex_mgr node_mutex(&pnode->nd_mutex, true);
   version = pnode->get_version();
+  pnode->unlock_node(__func__, NULL, LOGLEVEL);
 
   return(PBSE_NONE);
   }
@@ -25,6 +25,12 @@ void PBSD_FreeReply(struct batch_reply *reply)
   exit(1);
   }
 
+void pbs_freesnapshot(struct batch_snapshot *snap)
+  {
+  fprintf(stderr, "The call to pbs_freesnapshot needs to be mocked!!\n");
+  exit(1);
+  }
+
 int PBSD_status_put(int c, int function, char *id, struct attrl *attrib, char *extend)
   {
   fprintf(stderr, "The call to PBSD_status_put needs to be mocked!!\n");
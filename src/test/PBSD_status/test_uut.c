@@ -22,6 +22,51 @@ START_TEST(test_PBSD_status_get)
   }
 END_TEST
 
+START_TEST(test_split_snapshot_status)
+  {
+  struct brp_cmdstat    stats[5];
+  struct batch_snapshot snap;
+  int                   types[] = { MGR_OBJ_SERVER, MGR_OBJ_QUEUE, MGR_OBJ_JOB, MGR_OBJ_JOB, MGR_OBJ_NODE };
+  const char           *names[] = { "napali", "batch", "1.napali", "2.napali", "node1" };
+
+  memset(stats, 0, sizeof(stats));
+  memset(&snap, 0, sizeof(snap));
+
+  for (int i = 0; i < 5; i++)
+    {
+    stats[i].brp_objtype = types[i];
+    strcpy(stats[i].brp_objname, names[i]);
+    stats[i].brp_attrl = (struct attrl *)calloc(1, sizeof(struct attrl));
+    if (i < 4)
+      stats[i].brp_stlink = &stats[i + 1];
+    }
+
+  fail_unless(split_snapshot_status(stats, &snap) == PBSE_NONE);
+
+  fail_unless(snap.server != NULL);
+  fail_unless(!strcmp(snap.server->name, "napali"));
+  fail_unless(snap.server->next == NULL);
+  fail_unless(!strcmp(snap.queues->name, "batch"));
+  fail_unless(snap.queues->next == NULL);
+  fail_unless(!strcmp(snap.jobs->name, "1.napali"));
+  fail_unless(!strcmp(snap.jobs->next->name, "2.napali"));
+  fail_unless(snap.jobs->next->next == NULL);
+  fail_unless(!strcmp(snap.nodes->name, "node1"));
+  fail_unless(snap.nodes->next == NULL);
+
+  // the attribute lists now belong to the batch_status entries
+  fail_unless(stats[2].brp_attrl == NULL);
+  fail_unless(snap.jobs->attribs != NULL);
+
+  // an object type the snapshot doesn't know about is a protocol error
+  memset(&snap, 0, sizeof(snap));
+  stats[0].brp_objtype = MGR_OBJ_NONE;
+  stats[0].brp_stlink = NULL;
+  fail_unless(split_snapshot_status(stats, &snap) == PBSE_PROTOCOL);
+  fail_unless(snap.server == NULL);
+  }
+END_TEST
+
 Suite *PBSD_status_suite(void)
   {
   Suite *s = suite_create("PBSD_status_suite methods");
@@ -31,6 +76,7 @@ Suite *PBSD_status_suite(void)
 
   tc_core = tcase_create("test_PBSD_status_get");
   tcase_add_test(tc_core, test_PBSD_status_get);
+  tcase_add_test(tc_core, test_split_snapshot_status);
   suite_add_tcase(s, tc_core);
 
   return s;
@@ -298,16 +298,6 @@ batch_request *duplicate_request(batch_request *preq, int job_index)
   return NULL;
   }
 
-int lock_ss()
-    {
-    return(0);
-    }
-
-int unlock_ss()
-    {
-    return(0);
-    }
-
 std::string get_path_jobdata(const char *a, const char *b) {return ""; }
 
 job::job() {}
@@ -12,6 +12,7 @@ int array_request_token_count(const char *);
 int array_request_parse_token(char *, int *, int *);
 int num_array_jobs(const char *str);
 int array_recov_binary(const char *path, job_array **new_pa, char *log_buf, size_t buflen);
+int array_recov_counters(job_array *pa, const char *path);
 int parse_array_dom(job_array **pa, xmlNodePtr root_element, char *log_buf, size_t buflen);
 void update_array_values(job_array *pa, int old_state, enum ArrayEventsEnum event, const char *job_id, long job_atr_hold, int job_exit_status);
 void release_slot_hold(job *pjob, int &difference);
@@ -301,6 +302,58 @@ START_TEST(array_recov_binary_test)
 END_TEST
 
 
+START_TEST(array_save_counters_test)
+  {
+  job_array *pa = new job_array();
+  job_array *recovered = new job_array();
+  char       path[256];
+  FILE      *fp;
+
+  strcpy(pa->ai_qs.fileprefix, "counters");
+  strcpy(pa->ai_qs.parent_id, "2.roshar");
+  pa->ai_qs.jobs_running = 3;
+  pa->ai_qs.jobs_done = 40;
+  pa->ai_qs.num_started = 43;
+  pa->ai_qs.num_failed = 1;
+  pa->ai_qs.num_successful = 39;
+  pa->ai_qs.num_idle = 7;
+  pa->ai_qs.highest_id_created = 49;
+
+  snprintf(path, sizeof(path), "%s%s", pa->ai_qs.fileprefix, ARRAY_COUNTERS_SUFFIX);
+  unlink(path);
+
+  fail_unless(array_recov_counters(recovered, path) == -1);
+
+  fail_unless(array_save_counters(pa) == PBSE_NONE);
+  fail_unless(array_recov_counters(recovered, path) == PBSE_NONE);
+  fail_unless(recovered->ai_qs.jobs_running == 3);
+  fail_unless(recovered->ai_qs.jobs_done == 40);
+  fail_unless(recovered->ai_qs.num_started == 43);
+  fail_unless(recovered->ai_qs.num_failed == 1);
+  fail_unless(recovered->ai_qs.num_successful == 39);
+  fail_unless(recovered->ai_qs.num_idle == 7);
+  fail_unless(recovered->ai_qs.highest_id_created == 49);
+
+  // rewritten in place
+  pa->ai_qs.jobs_done = 41;
+  fail_unless(array_save_counters(pa) == PBSE_NONE);
+  fail_unless(array_recov_counters(recovered, path) == PBSE_NONE);
+  fail_unless(recovered->ai_qs.jobs_done == 41);
+
+  // a damaged record is ignored
+  fp = fopen(path, "r+");
+  fseek(fp, offsetof(array_counters_record, ac_jobs_done), SEEK_SET);
+  fputc(0x7f, fp);
+  fclose(fp);
+  recovered->ai_qs.jobs_done = 0;
+  fail_unless(array_recov_counters(recovered, path) == -1);
+  fail_unless(recovered->ai_qs.jobs_done == 0);
+
+  unlink(path);
+  }
+END_TEST
+
+
 
 
 Suite *array_func_suite(void)
@@ -342,6 +395,10 @@ Suite *array_func_suite(void)
   tcase_add_test(tc_core, update_slot_values_test);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("array_save_counters_test");
+  tcase_add_test(tc_core, array_save_counters_test);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
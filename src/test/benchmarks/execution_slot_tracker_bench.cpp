@@ -0,0 +1,244 @@
+#include "license_pbs.h" /* See here for the software license */
+/*
+ * execution_slot_tracker_bench - compares execution_slot_tracker with the
+ * std::vector<bool> tracker it replaced on the operations node placement and
+ * freeing use: reserving slots for a job, walking the job's slots, and giving
+ * them back.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+#include "execution_slot_tracker.hpp"
+#include "pbs_error.h"
+
+
+/*
+ * The tracker as it was before it moved to 64-bit words, reduced to what's
+ * measured here.
+ */
+
+class vector_bool_tracker
+  {
+  std::vector<bool> slots;
+  int               open_count;
+
+  public:
+  vector_bool_tracker() : slots(), open_count(0) {}
+
+  vector_bool_tracker(int size) : slots(size, false), open_count(size) {}
+
+  int get_number_free() const
+    {
+    return(this->open_count);
+    }
+
+  int mark_as_used(int index)
+    {
+    if ((index < 0) ||
+        (index >= (int)this->slots.size()))
+      return(OUT_OF_RANGE);
+
+    if (this->slots[index] == false)
+      {
+      this->slots[index] = true;
+      this->open_count--;
+      }
+
+    return(PBSE_NONE);
+    }
+
+  int mark_as_free(int index)
+    {
+    if ((index < 0) ||
+        (index >= (int)this->slots.size()))
+      return(OUT_OF_RANGE);
+
+    if (this->slots[index] == true)
+      {
+      this->slots[index] = false;
+      this->open_count++;
+      }
+
+    return(PBSE_NONE);
+    }
+
+  int reserve_execution_slots(int num_slots_to_reserve, vector_bool_tracker &est)
+    {
+    int reserved_so_far = 0;
+
+    if (this->open_count < num_slots_to_reserve)
+      return(INSUFFICIENT_FREE_EXECUTION_SLOTS);
+
+    while (est.slots.size() < this->slots.size())
+      {
+      est.slots.push_back(false);
+      est.open_count++;
+      }
+
+    for (int i = 0; i < (int)this->slots.size() && reserved_so_far < num_slots_to_reserve; i++)
+      {
+      if (this->slots[i] == false)
+        {
+        reserved_so_far++;
+        this->mark_as_used(i);
+        est.mark_as_used(i);
+        }
+      }
+
+    return(PBSE_NONE);
+    }
+
+  int unreserve_execution_slots(const vector_bool_tracker &subset)
+    {
+    if (this->slots.size() < subset.slots.size())
+      return(SUBSET_TOO_LARGE);
+
+    for (int i = 0; i < (int)subset.slots.size(); i++)
+      {
+      if (subset.slots[i] == true)
+        this->mark_as_free(i);
+      }
+
+    return(PBSE_NONE);
+    }
+
+  int get_next_occupied_index(int &iterator) const
+    {
+    int occupied_index = -1;
+
+    if (iterator == -1)
+      iterator = 0;
+
+    while (iterator < (int)this->slots.size())
+      {
+      if (this->slots[iterator] == true)
+        {
+        occupied_index = iterator;
+        iterator++;
+        break;
+        }
+      else
+        iterator++;
+      }
+
+    return(occupied_index);
+    }
+  };
+
+
+
+double elapsed_ns(
+
+  const struct timespec &start,
+  const struct timespec &end)
+
+  {
+  return(((end.tv_sec - start.tv_sec) * 1e9) + (end.tv_nsec - start.tv_nsec));
+  }
+
+
+
+/*
+ * place_and_free()
+ *
+ * Fills a node with jobs of ppn slots each, walking each job's slots the way
+ * place_subnodes_in_hostlist() does, then frees every job the way
+ * free_nodes() does. Half of the node is occupied by a long running job
+ * scattered across the slots, so free slots have to be searched for.
+ *
+ * @return the average time for one job's reserve, walk and free in ns
+ */
+
+template <class tracker>
+double place_and_free(
+
+  int node_slots,
+  int ppn,
+  int rounds)
+
+  {
+  struct timespec      start;
+  struct timespec      end;
+  tracker              node(node_slots);
+  std::vector<tracker> jobs;
+  long                 checksum = 0;
+  long                 ops = 0;
+
+  for (int i = 0; i < node_slots; i += 2)
+    node.mark_as_used(i);
+
+  jobs.reserve(node_slots);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  for (int r = 0; r < rounds; r++)
+    {
+    jobs.clear();
+
+    while (node.get_number_free() >= ppn)
+      {
+      tracker est;
+      int     iter = -1;
+      int     index;
+
+      node.reserve_execution_slots(ppn, est);
+
+      while ((index = est.get_next_occupied_index(iter)) != -1)
+        checksum += index;
+
+      jobs.push_back(est);
+      ops++;
+      }
+
+    for (size_t j = 0; j < jobs.size(); j++)
+      node.unreserve_execution_slots(jobs[j]);
+    }
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  /* keep the walk from being optimized away */
+  if (checksum == -1)
+    printf("%ld\n", checksum);
+
+  return(elapsed_ns(start, end) / ops);
+  } /* END place_and_free() */
+
+
+
+int main(
+
+  int   argc,
+  char *argv[])
+
+  {
+  static const int node_sizes[] = { 32, 256, 1024 };
+  static const int ppns[] = { 1, 8, 64 };
+  int              rounds = 2000;
+
+  if (argc > 1)
+    rounds = atoi(argv[1]);
+
+  printf("%-10s %-6s %16s %16s %8s\n", "slots", "ppn", "vector<bool> ns", "bitmap ns", "speedup");
+
+  for (size_t n = 0; n < sizeof(node_sizes) / sizeof(node_sizes[0]); n++)
+    {
+    for (size_t p = 0; p < sizeof(ppns) / sizeof(ppns[0]); p++)
+      {
+      if (ppns[p] > node_sizes[n] / 2)
+        continue;
+
+      /* fewer rounds for the bigger nodes, each round places more jobs */
+      int    node_rounds = rounds * 32 / node_sizes[n];
+      double old_ns = place_and_free<vector_bool_tracker>(node_sizes[n], ppns[p], node_rounds);
+      double new_ns = place_and_free<execution_slot_tracker>(node_sizes[n], ppns[p], node_rounds);
+
+      printf("%-10d %-6d %16.1f %16.1f %7.1fx\n",
+        node_sizes[n], ppns[p], old_ns, new_ns, old_ns / new_ns);
+      }
+    }
+
+  return(0);
+  } /* END main() */
@@ -0,0 +1,178 @@
+#include "license_pbs.h" /* See here for the software license */
+/*
+ * placement_bench - places single task jobs on a two socket node the way
+ * Machine::place_job() does, asking each socket how many tasks fit before
+ * placing on it, until the node is full, then frees every job. It's run for
+ * each kind of placement and reports the time spent asking whether the tasks
+ * fit separately from the time spent placing and freeing them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include "machine.hpp"
+#include "req.hpp"
+#include "allocation.hpp"
+
+
+struct placement_case
+  {
+  const char *name;
+  const char *thread_usage;
+  const char *placement;
+  };
+
+
+
+double elapsed_ns(
+
+  const struct timespec &start,
+  const struct timespec &end)
+
+  {
+  return(((end.tv_sec - start.tv_sec) * 1e9) + (end.tv_nsec - start.tv_nsec));
+  }
+
+
+
+/*
+ * fill_and_free()
+ *
+ * @param cores_per_socket - the size of each of the node's two sockets
+ * @param pc - how the jobs ask to be placed
+ * @param rounds - how many times to fill and empty the node
+ * @param fit_ns - O: the average time to find a socket the task fits on
+ * @param place_ns - O: the average time to place and free a task
+ */
+
+void fill_and_free(
+
+  int                   cores_per_socket,
+  const placement_case &pc,
+  int                   rounds,
+  double               &fit_ns,
+  double               &place_ns)
+
+  {
+  std::vector<Socket>      sockets;
+  std::vector<std::string> jobids;
+  struct timespec          start;
+  struct timespec          end;
+  double                   fit_total = 0;
+  double                   place_total = 0;
+  long                     tasks = 0;
+  int                      remainder = 0;
+  req                      r;
+
+  for (int i = 0; i < 2; i++)
+    sockets.push_back(Socket(cores_per_socket, 1, remainder));
+
+  r.set_value("lprocs", "1", false);
+  r.set_value("thread_usage_policy", pc.thread_usage, false);
+
+  if (*pc.placement != '\0')
+    r.set_value("placement_type", pc.placement, false);
+
+  for (int round = 0; round < rounds; round++)
+    {
+    jobids.clear();
+
+    while (true)
+      {
+      char       jobid[32];
+      allocation a;
+      int        placed_on = -1;
+
+      snprintf(jobid, sizeof(jobid), "%d.bench", (int)jobids.size());
+      a.jobid = jobid;
+      a.set_place_type(r.getPlacementType());
+
+      clock_gettime(CLOCK_MONOTONIC, &start);
+
+      for (unsigned int s = 0; s < sockets.size(); s++)
+        {
+        if (sockets[s].how_many_tasks_fit(r, a.place_type) >= 1)
+          {
+          placed_on = s;
+          break;
+          }
+        }
+
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      fit_total += elapsed_ns(start, end);
+
+      if (placed_on == -1)
+        break;
+
+      clock_gettime(CLOCK_MONOTONIC, &start);
+
+      if (sockets[placed_on].place_task(r, a, 1, "bench") == 0)
+        break;
+
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      place_total += elapsed_ns(start, end);
+
+      jobids.push_back(jobid);
+      tasks++;
+      }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (size_t j = 0; j < jobids.size(); j++)
+      {
+      for (unsigned int s = 0; s < sockets.size(); s++)
+        sockets[s].free_task(jobids[j].c_str());
+      }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    place_total += elapsed_ns(start, end);
+    }
+
+  fit_ns = (tasks > 0) ? fit_total / tasks : 0;
+  place_ns = (tasks > 0) ? place_total / tasks : 0;
+  } /* END fill_and_free() */
+
+
+
+int main(
+
+  int   argc,
+  char *argv[])
+
+  {
+  static const int            socket_sizes[] = { 8, 32, 64 };
+  static const placement_case cases[] =
+    {
+    { "cores", "usecores", "" },
+    { "threads", "usethreads", "" },
+    { "legacy", "allowthreads", "legacy" },
+    { "legacy2", "allowthreads", "legacy2" },
+    { "place=core", "allowthreads", "core=1" },
+    { "place=thread", "allowthreads", "thread=1" }
+    };
+  int                         rounds = 20;
+
+  if (argc > 1)
+    rounds = atoi(argv[1]);
+
+  printf("%-14s %-8s %12s %14s\n", "placement", "cores", "fit ns/task", "place ns/task");
+
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+    {
+    for (size_t s = 0; s < sizeof(socket_sizes) / sizeof(socket_sizes[0]); s++)
+      {
+      double fit_ns;
+      double place_ns;
+
+      fill_and_free(socket_sizes[s], cases[c], rounds, fit_ns, place_ns);
+
+      printf("%-14s %-8d %12.1f %14.1f\n",
+        cases[c].name, socket_sizes[s] * 2, fit_ns, place_ns);
+      }
+    }
+
+  return(0);
+  } /* END main() */
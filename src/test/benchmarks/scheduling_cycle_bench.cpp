@@ -0,0 +1,587 @@
+#include "license_pbs.h" /* See here for the software license */
+/*
+ * scheduling_cycle_bench - runs the fifo scheduler's scheduling cycle
+ * against a synthetic cluster and reports how long each phase takes:
+ * querying the server, sorting (init_scheduling_cycle()), checking which jobs
+ * can run, and running them.
+ *
+ * The IFL calls the scheduler makes are stubbed. The status snapshot hands
+ * back a fresh copy of the same seeded population of nodes, queues and jobs
+ * every cycle, and the time spent building it is taken out of the query
+ * phase. Running, altering and deleting jobs always succeed.
+ *
+ * usage: scheduling_cycle_bench [nodes [jobs [cycles]]]
+ *
+ * The default cluster is small enough for make bench. Checking jobs grows
+ * faster than linearly with fair share and backfilling on, so a cluster the
+ * size of a big site's, 10000 nodes and 200000 jobs, takes minutes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <limits.h>
+
+#include "pbs_ifl.h"
+#include "pbs_error.h"
+#include "rm.h"
+#include "sched_cmds.h"
+#include "data_types.h"
+#include "globals.h"
+#include "fifo.h"
+#include "lib_ifl.h"
+
+char path_acct[_POSIX_PATH_MAX];
+int  pbs_rm_port = 15003;
+
+/* the size of the cluster the snapshot describes */
+static int    num_nodes = 2000;
+static int    num_jobs = 40000;
+
+static const int num_queues = 4;
+static const int num_users = 2000;
+static const int num_groups = 50;
+static const int cpus_per_node = 16;
+
+/* time spent building snapshots, which isn't the scheduler's */
+static double snapshot_secs;
+
+
+
+double elapsed_secs(
+
+  const struct timespec &start,
+  const struct timespec &end)
+
+  {
+  return((end.tv_sec - start.tv_sec) + ((end.tv_nsec - start.tv_nsec) / 1e9));
+  }
+
+
+
+/*
+ * next_random()
+ *
+ * A small xorshift generator, so every snapshot gets the same population.
+ */
+
+static unsigned int next_random(
+
+  unsigned int &seed)
+
+  {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+
+  return(seed);
+  } /* END next_random() */
+
+
+
+static struct attrl *add_attr(
+
+  struct attrl *next,
+  const char   *name,
+  const char   *resource,
+  const char   *value)
+
+  {
+  struct attrl *attr = (struct attrl *)calloc(1, sizeof(struct attrl));
+
+  attr->next = next;
+  attr->name = strdup(name);
+  attr->resource = (resource != NULL) ? strdup(resource) : NULL;
+  attr->value = strdup(value);
+  attr->op = SET;
+
+  return(attr);
+  } /* END add_attr() */
+
+
+
+static struct batch_status *add_status(
+
+  struct batch_status *next,
+  const char          *name,
+  struct attrl        *attribs)
+
+  {
+  struct batch_status *bs = (struct batch_status *)calloc(1, sizeof(struct batch_status));
+
+  bs->next = next;
+  bs->name = strdup(name);
+  bs->attribs = attribs;
+
+  return(bs);
+  } /* END add_status() */
+
+
+
+/*
+ * make_jobs()
+ *
+ * About a tenth of the jobs run, until half of the nodes are busy, and a
+ * twentieth are held. The rest are queued. Users belong to one group each.
+ *
+ * @param cpus_used - O: the cpus the running jobs have
+ * @param nodes_used - O: the nodes the running jobs have
+ * @return the jobs, last one first
+ */
+
+static struct batch_status *make_jobs(
+
+  long &cpus_used,
+  long &nodes_used)
+
+  {
+  static const char   *walltimes[] = { "00:10:00", "01:00:00", "04:00:00", "12:00:00", "48:00:00" };
+  static const int     ncpus[] = { 1, 1, 2, 4, 8, 16 };
+  struct batch_status *jobs = NULL;
+  unsigned int         seed = 2463534242U;
+  char                 buf[64];
+
+  cpus_used = 0;
+  nodes_used = 0;
+
+  for (int i = 0; i < num_jobs; i++)
+    {
+    struct attrl *attrs = NULL;
+    unsigned int  r = next_random(seed);
+    int           user = r % num_users;
+    int           cpus = ncpus[(r >> 12) % 6];
+    const char   *walltime = walltimes[(r >> 16) % 5];
+    const char   *state = "Q";
+
+    if ((r % 10 == 0) &&
+        (nodes_used < num_nodes / 2))
+      state = "R";
+    else if (r % 20 == 1)
+      state = "H";
+
+    snprintf(buf, sizeof(buf), "queue%d", (r >> 8) % num_queues);
+    attrs = add_attr(attrs, ATTR_q, NULL, buf);
+    snprintf(buf, sizeof(buf), "%d", (int)((r >> 4) % 100));
+    attrs = add_attr(attrs, ATTR_p, NULL, buf);
+    snprintf(buf, sizeof(buf), "%d", 1000000000 + i);
+    attrs = add_attr(attrs, ATTR_qtime, NULL, buf);
+    attrs = add_attr(attrs, ATTR_state, NULL, state);
+    snprintf(buf, sizeof(buf), "usr%d", user);
+    attrs = add_attr(attrs, ATTR_euser, NULL, buf);
+    snprintf(buf, sizeof(buf), "grp%d", user % num_groups);
+    attrs = add_attr(attrs, ATTR_egroup, NULL, buf);
+    snprintf(buf, sizeof(buf), "%d", cpus);
+    attrs = add_attr(attrs, ATTR_l, "ncpus", buf);
+    snprintf(buf, sizeof(buf), "%dgb", cpus * 2);
+    attrs = add_attr(attrs, ATTR_l, "mem", buf);
+    attrs = add_attr(attrs, ATTR_l, "nodect", "1");
+    attrs = add_attr(attrs, ATTR_l, "walltime", walltime);
+    attrs = add_attr(attrs, ATTR_l, "cput", walltime);
+
+    if (*state == 'R')
+      {
+      snprintf(buf, sizeof(buf), "node%ld", nodes_used);
+      attrs = add_attr(attrs, ATTR_exechost, NULL, buf);
+      attrs = add_attr(attrs, ATTR_used, "walltime", "00:05:00");
+      attrs = add_attr(attrs, ATTR_used, "cput", "00:05:00");
+
+      cpus_used += cpus;
+      nodes_used++;
+      }
+
+    snprintf(buf, sizeof(buf), "%d.server", i);
+    jobs = add_status(jobs, buf, attrs);
+    }
+
+  return(jobs);
+  } /* END make_jobs() */
+
+
+
+static struct batch_status *make_nodes()
+
+  {
+  struct batch_status *nodes = NULL;
+  char                 buf[256];
+
+  for (int i = 0; i < num_nodes; i++)
+    {
+    struct attrl *attrs = NULL;
+
+    attrs = add_attr(attrs, ATTR_NODE_state, NULL, "free");
+    attrs = add_attr(attrs, ATTR_NODE_ntype, NULL, "cluster");
+    attrs = add_attr(attrs, ATTR_NODE_properties, NULL, "batch");
+    snprintf(buf, sizeof(buf),
+      "arch=x86_64,ncpus=%d,physmem=67108864kb,loadave=%.2f,max_load=%d.00,ideal_load=%d.00",
+      cpus_per_node, (i % 17) / 2.0, cpus_per_node, cpus_per_node - 2);
+    attrs = add_attr(attrs, ATTR_NODE_status, NULL, buf);
+
+    snprintf(buf, sizeof(buf), "node%d", i);
+    nodes = add_status(nodes, buf, attrs);
+    }
+
+  return(nodes);
+  } /* END make_nodes() */
+
+
+
+static struct batch_status *make_queues()
+
+  {
+  struct batch_status *queues = NULL;
+  char                 buf[64];
+
+  for (int i = num_queues - 1; i >= 0; i--)
+    {
+    struct attrl *attrs = NULL;
+
+    attrs = add_attr(attrs, ATTR_qtype, NULL, "Execution");
+    attrs = add_attr(attrs, ATTR_start, NULL, "True");
+    snprintf(buf, sizeof(buf), "%d", (num_queues - i) * 10);
+    attrs = add_attr(attrs, ATTR_p, NULL, buf);
+    attrs = add_attr(attrs, ATTR_maxuserrun, NULL, "200");
+
+    snprintf(buf, sizeof(buf), "queue%d", i);
+    queues = add_status(queues, buf, attrs);
+    }
+
+  return(queues);
+  } /* END make_queues() */
+
+
+
+static struct batch_status *make_server(
+
+  long cpus_used,
+  long nodes_used)
+
+  {
+  struct attrl *attrs = NULL;
+  char          buf[64];
+
+  attrs = add_attr(attrs, ATTR_dfltque, NULL, "queue0");
+  attrs = add_attr(attrs, ATTR_maxgrprun, NULL, "5000");
+  snprintf(buf, sizeof(buf), "%ld", (long)num_nodes * cpus_per_node);
+  attrs = add_attr(attrs, ATTR_rescavail, "ncpus", buf);
+  snprintf(buf, sizeof(buf), "%ldgb", (long)num_nodes * 64);
+  attrs = add_attr(attrs, ATTR_rescavail, "mem", buf);
+  snprintf(buf, sizeof(buf), "%d", num_nodes);
+  attrs = add_attr(attrs, ATTR_rescavail, "nodect", buf);
+  snprintf(buf, sizeof(buf), "%ld", cpus_used);
+  attrs = add_attr(attrs, ATTR_rescassn, "ncpus", buf);
+  snprintf(buf, sizeof(buf), "%ldgb", cpus_used * 2);
+  attrs = add_attr(attrs, ATTR_rescassn, "mem", buf);
+  snprintf(buf, sizeof(buf), "%ld", nodes_used);
+  attrs = add_attr(attrs, ATTR_rescassn, "nodect", buf);
+
+  return(add_status(NULL, "server", attrs));
+  } /* END make_server() */
+
+
+
+/* the IFL and resource monitor calls libfoo makes */
+
+int pbs_statsnapshot_err(
+
+  int                    c,
+  struct attrl          *svr_attrib,
+  struct attrl          *que_attrib,
+  struct attrl          *job_attrib,
+  struct attrl          *node_attrib,
+  char                  *extend,
+  struct batch_snapshot *snap,
+  int                   *local_errno)
+
+  {
+  struct timespec start;
+  struct timespec end;
+  long            cpus_used;
+  long            nodes_used;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  snap->jobs = make_jobs(cpus_used, nodes_used);
+  snap->nodes = make_nodes();
+  snap->queues = make_queues();
+  snap->server = make_server(cpus_used, nodes_used);
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  snapshot_secs += elapsed_secs(start, end);
+
+  *local_errno = PBSE_NONE;
+
+  return(PBSE_NONE);
+  }
+
+void pbs_statfree(
+
+  struct batch_status *bs)
+
+  {
+  while (bs != NULL)
+    {
+    struct batch_status *next_bs = bs->next;
+    struct attrl        *attr = bs->attribs;
+
+    while (attr != NULL)
+      {
+      struct attrl *next_attr = attr->next;
+
+      free(attr->name);
+      free(attr->resource);
+      free(attr->value);
+      free(attr);
+
+      attr = next_attr;
+      }
+
+    free(bs->name);
+    free(bs->text);
+    free(bs);
+
+    bs = next_bs;
+    }
+  }
+
+void pbs_freesnapshot(
+
+  struct batch_snapshot *snap)
+
+  {
+  pbs_statfree(snap->server);
+  pbs_statfree(snap->queues);
+  pbs_statfree(snap->jobs);
+  pbs_statfree(snap->nodes);
+
+  memset(snap, 0, sizeof(struct batch_snapshot));
+  }
+
+int pbs_connect(char *server) { return(1); }
+int pbs_disconnect(int connect) { return(0); }
+char *pbs_geterrmsg(int connect) { return(NULL); }
+int pbs_rescquery(int connect, char **rlist, int nresc, int *avail, int *alloc, int *resv, int *down) { return(0); }
+int pbs_runjob_err(int c, char *jobid, char *location, char *extend, int *local_errno) { return(0); }
+int pbs_alterjob_err(int c, char *jobid, struct attrl *attrib, char *extend, int *local_errno) { return(0); }
+int pbs_deljob_err(int c, const char *jobid, char *extend, int *local_errno) { return(0); }
+struct batch_status *pbs_selstat_err(int c, struct attropl *attrib, char *extend, int *local_errno) { return(NULL); }
+struct batch_status *pbs_statnode_err(int c, char *id, struct attrl *attrib, char *extend, int *local_errno) { return(NULL); }
+struct batch_status *pbs_statque_err(int c, char *id, struct attrl *attrib, char *extend, int *local_errno) { return(NULL); }
+struct batch_status *pbs_statserver_err(int c, struct attrl *attrib, char *extend, int *local_errno) { return(NULL); }
+void log_record(int eventtype, int objclass, const char *objname, const char *text) {}
+int openrm(char *host, unsigned int port) { return(-1); }
+int closerm_err(int *local_errno, int stream) { return(0); }
+int addreq_err(int stream, int *local_errno, char *line) { return(-1); }
+int begin_rm_req(int stream, int *local_errno, int num_requests) { return(-1); }
+char *getreq_err(int *local_errno, int stream) { return(NULL); }
+int flushreq(void) { return(0); }
+
+
+
+static void write_file(
+
+  const char *name,
+  const char *contents)
+
+  {
+  FILE *fp;
+
+  if ((fp = fopen(name, "w")) == NULL)
+    {
+    perror(name);
+    exit(1);
+    }
+
+  fputs(contents, fp);
+  fclose(fp);
+  } /* END write_file() */
+
+
+
+/*
+ * write_config()
+ *
+ * Writes the policy to sched_config, turning on fair share or backfilling
+ * on top of the default first in, first out policy.
+ */
+
+static void write_config(
+
+  const char *policy)
+
+  {
+  char config[1024];
+
+  snprintf(config, sizeof(config),
+    "round_robin: false ALL\n"
+    "by_queue: true ALL\n"
+    "strict_fifo: %s ALL\n"
+    "fair_share: %s ALL\n"
+    "help_starving_jobs: %s ALL\n"
+    "backfill: %s ALL\n"
+    "sort_queues: true ALL\n"
+    "load_balancing: false ALL\n"
+    "sort_by: %s ALL\n"
+    "max_starve: 24:00:00\n"
+    "half_life: 24:00:00\n"
+    "unknown_shares: 10\n"
+    "sync_time: 1:00:00\n",
+    strcmp(policy, "backfill") ? "false" : "true",
+    strcmp(policy, "fairshare") ? "false" : "true",
+    strcmp(policy, "backfill") ? "false" : "true",
+    strcmp(policy, "backfill") ? "false" : "true",
+    strcmp(policy, "fairshare") ? "shortest_job_first" : "fair_share");
+
+  write_file("sched_config", config);
+  } /* END write_config() */
+
+
+
+/*
+ * setup_sched_priv()
+ *
+ * Writes the files schedinit() reads into a scratch directory and moves
+ * there. Every user is in the fair share tree under their group.
+ */
+
+static void setup_sched_priv(
+
+  char *dir)
+
+  {
+  FILE      *fp;
+  time_t     now = time(NULL);
+  struct tm *ptm = localtime(&now);
+
+  if ((mkdtemp(dir) == NULL) ||
+      (chdir(dir) != 0))
+    {
+    perror(dir);
+    exit(1);
+    }
+
+  snprintf(path_acct, sizeof(path_acct), "%s", dir);
+
+  /* fair share has to be on when schedinit() runs, or the first cycle with
+   * it on decays the usage once for every half life since the epoch */
+  write_config("fairshare");
+  write_file("dedicated_time", "");
+
+  if ((fp = fopen("holidays", "w")) == NULL)
+    {
+    perror("holidays");
+    exit(1);
+    }
+
+  fprintf(fp, "YEAR %d\n", ptm->tm_year + 1900);
+  fprintf(fp, "weekday all none\nsaturday all none\nsunday all none\n");
+  fclose(fp);
+
+  if ((fp = fopen("resource_group", "w")) == NULL)
+    {
+    perror("resource_group");
+    exit(1);
+    }
+
+  for (int i = 0; i < num_groups; i++)
+    fprintf(fp, "grp%d %d root %d\n", i, 100 + i, 10 + (i % 5) * 10);
+
+  for (int i = 0; i < num_users; i++)
+    fprintf(fp, "usr%d %d grp%d %d\n", i, 1000 + i, i % num_groups, 1 + (i % 10));
+
+  fclose(fp);
+  } /* END setup_sched_priv() */
+
+
+
+static void remove_sched_priv(
+
+  const char *dir)
+
+  {
+  DIR           *dp;
+  struct dirent *de;
+
+  if (chdir(dir) == 0 &&
+      (dp = opendir(".")) != NULL)
+    {
+    while ((de = readdir(dp)) != NULL)
+      {
+      if (strcmp(de->d_name, ".") && strcmp(de->d_name, ".."))
+        unlink(de->d_name);
+      }
+
+    closedir(dp);
+    }
+
+  if (chdir("/") == 0)
+    rmdir(dir);
+  } /* END remove_sched_priv() */
+
+
+
+int main(
+
+  int   argc,
+  char *argv[])
+
+  {
+  static const char *policies[] = { "fifo", "fairshare", "backfill" };
+  char               dir[] = "/tmp/sched_benchXXXXXX";
+  int                cycles = 2;
+
+  if (argc > 1)
+    num_nodes = atoi(argv[1]);
+
+  if (argc > 2)
+    num_jobs = atoi(argv[2]);
+
+  if (argc > 3)
+    cycles = atoi(argv[3]);
+
+  setup_sched_priv(dir);
+
+  schedinit(argc, argv);
+
+  printf("%d nodes, %d jobs, %d cycles each\n", num_nodes, num_jobs, cycles);
+  printf("%-10s %10s %10s %10s %10s %10s\n",
+    "policy", "query ms", "sort ms", "check ms", "run ms", "total ms");
+
+  for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); p++)
+    {
+    struct cycle_times sum;
+
+    memset(&sum, 0, sizeof(sum));
+
+    write_config(policies[p]);
+    schedule(SCH_CONFIGURE);
+
+    for (int c = 0; c < cycles; c++)
+      {
+      snapshot_secs = 0;
+
+      schedule(SCH_SCHEDULE_CMD);
+
+      sum.query += cycle_times.query - snapshot_secs;
+      sum.sort += cycle_times.sort;
+      sum.check += cycle_times.check;
+      sum.run += cycle_times.run;
+      sum.total += cycle_times.total - snapshot_secs;
+      }
+
+    printf("%-10s %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+      policies[p],
+      sum.query * 1000 / cycles,
+      sum.sort * 1000 / cycles,
+      sum.check * 1000 / cycles,
+      sum.run * 1000 / cycles,
+      sum.total * 1000 / cycles);
+    }
+
+  remove_sched_priv(dir);
+
+  return(0);
+  } /* END main() */
@@ -86,6 +86,12 @@ int decode_DIS_Status(struct tcp_chan *chan, struct batch_request *preq)
   exit(1);
   }
 
+int decode_DIS_StatusSnapshot(struct tcp_chan *chan, struct batch_request *preq)
+  {
+  fprintf(stderr, "The call to decode_DIS_StatusSnapshot needs to be mocked!!\n");
+  exit(1);
+  }
+
 int decode_DIS_Manage(struct tcp_chan *chan, struct batch_request *preq)
   {
   fprintf(stderr, "The call to decode_DIS_Manage needs to be mocked!!\n");
@@ -122,6 +128,12 @@ int decode_DIS_RunJob(struct tcp_chan *chan, struct batch_request *preq)
   exit(1);
   }
 
+int decode_DIS_RunJobs(struct tcp_chan *chan, struct batch_request *preq)
+  {
+  fprintf(stderr, "The call to decode_DIS_RunJobs needs to be mocked!!\n");
+  exit(1);
+  }
+
 int decode_DIS_MoveJob(struct tcp_chan *chan, struct batch_request *preq)
   {
   fprintf(stderr, "The call to decode_DIS_MoveJob needs to be mocked!!\n");
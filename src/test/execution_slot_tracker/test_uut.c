@@ -193,6 +193,66 @@ START_TEST(test_occupied_iterator)
 END_TEST
 
 
+START_TEST(test_word_boundaries)
+  {
+  execution_slot_tracker e1(200);
+  execution_slot_tracker e2;
+  int                    iter = -1;
+
+  /* leave slots 60-69 free, spanning the first two words */
+  fail_unless(e1.mark_range_as_used(0, 60) == PBSE_NONE);
+  fail_unless(e1.mark_range_as_used(70, 130) == PBSE_NONE);
+  fail_unless(e1.get_number_free() == 10);
+  fail_unless(e1.is_occupied(59) == true);
+  fail_unless(e1.is_occupied(60) == false);
+  fail_unless(e1.is_occupied(69) == false);
+  fail_unless(e1.is_occupied(70) == true);
+  fail_unless(e1.is_occupied(199) == true);
+
+  fail_unless(e1.reserve_execution_slots(6, e2) == PBSE_NONE);
+  fail_unless(e2.get_total_execution_slots() == 200);
+  fail_unless(e2.get_number_free() == 194);
+  fail_unless(e1.get_number_free() == 4);
+
+  /* the lowest free slots are the ones reserved */
+  for (int i = 60; i < 66; i++)
+    {
+    fail_unless(e2.get_next_occupied_index(iter) == i);
+    fail_unless(e1.is_occupied(i) == true);
+    }
+  fail_unless(e2.get_next_occupied_index(iter) == -1);
+  fail_unless(e1.is_occupied(66) == false);
+
+  fail_unless(e1.unreserve_execution_slots(e2) == PBSE_NONE);
+  fail_unless(e1.get_number_free() == 10);
+
+  /* ranges that run past the end mark what exists */
+  fail_unless(e1.mark_range_as_free(190, 20) == OUT_OF_RANGE);
+  fail_unless(e1.get_number_free() == 20);
+  fail_unless(e1.mark_range_as_free(0, 200) == PBSE_NONE);
+  fail_unless(e1.get_number_free() == 200);
+
+  iter = 130;
+  e1.mark_as_used(199);
+  fail_unless(e1.get_next_occupied_index(iter) == 199);
+  fail_unless(e1.get_next_occupied_index(iter) == -1);
+
+  /* removing an occupied slot leaves the free count alone */
+  fail_unless(e1.remove_execution_slot() == PBSE_NONE);
+  fail_unless(e1.get_total_execution_slots() == 199);
+  fail_unless(e1.get_number_free() == 199);
+  e1.add_execution_slot();
+  fail_unless(e1.is_occupied(199) == false);
+  fail_unless(e1.get_number_free() == 200);
+
+  for (int i = 0; i < 200; i++)
+    fail_unless(e1.remove_execution_slot() == PBSE_NONE);
+  fail_unless(e1.get_number_free() == 0);
+  fail_unless(e1.remove_execution_slot() != PBSE_NONE);
+  }
+END_TEST
+
+
 Suite *execution_slot_tracker_suite(void)
   {
   Suite *s = suite_create("execution_slot_tracker test suite methods");
@@ -206,6 +266,7 @@ Suite *execution_slot_tracker_suite(void)
   tcase_add_test(tc_core, test_reserving);
   tcase_add_test(tc_core, test_occupied_iterator);
   tcase_add_test(tc_core, test_reserve_slot);
+  tcase_add_test(tc_core, test_word_boundaries);
   suite_add_tcase(s, tc_core);
   
   return(s);
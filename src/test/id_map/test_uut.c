@@ -48,6 +48,62 @@ END_TEST
 
 
 
+START_TEST(test_rename_id)
+  {
+  id_map im;
+  int    id = im.get_new_id("napali");
+  int    other = im.get_new_id("waimea");
+
+  // the id moves to the new name and the old name is gone
+  fail_unless(im.rename_id(id, "lihue") == 0);
+  fail_unless(im.get_id("lihue") == id);
+  fail_unless(im.get_id("napali") == -1);
+  fail_unless(!strcmp("lihue", im.get_name(id)));
+  fail_unless(im.get_new_id("lihue") == id);
+  fail_unless(im.get_id("waimea") == other);
+
+  // ids that were never handed out can't be renamed
+  fail_unless(im.rename_id(-1, "wailua") == -1);
+  fail_unless(im.rename_id(other + 1, "wailua") == -1);
+  fail_unless(im.get_id("wailua") == -1);
+  }
+END_TEST
+
+
+
+
+START_TEST(test_id_set)
+  {
+  id_set ids;
+
+  fail_unless(ids.contains(0) == false);
+  fail_unless(ids.contains(-1) == false);
+
+  ids.add(0);
+  ids.add(63);
+  ids.add(64);
+  ids.add(1000);
+  ids.add(-1);
+
+  fail_unless(ids.contains(0) == true);
+  fail_unless(ids.contains(63) == true);
+  fail_unless(ids.contains(64) == true);
+  fail_unless(ids.contains(1000) == true);
+  fail_unless(ids.contains(1) == false);
+  fail_unless(ids.contains(65) == false);
+  fail_unless(ids.contains(999) == false);
+  fail_unless(ids.contains(100000) == false);
+  fail_unless(ids.contains(-1) == false);
+
+  ids.clear();
+  fail_unless(ids.contains(0) == false);
+  fail_unless(ids.contains(1000) == false);
+  }
+END_TEST
+
+
+
+
 Suite *id_map_suite(void)
   {
   Suite *s = suite_create("id_map test suite methods");
@@ -58,6 +114,14 @@ Suite *id_map_suite(void)
   tc_core = tcase_create("test_adding");
   tcase_add_test(tc_core, test_adding);
   suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_id_set");
+  tcase_add_test(tc_core, test_id_set);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_rename_id");
+  tcase_add_test(tc_core, test_rename_id);
+  suite_add_tcase(s, tc_core);
   
   return(s);
   }
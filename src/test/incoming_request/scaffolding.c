@@ -58,11 +58,21 @@ void netcounter_incr() {}
 
 extern "C" 
 {
-void close_conn(int sd, int has_mutex)  { }
+int closed_count;
+
+void close_conn(int sd, int has_mutex)
+  {
+  closed_count++;
+  }
 }
 
+int   enqueued_count;
+void *enqueued_arg;
+
 int enqueue_threadpool_request(void *(*func)(void *), void *arg, threadpool_t *tp)
   {
+  enqueued_count++;
+  enqueued_arg = arg;
   return(0);
   }
 
@@ -84,3 +94,11 @@ int write_tcp_reply(
   {
   return(0);
   }
+
+long server_state = 3; /* SV_STATE_RUN */
+
+int get_svr_attr_l(int index, long *l)
+  {
+  *l = server_state;
+  return(0);
+  }
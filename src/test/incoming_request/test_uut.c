@@ -1,14 +1,24 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <sys/socket.h>
 #include <check.h>
 
 #include "tcp.h"
+#include "server_comm.h"
+#include "pbs_error.h"
 
 int get_protocol_type(struct tcp_chan *chan, int &rc);
+void check_parked_streams(int timeout);
 
 extern int    peek_count;
 extern time_t pbs_incoming_tcp_timeout;
 extern bool   busy_pool;
+extern int    enqueued_count;
+extern void  *enqueued_arg;
+extern int    closed_count;
+extern long   server_state;
+extern bool   parked_streams_polled;
 
 START_TEST(test_get_protocol_type)
   {
@@ -42,6 +52,75 @@ END_TEST
 
 
 
+START_TEST(test_check_parked_streams)
+  {
+  int   sv[2];
+  long  args[3];
+  long *enqueued;
+  char  c;
+
+  fail_unless(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+
+  args[0] = sv[0];
+  args[1] = 1;
+  args[2] = 2;
+
+  // streams aren't parked unless the poller is running
+  closed_count = 0;
+  park_status_stream(sv[0], args);
+  fail_unless(closed_count == 1);
+
+  enqueued_count = 0;
+  check_parked_streams(0);
+  fail_unless(enqueued_count == 0);
+
+  // the poller won't run without its wake pipe
+  fail_unless(poll_status_streams(NULL) == NULL);
+  fail_unless(parked_streams_polled == false);
+
+  fail_unless(init_status_stream_poller() == PBSE_NONE);
+  parked_streams_polled = true;
+  park_status_stream(sv[0], args);
+  fail_unless(closed_count == 1);
+
+  // nothing to read until the mom sends its next update
+  enqueued_count = 0;
+  check_parked_streams(0);
+  fail_unless(enqueued_count == 0);
+
+  fail_unless(write(sv[1], "x", 1) == 1);
+  check_parked_streams(1);
+  fail_unless(enqueued_count == 1);
+
+  enqueued = (long *)enqueued_arg;
+  fail_unless(enqueued[0] == sv[0]);
+  fail_unless(enqueued[1] == 1);
+  fail_unless(enqueued[2] == 2);
+  free(enqueued);
+
+  // handed off, so it isn't watched until it's parked again
+  check_parked_streams(0);
+  fail_unless(enqueued_count == 1);
+
+  // the poller stops and closes what's parked when the server shuts down
+  fail_unless(read(sv[0], &c, 1) == 1);
+  park_status_stream(sv[0], args);
+  server_state = 4; // SV_STATE_SHUTDEL
+  fail_unless(poll_status_streams(NULL) == NULL);
+  fail_unless(parked_streams_polled == false);
+  fail_unless(closed_count == 2);
+
+  park_status_stream(sv[0], args);
+  fail_unless(closed_count == 3);
+
+  close(sv[0]);
+  close(sv[1]);
+  }
+END_TEST
+
+
+
+
 START_TEST(test_two)
   {
   }
@@ -57,6 +136,10 @@ Suite *incoming_request_suite(void)
   tcase_add_test(tc_core, test_get_protocol_type);
   suite_add_tcase(s, tc_core);
   
+  tc_core = tcase_create("test_check_parked_streams");
+  tcase_add_test(tc_core, test_check_parked_streams);
+  suite_add_tcase(s, tc_core);
+  
   tc_core = tcase_create("test_two");
   tcase_add_test(tc_core, test_two);
   suite_add_tcase(s, tc_core);
@@ -1,6 +1,7 @@
 #include "license_pbs.h" /* See here for the software license */
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 
 #include "pbs_error.h"
@@ -12,11 +13,28 @@ extern attribute_def job_attr_def[];
 
 void free_do_nothing(pbs_attribute *attr) {}
 
+int decodes = 0;
+
+int decode_count(
+
+  pbs_attribute *attr,
+  const char    *name,
+  const char    *rescn,
+  const char    *val,
+  int            perm)
+
+  {
+  attr->at_val.at_str = strdup(val);
+  decodes++;
+  return(0);
+  }
+
 void init_job_attr_def()
   {
   for (int i = 0; i < 100; i++)
     {
     job_attr_def[i].at_free = free_do_nothing;
+    job_attr_def[i].at_decode = decode_count;
 
     }
   }
@@ -67,6 +85,40 @@ END_TEST
 
 
 
+START_TEST(test_deferred_attrs)
+  {
+  job           pjob;
+  std::string   value;
+  unsigned int  flags;
+
+  decodes = 0;
+  pjob.defer_attr(JOB_ATR_variables, "PBS_O_HOST=napali", ATR_VFLAG_SET | ATR_VFLAG_MODIFY);
+  pjob.defer_attr(JOB_ATR_submit_args, "-l nodes=2 script.sh", ATR_VFLAG_SET);
+  fail_unless(pjob.get_deferred_attr(JOB_ATR_variables, value, flags) == true);
+  fail_unless(value == "PBS_O_HOST=napali");
+  fail_unless(flags == (ATR_VFLAG_SET | ATR_VFLAG_MODIFY));
+  fail_unless(pjob.get_deferred_attr(JOB_ATR_jobname, value, flags) == false);
+
+  // hydrating decodes once and doesn't mark the attribute modified
+  pjob.hydrate_attr(JOB_ATR_variables);
+  pjob.hydrate_attr(JOB_ATR_variables);
+  fail_unless(decodes == 1);
+  fail_unless(!strcmp(pjob.ji_wattr[JOB_ATR_variables].at_val.at_str, "PBS_O_HOST=napali"));
+  fail_unless(pjob.ji_wattr[JOB_ATR_variables].at_flags == ATR_VFLAG_SET);
+  fail_unless(pjob.get_deferred_attr(JOB_ATR_variables, value, flags) == false);
+
+  // a value set since recovery wins over the deferred one
+  pjob.ji_wattr[JOB_ATR_submit_args].at_val.at_str = strdup("new");
+  pjob.ji_wattr[JOB_ATR_submit_args].at_flags = ATR_VFLAG_SET;
+  fail_unless(pjob.get_deferred_attr(JOB_ATR_submit_args, value, flags) == false);
+  pjob.hydrate_attrs();
+  fail_unless(decodes == 1);
+  fail_unless(!strcmp(pjob.ji_wattr[JOB_ATR_submit_args].at_val.at_str, "new"));
+  }
+END_TEST
+
+
+
 Suite *job_suite(void)
   {
   Suite *s = suite_create("job_suite methods");
@@ -78,6 +130,10 @@ Suite *job_suite(void)
   tcase_add_test(tc_core, test_plugin_things);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_deferred_attrs");
+  tcase_add_test(tc_core, test_deferred_attrs);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
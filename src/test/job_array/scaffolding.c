@@ -66,6 +66,14 @@ int array_save(
   return(PBSE_NONE);
   }
 
+int array_save_counters(
+
+  job_array *pa)
+
+  {
+  return(PBSE_NONE);
+  }
+
 int translate_range_string_to_vector(
 
   const char       *range_string,
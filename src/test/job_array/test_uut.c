@@ -122,11 +122,9 @@ START_TEST(test_parse_array_request)
 
   pa.ai_qs.idle_slot_limit = 2;
   pa.ai_qs.num_idle = 0;
-  int internal_index = -1;
 
   // It should tell us to create sub job 0 next
-  fail_unless(pa.get_next_index_to_create(internal_index) == 0);
-  fail_unless(internal_index == 0);
+  fail_unless(pa.get_next_index_to_create() == 0);
 
   // Make sure we'll create a job
   pa.create_job_if_needed();
@@ -135,6 +133,63 @@ START_TEST(test_parse_array_request)
   pa.create_job_if_needed();
   fail_unless(pa.job_ids[1] != NULL);
   fail_unless(pa.ai_qs.highest_id_created == 1);
+  fail_unless(pa.uncreated_ids.size() == 8);
+
+  // sub jobs created out of order don't move highest_id_created and are skipped later
+  fail_unless(pa.create_subjob(3, false) == PBSE_NONE);
+  fail_unless(pa.job_ids[3] != NULL);
+  fail_unless(pa.ai_qs.highest_id_created == 1);
+  fail_unless(pa.uncreated_ids.contains(3) == false);
+  fail_unless(pa.uncreated_ids.size() == 7);
+  pa.job_ids[2] = strdup("1[2].napali");
+  fail_unless(pa.get_next_index_to_create() == 4);
+
+  // no more once the array is deleted
+  pa.mark_deleted();
+  fail_unless(pa.get_next_index_to_create() == -1);
+  }
+END_TEST
+
+
+START_TEST(test_array_index_ranges)
+  {
+  array_index_ranges air;
+
+  fail_unless(air.empty() == true);
+  fail_unless(air.front() == -1);
+  fail_unless(air.pop_front() == -1);
+
+  fail_unless(air.set_from_string("0-9", 0) == PBSE_NONE);
+  fail_unless(air.size() == 10);
+  fail_unless(air.get_ranges().size() == 1);
+  fail_unless(air.get_ranges()[0].first == 0);
+  fail_unless(air.get_ranges()[0].second == 9);
+
+  // indices below the lower bound are left out
+  fail_unless(air.set_from_string("0-9", 5) == PBSE_NONE);
+  fail_unless(air.size() == 5);
+  fail_unless(air.front() == 5);
+  fail_unless(air.contains(9) == true);
+  fail_unless(air.contains(4) == false);
+  fail_unless(air.contains(10) == false);
+
+  // removing from the middle splits the range
+  fail_unless(air.remove(7) == true);
+  fail_unless(air.remove(7) == false);
+  fail_unless(air.size() == 4);
+  fail_unless(air.get_ranges().size() == 2);
+  fail_unless(air.contains(6) == true);
+  fail_unless(air.contains(7) == false);
+  fail_unless(air.contains(8) == true);
+
+  fail_unless(air.remove(9) == true);
+  fail_unless(air.pop_front() == 5);
+  fail_unless(air.pop_front() == 6);
+  fail_unless(air.pop_front() == 8);
+  fail_unless(air.empty() == true);
+  fail_unless(air.get_ranges().size() == 0);
+
+  fail_unless(air.set_from_string("the Lopen", 0) != PBSE_NONE);
   }
 END_TEST
 
@@ -203,6 +258,7 @@ Suite *job_array_suite(void)
   tcase_add_test(tc_core, update_array_values_test);
   tcase_add_test(tc_core, test_set_slot_limit);
   tcase_add_test(tc_core, test_initialize_uncreated_ids);
+  tcase_add_test(tc_core, test_array_index_ranges);
   suite_add_tcase(s, tc_core);
 
   return s;
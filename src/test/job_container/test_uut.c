@@ -108,6 +108,120 @@ START_TEST(insert_job_first_test)
   }
 END_TEST
 
+START_TEST(insert_by_rank_test)
+  {
+  all_jobs            alljobs;
+  all_jobs_iterator  *iter;
+  job                *pjob;
+  long                ranks[] = {5, 1, 9, 3, 7, 3};
+  const char         *ids[] = {"5.napali", "1.napali", "9.napali", "3.napali", "7.napali", "3b.napali"};
+  const char         *expected[] = {"1.napali", "3.napali", "3b.napali", "5.napali", "7.napali", "9.napali"};
+  int                 i = 0;
+
+  alljobs.lock();
+
+  for (int j = 0; j < 6; j++)
+    {
+    pjob = job_alloc();
+    strcpy(pjob->ji_qs.ji_jobid, ids[j]);
+    fail_unless(alljobs.insert_by_rank(pjob, ids[j], ranks[j]) == PBSE_NONE);
+    }
+
+  // duplicates are rejected
+  fail_unless(alljobs.insert_by_rank(pjob, "3b.napali", 3) == ALREADY_IN_LIST);
+
+  iter = alljobs.get_iterator();
+  while ((pjob = iter->get_next_item()) != NULL)
+    fail_unless(!strcmp(pjob->ji_qs.ji_jobid, expected[i++]), "%s out of order", pjob->ji_qs.ji_jobid);
+  delete iter;
+  fail_unless(i == 6);
+
+  // removed jobs drop out of the rank index too
+  fail_unless(alljobs.remove("9.napali") == true);
+  fail_unless(alljobs.remove("1.napali") == true);
+
+  pjob = job_alloc();
+  strcpy(pjob->ji_qs.ji_jobid, "8.napali");
+  fail_unless(alljobs.insert_by_rank(pjob, "8.napali", 8) == PBSE_NONE);
+  pjob = job_alloc();
+  strcpy(pjob->ji_qs.ji_jobid, "0.napali");
+  fail_unless(alljobs.insert_by_rank(pjob, "0.napali", 0) == PBSE_NONE);
+
+  const char *expected2[] = {"0.napali", "3.napali", "3b.napali", "5.napali", "7.napali", "8.napali"};
+  i = 0;
+  iter = alljobs.get_iterator();
+  while ((pjob = iter->get_next_item()) != NULL)
+    fail_unless(!strcmp(pjob->ji_qs.ji_jobid, expected2[i++]), "%s out of order", pjob->ji_qs.ji_jobid);
+  delete iter;
+  fail_unless(i == 6);
+
+  // jobs inserted by position take a neighbour's rank
+  pjob = job_alloc();
+  strcpy(pjob->ji_qs.ji_jobid, "5a.napali");
+  fail_unless(alljobs.insert_after("5.napali", pjob, "5a.napali") == true);
+  pjob = job_alloc();
+  strcpy(pjob->ji_qs.ji_jobid, "first.napali");
+  fail_unless(alljobs.insert_first(pjob, "first.napali") == true);
+  pjob = job_alloc();
+  strcpy(pjob->ji_qs.ji_jobid, "5b.napali");
+  fail_unless(alljobs.insert_by_rank(pjob, "5b.napali", 5) == PBSE_NONE);
+  pjob = job_alloc();
+  strcpy(pjob->ji_qs.ji_jobid, "0b.napali");
+  fail_unless(alljobs.insert_by_rank(pjob, "0b.napali", 0) == PBSE_NONE);
+
+  const char *expected3[] = {"first.napali", "0.napali", "0b.napali", "3.napali", "3b.napali",
+                             "5.napali", "5a.napali", "5b.napali", "7.napali", "8.napali"};
+  i = 0;
+  iter = alljobs.get_iterator();
+  while ((pjob = iter->get_next_item()) != NULL)
+    fail_unless(!strcmp(pjob->ji_qs.ji_jobid, expected3[i++]), "%s out of order", pjob->ji_qs.ji_jobid);
+  delete iter;
+  fail_unless(i == 10);
+
+  alljobs.unlock();
+  }
+END_TEST
+
+START_TEST(rerank_job_test)
+  {
+  all_jobs            alljobs;
+  all_jobs_iterator  *iter;
+  job                *pjob;
+  job                *jobs[3];
+  const char         *ids[] = {"1.napali", "2.napali", "3.napali"};
+  const char         *expected[] = {"2.napali", "3.napali", "1.napali"};
+  int                 i = 0;
+
+  for (int j = 0; j < 3; j++)
+    {
+    jobs[j] = job_alloc();
+    strcpy(jobs[j]->ji_qs.ji_jobid, ids[j]);
+    jobs[j]->ji_wattr[JOB_ATR_qrank].at_val.at_long = j + 1;
+    alljobs.lock();
+    alljobs.insert_by_rank(jobs[j], ids[j], j + 1);
+    alljobs.unlock();
+    }
+
+  fail_unless(rerank_job(&alljobs, NULL) != PBSE_NONE);
+
+  // the job moves to where its new rank belongs
+  jobs[0]->ji_wattr[JOB_ATR_qrank].at_val.at_long = 4;
+  fail_unless(rerank_job(&alljobs, jobs[0]) == PBSE_NONE);
+
+  alljobs.lock();
+  iter = alljobs.get_iterator();
+  while ((pjob = iter->get_next_item()) != NULL)
+    fail_unless(!strcmp(pjob->ji_qs.ji_jobid, expected[i++]), "%s out of order", pjob->ji_qs.ji_jobid);
+  delete iter;
+  alljobs.unlock();
+  fail_unless(i == 3);
+
+  pjob = job_alloc();
+  strcpy(pjob->ji_qs.ji_jobid, "4.napali");
+  fail_unless(rerank_job(&alljobs, pjob) == THING_NOT_FOUND);
+  }
+END_TEST
+
 START_TEST(has_job_test)
   {
   all_jobs alljobs;
@@ -281,6 +395,14 @@ Suite *job_container_suite(void)
   tcase_add_test(tc_core, insert_job_first_test);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("insert_by_rank_test");
+  tcase_add_test(tc_core, insert_by_rank_test);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("rerank_job_test");
+  tcase_add_test(tc_core, rerank_job_test);
+  suite_add_tcase(s, tc_core);
+
   tc_core = tcase_create("has_job_test");
   tcase_add_test(tc_core, has_job_test);
   suite_add_tcase(s, tc_core);
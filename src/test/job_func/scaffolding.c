@@ -22,6 +22,9 @@
 /* This section is for manipulting function return values */
 #include "test_job_func.h" /* *_SUITE */
 #include "user_info.h"
+#include "job_journal.hpp"
+#include "job_writer.hpp"
+#include "status_generation.hpp"
 int func_num = 0; /* Suite number being run */
 int tc = 0; /* Used for test routining */
 int iter_num = 0;
@@ -29,6 +32,9 @@ int called_remove_job;
 int dequejob_rc;
 
 bool exit_called = false;
+bool job_journal_enabled = false;
+long job_writer_threads = 0;
+bool job_binary_records = false;
 
 int valbuf_size = 0;
 /* end manip */
@@ -64,6 +70,11 @@ int array_save(job_array *pa)
   exit(1);
   }
 
+int array_save_counters(job_array *pa)
+  {
+  return(0);
+  }
+
 int job_route(job *jobp)
   {
   fprintf(stderr, "The call to job_route to be mocked!!\n");
@@ -715,3 +726,54 @@ bool job_array::is_deleted() const
   {
   return(this->being_deleted);
   }
+
+job_journal server_job_journal;
+
+job_journal::job_journal() {}
+
+job_journal::~job_journal() {}
+
+unsigned long job_journal::append(int type, const char *jobid, const char *fileprefix, bool is_template, const char *payload, size_t len)
+  {
+  return(0);
+  }
+
+int job_journal::commit(unsigned long seq)
+  {
+  return(-1);
+  }
+
+job_writer server_job_writer;
+
+job_writer::job_writer() {}
+
+job_writer::~job_writer() {}
+
+void job_writer::queue_save(const char *jobid, const char *fileprefix, bool is_template, const std::string &payload, bool quick) {}
+
+void job_writer::forget(const char *jobid) {}
+
+void job::hydrate_attr(int index) {}
+void job::hydrate_attrs() {}
+
+bool array_index_ranges::empty() const
+  {
+  return(this->count == 0);
+  }
+
+int array_index_ranges::pop_front()
+  {
+  return(-1);
+  }
+
+status_generation status_gen;
+
+status_generation::status_generation() {}
+status_generation::~status_generation() {}
+
+unsigned long long status_generation::next()
+  {
+  return(0);
+  }
+
+void status_generation::record_deleted(int kind, const char *name) {}
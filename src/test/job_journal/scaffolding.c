@@ -0,0 +1,22 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string>
+
+#include "job_journal.hpp"
+
+int LOGLEVEL = 0;
+
+
+void log_err(int errnum, const char *routine, const char *text) {}
+
+void log_event(int eventtype, int objclass, const char *objname, const char *text) {}
+
+int write_journal_entry(
+
+  const std::string   &jobid,
+  const journal_entry &je)
+
+  {
+  return(0);
+  }
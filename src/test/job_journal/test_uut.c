@@ -0,0 +1,276 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <check.h>
+
+#include "pbs_error.h"
+#include "job_journal.hpp"
+
+std::map<std::string, journal_entry> applied;
+int                                  apply_rc = PBSE_NONE;
+
+
+int record_entry(
+
+  const std::string   &jobid,
+  const journal_entry &je)
+
+  {
+  applied[jobid] = je;
+  return(apply_rc);
+  }
+
+
+void make_journal_path(
+
+  char *path)
+
+  {
+  strcpy(path, "/tmp/job_journal_XXXXXX");
+  close(mkstemp(path));
+  unlink(path);
+  }
+
+
+START_TEST(test_append_commit_read)
+  {
+  job_journal                          jj;
+  std::map<std::string, journal_entry> entries;
+  char                                 path[MAXPATHLEN];
+  unsigned long                        seq;
+
+  make_journal_path(path);
+
+  // nothing can be appended before the journal is open
+  fail_unless(jj.append(JOURNAL_SAVE, "1.napali", "1.napali", false, "a", 1) == 0);
+  fail_unless(jj.open_journal(path) == PBSE_NONE);
+  fail_unless(jj.is_open() == true);
+
+  seq = jj.append(JOURNAL_SAVE, "1.napali", "1.napali", false, "first", 5);
+  fail_unless(seq != 0);
+  seq = jj.append(JOURNAL_QUICK, "1.napali", "1.napali", false, "quick", 5);
+  seq = jj.append(JOURNAL_SAVE, "2.napali", "2.napali", true, "template", 8);
+  seq = jj.append(JOURNAL_SAVE, "3.napali", "3.napali", false, "gone", 4);
+  seq = jj.append(JOURNAL_PURGE, "3.napali", "3.napali", false, NULL, 0);
+  fail_unless(jj.commit(seq) == PBSE_NONE);
+
+  fail_unless(job_journal::read_journal(path, entries) == 5);
+  fail_unless(entries.size() == 3);
+  fail_unless(entries["1.napali"].image == "first");
+  fail_unless(entries["1.napali"].quick == "quick");
+  fail_unless(entries["1.napali"].purged == false);
+  fail_unless(entries["2.napali"].is_template == true);
+  fail_unless(entries["2.napali"].image == "template");
+  fail_unless(entries["3.napali"].purged == true);
+
+  // a newer image supersedes the quick record written before it
+  seq = jj.append(JOURNAL_SAVE, "1.napali", "1.napali", false, "second", 6);
+  fail_unless(jj.commit(seq) == PBSE_NONE);
+  entries.clear();
+  job_journal::read_journal(path, entries);
+  fail_unless(entries["1.napali"].image == "second");
+  fail_unless(entries["1.napali"].quick.size() == 0);
+
+  jj.close_journal();
+  fail_unless(jj.is_open() == false);
+  unlink(path);
+  }
+END_TEST
+
+
+START_TEST(test_torn_record)
+  {
+  job_journal                          jj;
+  std::map<std::string, journal_entry> entries;
+  char                                 path[MAXPATHLEN];
+  unsigned long                        seq;
+  int                                  fd;
+
+  make_journal_path(path);
+  fail_unless(jj.open_journal(path) == PBSE_NONE);
+  seq = jj.append(JOURNAL_SAVE, "1.napali", "1.napali", false, "complete", 8);
+  fail_unless(jj.commit(seq) == PBSE_NONE);
+  jj.close_journal();
+
+  // simulate a crash in the middle of writing the next record
+  fd = open(path, O_WRONLY | O_APPEND);
+  fail_unless(write(fd, "garbage", 7) == 7);
+  close(fd);
+
+  fail_unless(job_journal::read_journal(path, entries) == 1);
+  fail_unless(entries["1.napali"].image == "complete");
+  unlink(path);
+  }
+END_TEST
+
+
+START_TEST(test_replay)
+  {
+  job_journal   jj;
+  char          path[MAXPATHLEN];
+  unsigned long seq;
+
+  make_journal_path(path);
+
+  // a missing journal is nothing to replay
+  fail_unless(job_journal::replay(path, record_entry) == PBSE_NONE);
+
+  fail_unless(jj.open_journal(path) == PBSE_NONE);
+  seq = jj.append(JOURNAL_SAVE, "1.napali", "1.napali", false, "image", 5);
+  fail_unless(jj.commit(seq) == PBSE_NONE);
+  jj.close_journal();
+
+  // a failed replay leaves the journal in place
+  applied.clear();
+  apply_rc = -1;
+  fail_unless(job_journal::replay(path, record_entry) != PBSE_NONE);
+  fail_unless(access(path, F_OK) == 0);
+
+  applied.clear();
+  apply_rc = PBSE_NONE;
+  fail_unless(job_journal::replay(path, record_entry) == PBSE_NONE);
+  fail_unless(applied.size() == 1);
+  fail_unless(applied["1.napali"].image == "image");
+  fail_unless(access(path, F_OK) != 0);
+  }
+END_TEST
+
+
+START_TEST(test_compact)
+  {
+  job_journal                          jj;
+  std::map<std::string, journal_entry> entries;
+  char                                 path[MAXPATHLEN];
+  std::string                          old_path;
+  unsigned long                        seq;
+
+  make_journal_path(path);
+  old_path = std::string(path) + JOB_JOURNAL_OLD_SUFFIX;
+
+  fail_unless(jj.compact(record_entry) != PBSE_NONE);
+  fail_unless(jj.open_journal(path) == PBSE_NONE);
+
+  // an empty journal doesn't need compacting, a big one always does
+  fail_unless(jj.needs_compaction(time(NULL) + JOURNAL_COMPACT_INTERVAL * 2) == false);
+  seq = jj.append(JOURNAL_SAVE, "1.napali", "1.napali", false, "one", 3);
+  seq = jj.append(JOURNAL_SAVE, "1.napali", "1.napali", false, "two", 3);
+  seq = jj.append(JOURNAL_SAVE, "2.napali", "2.napali", false, "other", 5);
+  fail_unless(jj.commit(seq) == PBSE_NONE);
+  fail_unless(jj.needs_compaction(time(NULL) + JOURNAL_COMPACT_INTERVAL * 2) == true);
+
+  applied.clear();
+  apply_rc = PBSE_NONE;
+  fail_unless(jj.compact(record_entry) == PBSE_NONE);
+  fail_unless(applied.size() == 2);
+  fail_unless(applied["1.napali"].image == "two");
+  fail_unless(access(old_path.c_str(), F_OK) != 0);
+
+  // the journal starts over after compacting
+  fail_unless(job_journal::read_journal(path, entries) == 0);
+  fail_unless(jj.needs_compaction(time(NULL) + JOURNAL_COMPACT_INTERVAL * 2) == false);
+
+  // records appended after the rotation go to the new journal
+  seq = jj.append(JOURNAL_SAVE, "3.napali", "3.napali", false, "three", 5);
+  fail_unless(jj.commit(seq) == PBSE_NONE);
+  fail_unless(job_journal::read_journal(path, entries) == 1);
+  fail_unless(entries["3.napali"].image == "three");
+
+  jj.close_journal();
+  unlink(path);
+  }
+END_TEST
+
+
+START_TEST(test_failed_write)
+  {
+  job_journal                          jj;
+  std::map<std::string, journal_entry> entries;
+  std::string                          big(4096, 'x');
+  struct rlimit                        rl;
+  struct rlimit                        saved;
+  char                                 path[MAXPATHLEN];
+  unsigned long                        good;
+  unsigned long                        bad;
+  unsigned long                        seq;
+
+  make_journal_path(path);
+  fail_unless(jj.open_journal(path) == PBSE_NONE);
+  good = jj.append(JOURNAL_SAVE, "1.napali", "1.napali", false, "one", 3);
+  fail_unless(jj.commit(good) == PBSE_NONE);
+
+  // only part of the next batch fits in the file
+  signal(SIGXFSZ, SIG_IGN);
+  getrlimit(RLIMIT_FSIZE, &saved);
+  rl = saved;
+  rl.rlim_cur = 1024;
+  setrlimit(RLIMIT_FSIZE, &rl);
+  bad = jj.append(JOURNAL_SAVE, "2.napali", "2.napali", false, big.c_str(), big.size());
+  fail_unless(jj.commit(bad) != PBSE_NONE);
+  setrlimit(RLIMIT_FSIZE, &saved);
+
+  // the torn bytes are gone, so a later record can still be replayed
+  seq = jj.append(JOURNAL_SAVE, "3.napali", "3.napali", false, "three", 5);
+  fail_unless(jj.commit(seq) == PBSE_NONE);
+  fail_unless(job_journal::read_journal(path, entries) == 2);
+  fail_unless(entries["3.napali"].image == "three");
+  fail_unless(entries.find("2.napali") == entries.end());
+
+  // a later successful batch doesn't hide the earlier failure
+  fail_unless(jj.commit(bad) != PBSE_NONE);
+  fail_unless(jj.commit(good) == PBSE_NONE);
+
+  jj.close_journal();
+  unlink(path);
+  }
+END_TEST
+
+
+Suite *job_journal_suite(void)
+  {
+  Suite *s = suite_create("job_journal test suite methods");
+  TCase *tc_core = tcase_create("test_append_commit_read");
+  tcase_add_test(tc_core, test_append_commit_read);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_torn_record");
+  tcase_add_test(tc_core, test_torn_record);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_replay");
+  tcase_add_test(tc_core, test_replay);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_compact");
+  tcase_add_test(tc_core, test_compact);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_failed_write");
+  tcase_add_test(tc_core, test_failed_write);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(job_journal_suite());
+  srunner_set_log(sr, "job_journal_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
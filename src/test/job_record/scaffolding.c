@@ -0,0 +1,5 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+
+int LOGLEVEL = 0;
@@ -0,0 +1,220 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <check.h>
+
+#include "pbs_error.h"
+#include "job_record.hpp"
+
+
+void make_qs(
+
+  struct jobfix &qs)
+
+  {
+  memset(&qs, 0, sizeof(qs));
+  qs.qs_version = PBS_QS_VERSION;
+  qs.ji_state = 1;
+  strcpy(qs.ji_jobid, "1.napali");
+  strcpy(qs.ji_fileprefix, "1.napali");
+  }
+
+
+void build_record(
+
+  std::string &image)
+
+  {
+  struct jobfix qs;
+
+  make_qs(qs);
+
+  job_record_builder jrb(qs);
+
+  jrb.begin_attr(0, "Job_Name");
+  jrb.add_value(NULL, "STDIN", 1);
+  jrb.begin_attr(JOB_RECORD_NO_INDEX, "Resource_List");
+  jrb.add_value("nodes", "2:ppn=4", 3);
+  jrb.add_value("walltime", "01:00:00", 3);
+  image = jrb.finish();
+  }
+
+
+START_TEST(test_round_trip)
+  {
+  std::string        image;
+  job_record_reader  jrr;
+  struct jobfix      qs;
+  char               buf[256];
+  const char        *name;
+  const char        *resc;
+  const char        *value;
+  unsigned int       flags;
+  int                index;
+
+  build_record(image);
+  fail_unless(is_job_record(image.data(), image.size()) == true);
+  fail_unless(jrr.open_record(image.data(), image.size(), buf, sizeof(buf)) == PBSE_NONE);
+
+  jrr.get_qs(qs);
+  fail_unless(!strcmp(qs.ji_jobid, "1.napali"));
+  fail_unless(qs.ji_state == 1);
+
+  fail_unless(jrr.next_attr(index, name) == true);
+  fail_unless(index == 0);
+  fail_unless(!strcmp(name, "Job_Name"));
+  fail_unless(jrr.next_value(resc, value, flags) == true);
+  fail_unless(resc == NULL);
+  fail_unless(!strcmp(value, "STDIN"));
+  fail_unless(flags == 1);
+  fail_unless(jrr.next_value(resc, value, flags) == false);
+
+  fail_unless(jrr.next_attr(index, name) == true);
+  fail_unless(index == -1);
+  fail_unless(!strcmp(name, "Resource_List"));
+  fail_unless(jrr.next_value(resc, value, flags) == true);
+  fail_unless(!strcmp(resc, "nodes"));
+  fail_unless(!strcmp(value, "2:ppn=4"));
+  fail_unless(flags == 3);
+  fail_unless(jrr.next_value(resc, value, flags) == true);
+  fail_unless(!strcmp(resc, "walltime"));
+  fail_unless(jrr.next_value(resc, value, flags) == false);
+
+  fail_unless(jrr.next_attr(index, name) == false);
+  fail_unless(jrr.is_complete() == true);
+  }
+END_TEST
+
+
+START_TEST(test_skip_values)
+  {
+  std::string        image;
+  job_record_reader  jrr;
+  char               buf[256];
+  const char        *name;
+  int                index;
+
+  // values that aren't read are skipped by next_attr()
+  build_record(image);
+  fail_unless(jrr.open_record(image.data(), image.size(), buf, sizeof(buf)) == PBSE_NONE);
+  fail_unless(jrr.next_attr(index, name) == true);
+  fail_unless(jrr.next_attr(index, name) == true);
+  fail_unless(!strcmp(name, "Resource_List"));
+  fail_unless(jrr.is_complete() == false);
+  }
+END_TEST
+
+
+START_TEST(test_bad_records)
+  {
+  std::string        image;
+  std::string        bad;
+  job_record_reader  jrr;
+  job_record_header  jr;
+  char               buf[256];
+
+  build_record(image);
+
+  // xml isn't a record
+  bad = "<?xml version=\"1.0\"?>\n<job>";
+  fail_unless(is_job_record(bad.data(), bad.size()) == false);
+  fail_unless(jrr.open_record(bad.data(), bad.size(), buf, sizeof(buf)) == PBSE_INVALID_SYNTAX);
+
+  // truncated
+  bad = image.substr(0, image.size() - 1);
+  fail_unless(jrr.open_record(bad.data(), bad.size(), buf, sizeof(buf)) == -1);
+  bad = image.substr(0, sizeof(jr) - 1);
+  fail_unless(jrr.open_record(bad.data(), bad.size(), buf, sizeof(buf)) == -1);
+
+  // corrupted
+  bad = image;
+  bad[bad.size() - 2] ^= 0x20;
+  fail_unless(jrr.open_record(bad.data(), bad.size(), buf, sizeof(buf)) == -1);
+  fail_unless(strstr(buf, "checksum") != NULL);
+
+  // written by a newer version
+  bad = image;
+  memcpy(&jr, bad.data(), sizeof(jr));
+  jr.jr_version = JOB_RECORD_VERSION + 1;
+  bad.replace(0, sizeof(jr), (const char *)&jr, sizeof(jr));
+  fail_unless(jrr.open_record(bad.data(), bad.size(), buf, sizeof(buf)) == -1);
+
+  // a different ji_qs
+  bad = image;
+  memcpy(&jr, bad.data(), sizeof(jr));
+  jr.jr_qs_version = PBS_QS_VERSION + 1;
+  bad.replace(0, sizeof(jr), (const char *)&jr, sizeof(jr));
+  fail_unless(jrr.open_record(bad.data(), bad.size(), buf, sizeof(buf)) == -1);
+  }
+END_TEST
+
+
+START_TEST(test_malformed_block)
+  {
+  std::string        image;
+  job_record_reader  jrr;
+  job_record_header  jr;
+  job_record_attr    ja;
+  char               buf[256];
+  const char        *name;
+  int                index;
+  size_t             offset;
+
+  // a block claiming to run past the end of the record is rejected even
+  // when the checksum is fixed up to match
+  build_record(image);
+  offset = sizeof(jr) + sizeof(struct jobfix);
+  memcpy(&ja, image.data() + offset, sizeof(ja));
+  ja.ja_size = image.size();
+  image.replace(offset, sizeof(ja), (const char *)&ja, sizeof(ja));
+  memcpy(&jr, image.data(), sizeof(jr));
+  jr.jr_checksum = job_record_checksum(image.data() + sizeof(jr), image.size() - sizeof(jr));
+  image.replace(0, sizeof(jr), (const char *)&jr, sizeof(jr));
+
+  fail_unless(jrr.open_record(image.data(), image.size(), buf, sizeof(buf)) == PBSE_NONE);
+  fail_unless(jrr.next_attr(index, name) == false);
+  fail_unless(jrr.is_complete() == false);
+  }
+END_TEST
+
+
+Suite *job_record_suite(void)
+  {
+  Suite *s = suite_create("job_record test suite methods");
+  TCase *tc_core = tcase_create("test_round_trip");
+  tcase_add_test(tc_core, test_round_trip);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_skip_values");
+  tcase_add_test(tc_core, test_skip_values);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_bad_records");
+  tcase_add_test(tc_core, test_bad_records);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_malformed_block");
+  tcase_add_test(tc_core, test_malformed_block);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(job_record_suite());
+  srunner_set_log(sr, "job_record_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
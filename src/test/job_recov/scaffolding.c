@@ -15,6 +15,9 @@
 #include "id_map.hpp"
 #include "completed_jobs_map.h"
 #include "pbs_nodes.h"
+#include "job_journal.hpp"
+#include "job_writer.hpp"
+#include "status_generation.hpp"
 
 const char *text_name              = "text";
 const char *PJobSubState[10];
@@ -44,6 +47,9 @@ pthread_mutex_t *listener_command_mutex;
 threadpool_t    *task_pool;
 bool ghost_array_recovery = false;
 bool cray_enabled = false;
+bool job_journal_enabled = false;
+long job_writer_threads = 0;
+bool job_binary_records = false;
 
 completed_jobs_map_class completed_jobs_map;
 
@@ -81,16 +87,6 @@ void array_get_parent_id(char *job_id, char *parent_id)
   strcpy(parent_id, "4[].napali");
   }
 
-int lock_ss()
-  {
-  return(0);
-  }
-
-int unlock_ss()
-  {
-  return(0);
-  }
-
 int write_buffer(char *buf, int len, int fds)
   {
   return(0);
@@ -182,6 +178,8 @@ int attr_to_str(std::string& ds, attribute_def *attr_def,struct pbs_attribute at
   {
   if (attr_def->at_type == ATR_TYPE_STR)
     ds = attr.at_val.at_str;
+  else if (attr_def->at_type == ATR_TYPE_LONG)
+    ds = std::to_string(attr.at_val.at_long);
   return(0);
   }
 
@@ -233,6 +231,7 @@ int array_delete(const char *array_id)
   }
 
 int array_save(job_array *pa) {return 0;}
+int array_save_counters(job_array *pa) {return 0;}
 int reply_jobid(struct batch_request *preq, char *jobid, int which) {return 0;}
 void mutex_mgr::set_unlock_on_exit(bool val) {}
 int client_to_svr(pbs_net_t hostaddr, unsigned int port, int local_port, char *EMsg) {return 0;}
@@ -431,6 +430,27 @@ job::job()
 
 job::~job() {}
 
+void job::defer_attr(int index, const char *value, unsigned int flags)
+  {
+  this->ji_deferred_attrs[index] = std::pair<std::string, unsigned int>(value, flags);
+  }
+
+bool job::get_deferred_attr(int index, std::string &value, unsigned int &flags) const
+  {
+  std::map<int, std::pair<std::string, unsigned int> >::const_iterator it = this->ji_deferred_attrs.find(index);
+
+  if ((it == this->ji_deferred_attrs.end()) ||
+      (this->ji_wattr[index].at_flags & ATR_VFLAG_SET))
+    return(false);
+
+  value = it->second.first;
+  flags = it->second.second;
+  return(true);
+  }
+
+void job::hydrate_attr(int index) {}
+void job::hydrate_attrs() {}
+
 int node_avail_complex(
 
   char *spec,   /* I - node spec */
@@ -483,6 +503,18 @@ void clear_attr(
 
 array_info::array_info() {}
 
+array_index_ranges::array_index_ranges() : ranges(), count(0) {}
+
+bool array_index_ranges::empty() const
+  {
+  return(this->count == 0);
+  }
+
+int array_index_ranges::pop_front()
+  {
+  return(-1);
+  }
+
 job_array::job_array() : job_ids(NULL), jobs_recovered(0), ai_ghost_recovered(false), uncreated_ids(),
                          ai_mutex(NULL), ai_qs()
 
@@ -534,3 +566,41 @@ int check_default_gpu_mode_str(pbs_attribute *pattr, void *pobj, int mode)
   {
   return(PBSE_NONE);
   }
+
+job_journal server_job_journal;
+
+job_journal::job_journal() {}
+
+job_journal::~job_journal() {}
+
+unsigned long job_journal::append(int type, const char *jobid, const char *fileprefix, bool is_template, const char *payload, size_t len)
+  {
+  return(0);
+  }
+
+int job_journal::commit(unsigned long seq)
+  {
+  return(-1);
+  }
+
+job_writer server_job_writer;
+
+job_writer::job_writer() {}
+
+job_writer::~job_writer() {}
+
+void job_writer::queue_save(const char *jobid, const char *fileprefix, bool is_template, const std::string &payload, bool quick) {}
+
+void job_writer::forget(const char *jobid) {}
+
+status_generation status_gen;
+
+status_generation::status_generation() {}
+status_generation::~status_generation() {}
+
+unsigned long long status_generation::next()
+  {
+  return(0);
+  }
+
+void status_generation::record_deleted(int kind, const char *name) {}
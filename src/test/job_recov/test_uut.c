@@ -22,6 +22,7 @@ extern int svr_resc_size;
 extern attribute_def job_attr_def[];
 extern void free_server_attrs(tlist_head *att_head);
 extern completed_jobs_map_class completed_jobs_map;
+extern long job_writer_threads;
 int fill_resource_list(job **pj, xmlNodePtr resource_list_node, char *log_buf, size_t buflen, const char *aname);
 void init_resc_defs();
 
@@ -203,6 +204,12 @@ START_TEST(test_add_encoded_attributes)
   fail_unless(!strcmp((const char *)child->name, ATTR_owner));
   fail_unless(!strcmp((const char *)child->children->name, "text"));
   fail_unless(!strcmp((const char *)child->children->content, "dbeer@napali"));
+
+  // an empty value isn't written, but the attribute is no longer dirty
+  attributes[JOB_ATR_jobname].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
+  attributes[JOB_ATR_jobname].at_val.at_str = strdup("");
+  add_encoded_attributes(&attr_node, attributes);
+  fail_unless((attributes[JOB_ATR_jobname].at_flags & ATR_VFLAG_MODIFY) == 0);
   
 /*  save for later
   attributes[JOB_ATR_resc_used].at_flags |= ATR_VFLAG_SET;
@@ -452,6 +459,237 @@ START_TEST(test_job_recover)
   }
 END_TEST
 
+START_TEST(test_job_record_recover)
+  {
+  char        jobFileName[MAXPATHLEN];
+  char        log_buf[1024];
+  const char *jobid = "unit_test_job4";
+  std::string image;
+
+  job *pj = create_a_job(jobid);
+  fail_unless(pj != NULL, "unable to create a job");
+  snprintf(jobFileName, MAXPATHLEN, "/tmp/%s.JB", jobid);
+  pj->ji_qs.qs_version = PBS_QS_VERSION;
+
+  fail_unless(job_record_image(pj, image) == PBSE_NONE);
+  fail_unless(write_file_image(jobFileName, std::string(jobFileName) + ".SV", image) == PBSE_NONE);
+
+  job *recov_pj = new job();
+  fail_unless(job_recov_record(jobFileName, &recov_pj, log_buf, sizeof(log_buf)) == PBSE_NONE, log_buf);
+  fail_unless(job_compare(pj, recov_pj) == 0, "jobs (saved & recovered) did not compare the same");
+
+  // job_recov() recognizes records on its own
+  job *recov_pj2 = job_recov(jobFileName);
+  fail_unless(recov_pj2 != NULL);
+  fail_unless(job_compare(pj, recov_pj2) == 0);
+
+  // xml isn't a record
+  unlink(jobFileName);
+  fail_unless(saveJobToXML(pj, jobFileName) == PBSE_NONE);
+  fail_unless(job_recov_record(jobFileName, &recov_pj, log_buf, sizeof(log_buf)) == PBSE_INVALID_SYNTAX);
+
+  // a torn record is rejected
+  image.resize(image.size() / 2);
+  fail_unless(write_file_image(jobFileName, std::string(jobFileName) + ".SV", image) == PBSE_NONE);
+  fail_unless(job_recov_record(jobFileName, &recov_pj, log_buf, sizeof(log_buf)) == -1);
+
+  unlink(jobFileName);
+  }
+END_TEST
+
+START_TEST(test_deferred_attributes)
+  {
+  char          buf[1024];
+  char          jobFileName[MAXPATHLEN];
+  const char   *jobid = "unit_test_job5";
+  const char   *vars = "PBS_O_HOST=napali,PBS_O_HOME=/home/dbeer";
+  std::string   image;
+  std::string   value;
+  unsigned int  flags;
+
+  job      *pj = create_a_job(jobid);
+  svrattrl *pal = fill_svrattr_info(ATTR_v, vars, NULL, buf, sizeof(buf));
+  pal->al_flags = ATR_VFLAG_SET;
+  pj->ji_qs.qs_version = PBS_QS_VERSION;
+  snprintf(jobFileName, MAXPATHLEN, "/tmp/%s.JB", jobid);
+
+  // recovery leaves Variable_List encoded
+  decode_attribute(pal, &pj, true);
+  fail_unless((pj->ji_wattr[JOB_ATR_variables].at_flags & ATR_VFLAG_SET) == 0);
+  fail_unless(pj->get_deferred_attr(JOB_ATR_variables, value, flags) == true);
+  fail_unless(value == vars);
+  fail_unless(flags == ATR_VFLAG_SET);
+
+  // and saving writes it back without decoding it
+  fail_unless(job_record_image(pj, image) == PBSE_NONE);
+  fail_unless(write_file_image(jobFileName, std::string(jobFileName) + ".SV", image) == PBSE_NONE);
+  job *recov_pj = new job();
+  fail_unless(job_recov_record(jobFileName, &recov_pj, buf, sizeof(buf)) == PBSE_NONE, buf);
+  fail_unless(recov_pj->get_deferred_attr(JOB_ATR_variables, value, flags) == true);
+  fail_unless(value == vars);
+
+  unlink(jobFileName);
+  fail_unless(saveJobToXML(pj, jobFileName) == PBSE_NONE);
+  job *recov_pj2 = job_recov(jobFileName);
+  fail_unless(recov_pj2 != NULL);
+  fail_unless(recov_pj2->get_deferred_attr(JOB_ATR_variables, value, flags) == true);
+  fail_unless(value == vars);
+
+  // a value set since recovery supersedes the deferred one
+  recov_pj2->ji_wattr[JOB_ATR_variables].at_flags |= ATR_VFLAG_SET;
+  fail_unless(recov_pj2->get_deferred_attr(JOB_ATR_variables, value, flags) == false);
+
+  unlink(jobFileName);
+  }
+END_TEST
+
+START_TEST(test_quick_save_record)
+  {
+  char        quickFileName[MAXPATHLEN];
+  const char *jobid = "unit_test_job2";
+
+  job *pj = create_a_job(jobid);
+  fail_unless(pj != NULL, "unable to create a job");
+  snprintf(quickFileName, MAXPATHLEN, "/tmp/%s.JQ", jobid);
+
+  // decoded attributes are dirty until the first full save
+  fail_unless(job_has_dirty_attributes(pj) == true);
+  for (int i = 0; i < JOB_ATR_LAST; i++)
+    pj->ji_wattr[i].at_flags &= ~ATR_VFLAG_MODIFY;
+  fail_unless(job_has_dirty_attributes(pj) == false);
+
+  pj->ji_qs.qs_version = PBS_QS_VERSION;
+  pj->ji_qs.ji_state = JOB_STATE_RUNNING;
+  pj->ji_qs.ji_substate = JOB_SUBSTATE_RUNNING;
+  fail_unless(save_job_quick_record(pj, quickFileName) == PBSE_NONE);
+
+  job *recov_pj = create_a_job(jobid);
+  fail_unless(apply_job_quick_record(recov_pj, quickFileName) == PBSE_NONE);
+  fail_unless(recov_pj->ji_qs.ji_state == JOB_STATE_RUNNING);
+  fail_unless(recov_pj->ji_qs.ji_substate == JOB_SUBSTATE_RUNNING);
+  fail_unless(recov_pj->ji_wattr[JOB_ATR_substate].at_val.at_long == JOB_SUBSTATE_RUNNING);
+
+  // a record for a different job must be ignored
+  job *other_pj = create_a_job("unit_test_job3");
+  fail_unless(apply_job_quick_record(other_pj, quickFileName) == -1);
+  fail_unless(other_pj->ji_qs.ji_state != JOB_STATE_RUNNING);
+
+  // a corrupt record must be ignored
+  FILE *fp = fopen(quickFileName, "r+");
+  fseek(fp, sizeof(job_quick_record) - 1, SEEK_SET);
+  fputc('x', fp);
+  fclose(fp);
+  recov_pj->ji_qs.ji_state = JOB_STATE_QUEUED;
+  fail_unless(apply_job_quick_record(recov_pj, quickFileName) == -1);
+  fail_unless(recov_pj->ji_qs.ji_state == JOB_STATE_QUEUED);
+
+  unlink(quickFileName);
+  fail_unless(apply_job_quick_record(recov_pj, quickFileName) == -1);
+  }
+END_TEST
+
+START_TEST(test_quick_save_after_hold)
+  {
+  char        jobFileName[MAXPATHLEN];
+  char        quickFileName[MAXPATHLEN];
+  const char *jobid = "unit_test_job6";
+
+  job *pj = create_a_job(jobid);
+  fail_unless(pj != NULL, "unable to create a job");
+  // path_jobs is empty, so the job's files are in the current directory
+  snprintf(jobFileName, MAXPATHLEN, "%s.JB", jobid);
+  snprintf(quickFileName, MAXPATHLEN, "%s.JQ", jobid);
+  pj->ji_qs.qs_version = PBS_QS_VERSION;
+  pj->ji_qs.ji_state = JOB_STATE_QUEUED;
+  pj->ji_qs.ji_substate = JOB_SUBSTATE_QUEUED;
+
+  fail_unless(job_save(pj, SAVEJOB_FULL, 0) == PBSE_NONE);
+  fail_unless(job_has_dirty_attributes(pj) == false);
+
+  // a state only change goes to the quick save record
+  pj->ji_qs.ji_substate = JOB_SUBSTATE_PRESTAGEIN;
+  fail_unless(job_save(pj, SAVEJOB_QUICK, 0) == PBSE_NONE);
+  fail_unless(access(quickFileName, F_OK) == 0);
+
+  // holding the job the way req_holdjob does dirties Hold_Types, so the
+  // quick save must rewrite the job file
+  pj->ji_wattr[JOB_ATR_hold].at_val.at_long |= HOLD_u;
+  pj->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
+  pj->ji_qs.ji_state = JOB_STATE_HELD;
+  pj->ji_qs.ji_substate = JOB_SUBSTATE_HELD;
+  fail_unless(job_save(pj, SAVEJOB_QUICK, 0) == PBSE_NONE);
+  fail_unless(access(quickFileName, F_OK) != 0);
+
+  job *recov_pj = job_recov(jobFileName);
+  fail_unless(recov_pj != NULL);
+  fail_unless(recov_pj->ji_qs.ji_state == JOB_STATE_HELD);
+  fail_unless((recov_pj->ji_wattr[JOB_ATR_hold].at_flags & ATR_VFLAG_SET) != 0);
+  fail_unless(recov_pj->ji_wattr[JOB_ATR_hold].at_val.at_long == HOLD_u);
+
+  unlink(jobFileName);
+  unlink(quickFileName);
+  }
+END_TEST
+
+START_TEST(test_convert_resource_list)
+  {
+  char         jobFileName[MAXPATHLEN];
+  char         log_buf[1024];
+  const char  *jobid = "unit_test_job7";
+  std::string  image;
+  resource    *presc;
+
+  init();
+  init_resc_defs();
+
+  job *pj = create_a_job(jobid);
+  fail_unless(pj != NULL, "unable to create a job");
+  pj->ji_qs.qs_version = PBS_QS_VERSION;
+  fail_unless(decode_resc(&pj->ji_wattr[JOB_ATR_resource], ATTR_l, "nodes", "2:ppn=4", ATR_DFLAG_ACCESS) == PBSE_NONE);
+  snprintf(jobFileName, MAXPATHLEN, "%s.JB", jobid);
+
+  // convert the xml job file to a job record as --convert-jobs does
+  fail_unless(saveJobToXML(pj, jobFileName) == PBSE_NONE);
+  job *xml_pj = job_recov_read(jobFileName);
+  fail_unless(xml_pj != NULL);
+  fail_unless(job_record_image(xml_pj, image) == PBSE_NONE);
+  fail_unless(write_file_image(jobFileName, std::string(jobFileName) + ".SV", image) == PBSE_NONE);
+
+  job *recov_pj = new job();
+  fail_unless(job_recov_record(jobFileName, &recov_pj, log_buf, sizeof(log_buf)) == PBSE_NONE, log_buf);
+  presc = find_resc_entry(&recov_pj->ji_wattr[JOB_ATR_resource], find_resc_def(svr_resc_def, "nodes", svr_resc_size));
+  fail_unless(presc != NULL);
+  fail_unless(!strcmp(presc->rs_value.at_val.at_str, "2:ppn=4"));
+
+  unlink(jobFileName);
+  }
+END_TEST
+
+START_TEST(test_new_job_save_is_written)
+  {
+  char        jobFileName[MAXPATHLEN];
+  const char *jobid = "unit_test_job8";
+
+  job *pj = create_a_job(jobid);
+  fail_unless(pj != NULL, "unable to create a job");
+  pj->ji_qs.qs_version = PBS_QS_VERSION;
+  snprintf(jobFileName, MAXPATHLEN, "%s.JB", jobid);
+  unlink(jobFileName);
+
+  // the writer threads write other saves later
+  job_writer_threads = 2;
+  fail_unless(job_save(pj, SAVEJOB_FULL, 0) == PBSE_NONE);
+  fail_unless(access(jobFileName, F_OK) != 0);
+
+  // but a new job is on disk before it is acknowledged
+  fail_unless(job_save(pj, SAVEJOB_NEW, 0) == PBSE_NONE);
+  fail_unless(access(jobFileName, F_OK) == 0);
+  job_writer_threads = 0;
+
+  unlink(jobFileName);
+  }
+END_TEST
+
 Suite *job_recov_suite(void)
   {
   Suite *s = suite_create("job_recov_suite methods");
@@ -468,6 +706,12 @@ Suite *job_recov_suite(void)
   tc_core = tcase_create("test_moar");
   tcase_add_test(tc_core, test_set_array_jobs_ids);
   tcase_add_test(tc_core, test_decode_attribute);
+  tcase_add_test(tc_core, test_quick_save_record);
+  tcase_add_test(tc_core, test_quick_save_after_hold);
+  tcase_add_test(tc_core, test_convert_resource_list);
+  tcase_add_test(tc_core, test_new_job_save_is_written);
+  tcase_add_test(tc_core, test_job_record_recover);
+  tcase_add_test(tc_core, test_deferred_attributes);
   suite_add_tcase(s, tc_core);
 
   return s;
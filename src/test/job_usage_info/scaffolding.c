@@ -14,5 +14,6 @@ execution_slot_tracker &execution_slot_tracker::operator =(const execution_slot_
 execution_slot_tracker::execution_slot_tracker(const execution_slot_tracker &other)
   {
   this->slots = other.slots;
+  this->slot_count = other.slot_count;
   this->open_count = other.open_count;
   }
@@ -0,0 +1,117 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#include <string>
+#include <check.h>
+
+#include "pbs_error.h"
+#include "job_writer.hpp"
+
+std::map<std::string, journal_entry> written;
+int                                  writes = 0;
+
+
+int record_write(
+
+  const std::string   &jobid,
+  const journal_entry &je)
+
+  {
+  written[jobid] = je;
+  writes++;
+  return(PBSE_NONE);
+  }
+
+
+START_TEST(test_coalesce)
+  {
+  job_writer jw;
+
+  written.clear();
+  writes = 0;
+
+  jw.queue_save("1.napali", "1.napali", false, "first", false);
+  jw.queue_save("1.napali", "1.napali", false, "second", false);
+  jw.queue_save("1.napali", "1.napali", false, "quick", true);
+  jw.queue_save("2.napali", "2.napali", true, "template", false);
+  fail_unless(jw.dirty_count() == 2);
+
+  // each job is written once with only its newest image
+  fail_unless(jw.write_batch(record_write, false) == 2);
+  fail_unless(writes == 2);
+  fail_unless(written["1.napali"].image == "second");
+  fail_unless(written["1.napali"].quick == "quick");
+  fail_unless(written["2.napali"].is_template == true);
+  fail_unless(jw.dirty_count() == 0);
+
+  // nothing left to write
+  fail_unless(jw.write_batch(record_write, false) == 0);
+
+  // a full image supersedes a queued quick record
+  jw.queue_save("1.napali", "1.napali", false, "quick2", true);
+  jw.queue_save("1.napali", "1.napali", false, "third", false);
+  fail_unless(jw.write_batch(record_write, false) == 1);
+  fail_unless(written["1.napali"].image == "third");
+  fail_unless(written["1.napali"].quick.size() == 0);
+  }
+END_TEST
+
+
+START_TEST(test_forget_and_flush)
+  {
+  job_writer jw;
+  char       jobid[64];
+
+  written.clear();
+  writes = 0;
+
+  jw.queue_save("1.napali", "1.napali", false, "image", false);
+  jw.forget("1.napali");
+  fail_unless(jw.dirty_count() == 0);
+  fail_unless(jw.write_batch(record_write, false) == 0);
+
+  // flush writes more than one batch worth of jobs
+  for (int i = 0; i < JOB_WRITER_BATCH_SIZE * 2 + 1; i++)
+    {
+    snprintf(jobid, sizeof(jobid), "%d.napali", i);
+    jw.queue_save(jobid, jobid, false, "image", false);
+    }
+
+  jw.flush(record_write);
+  fail_unless(jw.dirty_count() == 0);
+  fail_unless(writes == JOB_WRITER_BATCH_SIZE * 2 + 1);
+  }
+END_TEST
+
+
+Suite *job_writer_suite(void)
+  {
+  Suite *s = suite_create("job_writer test suite methods");
+  TCase *tc_core = tcase_create("test_coalesce");
+  tcase_add_test(tc_core, test_coalesce);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_forget_and_flush");
+  tcase_add_test(tc_core, test_forget_and_flush);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(job_writer_suite());
+  srunner_set_log(sr, "job_writer_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
@@ -7,6 +7,7 @@
 #include "threadpool.h"
 #include "execution_slot_tracker.hpp"
 #include "id_map.hpp"
+#include "status_generation.hpp"
 
 all_nodes                allnodes;
 char                    *path_mom_hierarchy = NULL;
@@ -350,3 +351,13 @@ int remove_node(all_nodes *an, struct pbsnode *pnode)
   an->unlock();
   return(PBSE_NONE);
   }
+
+status_generation status_gen;
+
+status_generation::status_generation() {}
+status_generation::~status_generation() {}
+
+unsigned long long status_generation::next()
+  {
+  return(0);
+  }
@@ -5,6 +5,8 @@
 #include <vector>
 #include <errno.h>
 #include <sys/statfs.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include "mom_hierarchy.h" /* mom_hierarchy_t, node_comm_t */
 #include "mom_server.h"
@@ -31,6 +33,7 @@ char log_buffer[LOG_BUF_SIZE];
 char *apbasil_protocol = NULL;
 char *apbasil_path = NULL;
 int is_reporter_mom = FALSE;
+int MOMConfigStatusStream = FALSE;
 mom_hierarchy_t *mh;
 u_long              localaddr = 0;
 struct config *config_array = NULL;
@@ -41,7 +44,7 @@ unsigned int default_server_port = 0;
 int ServerStatUpdateInterval = DEFAULT_SERVER_STAT_UPDATES;
 float ideal_load_val = -1.0;
 int updates_waiting_to_send = 0;
-const char *PBSServerCmds[] = { "NULL", "HELLO", "CLUSTER_ADDRS", "UPDATE", "STATUS", "GPU_STATUS", NULL };
+const char *PBSServerCmds[] = { "NULL", "HELLO", "CLUSTER_ADDRS", "UPDATE", "STATUS", "GPU_STATUS", "STATUS_STREAM", NULL };
 const char *dis_emsg[10];
 float max_load_val = -1.0;
 char TMOMRejectConn[MAXLINE];
@@ -142,9 +145,12 @@ const char *reqgres(struct rm_attribute *attrib)
   return NULL;
   }
 
+int tcp_reply_status = DIS_SUCCESS;
+int connect_count = 0;
+
 int read_tcp_reply(struct tcp_chan *chan, int protocol, int version, int command, int *exit_status)
   {
-  *exit_status = DIS_SUCCESS;
+  *exit_status = tcp_reply_status;
   return *exit_status; 
   }
 
@@ -243,11 +249,16 @@ int rpp_close(int index)
 
 int close(int fd)
   {
+  // 100 is the stream from tcp_connect_sockaddr(), the status update's pipe is real
+  if (fd < 100)
+    return(syscall(SYS_close, fd));
+
   return(0);
   }
 
 int tcp_connect_sockaddr(struct sockaddr *sa, size_t sa_size, bool use_log)
   {
+  connect_count++;
   return 100;
   }
 
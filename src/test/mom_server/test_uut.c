@@ -7,9 +7,13 @@
 #include "pbs_error.h"
 #include "mom_server.h"
 #include "resmon.h"
+#include "dis.h"
+#include "pbs_nodes.h"
 
 #define MAXLINE 1024
 #define NO_SERVER_CONFIGURED -1
+#define COULD_NOT_CONTACT_SERVER -2
+#define STATUS_UPDATES_PER_FULL 20
 
 extern mom_hierarchy_t *mh;
 
@@ -35,6 +39,16 @@ extern mom_server mom_servers[PBS_MAXSERVER];
 bool is_for_this_host(std::string gpu_spec, const char *suffix);
 void get_device_indices(const char *gpu_str, std::vector<unsigned int> &gpu_indices, const char *suffix);
 
+extern float max_load_val;
+extern float ideal_load_val;
+extern int   MOMConfigStatusStream;
+extern std::vector<std::string> status_baseline;
+extern unsigned long            status_seq;
+extern int                      updates_since_full_status;
+extern bool                     status_baseline_changed;
+extern int   tcp_reply_status;
+extern int   connect_count;
+
 START_TEST(test_sort_paths)
   {
   char before[500];
@@ -193,6 +207,7 @@ START_TEST(test_mom_server_all_update_stat_clear_force)
   {
   ServerStatUpdateInterval = 45;
   strncpy(mom_servers[0].pbs_servername, "test", PBS_MAXSERVERNAME);
+  mom_servers[0].status_stream = -1;
 
   is_reporter_mom = true;
 
@@ -220,6 +235,198 @@ START_TEST(test_mom_server_all_update_stat_clear_force)
   }
 END_TEST
 
+START_TEST(test_status_stream)
+  {
+  std::vector<std::string> status(4, "Think of a status line");
+  mom_server *pms = &mom_servers[0];
+
+  ServerStatUpdateInterval = 45;
+  MOMConfigStatusStream = TRUE;
+  strncpy(pms->pbs_servername, "test", PBS_MAXSERVERNAME);
+  pms->status_stream = -1;
+  pms->connect_failure_count = 0;
+  pms->next_connect_time = 0;
+  time_now = time(NULL);
+  connect_count = 0;
+
+  open_status_streams();
+  fail_unless(pms->status_stream == 100);
+  fail_unless(connect_count == 1);
+
+  // the update goes over the stream without connecting again
+  pms->MOMLastSendToServerTime = time_now - 100;
+  fail_unless(mom_server_update_stat(pms, status) == PBSE_NONE);
+  fail_unless(connect_count == 1);
+  fail_unless(pms->status_stream_result == STATUS_STREAM_SENT);
+
+  // an open stream is reused by the next update
+  open_status_streams();
+  fail_unless(connect_count == 1);
+  fail_unless(pms->status_stream_result == STATUS_STREAM_UNUSED);
+
+  // a failed stream falls back to a new connection and backs off
+  tcp_reply_status = UNREAD_STATUS;
+  pms->MOMLastSendToServerTime = time_now - 100;
+  fail_unless(mom_server_update_stat(pms, status) == COULD_NOT_CONTACT_SERVER);
+  fail_unless(connect_count == 2);
+  fail_unless(pms->status_stream == -1);
+  fail_unless(pms->status_stream_result == STATUS_STREAM_BROKEN);
+
+  apply_status_stream_result(pms, pms->status_stream_result);
+  fail_unless(pms->connect_failure_count == 1);
+  fail_unless(pms->next_connect_time == time_now + 2);
+
+  open_status_streams();
+  fail_unless(connect_count == 2);
+  fail_unless(pms->status_stream == -1);
+
+  // once the wait is over the stream is opened again
+  time_now += 2;
+  tcp_reply_status = DIS_SUCCESS;
+  open_status_streams();
+  fail_unless(connect_count == 3);
+  fail_unless(pms->status_stream == 100);
+
+  pms->MOMLastSendToServerTime = time_now - 100;
+  fail_unless(mom_server_update_stat(pms, status) == PBSE_NONE);
+  apply_status_stream_result(pms, pms->status_stream_result);
+  fail_unless(pms->connect_failure_count == 0);
+
+  // turning the stream off closes it
+  MOMConfigStatusStream = FALSE;
+  open_status_streams();
+  fail_unless(pms->status_stream == -1);
+  }
+END_TEST
+
+
+START_TEST(test_build_status_delta)
+  {
+  std::vector<std::string> status;
+  std::vector<std::string> update;
+
+  // nothing to compare against yet
+  status_baseline.clear();
+  status.push_back("arch=linux");
+  fail_unless(build_status_delta(status, 1, update) == false);
+
+  status_baseline.push_back("arch=linux");
+  status_baseline.push_back("state=free");
+  status_baseline.push_back("netload=10");
+  status_baseline.push_back("message=hi");
+  status_baseline.push_back(START_GPU_STATUS);
+  status_baseline.push_back("gpuid=0");
+  status_baseline.push_back("gpuid=1");
+  status_baseline.push_back(END_GPU_STATUS);
+
+  status.push_back("state=free");
+  status.push_back("netload=20");
+  status.push_back("totmem=4gb");
+  status.push_back(START_GPU_STATUS);
+  status.push_back("gpuid=0");
+  status.push_back("gpuid=1");
+  status.push_back(END_GPU_STATUS);
+
+  // unchanged strings are left out except state, gpu blocks are sent whole
+  fail_unless(build_status_delta(status, 7, update) == true);
+  fail_unless(update.size() == 9, "%d", (int)update.size());
+  fail_unless(update[0] == "status_delta=7");
+  fail_unless(update[1] == "status_removed=message");
+  fail_unless(update[2] == "state=free");
+  fail_unless(update[3] == "netload=20");
+  fail_unless(update[4] == "totmem=4gb");
+  fail_unless(update[5] == START_GPU_STATUS);
+  fail_unless(update[8] == END_GPU_STATUS);
+
+  // a repeated key can't be described as a delta
+  status.push_back("netload=30");
+  fail_unless(build_status_delta(status, 8, update) == false);
+
+  build_full_status(status, 8, update);
+  fail_unless(update.size() == status.size() + 1);
+  fail_unless(update[0] == "status_seq=8");
+  fail_unless(update[1] == "arch=linux");
+  }
+END_TEST
+
+
+START_TEST(test_status_baseline_pipe)
+  {
+  std::string msg("0 1 0");
+
+  // nothing is written if the update wasn't numbered, and the baseline is dropped
+  status_baseline_changed = false;
+  status_baseline.push_back("arch=linux");
+  encode_status_baseline(msg);
+  fail_unless(msg == "0 1 0");
+  decode_status_baseline(msg);
+  fail_unless(status_baseline.size() == 0);
+
+  status_baseline_changed = true;
+  status_seq = 12;
+  updates_since_full_status = 3;
+  status_baseline.push_back("arch=linux");
+  status_baseline.push_back("message=two\nlines");
+  status_baseline.push_back("");
+  encode_status_baseline(msg);
+
+  status_baseline.clear();
+  status_seq = 0;
+  updates_since_full_status = 0;
+  decode_status_baseline(msg);
+  fail_unless(status_seq == 12);
+  fail_unless(updates_since_full_status == 3);
+  fail_unless(status_baseline.size() == 3);
+  fail_unless(status_baseline[1] == "message=two\nlines");
+  fail_unless(status_baseline[2] == "");
+  }
+END_TEST
+
+
+START_TEST(test_send_status_on_stream)
+  {
+  std::vector<std::string> status;
+  mom_server              *pms = &mom_servers[0];
+
+  strncpy(pms->pbs_servername, "test", PBS_MAXSERVERNAME);
+  pms->status_stream = 100;
+  status.push_back("arch=linux");
+  status.push_back("state=free");
+
+  status_baseline.clear();
+  status_seq = 4;
+  updates_since_full_status = 0;
+  status_baseline_changed = false;
+
+  // the first update sends everything, the ones after it only what changed
+  fail_unless(send_status_on_stream(pms, status) == DIS_SUCCESS);
+  fail_unless(status_seq == 5);
+  fail_unless(updates_since_full_status == 0);
+  fail_unless(status_baseline == status);
+  fail_unless(status_baseline_changed == true);
+
+  status[1] = "state=busy";
+  fail_unless(send_status_on_stream(pms, status) == DIS_SUCCESS);
+  fail_unless(status_seq == 6);
+  fail_unless(updates_since_full_status == 1);
+  fail_unless(status_baseline[1] == "state=busy");
+
+  // everything is sent again periodically
+  updates_since_full_status = STATUS_UPDATES_PER_FULL;
+  fail_unless(send_status_on_stream(pms, status) == DIS_SUCCESS);
+  fail_unless(updates_since_full_status == 0);
+
+  // the baseline is kept if the server doesn't accept the update
+  tcp_reply_status = UNREAD_STATUS;
+  status[1] = "state=free";
+  fail_unless(send_status_on_stream(pms, status) != DIS_SUCCESS);
+  fail_unless(status_seq == 7);
+  fail_unless(status_baseline[1] == "state=busy");
+  tcp_reply_status = DIS_SUCCESS;
+  }
+END_TEST
+
+
 START_TEST(test_is_for_this_host)
   {
   std::string spec;
@@ -265,6 +472,36 @@ START_TEST(test_get_device_indices)
 END_TEST
 
 
+START_TEST(test_gen_load_threshold)
+  {
+  std::vector<std::string> status;
+
+  max_load_val = -1.0;
+  ideal_load_val = -1.0;
+
+  /* unconfigured thresholds are reported as 0 */
+  gen_load_threshold("max_load", status);
+  gen_load_threshold("ideal_load", status);
+  fail_unless(status.size() == 2);
+  fail_unless(status[0] == "max_load=0.00", status[0].c_str());
+  fail_unless(status[1] == "ideal_load=0.00", status[1].c_str());
+  status.clear();
+
+  max_load_val = 4.5;
+  ideal_load_val = 2.0;
+
+  gen_load_threshold("max_load", status);
+  gen_load_threshold("ideal_load", status);
+  fail_unless(status.size() == 2);
+  fail_unless(status[0] == "max_load=4.50", status[0].c_str());
+  fail_unless(status[1] == "ideal_load=2.00", status[1].c_str());
+
+  max_load_val = -1.0;
+  ideal_load_val = -1.0;
+  }
+END_TEST
+
+
 Suite *mom_server_suite(void)
   {
   Suite *s = suite_create("mom_server_suite methods");
@@ -284,6 +521,16 @@ Suite *mom_server_suite(void)
   tcase_add_test(tc_core, test_send_update_force_flag);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_status_stream");
+  tcase_add_test(tc_core, test_status_stream);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_build_status_delta");
+  tcase_add_test(tc_core, test_build_status_delta);
+  tcase_add_test(tc_core, test_status_baseline_pipe);
+  tcase_add_test(tc_core, test_send_status_on_stream);
+  suite_add_tcase(s, tc_core);
+
   tc_core = tcase_create("test_is_for_this_host");
   tcase_add_test(tc_core, test_is_for_this_host);
   suite_add_tcase(s, tc_core);
@@ -293,6 +540,10 @@ Suite *mom_server_suite(void)
   tcase_add_test(tc_core, test_mom_server_all_update_stat_clear_force);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_gen_load_threshold");
+  tcase_add_test(tc_core, test_gen_load_threshold);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
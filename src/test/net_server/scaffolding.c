@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <netinet/in.h>
+#include <sys/select.h>
 #include <string.h>
 
 #include "pbs_error.h"
@@ -109,7 +110,6 @@ void log_event(int eventtype, int objclass, const char *objname, const char *tex
 
 void initialize_connections_table()
   {
-  fprintf(stderr, "The call to initialize_connections_table needs to be mocked!!\n");
   return;
   }
 
@@ -121,14 +121,12 @@ char *PAddrToString(pbs_net_t *Addr)
 
 int get_max_num_descriptors(void)
   {
-  fprintf(stderr, "The call to get_max_num_descriptors needs to be mocked!!\n");
-  return(0);
+  return(FD_SETSIZE);
   }
 
 int get_fdset_size(void)
   {
-  fprintf(stderr, "The call to get_fdset_size needs to be mocked!!\n");
-  return(0);
+  return(sizeof(fd_set));
   }
 
 void log_err(int errnum, const char *routine, const char *text) {}
@@ -0,0 +1,12 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "node_change_log.hpp"
+
+int LOGLEVEL = 0;
+
+
+void log_err(int errnum, const char *routine, const char *text) {}
+
+void log_event(int eventtype, int objclass, const char *objname, const char *text) {}
@@ -0,0 +1,211 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/param.h>
+#include <map>
+#include <string>
+#include <check.h>
+
+#include "pbs_error.h"
+#include "node_change_log.hpp"
+
+std::map<std::string, int>         states;
+std::map<std::string, std::string> notes;
+int                                snapshot_rc = PBSE_NONE;
+
+
+void apply_state(
+
+  const char *node_name,
+  int         state)
+
+  {
+  states[node_name] = state;
+  }
+
+
+void apply_note(
+
+  const char *node_name,
+  const char *note)
+
+  {
+  notes[node_name] = note;
+  }
+
+
+int write_snapshot()
+
+  {
+  return(snapshot_rc);
+  }
+
+
+void make_log_path(
+
+  char *path)
+
+  {
+  strcpy(path, "/tmp/node_changes_XXXXXX");
+  close(mkstemp(path));
+  unlink(path);
+  }
+
+
+START_TEST(test_record_flush_replay)
+  {
+  node_change_log ncl;
+  char            path[MAXPATHLEN];
+
+  make_log_path(path);
+
+  // nothing is recorded before the log is open
+  fail_unless(ncl.record_state("napali", 1) == false);
+  fail_unless(ncl.needs_flush_task() == false);
+  fail_unless(ncl.open_log(path, 0) == PBSE_NONE);
+
+  // repeated changes to one node are coalesced
+  fail_unless(ncl.record_state("napali", 1) == true);
+  fail_unless(ncl.needs_flush_task() == true);
+  fail_unless(ncl.record_state("napali", 0) == true);
+  fail_unless(ncl.needs_flush_task() == false);
+  fail_unless(ncl.record_state("waimea", 1) == true);
+  fail_unless(ncl.record_note("napali", "bad disk") == true);
+  fail_unless(ncl.record_note("waimea", "line one\nline two") == true);
+  fail_unless(ncl.flush() == PBSE_NONE);
+
+  fail_unless(ncl.record_note("napali", "") == true);
+  fail_unless(ncl.needs_flush_task() == true);
+  fail_unless(ncl.flush() == PBSE_NONE);
+  ncl.close_log();
+
+  states.clear();
+  notes.clear();
+  fail_unless(node_change_log::replay(path, apply_state, apply_note) == 5);
+  fail_unless(states.size() == 2);
+  fail_unless(states["napali"] == 0);
+  fail_unless(states["waimea"] == 1);
+  fail_unless(notes["napali"] == "");
+  fail_unless(notes["waimea"] == "line one line two");
+
+  unlink(path);
+
+  // no log is the same as an empty one
+  fail_unless(node_change_log::replay(path, apply_state, apply_note) == 0);
+  }
+END_TEST
+
+
+START_TEST(test_torn_and_bad_records)
+  {
+  char  path[MAXPATHLEN];
+  FILE *fp;
+
+  make_log_path(path);
+  fp = fopen(path, "w");
+  fprintf(fp, "state napali 1\n");
+  fprintf(fp, "state waimea x\n");
+  fprintf(fp, "bogus napali 1\n");
+  fprintf(fp, "note napali\n");
+  fprintf(fp, "state waimea 1");
+  fclose(fp);
+
+  states.clear();
+  notes.clear();
+  fail_unless(node_change_log::replay(path, apply_state, apply_note) == 1);
+  fail_unless(states.size() == 1);
+  fail_unless(states["napali"] == 1);
+  fail_unless(notes.size() == 0);
+
+  // opening the log cuts off the torn record, so the next one is intact
+  node_change_log ncl;
+
+  fail_unless(ncl.open_log(path, 1) == PBSE_NONE);
+  fail_unless(ncl.record_state("waimea", 4) == true);
+  fail_unless(ncl.flush() == PBSE_NONE);
+  ncl.close_log();
+
+  states.clear();
+  fail_unless(node_change_log::replay(path, apply_state, apply_note) == 2);
+  fail_unless(states["waimea"] == 4);
+
+  unlink(path);
+  }
+END_TEST
+
+
+START_TEST(test_compact)
+  {
+  node_change_log ncl;
+  char            path[MAXPATHLEN];
+
+  make_log_path(path);
+
+  fail_unless(ncl.open_log(path, NODE_CHANGES_COMPACT_RECORDS - 1) == PBSE_NONE);
+  fail_unless(ncl.needs_compaction() == false);
+  ncl.record_state("napali", 1);
+  fail_unless(ncl.flush() == PBSE_NONE);
+  fail_unless(ncl.needs_compaction() == true);
+
+  // a failed snapshot leaves the log alone
+  snapshot_rc = -1;
+  fail_unless(ncl.compact(write_snapshot) == -1);
+  fail_unless(ncl.needs_compaction() == true);
+  fail_unless(node_change_log::replay(path, apply_state, apply_note) == 1);
+
+  snapshot_rc = PBSE_NONE;
+  fail_unless(ncl.compact(write_snapshot) == PBSE_NONE);
+  fail_unless(ncl.needs_compaction() == false);
+  fail_unless(node_change_log::replay(path, apply_state, apply_note) == 0);
+
+  // appends continue at the start of the truncated log
+  ncl.record_state("waimea", 1);
+  fail_unless(ncl.flush() == PBSE_NONE);
+  states.clear();
+  fail_unless(node_change_log::replay(path, apply_state, apply_note) == 1);
+  fail_unless(states.size() == 1);
+  fail_unless(states["waimea"] == 1);
+
+  ncl.close_log();
+  unlink(path);
+  }
+END_TEST
+
+
+Suite *node_change_log_suite(void)
+  {
+  Suite *s = suite_create("node_change_log test suite methods");
+  TCase *tc_core = tcase_create("test_record_flush_replay");
+  tcase_add_test(tc_core, test_record_flush_replay);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_torn_and_bad_records");
+  tcase_add_test(tc_core, test_torn_and_bad_records);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_compact");
+  tcase_add_test(tc_core, test_compact);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(node_change_log_suite());
+  srunner_set_log(sr, "node_change_log_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
@@ -23,6 +23,8 @@
 #include "mom_hierarchy_handler.h"
 #include "machine.hpp"
 #include "authorized_hosts.hpp"
+#include "node_change_log.hpp"
+#include "status_generation.hpp"
 
 std::string attrname;
 std::string attrval;
@@ -391,12 +393,18 @@ int id_map::get_new_id(char const *name)
   return(id++);
   }
 
+int id_map::rename_id(int id, char const *name)
+  {
+  return(0);
+  }
+
 id_map::~id_map() 
   {
   }
 
 
 id_map node_mapper;
+id_map property_mapper;
 id_map job_mapper;
 
 struct pbsnode *tfind_addr(
@@ -598,3 +606,51 @@ bool authorized_hosts::remove_address(unsigned long addr, unsigned short port)
 
 authorized_hosts::authorized_hosts() {}
 authorized_hosts auth_hosts;
+
+char *path_nodechanges;
+
+node_change_log node_changes;
+
+node_change_log::node_change_log() {}
+node_change_log::~node_change_log() {}
+
+bool node_change_log::is_open()
+  {
+  return(false);
+  }
+
+int node_change_log::open_log(const char *path, int existing_records)
+  {
+  return(PBSE_NONE);
+  }
+
+bool node_change_log::record_state(const char *node_name, int state)
+  {
+  return(false);
+  }
+
+bool node_change_log::record_note(const char *node_name, const std::string &note)
+  {
+  return(false);
+  }
+
+int node_change_log::replay(const char *path, node_state_apply_func apply_state, node_note_apply_func apply_note)
+  {
+  return(0);
+  }
+
+void update_node_index(pbsnode *pnode) {}
+
+void remove_from_node_index(pbsnode *pnode) {}
+
+status_generation status_gen;
+
+status_generation::status_generation() {}
+status_generation::~status_generation() {}
+
+unsigned long long status_generation::next()
+  {
+  return(0);
+  }
+
+void status_generation::record_deleted(int kind, const char *name) {}
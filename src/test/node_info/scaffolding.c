@@ -0,0 +1,99 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "pbs_ifl.h"
+#include "rm.h"
+#include "data_types.h"
+#include "config.h"
+#include "misc.h"
+#include "globals.h"
+#include "job_info.h"
+
+const char *res_to_get[] =
+  {
+  "ncpus",
+  "arch",
+  "physmem",
+  "loadave",
+  "max_load",
+  "ideal_load"
+  };
+
+const int num_resget = sizeof(res_to_get) / sizeof(char *);
+
+struct config conf;
+struct status cstat;
+int pbs_rm_port = 15003;
+
+char *string_dup(char *str)
+  {
+  if (str == NULL)
+    return(NULL);
+
+  return(strdup(str));
+  }
+
+sch_resource_t res_to_num(char *res_str)
+  {
+  return(strtol(res_str, NULL, 10));
+  }
+
+void sched_log(int event, int event_class, const char *name, const char *text) {}
+
+void free_string_array(char **arr) {}
+
+char **break_comma_list(char *list)
+  {
+  return(NULL);
+  }
+
+void free_job_info(job_info *jinfo) {}
+
+resource_req *find_resource_req(resource_req *reqlist, const char *name)
+  {
+  return(NULL);
+  }
+
+struct batch_status *pbs_statnode_err(int c, char *id, struct attrl *attrib, char *extend, int *local_errno)
+  {
+  return(NULL);
+  }
+
+char *pbs_geterrmsg(int connect)
+  {
+  return(NULL);
+  }
+
+void pbs_statfree(struct batch_status *bsp) {}
+
+int openrm(char *host, unsigned int port)
+  {
+  return(-1);
+  }
+
+int closerm_err(int *local_errno, int stream)
+  {
+  return(0);
+  }
+
+int addreq_err(int stream, int *local_errno, char *line)
+  {
+  return(-1);
+  }
+
+int begin_rm_req(int stream, int *local_errno, int num_reqs)
+  {
+  return(-1);
+  }
+
+int flushreq(void)
+  {
+  return(0);
+  }
+
+char *getreq_err(int *local_errno, int stream)
+  {
+  return(NULL);
+  }
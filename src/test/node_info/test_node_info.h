@@ -0,0 +1,8 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _NODE_INFO_CT_H
+#define _NODE_INFO_CT_H
+#include <check.h>
+
+Suite *node_info_suite();
+
+#endif /* _NODE_INFO_CT_H */
@@ -0,0 +1,90 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "test_node_info.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "data_types.h"
+#include "node_info.h"
+
+
+START_TEST(test_set_node_mom_status)
+  {
+  node_info *ninfo = new_node_info();
+
+  // a mom too old to report the load thresholds still has to be asked
+  fail_unless(set_node_mom_status(ninfo, "ncpus=8,arch=linux,loadave=1.50") == 0);
+  fail_unless(ninfo->has_mom_status == 0);
+  fail_unless(ninfo->ncpus == 8);
+  fail_unless(ninfo->loadave == 1.5);
+  free_node_info(ninfo);
+
+  // unset thresholds are reported as 0 and default to ncpus
+  ninfo = new_node_info();
+  fail_unless(set_node_mom_status(ninfo, "ncpus=8,loadave=1.50,max_load=0.00,ideal_load=0.00") == 0);
+  fail_unless(ninfo->has_mom_status == 1);
+  fail_unless(ninfo->max_load == 8.0);
+  fail_unless(ninfo->ideal_load == 8.0);
+  free_node_info(ninfo);
+
+  // configured thresholds are kept
+  ninfo = new_node_info();
+  fail_unless(set_node_mom_status(ninfo, "ncpus=8,loadave=1.50,max_load=12.00,ideal_load=6.00") == 0);
+  fail_unless(ninfo->has_mom_status == 1);
+  fail_unless(ninfo->max_load == 12.0);
+  fail_unless(ninfo->ideal_load == 6.0);
+  free_node_info(ninfo);
+  }
+END_TEST
+
+START_TEST(test_set_node_resource)
+  {
+  node_info *ninfo = new_node_info();
+  char       value[64];
+
+  // moms answer queries in name=value form
+  strcpy(value, "max_load=4.00");
+  fail_unless(set_node_resource(ninfo, "max_load", value) == 0);
+  fail_unless(ninfo->max_load == 4.0);
+
+  // a threshold the mom couldn't answer is left for the default
+  strcpy(value, "? 15201");
+  fail_unless(set_node_resource(ninfo, "ideal_load", value) == 0);
+  fail_unless(ninfo->ideal_load == 0.0);
+
+  strcpy(value, "2");
+  fail_unless(set_node_resource(ninfo, "unknown", value) == 1);
+  free_node_info(ninfo);
+  }
+END_TEST
+
+Suite *node_info_suite(void)
+  {
+  Suite *s = suite_create("node_info_suite methods");
+  TCase *tc_core = tcase_create("test_set_node_mom_status");
+  tcase_add_test(tc_core, test_set_node_mom_status);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_set_node_resource");
+  tcase_add_test(tc_core, test_set_node_resource);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(node_info_suite());
+  srunner_set_log(sr, "node_info_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
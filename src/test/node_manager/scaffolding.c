@@ -23,9 +23,12 @@
 #include "complete_req.hpp"
 #include "json/json.h"
 #include "authorized_hosts.hpp"
+#include "node_change_log.hpp"
+#include "status_generation.hpp"
 
 
 bool cray_enabled;
+long node_select_threads = 0;
 bool conn_success = true;
 bool alloc_br_success = true;
 char *path_node_usage = strdup("/tmp/idontexistatallnotevenalittle");
@@ -669,6 +672,7 @@ void capture_until_close_character(
   
 
 id_map node_mapper;
+id_map property_mapper;
 id_map job_mapper;
 
 job_usage_info::job_usage_info(int id) : internal_job_id(id)
@@ -709,7 +713,8 @@ pbsnode::pbsnode() : nd_error(0), nd_properties(),
                      nd_is_alps_login(0), nd_ms_jobs(), alps_subnodes(NULL),
                      max_subnode_nppn(0), nd_power_state(0),
                      nd_power_state_change_time(0), nd_acl(NULL),
-                     nd_requestid(), nd_tmp_unlock_count(0)
+                     nd_requestid(), nd_tmp_unlock_count(0), nd_props_generation(0),
+                     nd_gpus_generation(0), nd_index_summary(), nd_status_gen(0)
 
   {
   pthread_mutex_init(&this->nd_mutex,NULL);
@@ -832,6 +837,14 @@ int pbsnode::get_error() const
 
 
 
+const std::vector<std::string> &pbsnode::get_properties() const
+
+  {
+  return(this->nd_properties);
+  }
+
+
+
 bool pbsnode::hasprop(
 
   std::vector<prop> *plist) const
@@ -1092,3 +1105,84 @@ pbsnode *authorized_hosts::get_authorized_node(unsigned long addr, unsigned shor
 
 authorized_hosts::authorized_hosts() {}
 authorized_hosts auth_hosts;
+
+node_change_log node_changes;
+
+node_change_log::node_change_log() {}
+node_change_log::~node_change_log() {}
+
+bool node_change_log::is_open()
+  {
+  return(false);
+  }
+
+bool node_change_log::needs_flush_task()
+  {
+  return(false);
+  }
+
+int node_change_log::flush()
+  {
+  return(PBSE_NONE);
+  }
+
+bool node_change_log::needs_compaction()
+  {
+  return(false);
+  }
+
+int node_change_log::compact(node_snapshot_func write_snapshot)
+  {
+  return(PBSE_NONE);
+  }
+
+node_select_index node_index;
+
+node_select_index::node_select_index() {}
+
+node_select_index::~node_select_index() {}
+
+bool node_index_summary::same_as(const node_index_summary &other) const
+  {
+  return(false);
+  }
+
+bool node_index_inputs::same_as(const node_index_inputs &other) const
+  {
+  return((this->state == other.state) &&
+         (this->slots_free == other.slots_free) &&
+         (this->gpus_generation == other.gpus_generation));
+  }
+
+void node_select_index::update_node(int id, const char *name, const std::vector<std::string> &properties, const node_index_summary &summary) {}
+
+void node_select_index::remove_node(int id) {}
+
+bool node_select_index::is_usable()
+  {
+  return(false);
+  }
+
+void node_select_index::find_candidates(const std::vector<prop> &plist, int ppn, int gpus, int mics, bool exclusive, std::map<unsigned long, std::string> &candidates) {}
+
+void node_select_index::find_candidates_parallel(const std::vector<node_index_request> &reqs, bool exclusive, int threads, std::map<unsigned long, std::string> &candidates) {}
+
+int node_select_index::count_eligible(const std::vector<prop> &plist, int ppn, int gpus, int mics, const std::set<std::string> &skip)
+  {
+  return(0);
+  }
+
+void resolve_property(prop &p)
+  {
+  p.id = PROP_NODE_NAME;
+  }
+
+status_generation status_gen;
+
+status_generation::status_generation() {}
+status_generation::~status_generation() {}
+
+unsigned long long status_generation::next()
+  {
+  return(0);
+  }
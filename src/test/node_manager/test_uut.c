@@ -41,6 +41,7 @@ int add_job_to_mic(struct pbsnode *pnode, int index, job *pjob);
 int remove_job_from_nodes_mics(struct pbsnode *pnode, job *pjob);
 void update_failure_counts(const char *node_name, int rc);
 void check_node_jobs_existence(struct work_task *pwt);
+void update_node_index(struct pbsnode *pnode);
 
 
 
@@ -401,6 +402,42 @@ START_TEST(node_is_spec_acceptable_test)
 END_TEST
 
 
+START_TEST(update_node_index_test)
+  {
+  struct pbsnode pnode;
+
+  pnode.nd_id = 1;
+  pnode.nd_power_state = POWER_STATE_RUNNING;
+
+  for (int i = 0; i < 4; i++)
+    pnode.nd_slots.add_execution_slot();
+
+  update_node_index(&pnode);
+  fail_unless(pnode.nd_index_summary.valid == true);
+  fail_unless(pnode.nd_index_summary.available == true);
+  fail_unless(pnode.nd_index_summary.free_slots == 4);
+
+  // down and unknown nodes can't take a job
+  pnode.nd_state = INUSE_DOWN;
+  update_node_index(&pnode);
+  fail_unless(pnode.nd_index_summary.available == false);
+
+  pnode.nd_state = INUSE_UNKNOWN;
+  update_node_index(&pnode);
+  fail_unless(pnode.nd_index_summary.available == false);
+
+  // nothing is recomputed until a field the summary depends on changes
+  pnode.nd_index_summary.free_slots = -1;
+  update_node_index(&pnode);
+  fail_unless(pnode.nd_index_summary.free_slots == -1);
+
+  pnode.nd_gpus_generation++;
+  update_node_index(&pnode);
+  fail_unless(pnode.nd_index_summary.free_slots == 4);
+  }
+END_TEST
+
+
 START_TEST(process_as_node_list_test)
   {
   std::list<node_job_add_info> naji_list;
@@ -949,6 +986,7 @@ Suite *node_manager_suite(void)
   
   tc_core = tcase_create("even more tests");
   tcase_add_test(tc_core, node_is_spec_acceptable_test);
+  tcase_add_test(tc_core, update_node_index_test);
   tcase_add_test(tc_core, populate_range_string_from_job_reservation_info_test);
   tcase_add_test(tc_core, check_node_jobs_exitence_test);
   suite_add_tcase(s, tc_core);
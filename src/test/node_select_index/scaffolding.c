@@ -0,0 +1,33 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "node_select_index.hpp"
+#include "threadpool.h"
+#include "pbs_error.h"
+
+int LOGLEVEL = 0;
+threadpool_t *task_pool;
+
+int enqueued_requests = 0;
+
+int enqueue_threadpool_request(
+
+  void *(*func)(void *),
+  void *arg,
+  threadpool_t *tp)
+
+  {
+  pthread_t      tid;
+  pthread_attr_t attr;
+
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+  if (pthread_create(&tid, &attr, func, arg) != 0)
+    return(-1);
+
+  enqueued_requests++;
+
+  return(PBSE_NONE);
+  }
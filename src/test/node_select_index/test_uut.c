@@ -0,0 +1,310 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <check.h>
+
+#include "node_select_index.hpp"
+#include "runjob_help.hpp"
+
+extern int enqueued_requests;
+
+
+node_index_summary make_summary(
+
+  int  total,
+  int  free_slots,
+  bool available)
+
+  {
+  node_index_summary s;
+
+  s.valid = true;
+  s.available = available;
+  s.total_slots = total;
+  s.free_slots = free_slots;
+  s.all_slots_free = (total == free_slots);
+
+  return(s);
+  }
+
+
+std::vector<std::string> make_props(
+
+  const char *name,
+  const char *p1,
+  const char *p2)
+
+  {
+  std::vector<std::string> props;
+
+  if (p1 != NULL)
+    props.push_back(p1);
+  if (p2 != NULL)
+    props.push_back(p2);
+
+  /* every node has its own name as its last property */
+  props.push_back(name);
+
+  return(props);
+  }
+
+
+START_TEST(test_summary)
+  {
+  node_index_summary s = make_summary(8, 4, true);
+  node_index_summary other = s;
+
+  fail_unless(s.same_as(other) == true);
+  other.free_slots = 3;
+  fail_unless(s.same_as(other) == false);
+
+  fail_unless(s.is_eligible(8, 0, 0) == true);
+  fail_unless(s.is_eligible(9, 0, 0) == false);
+  fail_unless(s.is_eligible(1, 1, 0) == false);
+
+  fail_unless(s.can_run(4, 0, 0, false) == true);
+  fail_unless(s.can_run(5, 0, 0, false) == false);
+  fail_unless(s.can_run(1, 0, 0, true) == false);
+
+  s.free_slots = 8;
+  s.all_slots_free = true;
+  fail_unless(s.can_run(1, 0, 0, true) == true);
+
+  s.available = false;
+  fail_unless(s.can_run(1, 0, 0, false) == false);
+  fail_unless(s.is_eligible(1, 0, 0) == true);
+  }
+END_TEST
+
+
+START_TEST(test_find_candidates)
+  {
+  node_select_index                    nsi;
+  std::map<unsigned long, std::string> candidates;
+  std::vector<prop>                    plist;
+
+  fail_unless(nsi.is_usable() == false);
+
+  nsi.update_node(0, "n0", make_props("n0", "fast", NULL), make_summary(8, 8, true));
+  nsi.update_node(1, "n1", make_props("n1", "fast", NULL), make_summary(8, 2, true));
+  nsi.update_node(2, "n2", make_props("n2", "slow", NULL), make_summary(8, 8, true));
+  nsi.update_node(3, "n3", make_props("n3", "fast", NULL), make_summary(8, 8, false));
+  fail_unless(nsi.is_usable() == true);
+  fail_unless(nsi.size() == 4);
+
+  nsi.find_candidates(plist, 1, 0, 0, false, candidates);
+  fail_unless(candidates.size() == 3);
+  fail_unless(candidates.begin()->second == "n0");
+  fail_unless(candidates.rbegin()->second == "n2");
+
+  candidates.clear();
+  plist.push_back(prop("fast"));
+  nsi.find_candidates(plist, 4, 0, 0, false, candidates);
+  fail_unless(candidates.size() == 1);
+  fail_unless(candidates.begin()->second == "n0");
+
+  /* a node name only matches that node */
+  candidates.clear();
+  plist.clear();
+  plist.push_back(prop("n1"));
+  nsi.find_candidates(plist, 1, 0, 0, false, candidates);
+  fail_unless(candidates.size() == 1);
+  fail_unless(candidates.begin()->second == "n1");
+
+  candidates.clear();
+  plist.push_back(prop("slow"));
+  nsi.find_candidates(plist, 1, 0, 0, false, candidates);
+  fail_unless(candidates.size() == 0);
+
+  /* unmarked properties don't count */
+  candidates.clear();
+  plist.clear();
+  plist.push_back(prop("nonexistent"));
+  plist[0].mark = 0;
+  nsi.find_candidates(plist, 1, 0, 0, true, candidates);
+  fail_unless(candidates.size() == 2);
+  }
+END_TEST
+
+
+START_TEST(test_updates_and_removal)
+  {
+  node_select_index                    nsi;
+  std::map<unsigned long, std::string> candidates;
+  std::vector<prop>                    plist;
+  node_index_summary                   s = make_summary(4, 4, true);
+
+  nsi.update_node(0, "n0", make_props("n0", NULL, NULL), s);
+  nsi.update_node(1, "n1", make_props("n1", NULL, NULL), s);
+
+  /* the node moves between buckets as its free slots change */
+  s.free_slots = 0;
+  s.all_slots_free = false;
+  nsi.update_node(0, "n0", make_props("n0", NULL, NULL), s);
+  nsi.find_candidates(plist, 1, 0, 0, false, candidates);
+  fail_unless(candidates.size() == 1);
+  fail_unless(candidates.begin()->second == "n1");
+
+  /* new properties move the node to another group */
+  s.props_generation++;
+  s.free_slots = 4;
+  s.all_slots_free = true;
+  nsi.update_node(0, "n0", make_props("n0", "bigmem", NULL), s);
+  plist.push_back(prop("bigmem"));
+  candidates.clear();
+  nsi.find_candidates(plist, 1, 0, 0, false, candidates);
+  fail_unless(candidates.size() == 1);
+  fail_unless(candidates.begin()->second == "n0");
+
+  nsi.remove_node(0);
+  candidates.clear();
+  nsi.find_candidates(plist, 1, 0, 0, false, candidates);
+  fail_unless(candidates.size() == 0);
+  fail_unless(nsi.size() == 1);
+
+  /* nodes with subnodes make the index unusable until they're gone */
+  s.indexable = false;
+  nsi.update_node(2, "n2", make_props("n2", NULL, NULL), s);
+  fail_unless(nsi.is_usable() == false);
+  nsi.remove_node(2);
+  fail_unless(nsi.is_usable() == true);
+  }
+END_TEST
+
+
+START_TEST(test_count_eligible)
+  {
+  node_select_index     nsi;
+  std::vector<prop>     plist;
+  std::set<std::string> skip;
+  node_index_summary    s = make_summary(8, 0, false);
+
+  nsi.update_node(0, "n0", make_props("n0", "gpu", NULL), s);
+  s.gpus_total = 2;
+  nsi.update_node(1, "n1", make_props("n1", "gpu", NULL), s);
+  nsi.update_node(2, "n2", make_props("n2", "gpu", NULL), make_summary(2, 2, true));
+
+  fail_unless(nsi.count_eligible(plist, 4, 0, 0, skip) == 2);
+  fail_unless(nsi.count_eligible(plist, 4, 1, 0, skip) == 1);
+
+  plist.push_back(prop("gpu"));
+  fail_unless(nsi.count_eligible(plist, 1, 0, 0, skip) == 3);
+
+  skip.insert("n1");
+  fail_unless(nsi.count_eligible(plist, 1, 0, 0, skip) == 2);
+
+  plist.push_back(prop("n1"));
+  fail_unless(nsi.count_eligible(plist, 1, 0, 0, skip) == 0);
+  skip.clear();
+  fail_unless(nsi.count_eligible(plist, 1, 0, 0, skip) == 1);
+  }
+END_TEST
+
+
+START_TEST(test_find_candidates_parallel)
+  {
+  node_select_index                    nsi;
+  std::map<unsigned long, std::string> serial;
+  std::map<unsigned long, std::string> parallel;
+  std::vector<prop>                    fast;
+  std::vector<prop>                    by_name;
+  std::vector<node_index_request>      reqs;
+  char                                 name[32];
+  int                                  node_count = 3000;
+
+  for (int i = 0; i < node_count; i++)
+    {
+    snprintf(name, sizeof(name), "n%d", i);
+    nsi.update_node(i, name, make_props(name, (i % 3 == 0) ? "fast" : "slow", NULL),
+                    make_summary(8, i % 9, (i % 7) != 0));
+    }
+
+  /* some nodes go away and come back, so the index order isn't the id order */
+  for (int i = 0; i < node_count; i += 100)
+    nsi.remove_node(i);
+
+  for (int i = 0; i < node_count; i += 200)
+    {
+    snprintf(name, sizeof(name), "n%d", i);
+    nsi.update_node(i, name, make_props(name, "fast", NULL), make_summary(8, 8, true));
+    }
+
+  fast.push_back(prop("fast"));
+  by_name.push_back(prop("n1501"));
+
+  reqs.push_back(node_index_request(&fast, 6, 0, 0));
+  reqs.push_back(node_index_request(&by_name, 1, 0, 0));
+
+  nsi.find_candidates(fast, 6, 0, 0, false, serial);
+  nsi.find_candidates(by_name, 1, 0, 0, false, serial);
+
+  enqueued_requests = 0;
+  nsi.find_candidates_parallel(reqs, false, 4, parallel);
+  fail_unless(enqueued_requests == 3);
+  fail_unless(serial.size() > 0);
+  fail_unless(parallel == serial);
+
+  /* too few nodes to split for that many threads */
+  parallel.clear();
+  enqueued_requests = 0;
+  nsi.find_candidates_parallel(reqs, false, 64, parallel);
+  fail_unless(enqueued_requests == (int)(nsi.size() / NODE_SELECT_MIN_PARTITION) - 1);
+  fail_unless(parallel == serial);
+
+  serial.clear();
+  parallel.clear();
+  nsi.find_candidates(fast, 1, 0, 0, true, serial);
+  reqs.clear();
+  reqs.push_back(node_index_request(&fast, 1, 0, 0));
+  nsi.find_candidates_parallel(reqs, true, 1, parallel);
+  fail_unless(parallel == serial);
+  }
+END_TEST
+
+
+Suite *node_select_index_suite(void)
+  {
+  Suite *s = suite_create("node_select_index test suite methods");
+  TCase *tc_core = tcase_create("test_summary");
+  tcase_add_test(tc_core, test_summary);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_find_candidates");
+  tcase_add_test(tc_core, test_find_candidates);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_updates_and_removal");
+  tcase_add_test(tc_core, test_updates_and_removal);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_find_candidates_parallel");
+  tcase_add_test(tc_core, test_find_candidates_parallel);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_count_eligible");
+  tcase_add_test(tc_core, test_count_eligible);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(node_select_index_suite());
+  srunner_set_log(sr, "node_select_index_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
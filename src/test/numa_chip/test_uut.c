@@ -1096,6 +1096,53 @@ START_TEST(test_reserve_accelerators)
 END_TEST
 
 
+START_TEST(test_free_core_count)
+  {
+  const char *jobid = "1.napali";
+  const char *jobid2 = "2.napali";
+  const char *host = "napali";
+  req r;
+  r.set_value("lprocs", "2", false);
+
+  allocation a(jobid);
+
+  Chip c;
+  c.setId(0);
+  c.setThreads(24);
+  c.setCores(12);
+  c.setMemory(40);
+  c.setChipAvailable(true);
+  for (int i = 0; i < 12; i++)
+    c.make_core(i);
+
+  fail_unless(c.free_core_count() == 12);
+
+  // whole cores
+  thread_type = use_cores;
+  my_placement_type = "";
+  fail_unless(c.place_task(r, a, 2, host) == 2);
+  fail_unless(c.free_core_count() == 8, "%d free", c.free_core_count());
+
+  // threads, which can leave a core partly used
+  thread_type = "";
+  a.clear();
+  a.jobid = jobid2;
+  fail_unless(c.place_task(r, a, 3, host) == 3);
+  fail_unless(c.free_core_count() == 5, "%d free", c.free_core_count());
+
+  c.free_task(jobid);
+  fail_unless(c.free_core_count() == 9, "%d free", c.free_core_count());
+
+  c.free_task(jobid2);
+  fail_unless(c.free_core_count() == 12, "%d free", c.free_core_count());
+
+  // copies keep the count
+  Chip copy(c);
+  fail_unless(copy.free_core_count() == 12);
+  }
+END_TEST
+
+
 START_TEST(test_place_and_free_task)
   {
   const char *jobid = "1.napali";
@@ -1203,6 +1250,7 @@ Suite *numa_socket_suite(void)
   tc_core = tcase_create("test_displayAsString");
   tcase_add_test(tc_core, test_displayAsString);
   tcase_add_test(tc_core, test_place_and_free_task);
+  tcase_add_test(tc_core, test_free_core_count);
   tcase_add_test(tc_core, test_exclusive_place);
   tcase_add_test(tc_core, test_json_constructor);
   tcase_add_test(tc_core, test_basic_constructor);
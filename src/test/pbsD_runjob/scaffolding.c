@@ -16,6 +16,12 @@ int encode_DIS_RunJob(struct tcp_chan *chan, char *jobid, char *where, unsigned
   exit(1);
   }
 
+int encode_DIS_RunJobs(struct tcp_chan *chan, int count, char **jids, char **wheres)
+  {
+  fprintf(stderr, "The call to encode_DIS_RunJobs needs to be mocked!!\n");
+  exit(1);
+  }
+
 struct tcp_chan *DIS_tcp_setup(int fd)
   {
   fprintf(stderr, "The call to DIS_tcp_setup needs to be mocked!!\n");
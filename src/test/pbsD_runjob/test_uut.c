@@ -18,10 +18,37 @@ START_TEST(test_pbs_runjob_err)
 END_TEST
 
 
-START_TEST(test_two)
+START_TEST(test_pbs_runjobs_err)
   {
+  int   err;
+  int   codes[2];
+  char *jobids[] = { strdup("1.napali"), strdup("2.napali") };
 
+  fail_unless(pbs_runjobs_err(0, 2, NULL, NULL, NULL, codes, &err) == PBSE_IVALREQ * -1);
+  fail_unless(pbs_runjobs_err(0, 2, jobids, NULL, NULL, NULL, &err) == PBSE_IVALREQ * -1);
+  fail_unless(pbs_runjobs_err(0, 0, jobids, NULL, NULL, codes, &err) == PBSE_IVALREQ * -1);
+  fail_unless(pbs_runjobs_err(0, PBS_RUNJOBS_MAX + 1, jobids, NULL, NULL, codes, &err) == PBSE_IVALREQ * -1);
+  fail_unless(pbs_runjobs_err(-1, 2, jobids, NULL, NULL, codes, &err) == PBSE_IVALREQ * -1);
+  }
+END_TEST
+
+
+START_TEST(test_parse_runjobs_reply)
+  {
+  int codes[3];
+
+  fail_unless(parse_runjobs_reply("1.napali 0\n2.napali 15001\n3.napali 15046\n", 3, codes) == PBSE_NONE);
+  fail_unless(codes[0] == PBSE_NONE);
+  fail_unless(codes[1] == PBSE_UNKJOBID);
+  fail_unless(codes[2] == 15046);
+
+  /* the last newline is optional */
+  fail_unless(parse_runjobs_reply("1.napali 0\n2.napali 15001", 2, codes) == PBSE_NONE);
+  fail_unless(codes[1] == PBSE_UNKJOBID);
 
+  fail_unless(parse_runjobs_reply("1.napali 0\n", 2, codes) == PBSE_PROTOCOL);
+  fail_unless(parse_runjobs_reply("1.napali\n2.napali 0\n", 2, codes) == PBSE_PROTOCOL);
+  fail_unless(parse_runjobs_reply("1.napali zero\n", 1, codes) == PBSE_PROTOCOL);
   }
 END_TEST
 
@@ -32,8 +59,9 @@ Suite *pbsD_runjob_suite(void)
   tcase_add_test(tc_core, test_pbs_runjob_err);
   suite_add_tcase(s, tc_core);
 
-  tc_core = tcase_create("test_two");
-  tcase_add_test(tc_core, test_two);
+  tc_core = tcase_create("test_pbs_runjobs_err");
+  tcase_add_test(tc_core, test_pbs_runjobs_err);
+  tcase_add_test(tc_core, test_parse_runjobs_reply);
   suite_add_tcase(s, tc_core);
 
   return s;
@@ -3,11 +3,62 @@
 #include <stdio.h> /* fprintf */
 
 #include "attribute.h" /* attrl */
+#include "libpbs.h" /* connect_handle */
+#include "pbs_ifl.h" /* PBS_MAXUSER */
 
 int pbs_errno = 0;
+struct connect_handle connection[10];
+char pbs_current_user[PBS_MAXUSER];
+const char *dis_emsg[10];
 
 struct batch_status *PBSD_status(int c, int function, int *local_errno, char *id, struct attrl *attrib, char *extend)
  {
  fprintf(stderr, "The call to PBSD_manager needs to be mocked!!\n");
  exit(1);
  }
+
+int PBSD_snapshot_get(int *local_errno, int c, struct batch_snapshot *snap)
+  {
+  fprintf(stderr, "The call to PBSD_snapshot_get needs to be mocked!!\n");
+  exit(1);
+  }
+
+int encode_DIS_StatusSnapshot(struct tcp_chan *chan, struct attrl *svr_attrl, struct attrl *que_attrl, struct attrl *job_attrl, struct attrl *node_attrl)
+  {
+  fprintf(stderr, "The call to encode_DIS_StatusSnapshot needs to be mocked!!\n");
+  exit(1);
+  }
+
+int encode_DIS_ReqHdr(struct tcp_chan *chan, int reqt, char *user)
+  {
+  fprintf(stderr, "The call to encode_DIS_ReqHdr needs to be mocked!!\n");
+  exit(1);
+  }
+
+int encode_DIS_ReqExtend(struct tcp_chan *chan, char *extend)
+  {
+  fprintf(stderr, "The call to encode_DIS_ReqExtend needs to be mocked!!\n");
+  exit(1);
+  }
+
+struct tcp_chan *DIS_tcp_setup(int fd)
+  {
+  fprintf(stderr, "The call to DIS_tcp_setup needs to be mocked!!\n");
+  exit(1);
+  }
+
+int DIS_tcp_wflush(tcp_chan *chan)
+  {
+  fprintf(stderr, "The call to DIS_tcp_wflush needs to be mocked!!\n");
+  exit(1);
+  }
+
+void DIS_tcp_cleanup(struct tcp_chan *chan)
+  {
+  }
+
+void pbs_statfree(struct batch_status *bsp)
+  {
+  fprintf(stderr, "The call to pbs_statfree needs to be mocked!!\n");
+  exit(1);
+  }
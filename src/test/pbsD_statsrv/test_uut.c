@@ -16,8 +16,19 @@ END_TEST
 
 START_TEST(test_two)
   {
+  struct batch_snapshot snap;
+  int                   local_errno = 0;
 
+  fail_unless(pbs_statsnapshot_err(0, NULL, NULL, NULL, NULL, NULL, NULL, &local_errno) == PBSE_IVALREQ);
+  fail_unless(local_errno == PBSE_IVALREQ);
 
+  snap.jobs = (struct batch_status *)&snap;
+  local_errno = 0;
+  fail_unless(pbs_statsnapshot_err(-1, NULL, NULL, NULL, NULL, NULL, &snap, &local_errno) == PBSE_IVALREQ);
+  fail_unless(local_errno == PBSE_IVALREQ);
+  fail_unless(snap.jobs == NULL);
+
+  fail_unless(pbs_statsnapshot_err(PBS_NET_MAX_CONNECTIONS, NULL, NULL, NULL, NULL, NULL, &snap, &local_errno) == PBSE_IVALREQ);
   }
 END_TEST
 
@@ -20,6 +20,7 @@
 #include "queue.h" /* all_queues, pbs_queue */
 #include "user_info.h"
 #include "id_map.hpp"
+#include "job_journal.hpp"
 #include "mom_hierarchy_handler.h"
 #include "machine.hpp"
 #include "queue.h"
@@ -83,6 +84,7 @@ char *path_spool;
 const char *msg_init_abt = "Job aborted on PBS Server initialization";
 const char *msg_init_noqueues = "No queues to open";
 char *path_nodenote_new;
+char *path_nodechanges;
 char *path_svrdb = NULL;
 threadpool_t *request_pool;
 const char *msg_init_baddb = "Unable to read server database";
@@ -297,8 +299,7 @@ job *next_job(all_jobs *aj, all_jobs_iterator *iter)
 
 int chk_file_sec(const char *path, int isdir, int sticky, int disallow, int fullpath, char *SEMsg)
   {
-  fprintf(stderr, "The call to chk_file_sec needs to be mocked!!\n");
-  exit(1);
+  return(0);
   }
 
 void log_close(int msg)
@@ -378,6 +379,31 @@ job *job_recov(const char *filename)
   exit(1);
   }
 
+int job_files_read = 0;
+int job_files_read_without_rescs = 0;
+int resc_defs_inited = 0;
+int journals_replayed = 0;
+int journals_replayed_before_read = 0;
+pthread_mutex_t job_files_read_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+job *job_recov_read(const char *filename)
+  {
+  pthread_mutex_lock(&job_files_read_mutex);
+  job_files_read++;
+  // decoding a Resource_List needs the resource definitions, extra_resc included
+  if ((svr_resc_def == NULL) ||
+      (resc_defs_inited == 0))
+    job_files_read_without_rescs++;
+  pthread_mutex_unlock(&job_files_read_mutex);
+
+  return(new job());
+  }
+
+int job_recov_link(job **pjob)
+  {
+  return(0);
+  }
+
 void initialize_recycler()
   {
   fprintf(stderr, "The call to initialize_recycler needs to be mocked!!\n");
@@ -397,8 +423,11 @@ pbs_queue *que_recov_xml(char *filename)
 
 int init_resc_defs(void)
   {
-  fprintf(stderr, "The call to init_resc_defs needs to be mocked!!\n");
-  exit(1);
+  static resource_def resc_defs[1];
+
+  svr_resc_def = resc_defs;
+  resc_defs_inited++;
+  return(0);
   }
 
 void free_arst(struct pbs_attribute *attr)
@@ -538,6 +567,7 @@ int enqueue_threadpool_request(
   threadpool_t *tp)
 
   {
+  func(arg);
   return(0);
   }
 
@@ -986,3 +1016,37 @@ void job_array::update_array_values(
 
   {
   }
+
+job_journal server_job_journal;
+
+job_journal::job_journal() {}
+
+job_journal::~job_journal() {}
+
+int job_journal::open_journal(const char *path)
+  {
+  return(0);
+  }
+
+int job_journal::replay(const char *path, journal_apply_func apply)
+  {
+  journals_replayed++;
+  if (job_files_read == 0)
+    journals_replayed_before_read++;
+  return(0);
+  }
+
+int write_journal_entry(const std::string &jobid, const journal_entry &je)
+  {
+  return(0);
+  }
+
+int job_file_image(job *pjob, std::string &image)
+  {
+  return(0);
+  }
+
+int write_file_image(const std::string &filename, const std::string &tmp_name, const std::string &image)
+  {
+  return(0);
+  }
@@ -9,11 +9,15 @@
 
 #include "pbs_error.h"
 #include "queue.h"
+#include "resource.h"
 
 int mk_subdirs(char **);
 int pbsd_init_reque(job *, int);
 void check_jobs_queue(job *pjob);
 void remove_invalid_allocations(pbsnode *pnode);
+void add_job_file(const char *, const char *, std::vector<std::string> &);
+void read_job_files(std::vector<std::string> &, std::vector<job *> &);
+bool job_rank_less(job *, job *);
 
 extern char global_log_ext_msg[LOCAL_LOG_BUF_SIZE];
 extern int enque_rc;
@@ -24,6 +28,13 @@ extern int job_state;
 extern bool dont_find_job;
 extern bool dont_find_node;
 extern pbs_queue *allocd_queue;
+extern int job_files_read;
+extern int job_files_read_without_rescs;
+extern int resc_defs_inited;
+extern int journals_replayed;
+extern int journals_replayed_before_read;
+extern const char *path_home;
+extern char *path_priv;
 
 #ifdef PENABLE_LINUX_CGROUPS
 START_TEST(test_remove_invalid_allocations)
@@ -100,6 +111,111 @@ START_TEST(test_mk_subdirs)
   }
 END_TEST
 
+START_TEST(test_add_job_file)
+  {
+  std::vector<std::string> job_files;
+
+  add_job_file(NULL, ".", job_files);
+  add_job_file(NULL, "1.napali.SC", job_files);
+  add_job_file(NULL, ".JB", job_files);
+  fail_unless(job_files.size() == 0);
+
+  add_job_file(NULL, "1.napali.JB", job_files);
+  add_job_file("2", "2[].napali.TA", job_files);
+  fail_unless(job_files.size() == 2);
+  fail_unless(job_files[0] == "1.napali.JB");
+  fail_unless(job_files[1] == "2/2[].napali.TA");
+  }
+END_TEST
+
+START_TEST(test_read_job_files)
+  {
+  std::vector<std::string> job_files;
+  std::vector<job *>       jobs;
+  char                     name[MAXPATHLEN];
+
+  fail_unless(system("mkdir -p ./recov_test") == 0);
+
+  // enough files that the readers share them out in several chunks
+  for (int i = 0; i < 100; i++)
+    {
+    snprintf(name, sizeof(name), "recov_test/%d.napali.JB", i);
+    FILE *fp = fopen(name, "w");
+    fail_unless(fp != NULL);
+    fclose(fp);
+    job_files.push_back(name);
+    }
+
+  // a file that disappeared isn't read
+  job_files.push_back("recov_test/gone.napali.JB");
+
+  job_files_read = 0;
+  read_job_files(job_files, jobs);
+  fail_unless(job_files_read == 100);
+  fail_unless(jobs.size() == 101);
+
+  for (int i = 0; i < 100; i++)
+    fail_unless(jobs[i] != NULL);
+
+  fail_unless(jobs[100] == NULL);
+
+  fail_unless(system("rm -rf ./recov_test") == 0);
+  }
+END_TEST
+
+START_TEST(test_convert_job_files)
+  {
+  char                 cwd[MAXPATHLEN];
+  char                 home[MAXPATHLEN];
+  const char          *old_home = path_home;
+  static resource_def  stale_defs[1];
+
+  fail_unless(getcwd(cwd, sizeof(cwd)) != NULL);
+  snprintf(home, sizeof(home), "%s/convert_test", cwd);
+  fail_unless(system("mkdir -p ./convert_test/checkpoint ./convert_test/server_priv/jobs") == 0);
+  fail_unless(system("touch ./convert_test/server_priv/jobs/1.napali.JB") == 0);
+
+  // the definitions built before the server attributes were recovered lack extra_resc
+  path_home = home;
+  path_priv = NULL;
+  svr_resc_def = stale_defs;
+  job_files_read = 0;
+  job_files_read_without_rescs = 0;
+  resc_defs_inited = 0;
+  journals_replayed = 0;
+  journals_replayed_before_read = 0;
+
+  // jobs are decoded with the rebuilt resource definitions, so a Resource_List
+  // using extra_resc decodes, and only after the journal was folded into the files
+  fail_unless(convert_job_files(true) == PBSE_NONE);
+  fail_unless(job_files_read == 1);
+  fail_unless(resc_defs_inited == 1);
+  fail_unless(svr_resc_def != stale_defs);
+  fail_unless(job_files_read_without_rescs == 0);
+  fail_unless(journals_replayed == 2);
+  fail_unless(journals_replayed_before_read == 2);
+
+  fail_unless(chdir(cwd) == 0);
+  path_home = old_home;
+  path_priv = NULL;
+  fail_unless(system("rm -rf ./convert_test") == 0);
+  }
+END_TEST
+
+START_TEST(test_job_rank_less)
+  {
+  job a;
+  job b;
+
+  a.ji_wattr[JOB_ATR_qrank].at_val.at_long = 5;
+  b.ji_wattr[JOB_ATR_qrank].at_val.at_long = 7;
+
+  fail_unless(job_rank_less(&a, &b) == true);
+  fail_unless(job_rank_less(&b, &a) == false);
+  fail_unless(job_rank_less(&a, &a) == false);
+  }
+END_TEST
+
 START_TEST(test_pbsd_init_reque)
   {
   job *pjob = (job *)calloc(1, sizeof(job));
@@ -135,6 +251,13 @@ Suite *pbsd_init_suite(void)
   tcase_add_test(tc_core, test_check_jobs_queue);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_add_job_file");
+  tcase_add_test(tc_core, test_add_job_file);
+  tcase_add_test(tc_core, test_read_job_files);
+  tcase_add_test(tc_core, test_convert_job_files);
+  tcase_add_test(tc_core, test_job_rank_less);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
@@ -19,8 +19,14 @@
 #include "completed_jobs_map.h"
 #include "acl_special.hpp"
 #include "authorized_hosts.hpp"
+#include "job_journal.hpp"
+#include "job_writer.hpp"
+#include "node_change_log.hpp"
 
 bool exit_called = false;
+bool job_journal_enabled = false;
+long job_writer_threads = 0;
+bool job_binary_records = false;
 pthread_mutex_t *job_log_mutex;
 pthread_mutex_t *log_mutex;
 all_queues svr_queues;
@@ -329,6 +335,11 @@ int pbsd_init(int type)
   exit(1);
   }
 
+int convert_job_files(bool to_binary)
+  {
+  return(0);
+  }
+
 int disrsi(tcp_chan *chan, int *retval)
   {
   fprintf(stderr, "The call to disrsi needs to be mocked!!\n");
@@ -515,7 +526,37 @@ void clear_all_alps_reservations() {}
 completed_jobs_map_class::completed_jobs_map_class() {}
 completed_jobs_map_class::~completed_jobs_map_class() {}
 void *remove_completed_jobs(void *vp) {return(NULL);}
+void *poll_status_streams(void *vp) {return(NULL);}
+
+int init_status_stream_poller() {return(0);}
+
+void *compact_job_journal(void *vp) {return(NULL);}
+
+void *write_dirty_jobs(void *vp) {return(NULL);}
+
+job_writer server_job_writer;
+
+job_writer::job_writer() {}
+
+job_writer::~job_writer() {}
+
+void job_writer::flush(journal_apply_func apply) {}
+
+int write_journal_entry(const std::string &jobid, const journal_entry &je)
+  {
+  return(0);
+  }
 
 acl_special::acl_special() {}
 
 authorized_hosts::authorized_hosts() {}
+
+node_change_log node_changes;
+
+node_change_log::node_change_log() {}
+node_change_log::~node_change_log() {}
+
+int node_change_log::flush()
+  {
+  return(0);
+  }
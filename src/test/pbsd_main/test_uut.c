@@ -17,6 +17,7 @@ extern int server_init_type;
 extern completed_jobs_map_class completed_jobs_map;
 extern bool TDoBackground;
 extern bool LineBufferOutput;
+extern const char *convert_jobs_to;
 
 bool are_we_forking()
 
@@ -123,6 +124,19 @@ START_TEST(test_parse_command_line_case7)
 END_TEST
 
 
+START_TEST(test_parse_command_line_convert_jobs)
+  {
+  char *argv[] = {strdup("pbs_server"), strdup("--convert-jobs=binary")};
+  set_optind();
+
+  convert_jobs_to = NULL;
+  parse_command_line(2, argv);
+  fail_unless(convert_jobs_to != NULL);
+  fail_unless(!strcmp(convert_jobs_to, "binary"));
+  }
+END_TEST
+
+
 Suite *pbsd_main_suite(void)
   {
   Suite *s = suite_create("pbsd_main_suite methods");
@@ -157,6 +171,10 @@ Suite *pbsd_main_suite(void)
   tcase_add_test(tc_core, test_parse_command_line_case7);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_parse_command_line_convert_jobs");
+  tcase_add_test(tc_core, test_parse_command_line_convert_jobs);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
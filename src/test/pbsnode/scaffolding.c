@@ -12,6 +12,7 @@ extern std::string global_string;
 AvlTree                 ipaddrs = NULL;
 int                     LOGLEVEL = 10;
 id_map                  node_mapper;
+id_map                  property_mapper;
 mom_hierarchy_handler   hierarchy_handler; //The global declaration.
 bool                    exit_called;
 bool                    cray_enabled;
@@ -41,6 +42,16 @@ int id_map::get_new_id(const char *nodename)
   return(0);
   }
 
+int id_map::get_id(const char *name)
+  {
+  return(-1);
+  }
+
+int id_map::rename_id(int id, const char *name)
+  {
+  return(0);
+  }
+
 struct prop *init_prop(
 
   const char *pname) /* I */
@@ -221,3 +232,5 @@ int node_status_list(
   {
   return(0);
   }
+
+void update_node_index(pbsnode *pnode) {}
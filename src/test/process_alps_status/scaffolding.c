@@ -1914,3 +1914,4 @@ void Machine::setMemory(long long mem)
   }
 #endif
 
+void job::hydrate_attr(int index) {}
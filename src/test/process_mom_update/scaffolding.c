@@ -15,6 +15,7 @@
 #include "id_map.hpp"
 
 #include "id_map.hpp"
+#include "status_generation.hpp"
 
 char        server_name[PBS_MAXSERVERNAME + 1]; /* host_name[:service|port] */
 int         allow_any_mom;
@@ -688,3 +689,13 @@ Machine::Machine(
 
 #endif
 
+
+status_generation status_gen;
+
+status_generation::status_generation() {}
+status_generation::~status_generation() {}
+
+unsigned long long status_generation::next()
+  {
+  return(0);
+  }
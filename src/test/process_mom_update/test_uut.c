@@ -6,6 +6,7 @@
 #include <pbs_config.h>
 #include "pbs_nodes.h"
 #include "machine.hpp"
+#include "mom_update.h"
 #include <check.h>
 
 int set_note_error(struct pbsnode *np, const char *str);
@@ -87,6 +88,59 @@ END_TEST
 
 
 
+START_TEST(test_save_status_block)
+  {
+  pbsnode      pnode;
+  status_block block;
+
+  // a full update with a sequence number is kept so deltas can be applied to it
+  block.seq = 5;
+  block.strings.push_back("arch=linux");
+  block.strings.push_back("state=free");
+  block.strings.push_back("message=hi");
+  fail_unless(save_status_block(&pnode, block) == PBSE_NONE);
+  fail_unless(pnode.nd_status_seq == 5);
+  fail_unless(pnode.nd_status.find("arch=linux,state=free,message=hi,rectime=") == 0, pnode.nd_status.c_str());
+
+  // the next delta changes, adds and removes strings in place
+  block.clear();
+  block.seq = 6;
+  block.delta = true;
+  block.strings.push_back("state=busy");
+  block.strings.push_back("netload=100");
+  block.removed.push_back("message");
+  fail_unless(save_status_block(&pnode, block) == PBSE_NONE);
+  fail_unless(pnode.nd_status_seq == 6);
+  fail_unless(pnode.nd_status.find("arch=linux,state=busy,netload=100,rectime=") == 0, pnode.nd_status.c_str());
+
+  // a missed update means the mom has to send everything
+  std::string last_status(pnode.nd_status);
+  block.clear();
+  block.seq = 8;
+  block.delta = true;
+  block.strings.push_back("state=free");
+  fail_unless(save_status_block(&pnode, block) == SEND_FULL_STATUS);
+  fail_unless(pnode.nd_status_seq == 0);
+  fail_unless(pnode.nd_status == last_status);
+
+  // and deltas can't be applied until it has
+  block.clear();
+  block.seq = 1;
+  block.delta = true;
+  fail_unless(save_status_block(&pnode, block) == SEND_FULL_STATUS);
+
+  // an update without a sequence number replaces everything
+  block.clear();
+  block.strings.push_back("state=down");
+  fail_unless(save_status_block(&pnode, block) == PBSE_NONE);
+  fail_unless(pnode.nd_status_seq == 0);
+  fail_unless(pnode.nd_status_strings.size() == 0);
+  fail_unless(pnode.nd_status.find("state=down,rectime=") == 0, pnode.nd_status.c_str());
+  }
+END_TEST
+
+
+
 START_TEST(test_two)
   {
   struct pbsnode *pnode = new pbsnode();
@@ -122,6 +176,10 @@ Suite *process_mom_update_suite(void)
 #endif
   suite_add_tcase(s, tc_core);
   
+  tc_core = tcase_create("test_save_status_block");
+  tcase_add_test(tc_core, test_save_status_block);
+  suite_add_tcase(s, tc_core);
+
   tc_core = tcase_create("test_two");
   tcase_add_test(tc_core, test_two);
   suite_add_tcase(s, tc_core);
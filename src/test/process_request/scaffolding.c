@@ -76,6 +76,12 @@ int req_stat_svr(batch_request *preq)
   exit(1);
   }
 
+int req_stat_snapshot(batch_request *preq)
+  {
+  fprintf(stderr, "The call to req_stat_snapshot needs to be mocked!!\n");
+  exit(1);
+  }
+
 void req_shutdown(struct batch_request *preq)
   {
   fprintf(stderr, "The call to req_shutdown needs to be mocked!!\n");
@@ -391,6 +397,12 @@ int req_runjob(batch_request *preq)
   exit(1);
   }
 
+int req_runjobs(batch_request *preq)
+  {
+  fprintf(stderr, "The call to req_runjobs needs to be mocked!!\n");
+  exit(1);
+  }
+
 int req_jobcredential(batch_request *preq)
   {
   fprintf(stderr, "The call to req_jobcredential needs to be mocked!!\n");
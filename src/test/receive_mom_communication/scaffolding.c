@@ -17,6 +17,7 @@
 #include "node_manager.h"
 #include "pbs_ifl.h"
 #include "authorized_hosts.hpp"
+#include "status_generation.hpp"
 
 
 id_map      job_mapper;
@@ -903,6 +904,16 @@ void pbsnode::set_version(const char *) {}
 
 void pbsnode::capture_plugin_resources(const char *) {}
 
+status_generation status_gen;
+
+status_generation::status_generation() {}
+status_generation::~status_generation() {}
+
+unsigned long long status_generation::next()
+  {
+  return(0);
+  }
+
 #include "../../src/server/id_map.cpp"
 #include "../../src/server/node_attr_def.c"
 #include "../../src/lib/Libutils/machine.cpp"
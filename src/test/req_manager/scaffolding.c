@@ -16,6 +16,7 @@
 #include "work_task.h" /* work_type */
 #include "mom_hierarchy_handler.h"
 #include "acl_special.hpp"
+#include "status_generation.hpp"
 
 
 all_nodes allnodes;
@@ -142,6 +143,12 @@ void write_node_state(void)
   exit(1);
   }
 
+void write_node_changes(int need_todo)
+  {
+  fprintf(stderr, "The call to write_node_changes to be mocked!!\n");
+  exit(1);
+  }
+
 struct pbsnode *next_host(
   all_nodes           *an,    /* I */
   all_nodes_iterator **iter,  /* M */
@@ -512,3 +519,12 @@ acl_special::acl_special() {}
 
 acl_special limited_acls;
 
+status_generation status_gen;
+
+status_generation::status_generation() {}
+status_generation::~status_generation() {}
+
+unsigned long long status_generation::next()
+  {
+  return(0);
+  }
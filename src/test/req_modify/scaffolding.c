@@ -13,6 +13,7 @@
 #include "queue.h" /* pbs_queue */
 #include "work_task.h" /* work_task */
 #include "threadpool.h"
+#include "status_generation.hpp"
 
 const char *PJobSubState[10];
 int svr_resc_size = 0;
@@ -330,3 +331,15 @@ void job::set_plugin_resource_usage(
   }
 
 void update_slot_held_jobs(job_array *pa, int num_to_release) {}
+
+void job::hydrate_attrs() {}
+
+status_generation status_gen;
+
+status_generation::status_generation() {}
+status_generation::~status_generation() {}
+
+unsigned long long status_generation::next()
+  {
+  return(0);
+  }
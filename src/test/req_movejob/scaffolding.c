@@ -64,6 +64,11 @@ int swap_jobs(all_jobs *aj, job *job1, job *job2)
   exit(1);
   }
 
+int rerank_job(all_jobs *aj, job *pjob)
+  {
+  return(0);
+  }
+
 char *pbse_to_txt(int err)
   {
   fprintf(stderr, "The call to pbse_to_txt to be mocked!!\n");
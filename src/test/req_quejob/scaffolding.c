@@ -526,6 +526,4 @@ int req_runjob(batch_request *preq)
   return(0);
   }
 
-
-
-
+void job::hydrate_attr(int index) {}
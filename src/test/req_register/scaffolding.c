@@ -391,6 +391,8 @@ array_info::array_info() : struct_version(ARRAY_QS_STRUCT_VERSION), array_size(0
   {
   }
 
+array_index_ranges::array_index_ranges() : ranges(), count(0) {}
+
 job_array::job_array() : job_ids(NULL), jobs_recovered(0), ai_ghost_recovered(false), uncreated_ids(),
                          ai_mutex(NULL), ai_qs()
 
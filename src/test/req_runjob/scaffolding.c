@@ -105,6 +105,13 @@ struct batch_request *cpy_checkpoint(struct batch_request *preq, job *pjob, enum
   exit(1);
   }
 
+batch_request *alloc_br(int type)
+  {
+  return(NULL);
+  }
+
+void reply_text(struct batch_request *preq, int code, const char *text) {}
+
 void reply_ack(struct batch_request *preq)
   {
   fprintf(stderr, "The call to reply_ack to be mocked!!\n");
@@ -261,6 +268,12 @@ job *chk_job_request(char *jobid, struct batch_request *preq)
   exit(1);
   }
 
+job *chk_job_request(char *jobid, struct batch_request *preq, int &rc)
+  {
+  fprintf(stderr, "The call to chk_job_request to be mocked!!\n");
+  exit(1);
+  }
+
 int insert_task(all_tasks *at, work_task *wt)
   {
   fprintf(stderr, "The call to insert_task to be mocked!!\n");
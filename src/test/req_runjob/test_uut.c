@@ -50,6 +50,30 @@ START_TEST(test_get_mail_text)
 END_TEST
 
 
+START_TEST(test_build_runjobs_reply)
+  {
+  batch_request     preq;
+  struct rq_runjob  jobs[2];
+  std::vector<int>  codes;
+  std::string       reply;
+
+  memset(&preq, 0, sizeof(preq));
+  memset(jobs, 0, sizeof(jobs));
+  strcpy(jobs[0].rq_jid, "1.napali");
+  strcpy(jobs[1].rq_jid, "2.napali");
+  preq.rq_type = PBS_BATCH_RunJobs;
+  preq.rq_ind.rq_runjobs.rq_count = 2;
+  preq.rq_ind.rq_runjobs.rq_jobs = jobs;
+
+  codes.push_back(PBSE_NONE);
+  codes.push_back(PBSE_UNKJOBID);
+
+  build_runjobs_reply(&preq, codes, reply);
+  fail_unless(reply == "1.napali 0\n2.napali 15001\n", reply.c_str());
+  }
+END_TEST
+
+
 START_TEST(test_two)
   {
   struct batch_request request;
@@ -82,6 +106,7 @@ Suite *req_runjob_suite(void)
   tc_core = tcase_create("test_two");
   tcase_add_test(tc_core, test_two);
   tcase_add_test(tc_core, test_get_mail_text);
+  tcase_add_test(tc_core, test_build_runjobs_reply);
   suite_add_tcase(s, tc_core);
 
   return s;
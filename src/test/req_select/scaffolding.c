@@ -173,3 +173,5 @@ void set_reply_type(struct batch_reply *preply, int type)
   {
   preply->brp_choice = type;
   }
+
+void job::hydrate_attr(int index) {}
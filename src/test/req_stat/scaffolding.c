@@ -14,6 +14,7 @@
 #include "work_task.h" /* work_task, work_type */
 #include "u_tree.h" /* AvlTree */
 #include "queue.h"
+#include "status_generation.hpp"
 
 all_nodes allnodes;
 pthread_mutex_t *netrates_mutex = NULL;
@@ -56,8 +57,14 @@ void svr_mailowner(job *pjob, int mailpoint, int force, const char *text)
 
 svrattrl *attrlist_create(const char *aname, const char *rname, int vsize)
   {
-  fprintf(stderr, "The call to attrlist_create to be mocked!!\n");
-  exit(1);
+  svrattrl *pal = (svrattrl *)calloc(1, sizeof(svrattrl));
+
+  CLEAR_LINK(pal->al_link);
+  pal->al_name = strdup(aname);
+  pal->al_resc = (rname != NULL) ? strdup(rname) : NULL;
+  pal->al_value = (char *)calloc(1, vsize);
+
+  return(pal);
   }
 
 int modify_job_attr(job *pjob, svrattrl *plist, int perm, int *bad)
@@ -204,8 +211,11 @@ void release_req(struct work_task *pwt)
 
 void append_link(tlist_head *head, list_link *new_link, void *pobj)
   {
-  fprintf(stderr, "The call to append_link to be mocked!!\n");
-  exit(1);
+  new_link->ll_struct = pobj;
+  new_link->ll_prior = head->ll_prior;
+  new_link->ll_next = head;
+  head->ll_prior->ll_next = new_link;
+  head->ll_prior = new_link;
   }
 
 pbs_queue *next_queue(all_queues *aq, all_queues_iterator *iter)
@@ -368,3 +378,41 @@ bool pbsnode::hasprop(std::vector<prop> *needed) const
   {
   preply->brp_choice = type;
   }
+
+job *find_or_create_array_subjob(const char *job_id)
+  {
+  return(svr_find_job(job_id, FALSE));
+  }
+
+bool array_index_ranges::empty() const
+  {
+  return(this->count == 0);
+  }
+
+const std::deque<std::pair<int, int> > &array_index_ranges::get_ranges() const
+  {
+  return(this->ranges);
+  }
+
+status_generation status_gen;
+bool                     deleted_complete = true;
+std::vector<std::string> deleted_names;
+
+status_generation::status_generation() {}
+status_generation::~status_generation() {}
+
+unsigned long long status_generation::current()
+  {
+  return(42);
+  }
+
+bool status_generation::deleted_since(int kind, unsigned long long since, std::vector<std::string> &names, const char *queue)
+  {
+  names = deleted_names;
+  return(deleted_complete);
+  }
+
+bool parse_status_since(const char *extend, unsigned long long &since)
+  {
+  return(false);
+  }
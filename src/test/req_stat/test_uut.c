@@ -5,10 +5,15 @@
 #include <stdio.h>
 #include "pbs_error.h"
 #include "array.h"
+#include "status_generation.hpp"
 
 bool in_execution_queue(job *pjob, job_array *pa);
 job *get_next_status_job(struct stat_cntl *cntl, int &job_array_index, job_array *pa, all_jobs_iterator *iter);
+int start_delta_status(tlist_head *pstathd, int kind, unsigned long long since, const char *queue, bool &resync);
+void copy_template_status_attr(svrattrl *pal, int index, tlist_head *phead);
 extern int abort_called;
+extern bool                     deleted_complete;
+extern std::vector<std::string> deleted_names;
 
 enum TJobStatTypeEnum
   {
@@ -107,6 +112,78 @@ START_TEST(test_get_next_status_job)
 END_TEST
 
 
+START_TEST(test_start_delta_status)
+  {
+  tlist_head         statuses;
+  struct brp_status *pstat;
+  svrattrl          *pal;
+  bool               resync = true;
+
+  CLEAR_HEAD(statuses);
+  deleted_complete = true;
+  deleted_names.clear();
+  deleted_names.push_back("2.napali");
+
+  fail_unless(start_delta_status(&statuses, STATUS_GEN_JOB, 40, "batch", resync) == PBSE_NONE);
+  fail_unless(resync == false);
+
+  // the generation comes first, then the deleted jobs
+  pstat = (struct brp_status *)GET_NEXT(statuses);
+  fail_unless(pstat->brp_objtype == MGR_OBJ_SERVER);
+  pal = (svrattrl *)GET_NEXT(pstat->brp_attr);
+  fail_unless(!strcmp(pal->al_name, ATTR_status_generation));
+  fail_unless(!strcmp(pal->al_value, "42"));
+  fail_unless(GET_NEXT(pal->al_link) == NULL);
+
+  pstat = (struct brp_status *)GET_NEXT(pstat->brp_stlink);
+  fail_unless(pstat->brp_objtype == MGR_OBJ_JOB);
+  fail_unless(!strcmp(pstat->brp_objname, "2.napali"));
+  pal = (svrattrl *)GET_NEXT(pstat->brp_attr);
+  fail_unless(!strcmp(pal->al_name, ATTR_status_deleted));
+  fail_unless(GET_NEXT(pstat->brp_stlink) == NULL);
+
+  // forgotten deletions turn the reply into a full status
+  CLEAR_HEAD(statuses);
+  deleted_complete = false;
+
+  fail_unless(start_delta_status(&statuses, STATUS_GEN_NODE, 1, NULL, resync) == PBSE_NONE);
+  fail_unless(resync == true);
+
+  pstat = (struct brp_status *)GET_NEXT(statuses);
+  pal = (svrattrl *)GET_NEXT(pstat->brp_attr);
+  pal = (svrattrl *)GET_NEXT(pal->al_link);
+  fail_unless(!strcmp(pal->al_name, ATTR_status_resync));
+  fail_unless(GET_NEXT(pstat->brp_stlink) == NULL);
+  }
+END_TEST
+
+
+START_TEST(test_copy_template_status_attr)
+  {
+  tlist_head  attrs;
+  svrattrl   *pal;
+
+  CLEAR_HEAD(attrs);
+
+  pal = attrlist_create(ATTR_N, NULL, strlen("array") + 1);
+  strcpy(pal->al_value, "array");
+  copy_template_status_attr(pal, 4, &attrs);
+
+  // the array request becomes the sub job's index
+  pal = attrlist_create(ATTR_t, NULL, strlen("0-9") + 1);
+  strcpy(pal->al_value, "0-9");
+  copy_template_status_attr(pal, 4, &attrs);
+
+  pal = (svrattrl *)GET_NEXT(attrs);
+  fail_unless(!strcmp(pal->al_value, "array-4"));
+  pal = (svrattrl *)GET_NEXT(pal->al_link);
+  fail_unless(!strcmp(pal->al_name, ATTR_array_id));
+  fail_unless(!strcmp(pal->al_value, "4"));
+  fail_unless(GET_NEXT(pal->al_link) == NULL);
+  }
+END_TEST
+
+
 Suite *req_stat_suite(void)
   {
   Suite *s = suite_create("req_stat_suite methods");
@@ -119,6 +196,14 @@ Suite *req_stat_suite(void)
   tcase_add_test(tc_core, test_get_next_status_job);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_start_delta_status");
+  tcase_add_test(tc_core, test_start_delta_status);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_copy_template_status_attr");
+  tcase_add_test(tc_core, test_copy_template_status_attr);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
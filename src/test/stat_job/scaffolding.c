@@ -185,3 +185,6 @@ void job::encode_plugin_resource_usage(
 
   {
   }
+
+void job::hydrate_attr(int index) {}
+void job::hydrate_attrs() {}
@@ -0,0 +1,7 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "status_generation.hpp"
+
+int LOGLEVEL = 0;
@@ -0,0 +1,178 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <check.h>
+
+#include "status_generation.hpp"
+
+
+START_TEST(test_next_and_current)
+  {
+  status_generation sg(100, 10);
+
+  fail_unless(sg.current() == 100);
+  fail_unless(sg.next() == 101);
+  fail_unless(sg.next() == 102);
+  fail_unless(sg.current() == 102);
+
+  // the default counter starts from the time so it outlives a restart
+  status_generation started_now;
+  fail_unless(started_now.current() > 100);
+  }
+END_TEST
+
+
+START_TEST(test_deleted_since)
+  {
+  status_generation        sg(100, 10);
+  std::vector<std::string> names;
+  unsigned long long       before_delete;
+
+  fail_unless(sg.deleted_since(STATUS_GEN_JOB, 100, names) == true);
+  fail_unless(names.size() == 0);
+
+  sg.next();
+  before_delete = sg.current();
+  sg.record_deleted(STATUS_GEN_JOB, "1.napali");
+  sg.record_deleted(STATUS_GEN_NODE, "numa3");
+  sg.record_deleted(STATUS_GEN_JOB, "2.napali");
+
+  fail_unless(sg.deleted_since(STATUS_GEN_JOB, before_delete, names) == true);
+  fail_unless(names.size() == 2);
+  fail_unless(names[0] == "2.napali");
+  fail_unless(names[1] == "1.napali");
+
+  names.clear();
+  fail_unless(sg.deleted_since(STATUS_GEN_NODE, before_delete, names) == true);
+  fail_unless(names.size() == 1);
+  fail_unless(names[0] == "numa3");
+
+  names.clear();
+  fail_unless(sg.deleted_since(STATUS_GEN_JOB, sg.current(), names) == true);
+  fail_unless(names.size() == 0);
+
+  // older than the server's first generation, or newer than its last
+  fail_unless(sg.deleted_since(STATUS_GEN_JOB, 99, names) == false);
+  fail_unless(sg.deleted_since(STATUS_GEN_JOB, sg.current() + 1, names) == false);
+  fail_unless(sg.deleted_since(STATUS_GEN_KINDS, 100, names) == false);
+  }
+END_TEST
+
+
+START_TEST(test_forgotten_deletions)
+  {
+  status_generation        sg(100, 2);
+  std::vector<std::string> names;
+  unsigned long long       first;
+
+  sg.record_deleted(STATUS_GEN_JOB, "1.napali");
+  first = sg.current();
+  sg.record_deleted(STATUS_GEN_JOB, "2.napali");
+  sg.record_deleted(STATUS_GEN_JOB, "3.napali");
+
+  // 1.napali was forgotten, so only a client that saw it can get a delta
+  fail_unless(sg.deleted_since(STATUS_GEN_JOB, 100, names) == false);
+  fail_unless(sg.deleted_since(STATUS_GEN_JOB, first, names) == true);
+  fail_unless(names.size() == 2);
+
+  // node deletions have their own history
+  names.clear();
+  fail_unless(sg.deleted_since(STATUS_GEN_NODE, 100, names) == true);
+  fail_unless(names.size() == 0);
+  }
+END_TEST
+
+
+START_TEST(test_dequeued_jobs)
+  {
+  status_generation        sg(100, 10);
+  std::vector<std::string> names;
+
+  sg.record_dequeued("1.napali", "batch");
+  sg.record_dequeued("2.napali", "batch");
+  sg.record_deleted(STATUS_GEN_JOB, "2.napali");
+  sg.record_dequeued("3.napali", "debug");
+
+  // jobs that left a queue are only removed from that queue's status
+  fail_unless(sg.deleted_since(STATUS_GEN_JOB, 100, names, "batch") == true);
+  fail_unless(names.size() == 2);
+  fail_unless(names[0] == "2.napali");
+  fail_unless(names[1] == "1.napali");
+
+  names.clear();
+  fail_unless(sg.deleted_since(STATUS_GEN_JOB, 100, names, "debug") == true);
+  fail_unless(names.size() == 2);
+  fail_unless(names[0] == "3.napali");
+  fail_unless(names[1] == "2.napali");
+
+  // the server's status only loses the deleted job
+  names.clear();
+  fail_unless(sg.deleted_since(STATUS_GEN_JOB, 100, names) == true);
+  fail_unless(names.size() == 1);
+  fail_unless(names[0] == "2.napali");
+  }
+END_TEST
+
+
+START_TEST(test_parse_status_since)
+  {
+  unsigned long long since = 0;
+
+  fail_unless(parse_status_since(NULL, since) == false);
+  fail_unless(parse_status_since("exec_queue_only", since) == false);
+  fail_unless(parse_status_since("since=", since) == false);
+  fail_unless(parse_status_since("since=abc", since) == false);
+
+  fail_unless(parse_status_since("since=1234", since) == true);
+  fail_unless(since == 1234);
+
+  fail_unless(parse_status_since("exec_queue_only,since=18446744073709551615", since) == true);
+  fail_unless(since == 18446744073709551615ULL);
+  }
+END_TEST
+
+
+Suite *status_generation_suite(void)
+  {
+  Suite *s = suite_create("status_generation test suite methods");
+  TCase *tc_core = tcase_create("test_next_and_current");
+  tcase_add_test(tc_core, test_next_and_current);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_deleted_since");
+  tcase_add_test(tc_core, test_deleted_since);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_forgotten_deletions");
+  tcase_add_test(tc_core, test_forgotten_deletions);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_dequeued_jobs");
+  tcase_add_test(tc_core, test_dequeued_jobs);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_parse_status_since");
+  tcase_add_test(tc_core, test_parse_status_since);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(status_generation_suite());
+  srunner_set_log(sr, "status_generation_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
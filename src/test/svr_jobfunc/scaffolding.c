@@ -20,6 +20,7 @@
 #include "machine.hpp"
 #include "log.h"
 #include "utils.h"
+#include "status_generation.hpp"
 
 all_nodes               allnodes;
 bool possible = false;
@@ -82,6 +83,7 @@ pbs_queue *find_queuebyname(const char *quename)
   pq->qu_mutex = (pthread_mutex_t*)calloc(1, sizeof(pthread_mutex_t));
   pq->qu_jobs = new all_jobs();
   pq->qu_jobs_array_sum = new all_jobs();
+  pq->qu_attr[QA_ATR_QType].at_val.at_str = strdup("Execution");
 
   snprintf(pq->qu_qs.qu_name, sizeof(pq->qu_qs.qu_name), "%s", quename);
 
@@ -141,8 +143,9 @@ int procs_available(int proc_ct)
 
 int decode_str(pbs_attribute *patr, const char *name, const char *rescn, const char *val, int perm)
   {
-  fprintf(stderr, "The call to decode_str to be mocked!!\n");
-  exit(1);
+  patr->at_val.at_str = strdup(val);
+  patr->at_flags |= ATR_VFLAG_SET;
+  return(0);
   }
 
 int decode_resc(pbs_attribute *patr, const char *name, const char *rescn, const char *val, int perm)
@@ -303,8 +306,9 @@ int insert_task(all_tasks *at, work_task *wt)
 
 void free_str(struct pbs_attribute *attr)
   {
-  fprintf(stderr, "The call to free_str to be mocked!!\n");
-  exit(1);
+  free(attr->at_val.at_str);
+  attr->at_val.at_str = NULL;
+  attr->at_flags &= ~ATR_VFLAG_SET;
   }
 
 void *get_next(list_link pl, char *file, int line)
@@ -742,3 +746,17 @@ job::~job() {}
 #include "../../lib/Libattr/req.cpp"
 #include "../../lib/Libattr/complete_req.cpp"
 #include "../../lib/Libattr/attr_req_info.cpp"
+
+void job::hydrate_attr(int index) {}
+
+status_generation status_gen;
+
+status_generation::status_generation() {}
+status_generation::~status_generation() {}
+
+unsigned long long status_generation::next()
+  {
+  return(0);
+  }
+
+void status_generation::record_dequeued(const char *job_id, const char *queue) {}
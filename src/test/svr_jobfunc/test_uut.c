@@ -207,9 +207,12 @@ START_TEST(svr_enquejob_test)
   result = svr_enquejob(NULL, 0, NULL, false, false);
   fail_unless(result != PBSE_NONE, "NULL input pointer fail");
 
+  strcpy(test_job.ji_qs.ji_jobid, "1.napali");
+  test_job.ji_wattr[JOB_ATR_qtime].at_flags = ATR_VFLAG_SET;
+  job_attr_def[JOB_ATR_in_queue].at_free = free_str;
+  job_attr_def[JOB_ATR_in_queue].at_decode = decode_str;
   result = svr_enquejob(&test_job, 0, NULL, false, false);
-  /*Need more complicated mocking in order to have other result than PBSE_JOBNOTFOUND*/
-  fail_unless(result == PBSE_JOBNOTFOUND, "svr_enquejob fail: %d", result);
+  fail_unless(result == PBSE_NONE, "svr_enquejob fail: %d", result);
 
   }
 END_TEST
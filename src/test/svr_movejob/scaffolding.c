@@ -45,6 +45,7 @@ bool cray_enabled = false;
 mom_hierarchy_handler hierarchy_handler;
 std::string global_string;
 id_map node_mapper;
+id_map property_mapper;
 struct pbsnode reporter;
 struct pbsnode *alps_reporter = &reporter;
 const char *alps_reporter_feature  = "alps_reporter";
@@ -631,6 +632,8 @@ int translate_range_string_to_vector(
 #include "../../src/server/pbsnode.cpp"
 #include "../../src/server/id_map.cpp"
 
+void update_node_index(pbsnode *pnode) {}
+
 struct pbsnode *find_nodebyname(
 
   const char *nodename)
@@ -662,3 +665,4 @@ int node_status_list(
   return(0);
   }
 
+void job::hydrate_attrs() {}
@@ -443,7 +443,7 @@ job::job() : ji_momstat(0), ji_modified(0), ji_momhandle(-1), ji_radix(0),
              ji_have_nodes_request(false), ji_external_clone(NULL),
              ji_cray_clone(NULL), ji_parent_job(NULL), ji_internal_id(-1),
              ji_being_recycled(false), ji_last_reported_time(0), ji_mod_time(0),
-             ji_queue_counted(0), ji_being_deleted(false), ji_commit_done(false)
+             ji_status_gen(0), ji_queue_counted(0), ji_being_deleted(false), ji_commit_done(false)
 
   {
   memset(this->ji_arraystructid, 0, sizeof(ji_arraystructid));